@@ -25,6 +25,9 @@ document.addEventListener('DOMContentLoaded', () => {
 
   const $toneEnabled = document.getElementById('tone-enabled');
   const $toneEnabledLabel = document.getElementById('tone-enabled-label');
+  const $tonePlan = document.getElementById('tone-plan');
+  const $tonePlanSaveBtn = document.getElementById('tone-plan-save');
+  const $tonePlanStatus = document.getElementById('tone-plan-status');
 
   // --- Console UI (receive-only) ---
   const $consoleLog = document.getElementById('console-log');
@@ -45,6 +48,7 @@ document.addEventListener('DOMContentLoaded', () => {
   const $ringLength = document.getElementById('ring-length');
   const $ringPause = document.getElementById('ring-pause');
   const $ringIterations = document.getElementById('ring-iterations');
+  const $ringMaxConcurrent = document.getElementById('ring-max-concurrent');
   const $ringSaveBtn = document.getElementById('ring-save');
   const $ringSettingsStatus = document.getElementById('ring-settings-status');
 
@@ -109,6 +113,13 @@ document.addEventListener('DOMContentLoaded', () => {
     if ($toneEnabledLabel) $toneEnabledLabel.textContent = enabled ? 'Enabled' : 'Disabled';
   };
 
+  const setTonePlanUi = (d) => {
+    if (typeof d.tonePlan === 'string' && $tonePlan && document.activeElement !== $tonePlan) $tonePlan.value = d.tonePlan;
+    if (!$tonePlanStatus) return;
+    if (d.tonePlanPending) $tonePlanStatus.textContent = 'Waiting for idle lines…';
+    else if ('tonePlanLoaded' in d) $tonePlanStatus.textContent = d.tonePlanLoaded ? 'Loaded' : 'Not loaded';
+  };
+
   const setMqttUiState = (enabled, retain) => {
     if ($mqttEnabled) $mqttEnabled.checked = !!enabled;
     if ($mqttEnabledLabel) $mqttEnabledLabel.textContent = enabled ? 'Enabled' : 'Disabled';
@@ -215,6 +226,7 @@ document.addEventListener('DOMContentLoaded', () => {
       const d = await r.json();
       if (typeof d.enabled === 'boolean') setToneEnabledUi(d.enabled);
       else if (typeof d.enabled === 'number') setToneEnabledUi(Boolean(d.enabled));
+      setTonePlanUi(d);
     } catch (e) {
       console.warn('Could not read tone generator state', e);
     }
@@ -245,6 +257,30 @@ document.addEventListener('DOMContentLoaded', () => {
     }
   }
 
+  // Load a tone plan (/tones/<name>.txt); the device swaps it in when no tone is playing
+  async function saveTonePlan() {
+    if (!$tonePlan) return;
+    const plan = $tonePlan.value.trim();
+    if (!plan) return;
+    try {
+      $tonePlanSaveBtn.classList.add('working');
+      const body = new URLSearchParams({ plan }).toString();
+      const r = await fetch('/api/tone-generator/plan', {
+        method: 'POST',
+        headers: { 'Content-Type': 'application/x-www-form-urlencoded' },
+        body
+      });
+      if (r.status === 404) throw new Error('No /tones/' + plan + '.txt on the device');
+      if (!r.ok) throw new Error('HTTP ' + r.status);
+      setTonePlanUi(await r.json());
+    } catch (e) {
+      console.warn('Could not load tone plan', e);
+      if ($tonePlanStatus) $tonePlanStatus.textContent = 'Failed: ' + e.message;
+    } finally {
+      $tonePlanSaveBtn.classList.remove('working');
+    }
+  }
+
   // Load ring settings from server
   async function loadRingSettings() {
     try {
@@ -254,6 +290,7 @@ document.addEventListener('DOMContentLoaded', () => {
       if (typeof d.ringLengthMs === 'number') $ringLength.value = msToSec(d.ringLengthMs);
       if (typeof d.ringPauseMs === 'number') $ringPause.value = msToSec(d.ringPauseMs);
       if (typeof d.ringIterations === 'number') $ringIterations.value = d.ringIterations;
+      if (typeof d.maxConcurrentRingers === 'number') $ringMaxConcurrent.value = d.maxConcurrentRingers;
     } catch (e) {
       console.warn('Could not read ring settings', e);
       setRingSettingsStatus('Could not read ring settings');
@@ -268,7 +305,8 @@ document.addEventListener('DOMContentLoaded', () => {
       const body = new URLSearchParams({
         ringLengthMs: secToMs($ringLength.value),
         ringPauseMs: secToMs($ringPause.value),
-        ringIterations: $ringIterations.value
+        ringIterations: $ringIterations.value,
+        maxConcurrentRingers: $ringMaxConcurrent.value
       }).toString();
       const r = await fetch('/api/settings/ring', {
         method: 'POST',
@@ -598,6 +636,7 @@ document.addEventListener('DOMContentLoaded', () => {
   $dbgBtn?.addEventListener('click', saveDebug);
   $restartBtn?.addEventListener('click', restartDevice);
   $toneEnabled?.addEventListener('change', saveToneGenerator);
+  $tonePlanSaveBtn?.addEventListener('click', saveTonePlan);
   $ringTestBtn?.addEventListener('click', testRing);
   $ringStopBtn?.addEventListener('click', stopRing);
   $ringSaveBtn?.addEventListener('click', saveRingSettings);
@@ -638,6 +677,7 @@ document.addEventListener('DOMContentLoaded', () => {
     try {
       const d = JSON.parse(ev.data);
       if ('enabled' in d) setToneEnabledUi(!!d.enabled);
+      setTonePlanUi(d);
     } catch {}
   });
 
@@ -1,5 +1,7 @@
 #pragma once
 #include <cstdint>
+#include <cstddef>
+#include <array>
 #include <Arduino.h>
 
 // Console color codes
@@ -16,6 +18,20 @@
 #define BOLD    "\033[1m"
 
 namespace cfg {
+
+  namespace lines {
+    // Line capacity is derived from the number of SLIC banks (one MCP23017 with
+    // four KS0835F each). Adding a bank means bumping SLIC_BANK_COUNT and
+    // extending the per-bank and per-line tables in cfg::mcp below; static_asserts
+    // there fail the build until they match.
+    inline constexpr std::size_t SLIC_BANK_COUNT = 2;
+    inline constexpr std::size_t LINES_PER_BANK  = 4;
+    inline constexpr std::size_t MAX_LINES       = SLIC_BANK_COUNT * LINES_PER_BANK;
+
+    // Line status events buffered for SSE/MQTT/logging (power of two). A consumer
+    // more than this many events behind loses the oldest ones.
+    inline constexpr std::size_t STATUS_EVENT_CAPACITY = 32;
+  }
   
   namespace ESP_PINS {
     
@@ -53,6 +69,10 @@ namespace cfg {
     inline constexpr uint8_t MCP_SLIC1_ADDRESS = 0x22;  //A0=GND, A1=VCC, A2=VCC??
     inline constexpr uint8_t MCP_SLIC2_ADDRESS = 0x23;  //A0=GND, A1=VCC, A2=VCC??
 
+    // I2C fast mode: one MT8816 strobe (4 register writes) takes ~0.3 ms on
+    // the bus instead of ~1.2 ms at the 100 kHz core default
+    inline constexpr uint32_t I2C_CLOCK_HZ = 400000;
+
     // MCP MAIN
     constexpr uint8_t Q1 = 15;
     constexpr uint8_t Q2 = 14;
@@ -172,16 +192,24 @@ namespace cfg {
       /*15*/{INPUT,   LOW},     // GPB7 PD_3/7
     };
 
-    inline constexpr uint8_t SHK_LINE_ADDR[8] = {
+    // MCP address and ESP32 INT pin per SLIC bank (bank b serves lines b*LINES_PER_BANK ..)
+    inline constexpr uint8_t SLIC_BANK_ADDR[] = {
+      MCP_SLIC1_ADDRESS, MCP_SLIC2_ADDRESS
+    };
+    inline constexpr int SLIC_BANK_INT_PIN[] = {
+      MCP_SLIC_INT_1_PIN, MCP_SLIC_INT_2_PIN
+    };
+
+    inline constexpr uint8_t SHK_LINE_ADDR[] = {
       MCP_SLIC1_ADDRESS, MCP_SLIC1_ADDRESS, MCP_SLIC1_ADDRESS, MCP_SLIC1_ADDRESS,
       MCP_SLIC2_ADDRESS, MCP_SLIC2_ADDRESS, MCP_SLIC2_ADDRESS, MCP_SLIC2_ADDRESS
     };
 
-    inline constexpr std::size_t SHK_LINE_COUNT = 8;
-    inline constexpr std::size_t FR_LINE_COUNT = 8;
-    inline constexpr std::size_t RM_LINE_COUNT = 8;
+    inline constexpr std::size_t SHK_LINE_COUNT = lines::MAX_LINES;
+    inline constexpr std::size_t FR_LINE_COUNT = lines::MAX_LINES;
+    inline constexpr std::size_t RM_LINE_COUNT = lines::MAX_LINES;
 
-    constexpr uint8_t SHK_PINS[8] = {
+    constexpr uint8_t SHK_PINS[] = {
       SHK_04,   // Line 0 MCP_SLIC1, GPA5
       SHK_15,   // Line 1 MCP_SLIC1, GPA4
       SHK_26,   // Line 2 MCP_SLIC1, GPB0
@@ -191,7 +219,7 @@ namespace cfg {
       SHK_26,   // Line 6 MCP_SLIC2, GPB0
       SHK_37,   // Line 7 MCP_SLIC2, GPB3
     };
-    constexpr uint8_t FR_PINS[8] = {
+    constexpr uint8_t FR_PINS[] = {
       FR_04,   // Line 0 MCP_SLIC1, GPA7
       FR_15,   // Line 1 MCP_SLIC1, GPA2
       FR_26,   // Line 2 MCP_SLIC1, GPB2
@@ -201,7 +229,7 @@ namespace cfg {
       FR_26,   // Line 6 MCP_SLIC2, GPB2
       FR_37,   // Line 7 MCP_SLIC2, GPB5
     };
-    constexpr uint8_t RM_PINS[8] = {
+    constexpr uint8_t RM_PINS[] = {
       RM_04,   // Line 0 MCP_SLIC1, GPA6
       RM_15,   // Line 1 MCP_SLIC1, GPA3
       RM_26,   // Line 2 MCP_SLIC1, GPB1
@@ -211,6 +239,33 @@ namespace cfg {
       RM_26,   // Line 6 MCP_SLIC2, GPB1
       RM_37,   // Line 7 MCP_SLIC2, GPB4
     };
+
+    // The tables above are written out per line; SLIC_BANK_COUNT must match them
+    static_assert(sizeof(SLIC_BANK_ADDR) == lines::SLIC_BANK_COUNT, "SLIC_BANK_ADDR needs one entry per SLIC bank");
+    static_assert(sizeof(SLIC_BANK_INT_PIN) / sizeof(SLIC_BANK_INT_PIN[0]) == lines::SLIC_BANK_COUNT,
+                  "SLIC_BANK_INT_PIN needs one entry per SLIC bank");
+    static_assert(sizeof(SHK_LINE_ADDR) == lines::MAX_LINES, "SHK_LINE_ADDR needs one entry per line");
+    static_assert(sizeof(SHK_PINS) == lines::MAX_LINES, "SHK_PINS needs one entry per line");
+    static_assert(sizeof(FR_PINS) == lines::MAX_LINES, "FR_PINS needs one entry per line");
+    static_assert(sizeof(RM_PINS) == lines::MAX_LINES, "RM_PINS needs one entry per line");
+
+    constexpr bool linesMatchBanks() {
+      for (std::size_t l = 0; l < lines::MAX_LINES; ++l) {
+        if (SHK_LINE_ADDR[l] != SLIC_BANK_ADDR[l / lines::LINES_PER_BANK]) return false;
+      }
+      return true;
+    }
+    static_assert(linesMatchBanks(), "SHK_LINE_ADDR must follow SLIC_BANK_ADDR bank by bank");
+  }
+
+  namespace ring {
+    // While FR toggles, the line's SHK interrupt is masked and ring trip is
+    // sampled instead: one GPIO read per bank and FR half cycle (25 ms),
+    // TRIP_SAMPLE_OFFSET_MS after the FR edge so the switching transient has
+    // settled. TRIP_CONSECUTIVE off-hook readings in a row mean the phone is answered.
+    inline constexpr uint32_t TRIP_SAMPLE_OFFSET_MS = 12;   // Mid half cycle
+    inline constexpr uint32_t TRIP_SAMPLE_LATE_MS   = 20;   // Past this, skip the half cycle
+    inline constexpr uint8_t  TRIP_CONSECUTIVE      = 3;
   }
 
   namespace externalGPIO {
@@ -237,10 +292,109 @@ namespace cfg {
     constexpr uint8_t ax_pins[4] = {mcp::AX0, mcp::AX1, mcp::AX2, mcp::AX3}; // GPB0-GPB3
     constexpr uint8_t ay_pins[3] = {mcp::AY0, mcp::AY1, mcp::AY2}; // GPB4-GPB6
 
+    // Audio sources occupy the top X rows. They are bused to every chip in the
+    // fabric, so a source can be switched to a line without using a trunk.
     constexpr uint8_t  DAC1 = 15;
     constexpr uint8_t  DAC2 = 14;
     constexpr uint8_t  DAC3 = 13;
     constexpr uint8_t  D_OUTL = 12;
+
+    constexpr uint8_t X_PORTS = 16;
+    constexpr uint8_t Y_PORTS = 8;
+
+    // ----- Switching fabric (one or more MT8816) -----
+    // All chips share RESET/DATA/AX/AY on their MCP; each chip has its own CS
+    // and STROBE. A second chip on the same MCP would typically use the free
+    // GPA4/GPA5 (e.g. {MCP_MT8816_ADDRESS, 4, 5}).
+    struct ChipPins {
+      uint8_t mcpAddr;
+      uint8_t cs;       // GPA pin (0..7)
+      uint8_t strobe;   // GPA pin (0..7)
+    };
+
+    inline constexpr std::size_t CHIP_COUNT = 1;
+    inline constexpr ChipPins CHIPS[CHIP_COUNT] = {
+      {mcp::MCP_MT8816_ADDRESS, mcp::CS, mcp::STROBE},
+    };
+
+    // Where a line is wired: the line is tied to both X and Y of the same chip
+    struct LinePort {
+      uint8_t chip;
+      uint8_t x;
+      uint8_t y;
+    };
+
+    inline constexpr LinePort LINE_PORTS[lines::MAX_LINES] = {
+      {0, 0, 0}, {0, 1, 1}, {0, 2, 2}, {0, 3, 3},
+      {0, 4, 4}, {0, 5, 5}, {0, 6, 6}, {0, 7, 7},
+    };
+
+    // Inter-chip trunk: one wire from a port on chip A to a port on chip B.
+    // isX tells whether the wire lands on an X (column) or Y (row) port.
+    struct TrunkEnd {
+      uint8_t chip;
+      uint8_t port;
+      bool    isX;
+    };
+    struct Trunk {
+      TrunkEnd a;
+      TrunkEnd b;
+    };
+
+    // Example for two chips: {{0, 8, true}, {1, 7, false}}
+    inline constexpr std::size_t TRUNK_COUNT = 0;
+    inline constexpr std::array<Trunk, TRUNK_COUNT> TRUNKS = {};
+
+    // Longest allowed trunk chain for a line-to-line call
+    inline constexpr uint8_t MAX_TRUNK_HOPS = 3;
+  }
+
+  namespace ad9833 {
+    // Master clock on the AD9833 modules (25 MHz crystal oscillator)
+    inline constexpr uint32_t MCLK_HZ = 25000000UL;
+    inline constexpr uint32_t SPI_HZ  = 8000000UL;
+
+    // 28-bit frequency register value: f * 2^28 / MCLK (rounded)
+    constexpr uint32_t frequencyWord(float hz) {
+      return (hz <= 0.0f) ? 0u
+           : static_cast<uint32_t>(static_cast<double>(hz) * 268435456.0 / MCLK_HZ + 0.5) & 0x0FFFFFFFu;
+    }
+  }
+
+  namespace synth {
+    // Software DDS on the PCM5102 (D_OUTL), used as a fourth tone generator
+    inline constexpr uint32_t SAMPLE_RATE_HZ = 16000;
+    inline constexpr size_t   BLOCK_FRAMES   = 128;     // 8 ms per block at 16 kHz
+    inline constexpr uint16_t AMPLITUDE_Q15  = 12000;   // Per oscillator, two summed stay below full scale
+    inline constexpr uint32_t TASK_STACK     = 4096;
+    inline constexpr uint8_t  TASK_PRIORITY  = 5;
+    inline constexpr int      TASK_CORE      = 0;
+  }
+
+  namespace dtmf {
+    // Software DTMF detector (DtmfDetector): one Goertzel bank per line, fed
+    // from a sampled line input instead of the shared MT8870
+    inline constexpr uint32_t SAMPLE_RATE_HZ = 8000;
+    inline constexpr size_t   BLOCK_SAMPLES  = 205;       // 25.6 ms, the classic 8 kHz block
+    inline constexpr size_t   MAX_CHANNELS   = lines::MAX_LINES;
+    inline constexpr int32_t  MIN_RMS        = 64;        // Below this a block is silence
+  }
+
+  namespace audio {
+    // AudioPlayer streaming: the loop reads LittleFS ahead into a ring buffer,
+    // a task drains it into I2S
+    inline constexpr uint32_t OUTPUT_RATE_HZ   = 16000;   // Fixed I2S rate, clips are resampled
+    inline constexpr size_t   RING_BYTES       = 16384;   // ~250 ms of 16 kHz stereo
+    inline constexpr size_t   READ_CHUNK_BYTES = 4096;    // One LittleFS read per refill
+    inline constexpr size_t   TASK_CHUNK_BYTES = 1024;    // Per I2S write
+    inline constexpr uint32_t WRITE_TIMEOUT_MS = 50;
+    inline constexpr uint32_t LEAD_IN_MS       = 20;      // Silence ahead of each clip, covers the D_OUTL close
+    inline constexpr uint32_t TASK_STACK       = 4096;
+    inline constexpr uint8_t  TASK_PRIORITY    = 5;
+    inline constexpr int      TASK_CORE        = 0;
+
+    // ToneSynth and AudioPlayer share one PCMDriver; the I2S clock never changes hands
+    static_assert(OUTPUT_RATE_HZ == synth::SAMPLE_RATE_HZ, "AudioPlayer and ToneSynth must run the same I2S rate");
   }
 
   namespace TMUX4051 {
@@ -0,0 +1,143 @@
+"""Pack data/audio/*.wav into a raw audio bank image for the 'audiobank' partition.
+
+Image layout (little endian, see src/services/AudioBank.h):
+  header  : magic 'ABNK', u16 version, u16 count, u32 image size, u32 reserved
+  entries : count x { char name[32], u32 offset, u32 size, u32 sample rate,
+                      u8 channels, u8 bits per sample, u16 reserved }
+  data    : raw PCM16 samples per clip, 4-byte aligned
+
+Clip names are the file names without '.wav'. Only 16-bit PCM mono/stereo.
+
+Standalone:  python scripts/audio_bank.py data/audio .pio/audiobank.bin
+PlatformIO:  pio run -t buildaudiobank / -t uploadaudiobank
+"""
+import os
+import struct
+import sys
+
+MAGIC = b"ABNK"
+VERSION = 1
+HEADER = struct.Struct("<4sHHII")
+ENTRY = struct.Struct("<32sIIIBBH")
+NAME_MAX = 31
+PARTITION_NAME = "audiobank"
+
+
+def read_wav(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[0:4] != b"RIFF" or data[8:12] != b"WAVE":
+        raise ValueError("%s: not a RIFF/WAVE file" % path)
+
+    pos = 12
+    fmt = None
+    pcm = None
+    while pos + 8 <= len(data):
+        chunk_id = data[pos:pos + 4]
+        size = struct.unpack_from("<I", data, pos + 4)[0]
+        body = data[pos + 8:pos + 8 + size]
+        if chunk_id == b"fmt ":
+            fmt = struct.unpack_from("<HHIIHH", body, 0)
+        elif chunk_id == b"data":
+            pcm = body
+        pos += 8 + size + (size & 1)
+
+    if fmt is None or pcm is None:
+        raise ValueError("%s: missing fmt or data chunk" % path)
+    audio_format, channels, rate, _, _, bits = fmt
+    if audio_format != 1 or bits != 16 or channels not in (1, 2):
+        raise ValueError("%s: only 16-bit PCM mono/stereo is supported" % path)
+    return rate, channels, bits, pcm
+
+
+def build_image(src_dir):
+    files = sorted(f for f in os.listdir(src_dir) if f.lower().endswith(".wav"))
+    clips = []
+    for name in files:
+        clip_name = os.path.splitext(name)[0]
+        if len(clip_name) > NAME_MAX:
+            raise ValueError("%s: clip name longer than %d characters" % (name, NAME_MAX))
+        clips.append((clip_name,) + read_wav(os.path.join(src_dir, name)))
+
+    offset = HEADER.size + ENTRY.size * len(clips)
+    entries = b""
+    payload = b""
+    for clip_name, rate, channels, bits, pcm in clips:
+        pad = (-offset) % 4
+        payload += b"\0" * pad
+        offset += pad
+        entries += ENTRY.pack(clip_name.encode("ascii"), offset, len(pcm), rate, channels, bits, 0)
+        payload += pcm
+        offset += len(pcm)
+
+    header = HEADER.pack(MAGIC, VERSION, len(clips), offset, 0)
+    return header + entries + payload, clips
+
+
+def write_image(src_dir, out_path):
+    image, clips = build_image(src_dir)
+    os.makedirs(os.path.dirname(os.path.abspath(out_path)), exist_ok=True)
+    with open(out_path, "wb") as f:
+        f.write(image)
+    for clip_name, rate, channels, _, pcm in clips:
+        print("audio bank: %-32s %6d Hz %d ch %8d bytes" % (clip_name, rate, channels, len(pcm)))
+    print("audio bank: %d clips, %d bytes -> %s" % (len(clips), len(image), out_path))
+    return image
+
+
+def partition_offset(csv_path, name=PARTITION_NAME):
+    with open(csv_path) as f:
+        for line in f:
+            line = line.split("#", 1)[0].strip()
+            if not line:
+                continue
+            cols = [c.strip() for c in line.split(",")]
+            if cols[0] == name:
+                return int(cols[3], 0), int(cols[4], 0)
+    raise ValueError("partition '%s' not found in %s" % (name, csv_path))
+
+
+# ---- PlatformIO integration (extra_scripts) ----
+try:
+    Import("env")  # noqa: F821
+except NameError:
+    env = None
+
+if env is not None:
+    project_dir = env.subst("$PROJECT_DIR")
+    audio_dir = os.path.join(project_dir, "data", "audio")
+    image_path = os.path.join(env.subst("$BUILD_DIR"), "audiobank.bin")
+    # Only envs with a custom table have the partition (16 MB flash, see partitions.csv)
+    partitions_option = env.GetProjectOption("board_build.partitions", "")
+    partitions = os.path.join(project_dir, partitions_option) if partitions_option else None
+
+    def _partition():
+        if partitions is None or not os.path.isfile(partitions):
+            raise SystemExit("audio bank: env '%s' has no audiobank partition (needs 16 MB flash, use devkitc_n16)"
+                             % env.subst("$PIOENV"))
+        return partition_offset(partitions)
+
+    def _build(*args, **kwargs):
+        image = write_image(audio_dir, image_path)
+        _, size = _partition()
+        if len(image) > size:
+            raise SystemExit("audio bank: image (%d bytes) does not fit the partition (%d bytes)" % (len(image), size))
+
+    def _upload(*args, **kwargs):
+        _build()
+        offset, _ = _partition()
+        env.Execute(" ".join([
+            "$PYTHONEXE", "$UPLOADER", "--chip", "$BOARD_MCU", "--port", "$UPLOAD_PORT",
+            "--baud", "$UPLOAD_SPEED", "write_flash", hex(offset), image_path,
+        ]))
+
+    env.AddCustomTarget("buildaudiobank", None, _build, title="Build audio bank",
+                        description="Pack data/audio into audiobank.bin")
+    env.AddCustomTarget("uploadaudiobank", None, _upload, title="Upload audio bank",
+                        description="Write audiobank.bin to the audiobank partition")
+
+elif __name__ == "__main__":
+    if len(sys.argv) != 3:
+        print(__doc__)
+        sys.exit(1)
+    write_image(sys.argv[1], sys.argv[2])
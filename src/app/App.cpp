@@ -8,13 +8,17 @@ App::App()
   : mcpDriver_(),
     interruptManager_(mcpDriver_, Settings::instance()),
     mt8816Driver_(mcpDriver_, Settings::instance()),
-    connectionHandler_(mt8816Driver_, Settings::instance()),
+    switchFabric_(mt8816Driver_, Settings::instance()),
+    connectionHandler_(switchFabric_, Settings::instance()),
 
     // ===== Tone generation stack =====
-    // Three physical AD9833 chips + one coordinating service.
+    // Three physical AD9833 chips, the PCM5102 synth + one coordinating service.
     ad9833Driver1_(cfg::ESP_PINS::CS1_PIN),
     ad9833Driver2_(cfg::ESP_PINS::CS2_PIN),
     ad9833Driver3_(cfg::ESP_PINS::CS3_PIN),
+    pcmDriver_(),
+    toneSynth_(pcmDriver_),
+    audioPlayer_(pcmDriver_),
     toneGenerator_(ad9833Driver1_, ad9833Driver2_, ad9833Driver3_),
 
     // ===== Telephony services =====
@@ -28,10 +32,10 @@ App::App()
     provisioning_(),
     mqttClient_(Settings::instance(), wifiClient_, lineManager_),
     lineAction_(lineManager_, Settings::instance(), mt8816Driver_, ringGenerator_, toneReader_,
-                toneGenerator_, connectionHandler_, mqttClient_),
+                toneGenerator_, connectionHandler_),
 
     // WebServer depends on line/ring/action + wifi.
-    webServer_(Settings::instance(), lineManager_, wifiClient_, ringGenerator_, lineAction_, 80),
+    webServer_(Settings::instance(), lineManager_, wifiClient_, ringGenerator_, lineAction_, toneGenerator_, 80),
     functions_(interruptManager_, mcpDriver_, wifiClient_, mqttClient_) {
     // Late wiring: optional callback dependency that cannot be injected in ctor
     // without circular include pressure.
@@ -61,6 +65,7 @@ void App::begin() {
 
 		// ---- I2C ----
 		Wire.begin(ESP_PINS::SDA_PIN, ESP_PINS::SCL_PIN);
+		Wire.setClock(cfg::mcp::I2C_CLOCK_HZ);
 
     // I2C-scanner if debug is enabled
     if (settings.debugI2CLevel >= 1) i2cScanner.scan();
@@ -68,7 +73,14 @@ void App::begin() {
 		// ---- Drivers setup ----
     mcpDriver_.begin();
 		mt8816Driver_.begin();
+    if (settings.toneSynthEnabled && toneSynth_.begin()) {
+      toneGenerator_.setSynth(&toneSynth_);
+    }
     toneGenerator_.begin();
+    // Same I2S format as the synth, so the two only take turns on D_OUTL
+    if (audioPlayer_.begin()) {
+      connectionHandler_.setAudioPlayer(&audioPlayer_, &toneGenerator_);
+    }
     Serial.println("----- Drivers initialized -----");
     
     //----- Service setup -----
@@ -94,21 +106,36 @@ void App::loop() {
 }
 
 void App::update() {
+  profiler_.startLoop();
   
   // ---- Interrupt handling ----
   interruptManager_.collectInterrupts();  // Collect all interrupts from MCP devices into InterruptManager queue
+  profiler_.mark("interrupts");
   
   // ---- Network and services updates ----
   wifiClient_.loop();       // Handle WiFi events and connection
   provisioning_.loop();     // Auto-close provisioning window after timeout
   webServer_.update();      // Handle web server events and client interactions
   mqttClient_.loop();       // Handle MQTT connection and messaging
+  profiler_.mark("network");
 
   // ---- Service updates (order can matter) ----
+  mt8816Driver_.update();   // Finish a pending MT8816 reset
   lineAction_.update();     // Check for line status changes and timers
+  lineManager_.update();    // Apply web status requests, log queued line status changes
+  profiler_.mark("lineAction");
   SHKService_.update();     // Check for SHK changes and process pulses
+  profiler_.mark("shk");
   toneReader_.update();     // Check for DTMF tones
+  profiler_.mark("toneReader");
   ringGenerator_.update();  // Update ring signal steps and timing
+  profiler_.mark("ringGenerator");
   toneGenerator_.update();  // Update tone generation steps and timing
+  profiler_.mark("toneGenerator");
+  audioPlayer_.updatePlayback();  // Refill the announcement ring, primed/finished callbacks
+  profiler_.mark("audioPlayer");
   functions_.update();      // Run any utility functions
+  profiler_.mark("functions");
+
+  profiler_.endLoop();
 }
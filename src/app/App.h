@@ -6,12 +6,16 @@
 #include "drivers/InterruptManager.h"
 #include "drivers/MT8816Driver.h"
 #include "drivers/AD9833Driver.h"
+#include "drivers/PCMDriver.h"
 
 #include "services/LineHandler.h"
 #include "services/LineManager.h"
 #include "services/SHKService.h"
 #include "services/LineAction.h"
+#include "services/SwitchFabric.h"
 #include "services/ToneGenerator.h"
+#include "services/ToneSynth.h"
+#include "services/AudioPlayer.h"
 #include "services/ToneReader.h"
 #include "services/RingGenerator.h"
 
@@ -27,6 +31,7 @@
 #include "util/Functions.h"
 #include "util/I2CScanner.h"
 #include "util/UIConsole.h"
+#include "util/LoopProfiler.h"
 
 class App {
 public:
@@ -44,12 +49,16 @@ private:
 
     // ===== Core drivers (owned by App) =====
     // Concrete instances: App creates and owns lifetime.
+    SwitchFabric switchFabric_;
     ConnectionHandler connectionHandler_;
     AD9833Driver ad9833Driver1_;
     AD9833Driver ad9833Driver2_;
     AD9833Driver ad9833Driver3_;
+    PCMDriver pcmDriver_;          // PCM5102 on D_OUTL, shared by the two below
+    ToneSynth toneSynth_;          // Fourth, software tone channel on D_OUTL
+    AudioPlayer audioPlayer_;      // Announcements on D_OUTL, via ConnectionHandler
 
-    // Service that orchestrates the three AD9833 drivers above.
+    // Service that orchestrates the three AD9833 drivers and the synth above.
     ToneGenerator toneGenerator_;
 
     // ===== Telephony services (owned by App, wired with references) =====
@@ -70,5 +79,6 @@ private:
     Functions functions_;
     I2CScanner i2cScanner{Wire, Serial};
     util::UIConsole uiConsole_;
+    util::LoopProfiler profiler_;   // Per-stage loop timing, logs stages over 1 ms
 
 };
@@ -6,7 +6,6 @@ bool AD9833Driver::spiStarted_ = false;
 
 AD9833Driver::AD9833Driver(uint8_t csPin, SPIClass& spi)
   : spi_(spi),
-    ad9833_(csPin),
     csPin_(csPin) {
 }
 
@@ -26,30 +25,65 @@ void AD9833Driver::begin() {
 #endif
     spiStarted_ = true;
   }
-
-  ad9833_.begin();
-  ad9833_.setMode(MD_AD9833::MODE_OFF);
   started_ = true;
+
+  // Hold in reset while clearing both frequency and phase registers, then leave it asleep
+  writeControl_(CTRL_RESET | CTRL_SLEEP1 | CTRL_SLEEP12);
+  loadFrequencyWord(0, 0);
+  loadFrequencyWord(1, 0);
+  write16_(REG_PHASE0);
+  write16_(REG_PHASE1);
+  selectedReg_ = 0;
+  writeControl_(CTRL_SLEEP1 | CTRL_SLEEP12);
 }
 
+// Kept for ad-hoc use: loads FREQ0 and plays it
 void AD9833Driver::setToneFrequency(float frequencyHz) {
   if (!started_) {
     begin();
   }
 
   if (frequencyHz <= 0.0f) {
-    ad9833_.setMode(MD_AD9833::MODE_OFF);
+    pause();
     return;
   }
 
-  ad9833_.setFrequency(MD_AD9833::CHAN_0, frequencyHz);
-  ad9833_.setMode(MD_AD9833::MODE_SINE);
+  loadFrequencyWord(0, cfg::ad9833::frequencyWord(frequencyHz));
+  select(0);
 }
 
 void AD9833Driver::stopOutput() {
   if (!started_) {
     begin();
   }
-  ad9833_.setMode(MD_AD9833::MODE_OFF);
+  writeControl_(CTRL_RESET | CTRL_SLEEP1 | CTRL_SLEEP12);
+}
+
+void AD9833Driver::loadFrequencyWord(uint8_t reg, uint32_t word) {
+  const uint16_t addr = reg ? REG_FREQ1 : REG_FREQ0;
+  // B28 mode: LSB 14 bits first, then MSB 14 bits
+  write16_(static_cast<uint16_t>(addr | (word & 0x3FFFu)));
+  write16_(static_cast<uint16_t>(addr | ((word >> 14) & 0x3FFFu)));
+}
+
+void AD9833Driver::select(uint8_t reg) {
+  selectedReg_ = reg ? 1 : 0;
+  writeControl_(0);
 }
 
+void AD9833Driver::pause() {
+  writeControl_(CTRL_SLEEP1 | CTRL_SLEEP12);
+}
+
+void AD9833Driver::writeControl_(uint16_t bits) {
+  write16_(static_cast<uint16_t>(CTRL_B28 | (selectedReg_ ? CTRL_FSELECT : 0) | bits));
+}
+
+void AD9833Driver::write16_(uint16_t word) {
+  spi_.beginTransaction(SPISettings(cfg::ad9833::SPI_HZ, MSBFIRST, SPI_MODE2));
+  digitalWrite(csPin_, LOW);
+  spi_.transfer16(word);
+  digitalWrite(csPin_, HIGH);
+  spi_.endTransaction();
+  spiWrites_++;
+}
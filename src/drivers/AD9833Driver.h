@@ -1,9 +1,12 @@
 #pragma once
 
 #include <Arduino.h>
-#include <MD_AD9833.h>
 #include <SPI.h>
 
+// AD9833 driven with raw 16-bit SPI words. Both frequency registers are used:
+// the sequencer preloads the next frequency into the idle register while the
+// other one plays, so a cadence step is a single control write (FSELECT or
+// SLEEP). FSELECT switches are phase-continuous in the AD9833.
 class AD9833Driver {
 public:
   explicit AD9833Driver(uint8_t csPin, SPIClass& spi = SPI);
@@ -12,14 +15,35 @@ public:
   void setToneFrequency(float frequencyHz);
   void stopOutput();
 
+  // Register-level API (frequency words from cfg::ad9833::frequencyWord)
+  void loadFrequencyWord(uint8_t reg, uint32_t word);   // reg 0/1, two SPI writes
+  void select(uint8_t reg);                             // Output sine from FREQ<reg>, one SPI write
+  void pause();                                         // DAC and MCLK off, one SPI write
+
+  uint8_t selectedReg() const { return selectedReg_; }
+  uint32_t spiWrites() const { return spiWrites_; }
   uint8_t csPin() const { return csPin_; }
 
 private:
+  // Control register bits
+  static constexpr uint16_t CTRL_B28     = 0x2000;
+  static constexpr uint16_t CTRL_FSELECT = 0x0800;
+  static constexpr uint16_t CTRL_RESET   = 0x0100;
+  static constexpr uint16_t CTRL_SLEEP1  = 0x0080;   // MCLK off (phase accumulator holds)
+  static constexpr uint16_t CTRL_SLEEP12 = 0x0040;   // DAC powered down
+  static constexpr uint16_t REG_FREQ0    = 0x4000;
+  static constexpr uint16_t REG_FREQ1    = 0x8000;
+  static constexpr uint16_t REG_PHASE0   = 0xC000;
+  static constexpr uint16_t REG_PHASE1   = 0xE000;
+
+  void write16_(uint16_t word);
+  void writeControl_(uint16_t bits);
+
   SPIClass& spi_;
-  MD_AD9833 ad9833_;
   uint8_t csPin_;
   bool started_ = false;
+  uint8_t selectedReg_ = 0;
+  uint32_t spiWrites_ = 0;
 
   static bool spiStarted_;
 };
-
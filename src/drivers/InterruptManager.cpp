@@ -35,69 +35,41 @@ void InterruptManager::collectInterrupts() {
     }
   }
 
-  // Collect all MCP_SLIC1 interrupts
-  while (true) {
-    IntResult r = mcpDriver_.handleSlic1Interrupt();
-    if (!r.hasEvent) break;
-    
-
-
-    if (eventQueue_.size() >= MAX_QUEUE_SIZE) {
-      if (settings_.debugIMLevel >= 1) {
-        Serial.println(F("InterruptManager: WARNING - Queue full, dropping MCP_SLIC1 event"));
-        util::UIConsole::log("WARNING - Queue full, dropping MCP_SLIC1 event", "InterruptManager");
+  // Collect all MCP_SLIC interrupts, bank by bank
+  for (uint8_t bank = 0; bank < cfg::lines::SLIC_BANK_COUNT; ++bank) {
+    while (true) {
+      IntResult r = mcpDriver_.handleSlicInterrupt(bank);
+      if (!r.hasEvent) break;
+
+      if (eventQueue_.size() >= MAX_QUEUE_SIZE) {
+        if (settings_.debugIMLevel >= 1) {
+          Serial.print(F("InterruptManager: WARNING - Queue full, dropping MCP_SLIC"));
+          Serial.print(bank + 1);
+          Serial.println(F(" event"));
+          util::UIConsole::log("WARNING - Queue full, dropping MCP_SLIC" + String(bank + 1) + " event", "InterruptManager");
+        }
+        break;
       }
-      break;
-    }
-    
-    eventQueue_.push(r);
-    
-    if (settings_.debugIMLevel >= 2) {
-      Serial.print(F("InterruptManager: Queued MCP_SLIC1 event - addr=0x"));
-      Serial.print(r.i2c_addr, HEX);
-      Serial.print(F(" pin="));
-      Serial.print(r.pin);
-      Serial.print(F(" line="));
-      Serial.print(r.line);
-      Serial.print(F(" level="));
-      Serial.println(r.level ? F("HIGH") : F("LOW"));
-      util::UIConsole::log("Queued MCP_SLIC1 0x" + String(r.i2c_addr, HEX) + 
-                          " pin=" + String(r.pin) + 
-                          " line=" + String(r.line) +
-                          " level=" + String(r.level ? "HIGH" : "LOW"),
-                          "InterruptManager");
-    }
-  }
-
-  // Collect all MCP_SLIC2 interrupts
-  while (true) {
-    IntResult r = mcpDriver_.handleSlic2Interrupt();
-    if (!r.hasEvent) break;
-    
-    if (eventQueue_.size() >= MAX_QUEUE_SIZE) {
-      if (settings_.debugIMLevel >= 1) {
-        Serial.println(F("InterruptManager: WARNING - Queue full, dropping MCP_SLIC2 event"));
-        util::UIConsole::log("WARNING - Queue full, dropping MCP_SLIC2 event", "InterruptManager");
+      
+      eventQueue_.push(r);
+      
+      if (settings_.debugIMLevel >= 2) {
+        Serial.print(F("InterruptManager: Queued MCP_SLIC"));
+        Serial.print(bank + 1);
+        Serial.print(F(" event - addr=0x"));
+        Serial.print(r.i2c_addr, HEX);
+        Serial.print(F(" pin="));
+        Serial.print(r.pin);
+        Serial.print(F(" line="));
+        Serial.print(r.line);
+        Serial.print(F(" level="));
+        Serial.println(r.level ? F("HIGH") : F("LOW"));
+        util::UIConsole::log("Queued MCP_SLIC" + String(bank + 1) + " 0x" + String(r.i2c_addr, HEX) + 
+                            " pin=" + String(r.pin) + 
+                            " line=" + String(r.line) +
+                            " level=" + String(r.level ? "HIGH" : "LOW"),
+                            "InterruptManager");
       }
-      break;
-    }
-    
-    eventQueue_.push(r);
-    
-    if (settings_.debugIMLevel >= 2) {
-      Serial.print(F("InterruptManager: Queued MCP_SLIC2 event - addr=0x"));
-      Serial.print(r.i2c_addr, HEX);
-      Serial.print(F(" pin="));
-      Serial.print(r.pin);
-      Serial.print(F(" line="));
-      Serial.print(r.line);
-      Serial.print(F(" level="));
-      Serial.println(r.level ? F("HIGH") : F("LOW"));
-      util::UIConsole::log("Queued MCP_SLIC2 0x" + String(r.i2c_addr, HEX) + 
-                          " pin=" + String(r.pin) + 
-                          " line=" + String(r.line) +
-                          " level=" + String(r.level ? "HIGH" : "LOW"),
-                          "InterruptManager");
     }
   }
 
@@ -18,12 +18,22 @@ static constexpr uint8_t REG_DEFVALB   = 0x07;
 static constexpr uint8_t REG_GPPUA     = 0x0C;
 static constexpr uint8_t REG_GPPUB     = 0x0D;
 static constexpr uint8_t REG_OLATA     = 0x14;
+static constexpr uint8_t REG_OLATB     = 0x15;
 
 // Split a PinModeEntry table into separate mode and initial-value arrays
 static void splitPinTable(const cfg::mcp::PinModeEntry (&tbl)[16], uint8_t (&modes)[16], bool (&initial)[16]) {
   for (int i = 0; i < 16; i++) { modes[i] = tbl[i].mode; initial[i] = tbl[i].initial; }
 }
 
+// Output latch value implied by the initial levels of the OUTPUT pins
+static uint16_t initialOlat(const cfg::mcp::PinModeEntry (&tbl)[16]) {
+  uint16_t olat = 0;
+  for (int i = 0; i < 16; i++) {
+    if (tbl[i].mode == OUTPUT && tbl[i].initial) olat |= static_cast<uint16_t>(1u << i);
+  }
+  return olat;
+}
+
 // Write an 8-bit value to a register over I2C
 bool MCPDriver::writeReg8_(uint8_t addr, uint8_t reg, uint8_t val) {
   Wire.beginTransmission(addr);
@@ -77,17 +87,19 @@ void MCPDriver::readRegPair16_(uint8_t addr, uint8_t regA, uint16_t& out16) {
 bool MCPDriver::begin() {
   Wire.setTimeOut(50);
   auto& settings = Settings::instance();
-  haveMain_ = haveSlic1_ = haveSlic2_ = haveMT8816_ = false;
+  haveMain_ = haveMT8816_ = false;
 
   // Probe each MCP device
-  haveSlic1_  = probeMcp_(mcpSlic1_,  cfg::mcp::MCP_SLIC1_ADDRESS);
-  haveSlic2_  = probeMcp_(mcpSlic2_,  cfg::mcp::MCP_SLIC2_ADDRESS);
+  bool anySlic = false;
+  for (uint8_t bank = 0; bank < lines::SLIC_BANK_COUNT; ++bank) {
+    haveSlic_[bank] = probeMcp_(mcpSlic_[bank], mcp::SLIC_BANK_ADDR[bank]);
+    settings.mcpSlicPresent[bank] = haveSlic_[bank];
+    anySlic = anySlic || haveSlic_[bank];
+  }
   haveMain_   = probeMcp_(mcpMain_,   cfg::mcp::MCP_MAIN_ADDRESS);
   haveMT8816_ = probeMcp_(mcpMT8816_, cfg::mcp::MCP_MT8816_ADDRESS);
 
   // Store presence info in settings
-  settings.mcpSlic1Present   = haveSlic1_;
-  settings.mcpSlic2Present   = haveSlic2_;
   settings.mcpMainPresent    = haveMain_;
   settings.mcpMt8816Present  = haveMT8816_;
 
@@ -97,7 +109,7 @@ bool MCPDriver::begin() {
   }
 
   // Abort if no MCP found
-  if (!(haveMain_ || haveSlic1_ || haveSlic2_ || haveMT8816_ )) {
+  if (!(haveMain_ || anySlic || haveMT8816_ )) {
     Serial.println(F("Ingen MCP hittades, avbryter."));
     return false;
   }
@@ -152,27 +164,16 @@ bool MCPDriver::begin() {
     if (settings.debugMCPLevel >= 3) dumpIntRegs("MAIN AFTER", cfg::mcp::MCP_MAIN_ADDRESS);
   }
   // ...existing code...
-  // Configure MCP_SLIC1 pins
-  if (haveSlic1_) {
-    // ...existing code...
-    uint8_t modes[16]; bool initial[16];
-    splitPinTable(mcp::MCP_SLIC, modes, initial);
-    if (!applyPinModes_(mcpSlic1_, modes, initial)) {
-      Serial.println(F("Fel vid konfiguration av SLIC1 pinlägen"));
-      return false;
-    }
-  }
-
-  // Configure MCP_SLIC2 pins
-  // ...existing code...
-  if (haveSlic2_) {
-    // ...existing code...
+  // Configure MCP_SLIC pins, one expander per bank
+  for (uint8_t bank = 0; bank < lines::SLIC_BANK_COUNT; ++bank) {
+    if (!haveSlic_[bank]) continue;
     uint8_t modes[16]; bool initial[16];
     splitPinTable(mcp::MCP_SLIC, modes, initial);
-    if (!applyPinModes_(mcpSlic2_, modes, initial)) {
-      Serial.println(F("Fel vid konfiguration av SLIC2 pinlägen"));
+    if (!applyPinModes_(mcpSlic_[bank], modes, initial)) {
+      Serial.printf("Fel vid konfiguration av SLIC%u pinlägen\n", bank + 1);
       return false;
     }
+    slicOlat_[bank] = initialOlat(mcp::MCP_SLIC);
   }
 
   // Configure MCP_MT8816 pins
@@ -193,22 +194,16 @@ bool MCPDriver::begin() {
   // Configure interrupts
   // ------------------------------------------------------------
 
-  if (haveSlic1_) {
+  for (uint8_t bank = 0; bank < lines::SLIC_BANK_COUNT; ++bank) {
+    if (!haveSlic_[bank]) continue;
+    const uint8_t addr = mcp::SLIC_BANK_ADDR[bank];
     // SLIC: active-low, open-drain, mirrored interrupts
-    programIOCON(cfg::mcp::MCP_SLIC1_ADDRESS, 0x44);
-    enableSlicShkInterrupts_(cfg::mcp::MCP_SLIC1_ADDRESS, mcpSlic1_);
+    programIOCON(addr, 0x44);
+    enableSlicShkInterrupts_(addr, mcpSlic_[bank]);
     // Clear any pending interrupt latches (important: reading INTCAP or GPIO clears INT)
     uint16_t dummy = 0;
-    (void)readRegPair16_OK_(cfg::mcp::MCP_SLIC1_ADDRESS, REG_INTCAPA, dummy);
-    (void)readRegPair16_OK_(cfg::mcp::MCP_SLIC1_ADDRESS, REG_GPIOA,   dummy);
-  }
-
-  if (haveSlic2_) {
-    programIOCON(cfg::mcp::MCP_SLIC2_ADDRESS, 0x44);
-    enableSlicShkInterrupts_(cfg::mcp::MCP_SLIC2_ADDRESS, mcpSlic2_);
-    uint16_t dummy = 0;
-    (void)readRegPair16_OK_(cfg::mcp::MCP_SLIC2_ADDRESS, REG_INTCAPA, dummy);
-    (void)readRegPair16_OK_(cfg::mcp::MCP_SLIC2_ADDRESS, REG_GPIOA,   dummy);
+    (void)readRegPair16_OK_(addr, REG_INTCAPA, dummy);
+    (void)readRegPair16_OK_(addr, REG_GPIOA,   dummy);
   }
   
   // ------------------------------------------------------------
@@ -220,16 +215,11 @@ bool MCPDriver::begin() {
                        &MCPDriver::isrMainThunk, this, FALLING);
   }
 
-  if (haveSlic1_) {
-    pinMode(mcp::MCP_SLIC_INT_1_PIN, INPUT_PULLUP);
-    attachInterruptArg(digitalPinToInterrupt(mcp::MCP_SLIC_INT_1_PIN),
-                       &MCPDriver::isrSlic1Thunk, this, FALLING);
-  }
-  
-  if (haveSlic2_) {
-    pinMode(mcp::MCP_SLIC_INT_2_PIN, INPUT_PULLUP);
-    attachInterruptArg(digitalPinToInterrupt(mcp::MCP_SLIC_INT_2_PIN),
-                       &MCPDriver::isrSlic2Thunk, this, FALLING);
+  for (uint8_t bank = 0; bank < lines::SLIC_BANK_COUNT; ++bank) {
+    if (!haveSlic_[bank]) continue;
+    pinMode(mcp::SLIC_BANK_INT_PIN[bank], INPUT_PULLUP);
+    attachInterruptArg(digitalPinToInterrupt(mcp::SLIC_BANK_INT_PIN[bank]),
+                       &MCPDriver::isrSlicThunk, &slicIrq_[bank], FALLING);
   }
 
   // ...existing code...
@@ -238,17 +228,17 @@ bool MCPDriver::begin() {
 
 // Write a digital value to a pin on the specified MCP device
 bool MCPDriver::digitalWriteMCP(uint8_t addr, uint8_t pin, bool value) {
-  if (addr==mcp::MCP_MAIN_ADDRESS   && !haveMain_)   return false;
-  if (addr==mcp::MCP_SLIC1_ADDRESS  && !haveSlic1_)  return false;
-  if (addr == mcp::MCP_SLIC2_ADDRESS && !haveSlic2_) return false;
-  if (addr==mcp::MCP_MT8816_ADDRESS && !haveMT8816_) return false;
-
-  Adafruit_MCP23X17* m = nullptr;
-  if (addr==mcp::MCP_MAIN_ADDRESS)        m=&mcpMain_;
-  else if (addr==mcp::MCP_SLIC1_ADDRESS)  m=&mcpSlic1_;
-  else if (addr == mcp::MCP_SLIC2_ADDRESS) m = &mcpSlic2_;
-  else if (addr==mcp::MCP_MT8816_ADDRESS) m=&mcpMT8816_;
-  else return false;
+  if (!chipPresent_(addr)) return false;
+
+  // SLIC outputs go through the OLAT shadow so it never goes stale
+  const int8_t bank = slicBankOf_(addr);
+  if (bank >= 0 && pin < 16) {
+    const uint16_t bit = static_cast<uint16_t>(1u << pin);
+    return writeSlicOutputs(static_cast<uint8_t>(bank), bit, value ? bit : 0);
+  }
+
+  Adafruit_MCP23X17* m = chipFor_(addr);
+  if (m == nullptr) return false;
 
   m->digitalWrite(pin, value);
   return true;
@@ -256,17 +246,10 @@ bool MCPDriver::digitalWriteMCP(uint8_t addr, uint8_t pin, bool value) {
 
 // Read a digital value from a pin on the specified MCP device
 bool MCPDriver::digitalReadMCP(uint8_t addr, uint8_t pin, bool& out) {
-  if (addr==mcp::MCP_MAIN_ADDRESS   && !haveMain_)   return false;
-  if (addr==mcp::MCP_SLIC1_ADDRESS  && !haveSlic1_)  return false;
-  if (addr==mcp::MCP_SLIC2_ADDRESS  && !haveSlic2_)  return false;
-  if (addr==mcp::MCP_MT8816_ADDRESS && !haveMT8816_) return false;
-
-  Adafruit_MCP23X17* m = nullptr;
-  if (addr==mcp::MCP_MAIN_ADDRESS)        m=&mcpMain_;
-  else if (addr==mcp::MCP_SLIC1_ADDRESS)  m=&mcpSlic1_;
-  else if (addr==mcp::MCP_SLIC2_ADDRESS)  m=&mcpSlic2_;
-  else if (addr==mcp::MCP_MT8816_ADDRESS) m=&mcpMT8816_;
-  else return false;
+  if (!chipPresent_(addr)) return false;
+
+  Adafruit_MCP23X17* m = chipFor_(addr);
+  if (m == nullptr) return false;
 
   out = m->digitalRead(pin);
   return true;
@@ -293,21 +276,89 @@ bool MCPDriver::writeMainTmuxAddress(uint8_t sel) {
   return writeReg8_(cfg::mcp::MCP_MAIN_ADDRESS, REG_OLATA, newA);
 }
 
+// Write OLATA and OLATB in one I2C transaction (sequential addressing, BANK=0).
+// Caller owns the full port state; no read-modify-write is done here.
+bool MCPDriver::writeOlatAB(uint8_t i2c_addr, uint8_t olatA, uint8_t olatB) {
+  Wire.beginTransmission(i2c_addr);
+  Wire.write(REG_OLATA);
+  Wire.write(olatA);
+  Wire.write(olatB);
+  return Wire.endTransmission() == 0;
+}
+
+// Write OLATA only (single I2C transaction)
+bool MCPDriver::writeOlatA(uint8_t i2c_addr, uint8_t olatA) {
+  return writeReg8_(i2c_addr, REG_OLATA, olatA);
+}
+
+// Update FR/RM bits of one SLIC bank from the shadow: one OLATA+OLATB write,
+// skipped when nothing changes.
+bool MCPDriver::writeSlicOutputs(uint8_t bank, uint16_t mask, uint16_t bits) {
+  if (bank >= cfg::lines::SLIC_BANK_COUNT) return false;
+  const uint16_t next = static_cast<uint16_t>((slicOlat_[bank] & ~mask) | (bits & mask));
+  if (next == slicOlat_[bank]) return true;
+
+  const uint8_t addr = cfg::mcp::SLIC_BANK_ADDR[bank];
+  if (!haveSlic_[bank]) return false;
+
+  if (!writeOlatAB(addr, static_cast<uint8_t>(next & 0xFF), static_cast<uint8_t>(next >> 8))) {
+    return false;
+  }
+  slicOlat_[bank] = next;
+  slicOlatWrites_++;
+  return true;
+}
+
+// Mask or unmask one line's SHK interrupt; only the affected GPINTEN byte is written
+bool MCPDriver::setShkInterruptEnabled(uint8_t line, bool enable) {
+  if (line >= cfg::mcp::SHK_LINE_COUNT) return false;
+  const uint8_t addr = cfg::mcp::SHK_LINE_ADDR[line];
+  const int8_t bank = slicBankOf_(addr);
+  if (bank < 0 || !haveSlic_[bank]) return false;
+
+  const uint8_t pin = cfg::mcp::SHK_PINS[line];
+  const uint16_t bit = static_cast<uint16_t>(1u << pin);
+  const uint16_t next = enable ? static_cast<uint16_t>(slicGpinten_[bank] | bit)
+                               : static_cast<uint16_t>(slicGpinten_[bank] & ~bit);
+  if (next == slicGpinten_[bank]) return true;
+
+  const bool ok = (pin < 8) ? writeReg8_(addr, REG_GPINTENA, static_cast<uint8_t>(next & 0xFF))
+                            : writeReg8_(addr, REG_GPINTENB, static_cast<uint8_t>(next >> 8));
+  if (ok) slicGpinten_[bank] = next;
+  return ok;
+}
+
+int8_t MCPDriver::slicBankOf_(uint8_t addr) const {
+  for (uint8_t b = 0; b < cfg::lines::SLIC_BANK_COUNT; b++) {
+    if (cfg::mcp::SLIC_BANK_ADDR[b] == addr) return static_cast<int8_t>(b);
+  }
+  return -1;
+}
+
+bool MCPDriver::chipPresent_(uint8_t addr) const {
+  if (addr == mcp::MCP_MAIN_ADDRESS)   return haveMain_;
+  if (addr == mcp::MCP_MT8816_ADDRESS) return haveMT8816_;
+  const int8_t bank = slicBankOf_(addr);
+  return bank >= 0 && haveSlic_[bank];
+}
+
+Adafruit_MCP23X17* MCPDriver::chipFor_(uint8_t addr) {
+  if (addr == mcp::MCP_MAIN_ADDRESS)   return &mcpMain_;
+  if (addr == mcp::MCP_MT8816_ADDRESS) return &mcpMT8816_;
+  const int8_t bank = slicBankOf_(addr);
+  return bank >= 0 ? &mcpSlic_[bank] : nullptr;
+}
+
 // Interrupt service routines for each MCP device (thunks set flags)
 void IRAM_ATTR MCPDriver::isrMainThunk(void* arg)   {
   auto* driver = reinterpret_cast<MCPDriver*>(arg);
   driver->mainIntFlag_ = true;
   driver->mainIntCounter_++;
 }
-void IRAM_ATTR MCPDriver::isrSlic1Thunk(void* arg)  {
-  auto* driver = reinterpret_cast<MCPDriver*>(arg);
-  driver->slic1IntFlag_ = true;
-  driver->slic1IntCounter_++;
-}
-void IRAM_ATTR MCPDriver::isrSlic2Thunk(void* arg)  {
-  auto* driver = reinterpret_cast<MCPDriver*>(arg);
-  driver->slic2IntFlag_ = true;
-  driver->slic2IntCounter_++;
+void IRAM_ATTR MCPDriver::isrSlicThunk(void* arg)  {
+  auto* irq = reinterpret_cast<SlicIrq*>(arg);
+  irq->flag = true;
+  irq->counter++;
 }
 void IRAM_ATTR MCPDriver::isrMT8816Thunk(void* arg) {
   auto* driver = reinterpret_cast<MCPDriver*>(arg);
@@ -320,17 +371,10 @@ IntResult MCPDriver::handleMainInterrupt()   {
   if (!haveMain_) return {};
   return handleInterrupt_(mainIntFlag_,   mcpMain_,   mcp::MCP_MAIN_ADDRESS);
 }
-// Handle interrupts for MCP_SLIC1
-IntResult MCPDriver::handleSlic1Interrupt()  {
-  if (!haveSlic1_) return {};
-  IntResult r = handleInterrupt_(slic1IntFlag_,  mcpSlic1_,  mcp::MCP_SLIC1_ADDRESS);
-  return r;
-}
-// Handle interrupts for MCP_SLIC2
-IntResult MCPDriver::handleSlic2Interrupt()  {
-  if (!haveSlic2_) return {};
-  IntResult r = handleInterrupt_(slic2IntFlag_,  mcpSlic2_,  mcp::MCP_SLIC2_ADDRESS);
-  return r;
+// Handle interrupts for the MCP of one SLIC bank
+IntResult MCPDriver::handleSlicInterrupt(uint8_t bank)  {
+  if (bank >= lines::SLIC_BANK_COUNT || !haveSlic_[bank]) return {};
+  return handleInterrupt_(slicIrq_[bank].flag, mcpSlic_[bank], mcp::SLIC_BANK_ADDR[bank]);
 }
 // Handle interrupts for MCP_MT8816
 IntResult MCPDriver::handleMT8816Interrupt() {
@@ -417,9 +461,12 @@ IntResult MCPDriver::handleInterrupt_(volatile bool& flag, Adafruit_MCP23X17& mc
     }
   }
 
-  // Extra clear after INTCAP (harmless but makes acknowledgment more robust)
-  uint16_t dummy = 0;
-  (void)readRegPair16_OK_(addr, REG_GPIOA, dummy);
+  // Extra clear after INTCAP (harmless but makes acknowledgment more robust).
+  // Both words go back to the caller, so e.g. the MT8870 nibble needs no new read.
+  uint16_t gpio = 0;
+  (void)readRegPair16_OK_(addr, REG_GPIOA, gpio);
+  r.intcap = intcap;
+  r.gpio   = gpio;
 
   if (!r.hasEvent) return r;
 
@@ -436,7 +483,7 @@ IntResult MCPDriver::handleInterrupt_(volatile bool& flag, Adafruit_MCP23X17& mc
   }
 
   // SLIC: map to line (do not return here)
-  if (addr == cfg::mcp::MCP_SLIC1_ADDRESS || addr == cfg::mcp::MCP_SLIC2_ADDRESS) {
+  if (slicBankOf_(addr) >= 0) {
     int8_t line = mapSlicPinToLine_(addr, r.pin);
     r.line = (line >= 0) ? static_cast<uint8_t>(line) : 255;
   }
@@ -553,6 +600,8 @@ void MCPDriver::enableSlicShkInterrupts_(uint8_t i2cAddr, Adafruit_MCP23X17& mcp
 
   (void)writeReg8_(i2cAddr, REG_GPINTENA, gpintena);
   (void)writeReg8_(i2cAddr, REG_GPINTENB, gpintenb);
+  const int8_t bank = slicBankOf_(i2cAddr);
+  if (bank >= 0) slicGpinten_[bank] = static_cast<uint16_t>(gpintena | (gpintenb << 8));
 
   // Clear any pending capture before runtime.
   (void)mcp.readGPIOAB();
@@ -664,10 +713,8 @@ void MCPDriver::enableMainInterrupts_(uint8_t i2cAddr, Adafruit_MCP23X17& mcp) {
 
 // Read 16-bit GPIO value (GPIOA low byte, GPIOB high byte)
 bool MCPDriver::readGpioAB16(uint8_t addr, uint16_t& out16) {
-  uint8_t a = readReg8_(addr, 0x12);
-  uint8_t b = readReg8_(addr, 0x13);
-  out16 = (uint16_t(b) << 8) | uint16_t(a);
-  return true;
+  // GPIOA+GPIOB in one transaction (sequential addressing, BANK=0)
+  return readRegPair16_OK_(addr, REG_GPIOA, out16);
 }
 
 // Probe an MCP device at the given I2C address; return true if present
@@ -13,6 +13,8 @@ struct IntResult {
   uint8_t pin      = 255;    // 0..15, 255 = ogiltig
   bool    level    = false;  // nivå enligt INTCAP/getLastInterruptValue()
   uint8_t i2c_addr = 0x00;   // vilken MCP
+  uint16_t intcap  = 0;      // hela INTCAP-ordet vid flanken (A = låg byte)
+  uint16_t gpio    = 0;      // GPIO lästa direkt efter INTCAP (kvitteringsläsningen)
 };
 
 class MCPDriver {
@@ -20,8 +22,7 @@ public:
   MCPDriver() = default;
 
   bool haveMain_;
-  bool haveSlic1_;
-  bool haveSlic2_;
+  bool haveSlic_[cfg::lines::SLIC_BANK_COUNT];   // Per SLIC bank (cfg::mcp::SLIC_BANK_ADDR)
   bool haveMT8816_;
 
   // Initiera alla MCP:er, lägg deras GPIO-lägen, INT-egenskaper och
@@ -33,17 +34,27 @@ public:
   bool digitalReadMCP (uint8_t i2c_addr, uint8_t pin, bool& out);
   bool readGpioAB16(uint8_t i2c_addr, uint16_t& out16);
   bool writeMainTmuxAddress(uint8_t sel);
+  bool writeOlatAB(uint8_t i2c_addr, uint8_t olatA, uint8_t olatB);
+  bool writeOlatA(uint8_t i2c_addr, uint8_t olatA);
+
+  // ===== SLIC-utgångar (FR/RM) via OLAT-skugga =====
+  // Ändrar bitarna i mask till bits och skriver OLATA+OLATB i en transaktion,
+  // utan read-modify-write. Ingen skrivning om porten redan har rätt värde.
+  bool writeSlicOutputs(uint8_t bank, uint16_t mask, uint16_t bits);
+  uint16_t slicOutputs(uint8_t bank) const { return bank < cfg::lines::SLIC_BANK_COUNT ? slicOlat_[bank] : 0; }
+  uint32_t slicOlatWrites() const { return slicOlatWrites_; }
+
+  // Slå av/på SHK-interrupt för en linje (GPINTEN-skugga, en registerskrivning)
+  bool setShkInterruptEnabled(uint8_t line, bool enable);
 
   // Snabbhjälp för kända kretsar
   inline Adafruit_MCP23X17& mainChip()   { return mcpMain_;   }
-  inline Adafruit_MCP23X17& slic1Chip()  { return mcpSlic1_;  }
-  inline Adafruit_MCP23X17& slic2Chip()  { return mcpSlic2_;  }
+  inline Adafruit_MCP23X17& slicChip(uint8_t bank) { return mcpSlic_[bank < cfg::lines::SLIC_BANK_COUNT ? bank : 0]; }
   inline Adafruit_MCP23X17& mt8816Chip() { return mcpMT8816_; }
 
   // ===== Loop-hanterare (pollas från loop()) =====
   IntResult handleMainInterrupt();
-  IntResult handleSlic1Interrupt();
-  IntResult handleSlic2Interrupt();
+  IntResult handleSlicInterrupt(uint8_t bank);
   IntResult handleMT8816Interrupt();
 
   bool mt8816Powered_ = false;
@@ -54,8 +65,7 @@ public:
 private:
   // ===== ISR-thunks (sätter endast flaggor) =====
   static void IRAM_ATTR isrMainThunk (void* arg);
-  static void IRAM_ATTR isrSlic1Thunk(void* arg);
-  static void IRAM_ATTR isrSlic2Thunk(void* arg);
+  static void IRAM_ATTR isrSlicThunk (void* arg);   // arg = &slicIrq_[bank]
   static void IRAM_ATTR isrMT8816Thunk(void* arg);
 
   // Gemensam interrupt-hantering
@@ -77,22 +87,33 @@ private:
   bool applyPinModes_(Adafruit_MCP23X17& mcp, const uint8_t (&modes)[16], const bool (&initial)[16]);
 
   Adafruit_MCP23X17 mcpMain_;
-  Adafruit_MCP23X17 mcpSlic1_;
-  Adafruit_MCP23X17 mcpSlic2_;
+  Adafruit_MCP23X17 mcpSlic_[cfg::lines::SLIC_BANK_COUNT];
   Adafruit_MCP23X17 mcpMT8816_;
 
   volatile bool mainIntFlag_   = false;
-  volatile bool slic1IntFlag_  = false;
-  volatile bool slic2IntFlag_  = false;
   volatile bool mt8816IntFlag_ = false;
 
   // Interrupt counters for debugging
   volatile uint32_t mainIntCounter_   = 0;
-  volatile uint32_t slic1IntCounter_  = 0;
-  volatile uint32_t slic2IntCounter_  = 0;
   volatile uint32_t mt8816IntCounter_ = 0;
 
+  // INT flag and counter per SLIC bank, set by isrSlicThunk
+  struct SlicIrq {
+    volatile bool     flag    = false;
+    volatile uint32_t counter = 0;
+  };
+  SlicIrq slicIrq_[cfg::lines::SLIC_BANK_COUNT];
+
   int8_t mapSlicPinToLine_(uint8_t addr, uint8_t pin) const;
+  int8_t slicBankOf_(uint8_t addr) const;
+  bool chipPresent_(uint8_t addr) const;
+  Adafruit_MCP23X17* chipFor_(uint8_t addr);
+
+  // Senast skrivna OLAT (A = låg byte) per SLIC-bank
+  uint16_t slicOlat_[cfg::lines::SLIC_BANK_COUNT] = {};
+  uint32_t slicOlatWrites_ = 0;
+  // GPINTEN (A = låg byte) per SLIC-bank
+  uint16_t slicGpinten_[cfg::lines::SLIC_BANK_COUNT] = {};
 
   // === [NYTT] Säkra I2C-hjälpare (deklarationer) ===
   bool writeReg8_(uint8_t addr, uint8_t reg, uint8_t val);
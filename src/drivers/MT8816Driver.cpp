@@ -2,6 +2,9 @@
 
 using namespace cfg;
 
+// GPA idle level between strobes: RESET, DATA, CS and STROBE low
+static constexpr uint8_t OLATA_IDLE = 0x00;
+
 MT8816Driver::MT8816Driver(MCPDriver& mcpDriver, Settings& settings) : mcpDriver_(mcpDriver), settings_(settings) {
 }
 
@@ -15,56 +18,137 @@ void MT8816Driver::begin(){
 }
 
 void MT8816Driver::setConnection(uint8_t x, uint8_t y, bool state) {
+  setConnection(0, x, y, state);
+}
+
+void MT8816Driver::setConnection(uint8_t chip, uint8_t x, uint8_t y, bool state) {
+  const Crosspoint op{chip, x, y, state};
+  apply(&op, 1);
+}
+
+uint16_t MT8816Driver::apply(const Crosspoint* ops, size_t count) {
+  if (resetPending_) {
+    finishReset_();
+  }
+  if (count > kMaxBatch) {
+    const uint16_t head = apply(ops, kMaxBatch);
+    return static_cast<uint16_t>(head + apply(ops + kMaxBatch, count - kMaxBatch));
+  }
+
+  uint16_t writes = 0;
+  bool done[kMaxBatch] = {false};
+
+  for (size_t i = 0; i < count; ++i) {
+    if (done[i]) continue;
+    const Crosspoint& op = ops[i];
+    if (op.chip >= mt8816::CHIP_COUNT || op.x >= mt8816::X_PORTS || op.y >= mt8816::Y_PORTS) {
+      done[i] = true;
+      if (settings_.debugMTLevel >= 1) {
+        Serial.println("MT8816: Invalid crosspoint chip=" + String(op.chip) + " x=" + String(op.x) + " y=" + String(op.y));
+        util::UIConsole::log("Invalid crosspoint chip=" + String(op.chip) + " x=" + String(op.x) + " y=" + String(op.y), "MT8816Driver");
+      }
+      continue;
+    }
 
-    mcpDriver_.digitalWriteMCP(mcp::MCP_MT8816_ADDRESS, mcp::STROBE, LOW);
-    mcpDriver_.digitalWriteMCP(mcp::MCP_MT8816_ADDRESS, mcp::CS, LOW);
-    setAddress(x, y);
-    delayMicroseconds(10);
-    mcpDriver_.digitalWriteMCP(mcp::MCP_MT8816_ADDRESS, mcp::DATA, state ? HIGH : LOW);
-    delayMicroseconds(5);
-    mcpDriver_.digitalWriteMCP(mcp::MCP_MT8816_ADDRESS, mcp::CS, HIGH);
-    delayMicroseconds(5);
-    mcpDriver_.digitalWriteMCP(mcp::MCP_MT8816_ADDRESS, mcp::STROBE, HIGH);
-    delayMicroseconds(10);
-    mcpDriver_.digitalWriteMCP(mcp::MCP_MT8816_ADDRESS, mcp::STROBE, LOW);
-    mcpDriver_.digitalWriteMCP(mcp::MCP_MT8816_ADDRESS, mcp::CS, LOW);
+    // Collect all chips on the same MCP that need the same crosspoint
+    const uint8_t mcpAddr = mt8816::CHIPS[op.chip].mcpAddr;
+    uint8_t csMask = 0;
+    uint8_t strobeMask = 0;
+    for (size_t j = i; j < count; ++j) {
+      const Crosspoint& other = ops[j];
+      if (done[j] || other.chip >= mt8816::CHIP_COUNT) continue;
+      if (mt8816::CHIPS[other.chip].mcpAddr != mcpAddr) continue;
+      if (other.x != op.x || other.y != op.y || other.state != op.state) continue;
+      csMask     |= static_cast<uint8_t>(1u << mt8816::CHIPS[other.chip].cs);
+      strobeMask |= static_cast<uint8_t>(1u << mt8816::CHIPS[other.chip].strobe);
+      done[j] = true;
+    }
+
+    if (strobeGroup_(mcpAddr, op.x, op.y, op.state, csMask, strobeMask)) {
+      writes += 4;
+    }
 
     if (settings_.debugMTLevel >= 2) {
-      Serial.print("MT8816: Set connection x=");
-      Serial.print(x);
+      Serial.print("MT8816: Set connection chip=");
+      Serial.print(op.chip);
+      Serial.print(" x=");
+      Serial.print(op.x);
       Serial.print(" y=");
-      Serial.print(y);
+      Serial.print(op.y);
       Serial.print(" state=");
-      Serial.println(state ? "HIGH" : "LOW");
-      util::UIConsole::log("Set connection x=" + String(x) + " y=" + String(y) + " state=" + String(state ? "HIGH" : "LOW"), "MT8816Driver");
+      Serial.println(op.state ? "HIGH" : "LOW");
+      util::UIConsole::log("Set connection chip=" + String(op.chip) + " x=" + String(op.x) + " y=" + String(op.y) +
+                           " state=" + String(op.state ? "HIGH" : "LOW"), "MT8816Driver");
     }
+  }
+
+  totalWrites_ += writes;
+  return writes;
 }
 
-void MT8816Driver::setAddress(uint8_t x, uint8_t y)
-{
+// One crosspoint write as four register writes instead of toggling single pins:
+//   1. OLATA+OLATB: DATA and CS set, address on AX/AY, STROBE low
+//   2. OLATA: STROBE high (MT8816 latches while CS and STROBE are high)
+//   3. OLATA: STROBE low, DATA and CS still held (data is taken on the falling edge)
+//   4. OLATA: back to idle
+// The setup/strobe/hold waits are the ones the pin-by-pin version used.
+bool MT8816Driver::strobeGroup_(uint8_t mcpAddr, uint8_t x, uint8_t y, bool state, uint8_t csMask, uint8_t strobeMask) {
+  const uint8_t address = static_cast<uint8_t>((x & 0x0F) | ((y & 0x07) << 4));   // GPB0-3 = AX, GPB4-6 = AY
+  const uint8_t selected = static_cast<uint8_t>(OLATA_IDLE | csMask | (state ? (1u << mcp::DATA) : 0));
 
-  for (int i = 0; i < 4; ++i) {
-    bool bit = (x >> i) & 0x01;
-    mcpDriver_.digitalWriteMCP(mcp::MCP_MT8816_ADDRESS, cfg::mt8816::ax_pins[i], bit);
+  bool ok = mcpDriver_.writeOlatAB(mcpAddr, selected, address);
+  delayMicroseconds(STROBE_SETUP_US);
+  ok = mcpDriver_.writeOlatA(mcpAddr, static_cast<uint8_t>(selected | strobeMask)) && ok;
+  delayMicroseconds(STROBE_WIDTH_US);
+  ok = mcpDriver_.writeOlatA(mcpAddr, selected) && ok;
+  delayMicroseconds(STROBE_HOLD_US);
+  ok = mcpDriver_.writeOlatA(mcpAddr, OLATA_IDLE) && ok;
+
+  if (!ok && settings_.debugMTLevel >= 1) {
+    Serial.printf("MT8816: I2C write failed on MCP 0x%02X\n", mcpAddr);
+    util::UIConsole::log("I2C write failed on MCP 0x" + String(mcpAddr, HEX), "MT8816Driver");
   }
+  return ok;
+}
 
-  for (int i = 0; i < 3; ++i) {
-    bool bit = (y >> i) & 0x01;
-    mcpDriver_.digitalWriteMCP(mcp::MCP_MT8816_ADDRESS, cfg::mt8816::ay_pins[i], bit);
+// Calls fn once per MCP that carries a chip (RESET is shared per MCP)
+template <typename Fn>
+void MT8816Driver::forEachResetMcp_(Fn fn) {
+  for (size_t chip = 0; chip < mt8816::CHIP_COUNT; ++chip) {
+    const uint8_t addr = mt8816::CHIPS[chip].mcpAddr;
+    bool seen = false;
+    for (size_t prev = 0; prev < chip; ++prev) {
+      if (mt8816::CHIPS[prev].mcpAddr == addr) { seen = true; break; }
+    }
+    if (!seen) fn(addr);
   }
 }
 
+// RESET is active high and clears every crosspoint. It is raised here and
+// dropped again by update() after RESET_HOLD_MS, so begin() does not stall the
+// boot. Any I2C write outlasts the MT8816 minimum reset pulse, so apply() may
+// end the hold early instead of waiting; the first strobe after that still
+// waits STROBE_SETUP_US with RESET low before STROBE rises. The only busy
+// waits left on this path are the strobe timings (~25 µs per strobe).
 void MT8816Driver::reset()
 {   
-  // Pulse the reset pin to reset the IC
-  mcpDriver_.digitalWriteMCP(mcp::MCP_MT8816_ADDRESS, mcp::RESET, LOW);
-  delayMicroseconds(10);
-  mcpDriver_.digitalWriteMCP(mcp::MCP_MT8816_ADDRESS, mcp::RESET, HIGH);
-  delay(100);  
-  mcpDriver_.digitalWriteMCP(mcp::MCP_MT8816_ADDRESS, mcp::RESET, LOW);
-
-  mcpDriver_.digitalWriteMCP(mcp::MCP_MT8816_ADDRESS, mcp::STROBE, LOW);
-  mcpDriver_.digitalWriteMCP(mcp::MCP_MT8816_ADDRESS, mcp::CS, LOW);
+  forEachResetMcp_([this](uint8_t addr) {
+    mcpDriver_.digitalWriteMCP(addr, mcp::RESET, LOW);
+    mcpDriver_.digitalWriteMCP(addr, mcp::RESET, HIGH);
+  });
+  resetPending_ = true;
+  resetStartMs_ = millis();
+}
+
+void MT8816Driver::update() {
+  if (resetPending_ && millis() - resetStartMs_ >= RESET_HOLD_MS) {
+    finishReset_();
+  }
+}
+
+void MT8816Driver::finishReset_() {
+  resetPending_ = false;
+  forEachResetMcp_([this](uint8_t addr) { mcpDriver_.writeOlatA(addr, OLATA_IDLE); });
 
   if (settings_.debugMTLevel >= 1) {
     Serial.println("MT8816: reset performed.");
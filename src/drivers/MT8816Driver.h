@@ -7,16 +7,48 @@
 
 class MT8816Driver {
   public:
+    // One crosspoint operation on a given chip in the fabric
+    struct Crosspoint {
+      uint8_t chip;
+      uint8_t x;
+      uint8_t y;
+      bool    state;
+    };
+
+    static constexpr size_t kMaxBatch = 16;
+
     MT8816Driver(MCPDriver& mcpDriver, Settings& settings);
     void begin();
+    void update();      // Ends the reset started by begin() once RESET_HOLD_MS has passed
+
+    // Chip 0 (single-chip setups)
     void setConnection(uint8_t x, uint8_t y, bool state);
-    
+    void setConnection(uint8_t chip, uint8_t x, uint8_t y, bool state);
+
+    // Program a batch of crosspoints. Operations with the same MCP/x/y/state
+    // on different chips share one strobe. Returns number of I2C writes used.
+    uint16_t apply(const Crosspoint* ops, size_t count);
+
+    uint32_t totalWrites() const { return totalWrites_; }
 
   private:
   
-    void setAddress(uint8_t x, uint8_t y);
+    static constexpr unsigned long RESET_HOLD_MS = 100;
+
+    // Crosspoint timing around STROBE (µs): address/DATA/CS setup, strobe
+    // width and DATA/CS hold after STROBE falls
+    static constexpr uint32_t STROBE_SETUP_US = 10;
+    static constexpr uint32_t STROBE_WIDTH_US = 10;
+    static constexpr uint32_t STROBE_HOLD_US  = 5;
+
     void reset();
+    void finishReset_();
+    template <typename Fn> void forEachResetMcp_(Fn fn);
+    bool strobeGroup_(uint8_t mcpAddr, uint8_t x, uint8_t y, bool state, uint8_t csMask, uint8_t strobeMask);
 
     MCPDriver& mcpDriver_;
     Settings& settings_;
-};
\ No newline at end of file
+    uint32_t totalWrites_ = 0;
+    bool resetPending_ = false;
+    unsigned long resetStartMs_ = 0;
+};
@@ -22,6 +22,9 @@ bool PCMDriver::setFormat(uint32_t sampleRateHz, uint8_t bitsPerSample, uint8_t
   }
 
   const uint8_t effectiveBits = force32BitSlots_ ? 32 : bitsPerSample;
+  if (running_ && sampleRateHz == sampleRateHz_ && effectiveBits == bitsPerSample_ && channels == channels_) {
+    return true;   // Cached format, nothing to do
+  }
 
   const esp_err_t res = i2s_set_clk(
     port_,
@@ -38,6 +41,8 @@ bool PCMDriver::setFormat(uint32_t sampleRateHz, uint8_t bitsPerSample, uint8_t
   sampleRateHz_ = sampleRateHz;
   bitsPerSample_ = effectiveBits;
   channels_ = channels;
+  running_ = true;   // i2s_set_clk restarts the peripheral
+  reclocks_++;
   return true;
 }
 
@@ -54,6 +59,8 @@ bool PCMDriver::setCommFormat(CommFormat format) {
   i2s_stop(port_);
   i2s_driver_uninstall(port_);
   started_ = false;
+  running_ = false;
+  reinstalls_++;
   return installDriver_(sampleRateHz_, bitsPerSample_, channels_);
 }
 
@@ -69,11 +76,30 @@ bool PCMDriver::write(const uint8_t* data, size_t lengthBytes, size_t* writtenBy
   return res == ESP_OK;
 }
 
+void PCMDriver::clear() {
+  if (!started_) return;
+  i2s_zero_dma_buffer(port_);
+}
+
 void PCMDriver::stop() {
   if (!started_) return;
 
   i2s_zero_dma_buffer(port_);
   i2s_stop(port_);
+  running_ = false;
+}
+
+size_t PCMDriver::preroll(const uint8_t* data, size_t lengthBytes) {
+  if (!running_ || data == nullptr || lengthBytes == 0) {
+    return 0;
+  }
+  size_t actual = 0;
+  i2s_write(port_, data, lengthBytes, &actual, 0);
+  return actual;
+}
+
+size_t PCMDriver::dmaCapacityBytes() const {
+  return static_cast<size_t>(kDmaBufCount) * kDmaBufLen * channels_ * (bitsPerSample_ / 8u);
 }
 
 bool PCMDriver::installDriver_(uint32_t sampleRateHz, uint8_t bitsPerSample, uint8_t channels) {
@@ -93,8 +119,8 @@ bool PCMDriver::installDriver_(uint32_t sampleRateHz, uint8_t bitsPerSample, uin
     ? I2S_COMM_FORMAT_STAND_MSB
     : I2S_COMM_FORMAT_STAND_I2S;
   cfg.intr_alloc_flags = ESP_INTR_FLAG_LEVEL1;
-  cfg.dma_buf_count = 8;
-  cfg.dma_buf_len = 256;
+  cfg.dma_buf_count = kDmaBufCount;
+  cfg.dma_buf_len = kDmaBufLen;
   cfg.use_apll = false;
   cfg.tx_desc_auto_clear = true;
   cfg.fixed_mclk = 0;
@@ -122,6 +148,7 @@ bool PCMDriver::installDriver_(uint32_t sampleRateHz, uint8_t bitsPerSample, uin
   bitsPerSample_ = effectiveBits;
   channels_ = channels;
   started_ = true;
+  running_ = true;
   i2s_zero_dma_buffer(port_);
   Serial.printf("PCMDriver: I2S initialized for PCM5102 (format=%s, slotBits=%u).\n",
                 (commFormat_ == CommFormat::StandMSB) ? "STAND_MSB" : "STAND_I2S",
@@ -17,13 +17,25 @@ public:
 
   PCMDriver(i2s_port_t port = I2S_NUM_0);
 
+  // The driver stays installed once begin() succeeds. setFormat() is a no-op
+  // for the cached format and only re-clocks otherwise; a reinstall happens
+  // only for a comm format change.
   bool begin(uint32_t sampleRateHz = 16000, uint8_t bitsPerSample = 16, uint8_t channels = 2);
   bool setFormat(uint32_t sampleRateHz, uint8_t bitsPerSample, uint8_t channels);
   bool setCommFormat(CommFormat format);
   void setSampleWordMode(SampleWordMode mode) { sampleWordMode_ = mode; }
   void setForce32BitSlots(bool enable) { force32BitSlots_ = enable; }
   bool write(const uint8_t* data, size_t lengthBytes, size_t* writtenBytes = nullptr, TickType_t timeout = portMAX_DELAY);
-  void stop();
+  void stop();     // Power down the peripheral; begin()/setFormat() restarts it
+  void clear();    // Zero the DMA buffers, I2S keeps running
+
+  // Pre-roll: queue frames without blocking, returns bytes accepted. Used to
+  // fill the DMA ring before the D_OUTL crosspoint is closed.
+  size_t preroll(const uint8_t* data, size_t lengthBytes);
+  size_t dmaCapacityBytes() const;
+
+  uint32_t reclocks() const { return reclocks_; }
+  uint32_t reinstalls() const { return reinstalls_; }
 
   bool isStarted() const { return started_; }
   uint32_t sampleRateHz() const { return sampleRateHz_; }
@@ -37,9 +49,15 @@ private:
   bool installDriver_(uint32_t sampleRateHz, uint8_t bitsPerSample, uint8_t channels);
   bool isSupportedFormat_(uint8_t bitsPerSample, uint8_t channels) const;
 
+  static constexpr int kDmaBufCount = 8;
+  static constexpr int kDmaBufLen = 256;     // Frames per DMA buffer
+
 private:
   i2s_port_t port_;
   bool started_ = false;
+  bool running_ = false;     // false after stop() until the next setFormat()
+  uint32_t reclocks_ = 0;
+  uint32_t reinstalls_ = 0;
   uint32_t sampleRateHz_ = 16000;
   uint8_t bitsPerSample_ = 16;
   uint8_t channels_ = 2;
@@ -0,0 +1,99 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+#include "config.h"
+
+namespace model {
+
+  namespace detail {
+    // Smallest unsigned word that can hold N line bits.
+    template <std::size_t N>
+    using LineSetWord =
+      typename std::conditional<(N <= 8),  uint8_t,
+      typename std::conditional<(N <= 16), uint16_t,
+      typename std::conditional<(N <= 32), uint32_t, uint64_t>::type>::type>::type;
+
+    inline unsigned ctz(uint64_t w)      { return static_cast<unsigned>(__builtin_ctzll(w)); }
+    inline unsigned popcount(uint64_t w) { return static_cast<unsigned>(__builtin_popcountll(w)); }
+  }
+
+  // Fixed-size bitset of line indices (N <= 64). Replaces the raw uint8_t line
+  // masks so the line count is a compile-time setting (cfg::lines::MAX_LINES).
+  // Iteration only visits set bits (count-trailing-zeros), so loops over e.g.
+  // "lines with a pending change" cost O(set bits) rather than O(N).
+  template <std::size_t N>
+  class LineSet {
+    static_assert(N > 0 && N <= 64, "LineSet supports 1..64 lines");
+
+  public:
+    using word_type = detail::LineSetWord<N>;
+    static constexpr std::size_t kSize = N;
+
+    // Iterates the indices of set bits in ascending order
+    class iterator {
+    public:
+      explicit iterator(uint64_t bits) : bits_(bits) {}
+      uint8_t operator*() const { return static_cast<uint8_t>(detail::ctz(bits_)); }
+      iterator& operator++() { bits_ &= bits_ - 1; return *this; }
+      bool operator!=(const iterator& o) const { return bits_ != o.bits_; }
+    private:
+      uint64_t bits_;
+    };
+
+    constexpr LineSet() = default;
+    constexpr explicit LineSet(word_type bits) : bits_(static_cast<word_type>(bits & kAllBits)) {}
+
+    static constexpr LineSet all() { return LineSet(kAllBits); }
+    static constexpr LineSet single(std::size_t i) {
+      return (i < N) ? LineSet(static_cast<word_type>(word_type(1) << i)) : LineSet();
+    }
+
+    constexpr bool test(std::size_t i) const { return i < N && ((bits_ >> i) & 1u) != 0; }
+    void set(std::size_t i)   { if (i < N) bits_ = static_cast<word_type>(bits_ |  (word_type(1) << i)); }
+    void reset(std::size_t i) { if (i < N) bits_ = static_cast<word_type>(bits_ & ~(word_type(1) << i)); }
+    void assign(std::size_t i, bool on) { if (on) set(i); else reset(i); }
+    void clear() { bits_ = 0; }
+
+    constexpr bool any()  const { return bits_ != 0; }
+    constexpr bool none() const { return bits_ == 0; }
+    unsigned count() const { return detail::popcount(bits_); }
+    constexpr word_type value() const { return bits_; }
+
+    // Lowest set index, or -1 if empty
+    int first() const { return bits_ ? static_cast<int>(detail::ctz(bits_)) : -1; }
+
+    // First set index strictly after 'from', wrapping around; -1 if empty.
+    // Pass from = -1 to start at index 0.
+    int nextAfter(int from) const {
+      if (!bits_) return -1;
+      const unsigned start = static_cast<unsigned>(from + 1);
+      if (start < N) {
+        const uint64_t upper = static_cast<uint64_t>(bits_) & (~uint64_t(0) << start);
+        if (upper) return static_cast<int>(detail::ctz(upper));
+      }
+      return first();
+    }
+
+    iterator begin() const { return iterator(bits_); }
+    iterator end()   const { return iterator(0); }
+
+    constexpr LineSet operator&(const LineSet& o) const { return LineSet(static_cast<word_type>(bits_ & o.bits_)); }
+    constexpr LineSet operator|(const LineSet& o) const { return LineSet(static_cast<word_type>(bits_ | o.bits_)); }
+    constexpr LineSet operator^(const LineSet& o) const { return LineSet(static_cast<word_type>(bits_ ^ o.bits_)); }
+    constexpr LineSet operator~() const { return LineSet(static_cast<word_type>(~bits_)); }
+    LineSet& operator&=(const LineSet& o) { bits_ &= o.bits_; return *this; }
+    LineSet& operator|=(const LineSet& o) { bits_ |= o.bits_; return *this; }
+    constexpr bool operator==(const LineSet& o) const { return bits_ == o.bits_; }
+    constexpr bool operator!=(const LineSet& o) const { return bits_ != o.bits_; }
+
+  private:
+    static constexpr word_type kAllBits =
+      (N == sizeof(word_type) * 8) ? static_cast<word_type>(~word_type(0))
+                                   : static_cast<word_type>((uint64_t(1) << N) - 1);
+    word_type bits_ = 0;
+  };
+
+  // Mask type used for all per-line bit flags in the exchange
+  using LineMask = LineSet<cfg::lines::MAX_LINES>;
+}
@@ -0,0 +1,209 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "model/Types.h"
+
+namespace model {
+
+  // The call state machine as data. LineAction maps a hook change or timer
+  // expiry to a LineEvent, looks up kTransitions[status][event] and applies
+  // it; entering a status runs the fixed action list in kEntryActions[status].
+  // Both tables are built at compile time, so a new status is a new row here
+  // and nothing changes in the dispatch code.
+
+  inline constexpr std::size_t kLineStatusCount = static_cast<std::size_t>(LineStatus::SystemConfig) + 1;
+
+  enum class LineEvent : uint8_t {
+    HookOff,        // On-hook -> off-hook
+    HookOn,         // Off-hook -> on-hook
+    HookOther,      // Any other hook change (e.g. to Disconnected)
+    TimerExpired,
+    Count
+  };
+  inline constexpr std::size_t kLineEventCount = static_cast<std::size_t>(LineEvent::Count);
+
+  // ---- Transitions ----
+
+  enum class TransitionKind : uint8_t {
+    Stay,           // Nothing happens
+    Set,            // Go to next (and update the peer first, if any)
+    RouteDialed     // Look up dialedDigits: Ringing + Incoming, Busy or Fail
+  };
+
+  // Which related line a transition also moves
+  enum class Peer : uint8_t { None, IncomingFrom, OutgoingTo };
+
+  struct Transition {
+    TransitionKind kind = TransitionKind::Stay;
+    LineStatus next = LineStatus::Idle;
+    Peer peer = Peer::None;
+    LineStatus peerNext = LineStatus::Idle;
+    bool link = false;        // Cross-link outgoingTo/incomingFrom once the peer has moved
+  };
+
+  using TransitionTable = std::array<std::array<Transition, kLineEventCount>, kLineStatusCount>;
+
+  namespace detail {
+    constexpr std::size_t row(LineStatus s) { return static_cast<std::size_t>(s); }
+    constexpr std::size_t col(LineEvent e) { return static_cast<std::size_t>(e); }
+
+    constexpr Transition to(LineStatus next) {
+      Transition t;
+      t.kind = TransitionKind::Set;
+      t.next = next;
+      return t;
+    }
+    constexpr Transition withPeer(LineStatus next, Peer peer, LineStatus peerNext, bool link = false) {
+      Transition t = to(next);
+      t.peer = peer;
+      t.peerNext = peerNext;
+      t.link = link;
+      return t;
+    }
+
+    constexpr TransitionTable makeTransitions() {
+      TransitionTable t{};
+      for (std::size_t s = 0; s < kLineStatusCount; ++s) {
+        // Lifting or replacing the handset in any other state ends up in Idle
+        t[s][col(LineEvent::HookOff)]   = to(LineStatus::Idle);
+        t[s][col(LineEvent::HookOn)]    = to(LineStatus::Idle);
+        t[s][col(LineEvent::HookOther)] = to(LineStatus::Idle);
+      }
+
+      t[row(LineStatus::Idle)][col(LineEvent::HookOff)] = to(LineStatus::Ready);
+      // Answer: the caller goes Connected first, then this line
+      t[row(LineStatus::Incoming)][col(LineEvent::HookOff)] =
+          withPeer(LineStatus::Connected, Peer::IncomingFrom, LineStatus::Connected, true);
+
+      t[row(LineStatus::Connected)][col(LineEvent::HookOn)] =
+          withPeer(LineStatus::Idle, Peer::IncomingFrom, LineStatus::Disconnected);
+      // Caller hangs up while the other phone is still ringing
+      t[row(LineStatus::Ringing)][col(LineEvent::HookOn)] =
+          withPeer(LineStatus::Idle, Peer::OutgoingTo, LineStatus::Idle);
+
+      constexpr std::size_t timer = col(LineEvent::TimerExpired);
+      t[row(LineStatus::Ready)][timer]        = to(LineStatus::Timeout);
+      t[row(LineStatus::ToneDialing)][timer].kind  = TransitionKind::RouteDialed;
+      t[row(LineStatus::PulseDialing)][timer].kind = TransitionKind::RouteDialed;
+      t[row(LineStatus::Ringing)][timer]      = to(LineStatus::Disconnected);
+      t[row(LineStatus::Incoming)][timer]     = to(LineStatus::Idle);
+      t[row(LineStatus::Busy)][timer]         = to(LineStatus::Timeout);
+      t[row(LineStatus::Fail)][timer]         = to(LineStatus::Timeout);
+      t[row(LineStatus::Disconnected)][timer] = to(LineStatus::Timeout);
+      t[row(LineStatus::Timeout)][timer]      = to(LineStatus::Abandoned);
+      return t;
+    }
+  }
+
+  inline constexpr TransitionTable kTransitions = detail::makeTransitions();
+
+  constexpr const Transition& transitionFor(LineStatus s, LineEvent e) {
+    return kTransitions[detail::row(s)][detail::col(e)];
+  }
+
+  // ---- Entry actions ----
+
+  // Applied in this order when a line enters a status
+  enum EntryFlag : uint8_t {
+    kReleaseTone     = 1u << 0,
+    kStopRing        = 1u << 1,
+    kDisconnectLines = 1u << 2,   // Drop the speech path to incomingFrom
+    kConnectLines    = 1u << 3,   // Speech path to incomingFrom
+    kNoteConnected   = 1u << 4,   // Answer latency bookkeeping in RingGenerator
+    kStartTone       = 1u << 5,
+    kSetTimer        = 1u << 6
+  };
+
+  // Settings timer a status arms on entry
+  enum class LineTimer : uint8_t { None, Ringing, Incoming, Busy, Fail, Disconnected, Timeout };
+
+  struct EntryAction {
+    uint8_t flags = 0;
+    ToneId tone = ToneId::Ready;
+    LineTimer timer = LineTimer::None;
+  };
+
+  using EntryTable = std::array<EntryAction, kLineStatusCount>;
+
+  namespace detail {
+    constexpr EntryAction entry(uint8_t flags, ToneId tone = ToneId::Ready, LineTimer timer = LineTimer::None) {
+      EntryAction a;
+      a.flags = static_cast<uint8_t>(flags | (timer != LineTimer::None ? kSetTimer : 0));
+      a.tone = tone;
+      a.timer = timer;
+      return a;
+    }
+
+    constexpr EntryTable makeEntryActions() {
+      EntryTable a{};
+      a[row(LineStatus::Idle)]         = entry(kReleaseTone | kStopRing);
+      a[row(LineStatus::Ready)]        = entry(kStartTone, ToneId::Ready);
+      a[row(LineStatus::PulseDialing)] = entry(kReleaseTone);
+      a[row(LineStatus::ToneDialing)]  = entry(kReleaseTone);
+      a[row(LineStatus::Ringing)]      = entry(kReleaseTone | kStartTone, ToneId::Ring, LineTimer::Ringing);
+      a[row(LineStatus::Incoming)]     = entry(0, ToneId::Ready, LineTimer::Incoming);
+      a[row(LineStatus::Connected)]    = entry(kReleaseTone | kStopRing | kConnectLines | kNoteConnected);
+      a[row(LineStatus::Busy)]         = entry(kReleaseTone | kStartTone, ToneId::Busy, LineTimer::Busy);
+      a[row(LineStatus::Fail)]         = entry(kReleaseTone | kStartTone, ToneId::Fail, LineTimer::Fail);
+      a[row(LineStatus::Disconnected)] = entry(kReleaseTone | kDisconnectLines, ToneId::Ready, LineTimer::Disconnected);
+      a[row(LineStatus::Timeout)]      = entry(kReleaseTone, ToneId::Ready, LineTimer::Timeout);
+      a[row(LineStatus::Abandoned)]    = entry(kReleaseTone, ToneId::Ready, LineTimer::Timeout);
+      // Operator and SystemConfig: no actions
+      return a;
+    }
+  }
+
+  inline constexpr EntryTable kEntryActions = detail::makeEntryActions();
+
+  constexpr const EntryAction& entryActionFor(LineStatus s) {
+    return kEntryActions[detail::row(s)];
+  }
+
+  // ---- Compile-time checks over every (status, event) pair ----
+
+  namespace detail {
+    constexpr bool everyHookOnEndsIdle() {
+      for (std::size_t s = 0; s < kLineStatusCount; ++s) {
+        const Transition& t = kTransitions[s][col(LineEvent::HookOn)];
+        if (t.kind != TransitionKind::Set || t.next != LineStatus::Idle) return false;
+      }
+      return true;
+    }
+
+    constexpr bool timerNeverOffersDialTone() {
+      for (std::size_t s = 0; s < kLineStatusCount; ++s) {
+        const Transition& t = kTransitions[s][col(LineEvent::TimerExpired)];
+        if (t.kind == TransitionKind::Set && (t.next == LineStatus::Ready || t.peer != Peer::None)) return false;
+      }
+      return true;
+    }
+
+    constexpr bool peersAreConsistent() {
+      for (std::size_t s = 0; s < kLineStatusCount; ++s) {
+        for (std::size_t e = 0; e < kLineEventCount; ++e) {
+          const Transition& t = kTransitions[s][e];
+          if (t.kind != TransitionKind::Set && (t.peer != Peer::None || t.link)) return false;
+          if (t.link && t.peer != Peer::IncomingFrom) return false;
+        }
+      }
+      return true;
+    }
+
+    constexpr bool entryActionsConsistent() {
+      for (std::size_t s = 0; s < kLineStatusCount; ++s) {
+        const EntryAction& a = kEntryActions[s];
+        if ((a.flags & kConnectLines) && (a.flags & kStartTone)) return false;
+        if ((a.flags & kSetTimer) && a.timer == LineTimer::None) return false;
+      }
+      return true;
+    }
+  }
+
+  static_assert(detail::everyHookOnEndsIdle(), "Putting the handset down must always lead to Idle");
+  static_assert(detail::timerNeverOffersDialTone(), "A timer must not move a line to Ready or move its peer");
+  static_assert(detail::peersAreConsistent(), "Peer updates belong to Set transitions; link only for answer");
+  static_assert(detail::entryActionsConsistent(), "Entry actions are inconsistent");
+  static_assert(transitionFor(LineStatus::Idle, LineEvent::HookOff).next == LineStatus::Ready, "Hook-off in Idle gives dial tone");
+  static_assert(transitionFor(LineStatus::Operator, LineEvent::TimerExpired).kind == TransitionKind::Stay, "Unlisted timers stay");
+}
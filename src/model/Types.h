@@ -21,6 +21,14 @@ namespace model {
     SystemConfig    // Line is in configuration mode
   };
 
+  // One line status transition, posted by LineManager::setStatus
+  struct LineStatusEvent {
+    uint32_t   atMs;
+    uint8_t    line;
+    LineStatus from;
+    LineStatus to;
+  };
+
   // Enum representing all possible statuses of the hook
   enum class HookStatus : uint8_t {
     On,            // Hook is off (off-hook)
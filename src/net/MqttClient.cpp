@@ -38,11 +38,9 @@ void MqttClient::begin() {
     util::UIConsole::log("No usable MQTT settings yet (disabled or host missing).", "MqttClient");
   }
 
-  if (!registeredCallbacks_) {
-    lineManager_.addStatusChangedCallback([this](int lineIndex, model::LineStatus) {
-      publishLineStatus(lineIndex);
-    });
-    registeredCallbacks_ = true;
+  if (!subscribed_) {
+    statusCursor_ = lineManager_.statusEvents.subscribe();
+    subscribed_ = true;
   }
 }
 
@@ -63,6 +61,7 @@ void MqttClient::loop() {
     reconfigureFromSettings();
     settings_.mqttConfigDirty = false;
   }
+  drainStatusEvents_();
 
   const bool wasConnectedBefore = wasConnected_;
   const bool nowConnected = mqtt_.connected();
@@ -128,11 +127,29 @@ void MqttClient::loop() {
   }
 }
 
+// Status changes queued by LineManager. While disconnected they are simply
+// consumed; publishFullSnapshot() on connect brings the broker up to date.
+void MqttClient::drainStatusEvents_() {
+  if (!subscribed_) return;
+  model::LineStatusEvent ev;
+  while (lineManager_.statusEvents.poll(statusCursor_, ev)) {
+    publishLineStatus(ev.line, ev.to);
+  }
+  if (statusCursor_.dropped > 0) {
+    statusCursor_.dropped = 0;
+    publishFullSnapshot();
+  }
+}
+
 void MqttClient::publishLineStatus(int lineIndex) {
+  if (lineIndex < 0 || lineIndex >= static_cast<int>(cfg::lines::MAX_LINES)) return;
+  publishLineStatus(lineIndex, lineManager_.getLine(lineIndex).currentLineStatus);
+}
+
+void MqttClient::publishLineStatus(int lineIndex, model::LineStatus status) {
   if (!mqtt_.connected()) return;
-  if (lineIndex < 0 || lineIndex > 7) return;
+  if (lineIndex < 0 || lineIndex >= static_cast<int>(cfg::lines::MAX_LINES)) return;
   const auto& line = lineManager_.getLine(lineIndex);
-  const auto status = line.currentLineStatus;
   String lineName = line.lineName;
   lineName.trim();
 
@@ -156,7 +173,7 @@ void MqttClient::publishFullSnapshot() {
   mqtt_.publish(linesTopic.c_str(), linesJson.c_str(), settings_.mqttRetain);
 
   const String activeTopic = makeTopic_("active");
-  String activeJson = "{\"mask\":" + String(settings_.activeLinesMask) + "}";
+  String activeJson = "{\"mask\":" + String(static_cast<unsigned long long>(settings_.activeLinesMask.value())) + "}";
   mqtt_.publish(activeTopic.c_str(), activeJson.c_str(), settings_.mqttRetain);
 }
 
@@ -6,8 +6,7 @@
 #include "settings/settings.h"
 #include "net/WifiClient.h"
 #include "model/Types.h"
-
-class LineManager;
+#include "services/LineManager.h"
 
 namespace net {
 
@@ -21,6 +20,7 @@ public:
   bool isConnected() { return mqtt_.connected(); }
 
   void publishLineStatus(int lineIndex);
+  void publishLineStatus(int lineIndex, model::LineStatus status);
   void publishFullSnapshot();
 
 private:
@@ -40,7 +40,8 @@ private:
 
   unsigned long reconnectDelayMs_ = 0;
   unsigned long lastConnectAttemptMs_ = 0;
-  bool registeredCallbacks_ = false;
+  bool subscribed_ = false;
+  LineManager::StatusEventBus::Cursor statusCursor_;
   int lastBlockedReason_ = -1;
   bool wasConnected_ = false;
   uint8_t failedConnectAttempts_ = 0;
@@ -51,6 +52,7 @@ private:
   static constexpr uint8_t kQuickRetryAttempts = 3;
 
   void loadConfig_();
+  void drainStatusEvents_();
   bool shouldRun_() const;
   int blockedReason_() const;
   bool connect_();
@@ -17,8 +17,10 @@ String escapeJson(const String& in) {
 }
 } // namespace
 
-WebServer::WebServer(Settings& settings, LineManager& lineManager, net::WifiClient& wifi, RingGenerator& ringGenerator, LineAction& lineAction, uint16_t port)
-: settings_ (settings), lineManager_(lineManager), ringGenerator_(ringGenerator), lineAction_(lineAction), wifi_(wifi), server_(port) {}
+WebServer::WebServer(Settings& settings, LineManager& lineManager, net::WifiClient& wifi, RingGenerator& ringGenerator, LineAction& lineAction,
+                     ToneGenerator& toneGenerator, uint16_t port)
+: settings_ (settings), lineManager_(lineManager), ringGenerator_(ringGenerator), lineAction_(lineAction),
+  toneGenerator_(toneGenerator), server_(port), wifi_(wifi) {}
 
 bool WebServer::begin() {
 
@@ -49,6 +51,8 @@ bool WebServer::begin() {
 
 void WebServer::update() {
   if (serverStarted_) {
+    sendStatusEvents_();
+    applyPendingTonePlan_();
     return;
   }
 
@@ -123,14 +127,25 @@ void WebServer::setupCallbacks_() {
 }
 
 void WebServer::setupLineManagerCallback_() {
-  lineManager_.addStatusChangedCallback([this](int index, LineStatus status){
+  statusCursor_ = lineManager_.statusEvents.subscribe();
+}
+
+// Line status changes are queued by LineManager and sent from update()
+void WebServer::sendStatusEvents_() {
+  model::LineStatusEvent ev;
+  while (lineManager_.statusEvents.poll(statusCursor_, ev)) {
     // Only send SSE if there are connected clients
     if (events_.count() > 0) {
-      String json = "{\"line\":" + String(index) +
-                    ",\"status\":\"" + model::LineStatusToString(status) + "\"}";
-      events_.send(json.c_str(), "lineStatus", millis());
+      String json = "{\"line\":" + String(ev.line) +
+                    ",\"status\":\"" + model::LineStatusToString(ev.to) + "\"}";
+      events_.send(json.c_str(), "lineStatus", ev.atMs);
     }
-  });
+  }
+  // Events lost in between: let the clients resync from a full snapshot
+  if (statusCursor_.dropped > 0) {
+    statusCursor_.dropped = 0;
+    if (events_.count() > 0) sendFullStatusSse();
+  }
 }
 
 
@@ -159,7 +174,7 @@ void WebServer::setupApiRoutes_() {
       line = req->getParam("line", /*post=*/true)->value().toInt();
     }
 
-    if (line < 0 || line > 7) {
+    if (line < 0 || line >= static_cast<int>(cfg::lines::MAX_LINES)) {
       req->send(400, "application/json", "{\"error\":\"missing/invalid line\"}");
       return;
     }
@@ -185,7 +200,7 @@ void WebServer::setupApiRoutes_() {
       active = req->getParam("active", true)->value().toInt();
     }
 
-    if (line < 0 || line > 7 || (active != 0 && active != 1)) {
+    if (line < 0 || line >= static_cast<int>(cfg::lines::MAX_LINES) || (active != 0 && active != 1)) {
       req->send(400, "application/json", "{\"error\":\"missing/invalid line/active\"}");
       return;
     }
@@ -217,7 +232,7 @@ void WebServer::setupApiRoutes_() {
     }
 
     int line = lineParam->value().toInt();
-    if (line < 0 || line > 7) {
+    if (line < 0 || line >= static_cast<int>(cfg::lines::MAX_LINES)) {
       req->send(400, "application/json", "{\"error\":\"invalid line\"}");
       return;
     }
@@ -244,7 +259,7 @@ void WebServer::setupApiRoutes_() {
     }
 
     if (value.length() > 0) {
-      for (int i = 0; i < 8; ++i) {
+      for (int i = 0; i < static_cast<int>(cfg::lines::MAX_LINES); ++i) {
         if (i == line) continue;
         String existing = settings_.linePhoneNumbers[i];
         existing.trim();
@@ -291,7 +306,7 @@ void WebServer::setupApiRoutes_() {
     }
 
     int line = lineParam->value().toInt();
-    if (line < 0 || line > 7) {
+    if (line < 0 || line >= static_cast<int>(cfg::lines::MAX_LINES)) {
       req->send(400, "application/json", "{\"error\":\"invalid line\"}");
       return;
     }
@@ -394,12 +409,15 @@ void WebServer::setupApiRoutes_() {
   server_.on("/api/tone-generator", HTTP_GET, [this](AsyncWebServerRequest *req){
     req->send(200, "application/json", buildToneGeneratorJson_());
   });
-  // Set tone generator: POST /api/tone-generator/set  (body: enabled=1)
+  // Set tone generator: POST /api/tone-generator/set  (body: enabled=1, optional prearm=0/1)
   server_.on("/api/tone-generator/set", HTTP_POST, [this](AsyncWebServerRequest* req){
     int enabled = -1;
+    int prearm = -1;
 
     if (req->hasParam("enabled")) enabled = req->getParam("enabled")->value().toInt();
     else if (req->hasParam("enabled", true)) enabled = req->getParam("enabled", true)->value().toInt();
+    if (req->hasParam("prearm")) prearm = req->getParam("prearm")->value().toInt();
+    else if (req->hasParam("prearm", true)) prearm = req->getParam("prearm", true)->value().toInt();
 
     if (enabled != 0 && enabled != 1) {
       req->send(400, "application/json", "{\"error\":\"enabled must be 0 or 1\"}");
@@ -407,11 +425,36 @@ void WebServer::setupApiRoutes_() {
     }
 
     settings_.toneGeneratorEnabled = (enabled == 1);
+    if (prearm == 0 || prearm == 1) settings_.toneReadyPrearmed = (prearm == 1);
     settings_.save();
 
     sendToneGeneratorSse();
     req->send(200, "application/json", buildToneGeneratorJson_());
   });
+  // Tone plan: POST /api/tone-generator/plan  (body: plan=<name>, file /tones/<name>.txt)
+  server_.on("/api/tone-generator/plan", HTTP_POST, [this](AsyncWebServerRequest* req){
+    String plan;
+    if (req->hasParam("plan")) plan = req->getParam("plan")->value();
+    else if (req->hasParam("plan", true)) plan = req->getParam("plan", true)->value();
+    plan.trim();
+
+    if (!isValidTonePlanName_(plan)) {
+      req->send(400, "application/json", "{\"error\":\"plan must be 1-24 characters a-z, 0-9, - or _\"}");
+      return;
+    }
+    if (!fsMounted_ || !LittleFS.exists("/tones/" + plan + ".txt")) {
+      req->send(404, "application/json", "{\"error\":\"/tones/" + plan + ".txt not found\"}");
+      return;
+    }
+
+    // ToneGenerator belongs to the loop: hand the name over, update() loads it
+    portENTER_CRITICAL(&tonePlanMux_);
+    memcpy(pendingTonePlan_, plan.c_str(), plan.length() + 1);
+    tonePlanPending_ = true;
+    portEXIT_CRITICAL(&tonePlanMux_);
+
+    req->send(202, "application/json", buildToneGeneratorJson_());
+  });
   // Enhetsinfo: GET /api/info
   server_.on("/api/info", HTTP_GET, [this](AsyncWebServerRequest* req){
     String hn = wifi_.getHostname();
@@ -467,7 +510,7 @@ void WebServer::setupApiRoutes_() {
       line = req->getParam("line", true)->value().toInt();
     }
 
-    if (line < 0 || line > 7) {
+    if (line < 0 || line >= static_cast<int>(cfg::lines::MAX_LINES)) {
       req->send(400, "application/json", "{\"error\":\"invalid line\"}");
       return;
     }
@@ -477,7 +520,7 @@ void WebServer::setupApiRoutes_() {
       return;
     }
 
-    lineManager_.setStatus(line, LineStatus::Incoming);
+    lineManager_.requestStatus(line, LineStatus::Incoming);   // Applied on the loop
     req->send(200, "application/json", "{\"ok\":true}");
 
     if (settings_.debugWSLevel >= 1) {
@@ -495,7 +538,7 @@ void WebServer::setupApiRoutes_() {
       line = req->getParam("line", true)->value().toInt();
     }
 
-    if (line < 0 || line > 7) {
+    if (line < 0 || line >= static_cast<int>(cfg::lines::MAX_LINES)) {
       req->send(400, "application/json", "{\"error\":\"invalid line\"}");
       return;
     }
@@ -505,7 +548,7 @@ void WebServer::setupApiRoutes_() {
       return;
     }
 
-    lineManager_.setStatus(line, LineStatus::Idle);
+    lineManager_.requestStatus(line, LineStatus::Idle);
     req->send(200, "application/json", "{\"ok\":true}");
 
     if (settings_.debugWSLevel >= 1) {
@@ -518,7 +561,8 @@ void WebServer::setupApiRoutes_() {
     String json = "{";
     json += "\"ringLengthMs\":" + String(settings_.ringLengthMs) + ",";
     json += "\"ringPauseMs\":" + String(settings_.ringPauseMs) + ",";
-    json += "\"ringIterations\":" + String(settings_.ringIterations);
+    json += "\"ringIterations\":" + String(settings_.ringIterations) + ",";
+    json += "\"maxConcurrentRingers\":" + String(settings_.maxConcurrentRingers);
     json += "}";
     req->send(200, "application/json", json);
   });
@@ -533,6 +577,7 @@ void WebServer::setupApiRoutes_() {
     int ringLength = getParam("ringLengthMs");
     int ringPause = getParam("ringPauseMs");
     int ringIter = getParam("ringIterations");
+    int maxRingers = getParam("maxConcurrentRingers");
 
     bool updated = false;
     if (ringLength >= 100 && ringLength <= 10000) {
@@ -547,6 +592,10 @@ void WebServer::setupApiRoutes_() {
       settings_.ringIterations = ringIter;
       updated = true;
     }
+    if (maxRingers >= 0 && maxRingers <= static_cast<int>(cfg::lines::MAX_LINES)) {
+      settings_.maxConcurrentRingers = static_cast<uint8_t>(maxRingers);
+      updated = true;
+    }
 
     if (updated) {
       settings_.save();
@@ -836,11 +885,10 @@ void WebServer::setupApiRoutes_() {
 }
 
 void WebServer::setLineActiveBit_(int line, bool makeActive) {
-  if (line < 0 || line > 7) return;
+  if (line < 0 || line >= static_cast<int>(cfg::lines::MAX_LINES)) return;
 
-  uint8_t before = settings_.activeLinesMask;
-  if (makeActive) settings_.activeLinesMask |=  (1u << line);
-  else            settings_.activeLinesMask &= ~(1u << line);
+  const unsigned long long before = settings_.activeLinesMask.value();
+  settings_.activeLinesMask.assign(line, makeActive);
 
   // Respektera tillåtna linjer (SLIC1/SLIC2 närvaro)
   settings_.adjustActiveLines();
@@ -855,14 +903,15 @@ void WebServer::setLineActiveBit_(int line, bool makeActive) {
   sendActiveMaskSse();
 
   if (settings_.debugWSLevel >= 1) {
-    Serial.printf("WebServer: ActiveMask: 0x%02X -> 0x%02X\n", before, settings_.activeLinesMask);
-    util::UIConsole::log("ActiveMask: 0x" + String(before, HEX) + " -> 0x" + String(settings_.activeLinesMask, HEX), "WebServer");
+    const unsigned long long after = settings_.activeLinesMask.value();
+    Serial.printf("WebServer: ActiveMask: 0x%02llX -> 0x%02llX\n", before, after);
+    util::UIConsole::log("ActiveMask: 0x" + String(before, HEX) + " -> 0x" + String(after, HEX), "WebServer");
   }
 }
 
 void WebServer::toggleLineActiveBit_(int line) {
-  if (line < 0 || line > 7) return;
-  bool wasActive = (settings_.activeLinesMask >> line) & 0x01;
+  if (line < 0 || line >= static_cast<int>(cfg::lines::MAX_LINES)) return;
+  bool wasActive = settings_.activeLinesMask.test(line);
   setLineActiveBit_(line, !wasActive);
 
   if (settings_.debugWSLevel >= 1) {
@@ -896,15 +945,13 @@ String WebServer::buildStatusJson_() const {
   return net::buildLinesStatusJson(lineManager_);
 }
 
-String WebServer::buildActiveJson_(uint8_t mask) {
-  String json = "{\"mask\":" + String(mask) + ",\"active\":[";
+String WebServer::buildActiveJson_(const model::LineMask& mask) {
+  String json = "{\"mask\":" + String(static_cast<unsigned long long>(mask.value())) + ",\"active\":[";
   bool first = true;
-  for (int i = 0; i < 8; ++i) {
-    if (mask & (1u << i)) {
-      if (!first) json += ",";
-      json += String(i);
-      first = false;
-    }
+  for (uint8_t i : mask) {
+    if (!first) json += ",";
+    json += String(i);
+    first = false;
   }
   json += "]}";
   return json;
@@ -944,10 +991,53 @@ String WebServer::buildToneGeneratorJson_() const {
   String json = "{";
   json += "\"enabled\":";
   json += settings_.toneGeneratorEnabled ? "true" : "false";
+  json += ",\"prearmed\":";
+  json += settings_.toneReadyPrearmed ? "true" : "false";
+  json += ",\"tonePlan\":\"" + escapeJson(settings_.tonePlan) + "\"";
+  json += ",\"tonePlanLoaded\":";
+  json += toneGenerator_.hasTonePlan() ? "true" : "false";
+  json += ",\"tonePlanPending\":";
+  json += tonePlanPending_ ? "true" : "false";
   json += "}";
   return json;
 }
 
+// Plan names become a LittleFS path, so no separators or dots
+bool WebServer::isValidTonePlanName_(const String& name) {
+  if (name.length() == 0 || name.length() > kTonePlanNameMax) return false;
+  for (unsigned i = 0; i < name.length(); ++i) {
+    const char c = name[i];
+    const bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_';
+    if (!ok) return false;
+  }
+  return true;
+}
+
+// Runs on the loop. Waits while calls use the tone tables; a plan that does
+// not compile is rejected and the saved plan is loaded again.
+void WebServer::applyPendingTonePlan_() {
+  if (!tonePlanPending_ || !toneGenerator_.canLoadTonePlan()) return;
+
+  char name[kTonePlanNameMax + 1];
+  portENTER_CRITICAL(&tonePlanMux_);
+  memcpy(name, pendingTonePlan_, sizeof(name));
+  tonePlanPending_ = false;
+  portEXIT_CRITICAL(&tonePlanMux_);
+
+  if (toneGenerator_.loadTonePlan(name)) {
+    settings_.tonePlan = name;
+    settings_.save();
+    util::UIConsole::log("Tone plan " + String(name) + " loaded and saved", "WebServer");
+  } else {
+    toneGenerator_.loadTonePlan(settings_.tonePlan);
+    util::UIConsole::log("Tone plan " + String(name) + " rejected, keeping " + settings_.tonePlan, "WebServer");
+  }
+  if (settings_.debugWSLevel >= 1) {
+    Serial.println("WebServer: Tone plan request " + String(name) + " handled, active plan " + settings_.tonePlan);
+  }
+  sendToneGeneratorSse();
+}
+
 String WebServer::buildMqttJson_() const {
   String json = "{";
   json += "\"enabled\":"; json += settings_.mqttEnabled ? "true" : "false";
@@ -14,7 +14,8 @@ class RingGenerator;
 
 class WebServer {
 public:
-  WebServer(Settings& settings, LineManager& lineManager, net::WifiClient& wifi, RingGenerator& ringGenerator, LineAction& lineAction, uint16_t port = 80);
+  WebServer(Settings& settings, LineManager& lineManager, net::WifiClient& wifi, RingGenerator& ringGenerator, LineAction& lineAction,
+            ToneGenerator& toneGenerator, uint16_t port = 80);
   bool begin();
   void update();
   void listFS();
@@ -32,6 +33,7 @@ private:
   LineManager& lineManager_;
   RingGenerator& ringGenerator_;
   LineAction& lineAction_;
+  ToneGenerator& toneGenerator_;
   AsyncWebServer server_;
   AsyncEventSource events_{"/events"};
   
@@ -40,13 +42,23 @@ private:
 
   bool serverStarted_ = false;
   bool fsMounted_ = false;
+  LineManager::StatusEventBus::Cursor statusCursor_;
 
   TaskHandle_t pingTask_ = nullptr;
+
+  // Tone plan chosen over HTTP (AsyncTCP task), loaded from update() on the loop
+  static constexpr size_t kTonePlanNameMax = 24;
+  portMUX_TYPE tonePlanMux_ = portMUX_INITIALIZER_UNLOCKED;
+  char pendingTonePlan_[kTonePlanNameMax + 1] = {};
+  bool tonePlanPending_ = false;
+  static bool isValidTonePlanName_(const String& name);
+  void applyPendingTonePlan_();
   
   void setupFilesystem_();
   void initSse_();
   void setupCallbacks_();
   void setupLineManagerCallback_();
+  void sendStatusEvents_();
   void setupApiRoutes_();
   void setLineActiveBit_(int line, bool makeActive);
   void restartDevice_();
@@ -58,7 +70,7 @@ private:
 
   // Help functions
   String buildStatusJson_() const;
-  String buildActiveJson_(uint8_t mask);
+  String buildActiveJson_(const model::LineMask& mask);
   String buildDebugJson_() const;
   String buildToneGeneratorJson_() const;
   String buildMqttJson_() const;
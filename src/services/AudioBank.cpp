@@ -0,0 +1,75 @@
+#include "services/AudioBank.h"
+#include "util/UIConsole.h"
+#include <string.h>
+
+namespace {
+  constexpr esp_partition_subtype_t kAudioBankSubtype = static_cast<esp_partition_subtype_t>(0x40);
+}
+
+bool AudioBank::begin() {
+  if (isMounted()) return true;
+
+  const esp_partition_t* part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, kAudioBankSubtype, "audiobank");
+  if (part == nullptr) {
+    Serial.println("AudioBank: No audiobank partition, using LittleFS for audio");
+    util::UIConsole::log("No audiobank partition, using LittleFS for audio", "AudioBank");
+    return false;
+  }
+
+  const void* mapped = nullptr;
+  if (esp_partition_mmap(part, 0, part->size, SPI_FLASH_MMAP_DATA, &mapped, &mapHandle_) != ESP_OK) {
+    Serial.println("AudioBank: esp_partition_mmap failed");
+    util::UIConsole::log("esp_partition_mmap failed", "AudioBank");
+    return false;
+  }
+
+  const auto* header = static_cast<const Header*>(mapped);
+  const size_t indexBytes = sizeof(Header) + static_cast<size_t>(header->count) * sizeof(Entry);
+  if (header->magic != kMagic || header->version != kVersion ||
+      header->imageSize > part->size || indexBytes > header->imageSize) {
+    Serial.println("AudioBank: Partition is empty or has an unknown format");
+    util::UIConsole::log("Partition is empty or has an unknown format", "AudioBank");
+    spi_flash_munmap(mapHandle_);
+    mapHandle_ = 0;
+    return false;
+  }
+
+  base_ = static_cast<const uint8_t*>(mapped);
+  header_ = header;
+  entries_ = reinterpret_cast<const Entry*>(base_ + sizeof(Header));
+
+  Serial.println("AudioBank: " + String(header_->count) + " clips mapped (" + String(header_->imageSize) + " bytes)");
+  util::UIConsole::log(String(header_->count) + " clips mapped (" + String(header_->imageSize) + " bytes)", "AudioBank");
+  return true;
+}
+
+void AudioBank::end() {
+  if (!isMounted()) return;
+  spi_flash_munmap(mapHandle_);
+  mapHandle_ = 0;
+  header_ = nullptr;
+  entries_ = nullptr;
+  base_ = nullptr;
+}
+
+uint16_t AudioBank::clipCount() const {
+  return isMounted() ? header_->count : 0;
+}
+
+bool AudioBank::find(const String& name, Clip& out) const {
+  if (!isMounted()) return false;
+
+  for (uint16_t i = 0; i < header_->count; ++i) {
+    const Entry& entry = entries_[i];
+    if (strncmp(entry.name, name.c_str(), kNameLength) != 0) continue;
+    if (static_cast<uint64_t>(entry.offset) + entry.size > header_->imageSize) return false;
+
+    out.data = base_ + entry.offset;
+    out.size = entry.size;
+    out.sampleRate = entry.sampleRate;
+    out.channels = entry.channels;
+    out.bitsPerSample = entry.bitsPerSample;
+    return true;
+  }
+  return false;
+}
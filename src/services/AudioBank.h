@@ -0,0 +1,56 @@
+#pragma once
+
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+#include <esp_partition.h>
+
+// Read-only clip index over the "audiobank" flash partition, built by
+// scripts/audio_bank.py from data/audio. The partition is memory-mapped once,
+// so a clip is just a pointer into flash: no filesystem, no header parsing.
+class AudioBank {
+public:
+  static constexpr uint32_t kMagic = 0x4B4E4241;   // "ABNK"
+  static constexpr uint16_t kVersion = 1;
+  static constexpr size_t kNameLength = 32;
+
+  struct Clip {
+    const uint8_t* data = nullptr;   // Raw PCM16, little endian
+    uint32_t size = 0;               // Bytes
+    uint32_t sampleRate = 0;
+    uint8_t channels = 0;
+    uint8_t bitsPerSample = 0;
+  };
+
+  bool begin();
+  void end();
+  bool isMounted() const { return header_ != nullptr; }
+  uint16_t clipCount() const;
+  bool find(const String& name, Clip& out) const;
+
+private:
+  // Must match scripts/audio_bank.py
+  struct __attribute__((packed)) Header {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;
+    uint32_t imageSize;
+    uint32_t reserved;
+  };
+  struct __attribute__((packed)) Entry {
+    char name[kNameLength];
+    uint32_t offset;
+    uint32_t size;
+    uint32_t sampleRate;
+    uint8_t channels;
+    uint8_t bitsPerSample;
+    uint16_t reserved;
+  };
+  static_assert(sizeof(Header) == 16, "AudioBank header layout");
+  static_assert(sizeof(Entry) == 48, "AudioBank entry layout");
+
+  const Header* header_ = nullptr;
+  const Entry* entries_ = nullptr;
+  const uint8_t* base_ = nullptr;
+  spi_flash_mmap_handle_t mapHandle_ = 0;
+};
@@ -0,0 +1,58 @@
+#include "services/AudioCodecs.h"
+#include <array>
+
+namespace {
+  // ITU-T G.711, expanded to 16-bit linear
+  constexpr int16_t ulawToLinear(uint8_t u) {
+    u = static_cast<uint8_t>(~u);
+    const int exponent = (u >> 4) & 0x07;
+    const int mantissa = u & 0x0F;
+    const int magnitude = (((mantissa << 3) + 0x84) << exponent) - 0x84;
+    return static_cast<int16_t>((u & 0x80) ? -magnitude : magnitude);
+  }
+
+  constexpr int16_t alawToLinear(uint8_t a) {
+    a = static_cast<uint8_t>(a ^ 0x55);
+    const int exponent = (a >> 4) & 0x07;
+    const int mantissa = a & 0x0F;
+    const int magnitude = (exponent == 0) ? ((mantissa << 4) + 8)
+                                          : (((mantissa << 4) + 0x108) << (exponent - 1));
+    return static_cast<int16_t>((a & 0x80) ? magnitude : -magnitude);
+  }
+
+  template <int16_t (*Fn)(uint8_t)>
+  constexpr std::array<int16_t, 256> buildTable() {
+    std::array<int16_t, 256> table{};
+    for (int i = 0; i < 256; ++i) {
+      table[i] = Fn(static_cast<uint8_t>(i));
+    }
+    return table;
+  }
+
+  static_assert(ulawToLinear(0xFF) == 0 && ulawToLinear(0x00) == -32124, "mu-law");
+  static_assert(alawToLinear(0xD5) == 8 && alawToLinear(0x2A) == -32256, "A-law");
+}
+
+namespace codec {
+
+  // Built at compile time, placed in flash
+  const std::array<int16_t, 256> kUlawTable = buildTable<ulawToLinear>();
+  const std::array<int16_t, 256> kAlawTable = buildTable<alawToLinear>();
+
+  const int16_t kImaStepTable[89] = {
+        7,     8,     9,    10,    11,    12,    13,    14,    16,    17,
+       19,    21,    23,    25,    28,    31,    34,    37,    41,    45,
+       50,    55,    60,    66,    73,    80,    88,    97,   107,   118,
+      130,   143,   157,   173,   190,   209,   230,   253,   279,   307,
+      337,   371,   408,   449,   494,   544,   598,   658,   724,   796,
+      876,   963,  1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+     2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,
+     5894,  6484,  7132,  7845,  8630,  9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+  };
+
+  const int8_t kImaIndexTable[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+  };
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Table-driven fixed-point decoders for compressed WAV announcements:
+// G.711 μ-law/A-law (1 byte per sample) and IMA-ADPCM (4 bits per sample).
+namespace codec {
+
+  // WAVE_FORMAT_* tags handled by AudioPlayer
+  constexpr uint16_t kFormatPcm      = 0x0001;
+  constexpr uint16_t kFormatAlaw     = 0x0006;
+  constexpr uint16_t kFormatUlaw     = 0x0007;
+  constexpr uint16_t kFormatImaAdpcm = 0x0011;
+
+  extern const std::array<int16_t, 256> kUlawTable;
+  extern const std::array<int16_t, 256> kAlawTable;
+  extern const int16_t kImaStepTable[89];
+  extern const int8_t  kImaIndexTable[16];
+
+  inline int16_t ulaw(uint8_t b) { return kUlawTable[b]; }
+  inline int16_t alaw(uint8_t b) { return kAlawTable[b]; }
+
+  struct ImaState {
+    int32_t predictor = 0;
+    int32_t index = 0;
+  };
+
+  // One 4-bit code -> 16-bit sample, integer only
+  inline int16_t imaDecode(ImaState& st, uint8_t code) {
+    const int32_t step = kImaStepTable[st.index];
+    int32_t diff = step >> 3;
+    if (code & 4) diff += step;
+    if (code & 2) diff += step >> 1;
+    if (code & 1) diff += step >> 2;
+    st.predictor += (code & 8) ? -diff : diff;
+    if (st.predictor > 32767) st.predictor = 32767;
+    else if (st.predictor < -32768) st.predictor = -32768;
+
+    st.index += kImaIndexTable[code & 0x0F];
+    if (st.index < 0) st.index = 0;
+    else if (st.index > 88) st.index = 88;
+    return static_cast<int16_t>(st.predictor);
+  }
+
+  // Samples per channel in one IMA block (Microsoft layout: 4-byte header per channel)
+  inline uint32_t imaSamplesPerBlock(uint16_t blockAlign, uint16_t channels) {
+    if (channels == 0 || blockAlign <= 4u * channels) return 0;
+    return (static_cast<uint32_t>(blockAlign) - 4u * channels) * 2u / channels + 1u;
+  }
+}
@@ -1,4 +1,6 @@
 #include "services/AudioPlayer.h"
+#include "services/AudioCodecs.h"
+#include <esp_timer.h>
 
 AudioPlayer::AudioPlayer(PCMDriver& pcmDriver)
   : pcmDriver_(pcmDriver) {
@@ -8,7 +10,23 @@ bool AudioPlayer::begin() {
   if (!ensureFilesystemMounted_()) {
     return false;
   }
-  return pcmDriver_.begin(16000, 16, 2);
+  // The I2S clock is set once; clips are resampled to OUTPUT_RATE_HZ
+  pcmDriver_.setCommFormat(PCMDriver::CommFormat::StandardI2S);
+  pcmDriver_.setForce32BitSlots(true);
+  pcmDriver_.setSampleWordMode(PCMDriver::SampleWordMode::Bits32High16);
+  if (!pcmDriver_.begin(cfg::audio::OUTPUT_RATE_HZ, 32, 2)) {
+    Serial.println("AudioPlayer: Failed to configure I2S format.");
+    return false;
+  }
+
+  if (task_ == nullptr &&
+      xTaskCreatePinnedToCore(&AudioPlayer::taskEntry_, "audioPlayer", cfg::audio::TASK_STACK, this,
+                              cfg::audio::TASK_PRIORITY, &task_, cfg::audio::TASK_CORE) != pdPASS) {
+    task_ = nullptr;
+    Serial.println("AudioPlayer: Could not create playback task.");
+    return false;
+  }
+  return true;
 }
 
 bool AudioPlayer::audioPlayer(const String& filePath) {
@@ -21,6 +39,7 @@ bool AudioPlayer::playWav(const String& filePath) {
   }
   while (isPlaying()) {
     updatePlayback();
+    delay(1);
   }
   return lastPlaybackSucceeded_;
 }
@@ -28,13 +47,32 @@ bool AudioPlayer::playWav(const String& filePath) {
 bool AudioPlayer::startPlayback(const String& filePath) {
   stop();
 
+  if (task_ == nullptr) {
+    Serial.println("AudioPlayer: Not started, call begin() first.");
+    lastPlaybackSucceeded_ = false;
+    return false;
+  }
+  if (haltPending_) {
+    // The task is still inside its last I2S write; the ring is not ours yet
+    Serial.println("AudioPlayer: Previous clip still stopping, try again.");
+    lastPlaybackSucceeded_ = false;
+    return false;
+  }
+
+  const String path = normalizePath_(filePath);
+
+  // Clips in the flash audio bank play straight from mapped memory
+  AudioBank::Clip clip;
+  if (audioBank_ != nullptr && audioBank_->find(clipName_(path), clip)) {
+    return startClip_(clip);
+  }
+
   if (!ensureFilesystemMounted_()) {
     Serial.println("AudioPlayer: LittleFS is not mounted.");
     lastPlaybackSucceeded_ = false;
     return false;
   }
 
-  const String path = normalizePath_(filePath);
   currentFile_ = LittleFS.open(path, "r");
   if (!currentFile_) {
     Serial.println("AudioPlayer: Could not open file: " + path);
@@ -55,11 +93,7 @@ bool AudioPlayer::startPlayback(const String& filePath) {
                 static_cast<unsigned>(currentInfo_.channels),
                 static_cast<unsigned long>(currentInfo_.dataSize));
 
-  pcmDriver_.setCommFormat(PCMDriver::CommFormat::StandardI2S);
-  pcmDriver_.setForce32BitSlots(true);
-  pcmDriver_.setSampleWordMode(PCMDriver::SampleWordMode::Bits32High16);
-  if (!pcmDriver_.setFormat(currentInfo_.sampleRate, 32, 2)) {
-    Serial.println("AudioPlayer: Failed to configure I2S format.");
+  if (!configureOutput_(currentInfo_)) {
     currentFile_.close();
     lastPlaybackSucceeded_ = false;
     return false;
@@ -73,51 +107,280 @@ bool AudioPlayer::startPlayback(const String& filePath) {
   }
 
   bytesRemaining_ = currentInfo_.dataSize;
+  streamStats_.fillMinBytes = cfg::audio::RING_BYTES;
+
+  // One chunk is enough to start on; updatePlayback() tops the ring up while
+  // the task writes the lead-in, so the start is not held up by LittleFS
+  if (!refill_(cfg::audio::READ_CHUNK_BYTES)) {
+    Serial.println("AudioPlayer: Failed to read WAV data.");
+    currentFile_.close();
+    lastPlaybackSucceeded_ = false;
+    return false;
+  }
+
   playing_ = true;
   finishedEvent_ = false;
   lastPlaybackSucceeded_ = true;
+  startUs_ = esp_timer_get_time();
+  primed_ = false;
+  firstFrameWritten_ = false;
+  primedReported_ = false;
+  taskIdle_ = false;
+  streaming_ = true;
+  xTaskNotifyGive(task_);
   return true;
 }
 
 void AudioPlayer::updatePlayback(size_t maxChunkBytes) {
+  if (haltPending_) {
+    finishHalt_();
+  }
   if (!playing_) {
     return;
   }
 
-  size_t chunk = (maxChunkBytes == 0) ? kBufferSize : maxChunkBytes;
-  if (chunk > kBufferSize) chunk = kBufferSize;
-  if (chunk > bytesRemaining_) chunk = bytesRemaining_;
+  if (primed_.load() && !primedReported_) {
+    primedReported_ = true;
+    if (primedCallback_) primedCallback_();
+  }
 
-  if (chunk == 0) {
+  if (writeFailed_.load()) {
+    Serial.println("AudioPlayer: I2S write failed.");
+    haltTask_();
+    finalizePlayback_(false);
+    return;
+  }
+  if (drained_.load()) {
+    haltTask_();
     finalizePlayback_(true);
     return;
   }
 
-  const int bytesRead = currentFile_.read(readBuffer_, chunk);
-  if (bytesRead <= 0) {
+  if (!refill_(maxChunkBytes)) {
     Serial.println("AudioPlayer: Unexpected end of WAV data.");
+    haltTask_();
     finalizePlayback_(false);
     return;
   }
 
-  if (!processChunk_(readBuffer_, static_cast<size_t>(bytesRead), currentInfo_)) {
-    finalizePlayback_(false);
-    return;
+  const size_t fill = ring_.available();
+  if (!endOfData_.load() && fill < streamStats_.fillMinBytes) {
+    streamStats_.fillMinBytes = static_cast<uint32_t>(fill);
+  }
+}
+
+// Read ahead from LittleFS in whole chunks while the ring has room
+bool AudioPlayer::refill_(size_t maxBytes) {
+  size_t budget = (maxBytes == 0) ? cfg::audio::READ_CHUNK_BYTES : maxBytes;
+
+  while (budget > 0 && bytesRemaining_ > 0) {
+    size_t chunk = cfg::audio::READ_CHUNK_BYTES;
+    if (chunk > bytesRemaining_) chunk = bytesRemaining_;
+    if (ring_.space() < chunk) break;   // Wait for room for a full chunk
+    if (chunk > budget) chunk = budget;
+
+    const int bytesRead = currentFile_.read(fileBuffer_, chunk);
+    if (bytesRead <= 0) {
+      return false;
+    }
+    ring_.write(fileBuffer_, static_cast<size_t>(bytesRead));
+    bytesRemaining_ -= static_cast<uint32_t>(bytesRead);
+    budget -= (static_cast<size_t>(bytesRead) < budget) ? static_cast<size_t>(bytesRead) : budget;
+    streamStats_.refills++;
   }
 
-  bytesRemaining_ -= static_cast<uint32_t>(bytesRead);
   if (bytesRemaining_ == 0) {
-    finalizePlayback_(true);
+    endOfData_ = true;
   }
+  return true;
+}
+
+void AudioPlayer::setOutputGain(float gain) {
+  gainQ12_ = pcm::gainFromFloat(gain);
 }
 
 void AudioPlayer::stop() {
+  haltTask_();
   if (currentFile_) {
     currentFile_.close();
   }
   playing_ = false;
   bytesRemaining_ = 0;
-  pcmDriver_.stop();
+  pcmDriver_.clear();   // I2S keeps running at the fixed rate, output silence
+}
+
+// Tell the task to stop draining. It parks after the I2S write it is in,
+// so wait at most one write timeout; if it has not acknowledged by then the
+// ring stays untouched and updatePlayback() finishes the halt later.
+void AudioPlayer::haltTask_() {
+  streaming_ = false;
+  haltPending_ = true;
+  if (task_ != nullptr) {
+    xTaskNotifyGive(task_);
+    const uint32_t start = millis();
+    while (!taskIdle_.load() && (millis() - start) < cfg::audio::WRITE_TIMEOUT_MS) {
+      vTaskDelay(1);
+    }
+  }
+  finishHalt_();
+}
+
+// Only once the task is parked: the ring and the mapped-flash cursor are ours again
+bool AudioPlayer::finishHalt_() {
+  if (task_ != nullptr && !taskIdle_.load()) {
+    return false;
+  }
+  ring_.reset();
+  memData_ = nullptr;
+  memRemaining_ = 0;
+  endOfData_ = false;
+  drained_ = false;
+  writeFailed_ = false;
+  haltPending_ = false;
+  return true;
+}
+
+void AudioPlayer::taskEntry_(void* arg) {
+  static_cast<AudioPlayer*>(arg)->run_();
+}
+
+void AudioPlayer::run_() {
+  for (;;) {
+    const TickType_t wait = runOnce();
+    if (wait != 0) {
+      ulTaskNotifyTake(pdTRUE, wait);
+    }
+  }
+}
+
+TickType_t AudioPlayer::runOnce() {
+  if (!streaming_.load()) {
+    if (drained_.load()) markPrimed_();   // Clip shorter than the DMA ring
+    taskIdle_ = true;
+    starving_ = false;
+    leadInDone_ = false;
+    return portMAX_DELAY;
+  }
+  if (!leadInDone_) {
+    writeLeadIn_();
+    leadInDone_ = true;
+    markPrimed_();
+  }
+
+  const size_t frameBytes = chunkUnit_(currentInfo_);
+  if (memData_ != nullptr) {
+    drainMemory_(frameBytes);
+    return 0;
+  }
+
+  size_t n = ring_.available();
+  if (n > kBufferSize) n = kBufferSize;
+  n -= n % frameBytes;
+
+  if (n == 0) {
+    if (endOfData_.load()) {
+      writeTail_();
+      streaming_ = false;
+      drained_ = true;
+      return 0;
+    }
+    if (!starving_) {
+      streamStats_.underruns++;
+      starving_ = true;
+    }
+    return pdMS_TO_TICKS(2);
+  }
+  starving_ = false;
+
+  ring_.read(readBuffer_, n);
+  if (!processChunk_(readBuffer_, n, currentInfo_)) {
+    streaming_ = false;
+    writeFailed_ = true;
+  }
+  return 0;
+}
+
+// Mapped-flash source: no ring, the task reads the clip in place
+void AudioPlayer::drainMemory_(size_t frameBytes) {
+  size_t n = memRemaining_;
+  if (n > kBufferSize) n = kBufferSize;
+  n -= n % frameBytes;
+
+  if (n == 0) {
+    writeTail_();
+    memData_ = nullptr;
+    memRemaining_ = 0;
+    streaming_ = false;
+    drained_ = true;
+    return;
+  }
+  if (!processChunk_(memData_, n, currentInfo_)) {
+    streaming_ = false;
+    writeFailed_ = true;
+    return;
+  }
+  memData_ += n;
+  memRemaining_ -= n;
+}
+
+bool AudioPlayer::startClip_(const AudioBank::Clip& clip) {
+  if (clip.bitsPerSample != 16 || (clip.channels != 1 && clip.channels != 2) || clip.sampleRate == 0) {
+    Serial.println("AudioPlayer: Unsupported clip format in audio bank.");
+    lastPlaybackSucceeded_ = false;
+    return false;
+  }
+
+  currentInfo_ = WavInfo{};
+  currentInfo_.audioFormat = 1;
+  currentInfo_.channels = clip.channels;
+  currentInfo_.sampleRate = clip.sampleRate;
+  currentInfo_.bitsPerSample = clip.bitsPerSample;
+  currentInfo_.dataSize = clip.size;
+
+  if (!configureOutput_(currentInfo_)) {
+    lastPlaybackSucceeded_ = false;
+    return false;
+  }
+
+  memData_ = clip.data;
+  memRemaining_ = clip.size;
+  bytesRemaining_ = 0;
+  endOfData_ = true;
+
+  playing_ = true;
+  finishedEvent_ = false;
+  lastPlaybackSucceeded_ = true;
+  startUs_ = esp_timer_get_time();
+  primed_ = false;
+  firstFrameWritten_ = false;
+  primedReported_ = false;
+  taskIdle_ = false;
+  streaming_ = true;
+  xTaskNotifyGive(task_);
+  return true;
+}
+
+// No I2S reconfiguration per clip, only the resampler ratio
+bool AudioPlayer::configureOutput_(const WavInfo& info) {
+  if (!resampler_.configure(info.sampleRate, cfg::audio::OUTPUT_RATE_HZ, static_cast<uint8_t>(info.channels))) {
+    Serial.println("AudioPlayer: Unsupported sample rate " + String(info.sampleRate) + " Hz.");
+    return false;
+  }
+  packFrames_ = 0;
+  return true;
+}
+
+// "/audio/foo.wav" -> "foo"
+String AudioPlayer::clipName_(const String& path) {
+  int start = 0;
+  for (int i = static_cast<int>(path.length()) - 1; i >= 0; --i) {
+    if (path[i] == '/') { start = i + 1; break; }
+  }
+  String name = path.substring(start);
+  if (name.endsWith(".wav")) {
+    name = name.substring(0, name.length() - 4);
+  }
+  return name;
 }
 
 bool AudioPlayer::consumeFinishedEvent() {
@@ -167,9 +430,19 @@ bool AudioPlayer::parseWavHeader_(File& file, WavInfo& outInfo) {
       outInfo.audioFormat = readU16LE_(fmt + 0);
       outInfo.channels = readU16LE_(fmt + 2);
       outInfo.sampleRate = readU32LE_(fmt + 4);
+      outInfo.blockAlign = readU16LE_(fmt + 12);
       outInfo.bitsPerSample = readU16LE_(fmt + 14);
       gotFmt = true;
 
+      // WAVEFORMATEX extension: cbSize, samplesPerBlock (IMA-ADPCM)
+      if (chunkSize >= 20) {
+        uint8_t ext[4];
+        if (file.read(ext, sizeof(ext)) != static_cast<int>(sizeof(ext))) {
+          return false;
+        }
+        outInfo.samplesPerBlock = readU16LE_(ext + 2);
+      }
+
       const uint32_t toSkip = chunkSize - 16;
       if (toSkip > 0 && !file.seek(chunkDataPos + chunkSize)) {
         return false;
@@ -194,38 +467,249 @@ bool AudioPlayer::parseWavHeader_(File& file, WavInfo& outInfo) {
   }
 
   if (!gotFmt || !gotData) return false;
-  if (outInfo.audioFormat != 1) return false; // PCM only
-  if (outInfo.bitsPerSample != 16) return false;
   if (outInfo.channels != 1 && outInfo.channels != 2) return false;
   if (outInfo.sampleRate == 0) return false;
+
+  switch (outInfo.audioFormat) {
+    case codec::kFormatPcm:
+      return outInfo.bitsPerSample == 16;
+    case codec::kFormatUlaw:
+    case codec::kFormatAlaw:
+      return outInfo.bitsPerSample == 8;
+    case codec::kFormatImaAdpcm: {
+      // Whole blocks go through the task buffer
+      if (outInfo.bitsPerSample != 4 || outInfo.blockAlign > kBufferSize) return false;
+      const uint32_t expected = codec::imaSamplesPerBlock(outInfo.blockAlign, outInfo.channels);
+      if (expected == 0) return false;
+      if (outInfo.samplesPerBlock == 0 || outInfo.samplesPerBlock > expected) {
+        outInfo.samplesPerBlock = static_cast<uint16_t>(expected);
+      }
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+bool AudioPlayer::processChunk_(const uint8_t* readBuffer, size_t bytesRead, const WavInfo& info) {
+  switch (info.audioFormat) {
+    case codec::kFormatUlaw:
+      return decodeG711_(readBuffer, bytesRead, info.channels, codec::kUlawTable.data());
+    case codec::kFormatAlaw:
+      return decodeG711_(readBuffer, bytesRead, info.channels, codec::kAlawTable.data());
+    case codec::kFormatImaAdpcm:
+      for (size_t off = 0; off + info.blockAlign <= bytesRead; off += info.blockAlign) {
+        if (!decodeImaBlock_(readBuffer + off, info)) return false;
+      }
+      return flushPack_();
+    default:
+      break;
+  }
+
+  if (!resampler_.bypass()) {
+    const int16_t* pcm = reinterpret_cast<const int16_t*>(readBuffer);
+    const size_t samples = bytesRead / sizeof(int16_t);
+    if (info.channels == 2) {
+      for (size_t i = 0; i + 1 < samples; i += 2) {
+        if (!emitFrame_(pcm[i], pcm[i + 1])) return false;
+      }
+    } else {
+      for (size_t i = 0; i < samples; ++i) {
+        if (!emitFrame_(pcm[i], pcm[i])) return false;
+      }
+    }
+    return flushPack_();
+  }
+
+  const size_t frames = bytesRead / (static_cast<size_t>(info.channels) * sizeof(int16_t));
+  if (!writePcm_(reinterpret_cast<const int16_t*>(readBuffer), frames, info.channels)) {
+    Serial.println("AudioPlayer: I2S write failed (pcm).");
+    return false;
+  }
   return true;
 }
 
-bool AudioPlayer::processChunk_(uint8_t* readBuffer, size_t bytesRead, const WavInfo& info) {
-  if (info.channels == 2) {
-    applyGainInPlace_(reinterpret_cast<int16_t*>(readBuffer), bytesRead / sizeof(int16_t));
-    const size_t frames = bytesRead / (2u * sizeof(int16_t));
-    if (!writeStereo16_(reinterpret_cast<const int16_t*>(readBuffer), frames)) {
-      Serial.println("AudioPlayer: I2S write failed (stereo).");
-      return false;
+// Smallest unit the task may hand to processChunk_
+size_t AudioPlayer::chunkUnit_(const WavInfo& info) {
+  switch (info.audioFormat) {
+    case codec::kFormatUlaw:
+    case codec::kFormatAlaw:     return info.channels;
+    case codec::kFormatImaAdpcm: return info.blockAlign;
+    default:                     return static_cast<size_t>(info.channels) * sizeof(int16_t);
+  }
+}
+
+// G.711: one table lookup per byte, straight into the I2S packing buffer
+bool AudioPlayer::decodeG711_(const uint8_t* src, size_t bytes, uint16_t channels, const int16_t* table) {
+  if (channels == 2) {
+    for (size_t i = 0; i + 1 < bytes; i += 2) {
+      if (!emitFrame_(table[src[i]], table[src[i + 1]])) return false;
     }
   } else {
-    const size_t sampleCount = bytesRead / sizeof(int16_t);
-    const int16_t* mono = reinterpret_cast<const int16_t*>(readBuffer);
-    for (size_t i = 0; i < sampleCount; ++i) {
-      stereoBuffer_[2 * i] = mono[i];
-      stereoBuffer_[2 * i + 1] = mono[i];
+    for (size_t i = 0; i < bytes; ++i) {
+      const int16_t s = table[src[i]];
+      if (!emitFrame_(s, s)) return false;
     }
-    applyGainInPlace_(stereoBuffer_, sampleCount * 2);
-    if (!writeStereo16_(stereoBuffer_, sampleCount)) {
-      Serial.println("AudioPlayer: I2S write failed (mono->stereo).");
-      return false;
+  }
+  return flushPack_();
+}
+
+// Microsoft IMA-ADPCM block: per channel a 4-byte header (predictor, index),
+// then 4-bit codes; stereo interleaves 4 bytes (8 samples) per channel.
+bool AudioPlayer::decodeImaBlock_(const uint8_t* block, const WavInfo& info) {
+  const uint16_t channels = info.channels;
+  codec::ImaState state[2];
+  for (uint16_t c = 0; c < channels; ++c) {
+    const uint8_t* h = block + 4u * c;
+    state[c].predictor = static_cast<int16_t>(readU16LE_(h));
+    state[c].index = h[2] > 88 ? 88 : h[2];
+  }
+
+  // The header sample is the first output sample
+  const int16_t first0 = static_cast<int16_t>(state[0].predictor);
+  if (!emitFrame_(first0, channels == 2 ? static_cast<int16_t>(state[1].predictor) : first0)) return false;
+
+  const uint8_t* data = block + 4u * channels;
+  uint32_t remaining = info.samplesPerBlock - 1u;
+
+  if (channels == 1) {
+    for (; remaining > 0; ++data) {
+      const int16_t a = codec::imaDecode(state[0], *data & 0x0F);
+      if (!emitFrame_(a, a)) return false;
+      if (--remaining == 0) break;
+      const int16_t b = codec::imaDecode(state[0], *data >> 4);
+      if (!emitFrame_(b, b)) return false;
+      --remaining;
+    }
+    return true;
+  }
+
+  int16_t left[8];
+  int16_t right[8];
+  while (remaining > 0) {
+    for (int k = 0; k < 4; ++k) {
+      left[2 * k]      = codec::imaDecode(state[0], data[k] & 0x0F);
+      left[2 * k + 1]  = codec::imaDecode(state[0], data[k] >> 4);
+      right[2 * k]     = codec::imaDecode(state[1], data[4 + k] & 0x0F);
+      right[2 * k + 1] = codec::imaDecode(state[1], data[4 + k] >> 4);
+    }
+    data += 8;
+    const uint32_t n = remaining < 8 ? remaining : 8;
+    for (uint32_t k = 0; k < n; ++k) {
+      if (!emitFrame_(left[k], right[k])) return false;
     }
+    remaining -= n;
+  }
+  return true;
+}
+
+// Decoded frame at the clip rate -> resampler -> packing buffer
+bool AudioPlayer::emitFrame_(int16_t left, int16_t right) {
+  if (resampler_.bypass()) {
+    return putFrame_(left, right);
+  }
+  return resampler_.push(left, right, [this](int16_t l, int16_t r) { return putFrame_(l, r); });
+}
+
+// Gain and slot packing for one frame; writes to I2S when the buffer is full
+bool AudioPlayer::putFrame_(int16_t left, int16_t right) {
+  if (gainQ12_ != pcm::kUnityGain) {
+    left = pcm::applyGain(left, gainQ12_);
+    right = pcm::applyGain(right, gainQ12_);
   }
 
+  const PCMDriver::SampleWordMode mode = pcmDriver_.sampleWordMode();
+  const size_t i = 2u * packFrames_;
+  if (mode == PCMDriver::SampleWordMode::Bits16) {
+    int16_t* out = reinterpret_cast<int16_t*>(packBuffer_);
+    out[i] = left;
+    out[i + 1] = right;
+  } else {
+    packBuffer_[i] = pcm::toSlot32(left, mode);
+    packBuffer_[i + 1] = pcm::toSlot32(right, mode);
+  }
+
+  if (++packFrames_ == kPackFrames) {
+    return flushPack_();
+  }
   return true;
 }
 
+bool AudioPlayer::flushPack_() {
+  if (packFrames_ == 0) return true;
+
+  const size_t bytes = packFrames_ * pcm::frameBytes(pcmDriver_.sampleWordMode());
+  packFrames_ = 0;
+
+  if (!writeI2S_(reinterpret_cast<const uint8_t*>(packBuffer_), bytes)) {
+    Serial.println("AudioPlayer: I2S write failed (decoded).");
+    return false;
+  }
+  return true;
+}
+
+// The lead-in goes in with preroll() and never waits. The first clip write
+// after it fixes when the clip reaches the DAC.
+bool AudioPlayer::writeI2S_(const uint8_t* data, size_t bytes) {
+  size_t done = 0;
+  if (!primed_.load()) {
+    done = pcmDriver_.preroll(data, bytes);
+    if (done == bytes) return true;
+  } else if (!firstFrameWritten_) {
+    markFirstFrame_();
+  }
+
+  size_t written = 0;
+  if (!pcmDriver_.write(data + done, bytes - done, &written, pdMS_TO_TICKS(cfg::audio::WRITE_TIMEOUT_MS))) {
+    return false;
+  }
+  // A timeout drops the rest of the chunk rather than stalling the stream
+  if (written != bytes - done) streamStats_.writeTimeouts++;
+  return true;
+}
+
+void AudioPlayer::markPrimed_() {
+  if (primed_.load()) return;
+  firstFrameWritten_ = false;
+  primed_ = true;
+}
+
+// The DMA ring was empty at the lead-in, so the lead-in plays out first and
+// the clip follows it, or follows its own write if decoding fell behind
+void AudioPlayer::markFirstFrame_() {
+  firstFrameWritten_ = true;
+  const int64_t now = esp_timer_get_time();
+  const int64_t due = (leadInDueUs_ > now) ? leadInDueUs_ : now;
+  firstFrameDueUs_ = due;
+
+  const uint32_t latency = static_cast<uint32_t>(due - startUs_);
+  streamStats_.startLatencyLastUs = latency;
+  if (latency > streamStats_.startLatencyMaxUs) streamStats_.startLatencyMaxUs = latency;
+}
+
+// LEAD_IN_MS of silence ahead of the clip: the time the loop has, after the
+// primed callback, to close D_OUTL before the first clip frame plays. stop()
+// zeroed the DMA ring, so nothing else is queued ahead of it.
+void AudioPlayer::writeLeadIn_() {
+  const uint32_t frames = cfg::audio::OUTPUT_RATE_HZ * cfg::audio::LEAD_IN_MS / 1000u;
+  leadInDueUs_ = esp_timer_get_time() + static_cast<int64_t>(frames) * 1000000 / cfg::audio::OUTPUT_RATE_HZ;
+  for (uint32_t i = 0; i < frames; ++i) {
+    if (!putFrame_(0, 0)) break;
+  }
+  flushPack_();
+}
+
+// One DMA ring of silence behind the clip. The write returns once the clip's
+// last frames have left the ring, so the finished callback (D_OUTL opens)
+// does not cut off the tail still queued in DMA. stop() cuts it short.
+void AudioPlayer::writeTail_() {
+  const size_t frames = pcmDriver_.dmaCapacityBytes() / pcm::frameBytes(pcmDriver_.sampleWordMode());
+  for (size_t i = 0; i < frames && streaming_.load(); ++i) {
+    if (!putFrame_(0, 0)) return;
+  }
+  flushPack_();
+}
+
 void AudioPlayer::finalizePlayback_(bool success) {
   if (currentFile_) {
     currentFile_.close();
@@ -234,68 +718,36 @@ void AudioPlayer::finalizePlayback_(bool success) {
   bytesRemaining_ = 0;
   lastPlaybackSucceeded_ = success;
   finishedEvent_ = true;
+  if (finishedCallback_) {
+    finishedCallback_(success);
+  }
 }
 
-bool AudioPlayer::writeStereo16_(const int16_t* interleavedStereo, size_t frames) {
-  if (interleavedStereo == nullptr || frames == 0) {
+// Undecoded PCM at the output rate: one fused pass per packing buffer.
+// Stereo 16-bit slots at unity gain are already in I2S layout and go out as is.
+bool AudioPlayer::writePcm_(const int16_t* samples, size_t frames, uint8_t channels) {
+  if (samples == nullptr || frames == 0) {
     return false;
   }
+  if (!flushPack_()) return false;
 
   const PCMDriver::SampleWordMode mode = pcmDriver_.sampleWordMode();
-  if (mode == PCMDriver::SampleWordMode::Bits16) {
-    const size_t bytes = frames * 2u * sizeof(int16_t);
-    size_t written = 0;
-    return pcmDriver_.write(reinterpret_cast<const uint8_t*>(interleavedStereo), bytes, &written) && written == bytes;
-  }
-
-  static constexpr size_t kChunkFrames = 256;
-  int32_t packed[kChunkFrames * 2];
-  size_t offsetFrames = 0;
-
-  while (offsetFrames < frames) {
-    const size_t remaining = frames - offsetFrames;
-    const size_t n = (remaining > kChunkFrames) ? kChunkFrames : remaining;
-    const size_t sampleCount = n * 2u;
-    const int16_t* src = interleavedStereo + (offsetFrames * 2u);
-
-    for (size_t i = 0; i < sampleCount; ++i) {
-      const int16_t s = src[i];
-      if (mode == PCMDriver::SampleWordMode::Bits32High16) {
-        packed[i] = static_cast<int32_t>(s) << 16;
-      } else {
-        packed[i] = static_cast<int32_t>(static_cast<uint16_t>(s));
-      }
-    }
+  if (mode == PCMDriver::SampleWordMode::Bits16 && channels == 2 && gainQ12_ == pcm::kUnityGain) {
+    return writeI2S_(reinterpret_cast<const uint8_t*>(samples), frames * 2u * sizeof(int16_t));
+  }
 
-    const size_t bytes = sampleCount * sizeof(int32_t);
-    size_t written = 0;
-    if (!pcmDriver_.write(reinterpret_cast<const uint8_t*>(packed), bytes, &written) || written != bytes) {
+  while (frames > 0) {
+    const size_t n = (frames > kPackFrames) ? kPackFrames : frames;
+    const size_t bytes = pcm::pack(samples, n, channels, gainQ12_, mode, packBuffer_);
+    if (!writeI2S_(reinterpret_cast<const uint8_t*>(packBuffer_), bytes)) {
       return false;
     }
-
-    offsetFrames += n;
+    samples += n * channels;
+    frames -= n;
   }
-
   return true;
 }
 
-void AudioPlayer::applyGainInPlace_(int16_t* samples, size_t count) const {
-  if (samples == nullptr || count == 0 || outputGain_ <= 1.0f) {
-    return;
-  }
-
-  for (size_t i = 0; i < count; ++i) {
-    const float scaled = static_cast<float>(samples[i]) * outputGain_;
-    if (scaled > 32767.0f) {
-      samples[i] = 32767;
-    } else if (scaled < -32768.0f) {
-      samples[i] = -32768;
-    } else {
-      samples[i] = static_cast<int16_t>(scaled);
-    }
-  }
-}
-
 String AudioPlayer::normalizePath_(const String& filePath) const {
   String path = filePath;
   path.trim();
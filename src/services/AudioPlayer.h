@@ -2,38 +2,108 @@
 
 #include <Arduino.h>
 #include <LittleFS.h>
+#include <atomic>
+#include <functional>
+#include "config.h"
 #include "drivers/PCMDriver.h"
+#include "services/AudioBank.h"
+#include "services/PcmPack.h"
+#include "services/Resampler.h"
+#include "util/ByteRing.h"
 
+// Playback runs in its own task: startPlayback() returns at once, the loop
+// keeps the ring buffer filled from LittleFS through updatePlayback(), and the
+// task drains it into I2S. Completion is reported from updatePlayback() via
+// the finished callback / consumeFinishedEvent().
 class AudioPlayer {
 public:
   explicit AudioPlayer(PCMDriver& pcmDriver);
 
   bool begin();
   bool audioPlayer(const String& filePath);
-  bool playWav(const String& filePath);
+  bool playWav(const String& filePath);          // Blocking, not for the main loop
   bool startPlayback(const String& filePath);
-  void updatePlayback(size_t maxChunkBytes = 1024);
+  void updatePlayback(size_t maxChunkBytes = cfg::audio::READ_CHUNK_BYTES);
   bool isPlaying() const { return playing_; }
   bool consumeFinishedEvent();
   bool lastPlaybackSucceeded() const { return lastPlaybackSucceeded_; }
   void stop();
 
+  // Optional: clips found in the flash audio bank (by file name without
+  // ".wav") skip LittleFS and stream from mapped flash.
+  void setAudioBank(AudioBank* bank) { audioBank_ = bank; }
+
+  // Linear output gain (0..8), converted once to Q12 for the packing kernels.
+  // Takes effect from the next packing buffer.
+  void setOutputGain(float gain);
+
+  using FinishedCallback = std::function<void(bool /*success*/)>;
+  void setFinishedCallback(FinishedCallback cb) { finishedCallback_ = std::move(cb); }
+
+  // Fired from updatePlayback() once the lead-in silence is queued: the time
+  // to close the D_OUTL crosspoint. ConnectionHandler registers it and only
+  // switches the line in from there.
+  using PrimedCallback = std::function<void()>;
+  void setPrimedCallback(PrimedCallback cb) { primedCallback_ = std::move(cb); }
+  bool isPrimed() const { return primed_.load(); }
+  // esp_timer time the first clip frame reaches the DAC, 0 until it is queued
+  int64_t firstFrameDueUs() const { return firstFrameWritten_ ? firstFrameDueUs_ : 0; }
+
+  // For tuning ring size and dma_buf_count/dma_buf_len
+  struct StreamStats {
+    uint32_t underruns = 0;        // Task found the ring empty before end of file
+    uint32_t writeTimeouts = 0;    // I2S write did not complete within WRITE_TIMEOUT_MS
+    uint32_t refills = 0;          // LittleFS reads into the ring
+    uint32_t fillMinBytes = 0;     // Lowest fill seen while playing (current clip)
+    uint32_t startLatencyLastUs = 0;   // startPlayback() -> first clip frame at the DAC
+    uint32_t startLatencyMaxUs = 0;
+  };
+  const StreamStats& streamStats() const { return streamStats_; }
+  size_t bufferFill() const { return ring_.available(); }
+  static constexpr size_t bufferCapacity() { return cfg::audio::RING_BYTES; }
+
+  // One pass of the playback task. Returns how long the task waits for a
+  // notification before the next pass (0 = straight on). The task calls it in
+  // a loop; host tests call it directly in place of the task.
+  TickType_t runOnce();
+
 private:
   struct WavInfo {
     uint16_t audioFormat = 0;
     uint16_t channels = 0;
     uint32_t sampleRate = 0;
+    uint16_t blockAlign = 0;
     uint16_t bitsPerSample = 0;
+    uint16_t samplesPerBlock = 0;   // IMA-ADPCM
     uint32_t dataOffset = 0;
     uint32_t dataSize = 0;
   };
 
   bool ensureFilesystemMounted_();
   bool parseWavHeader_(File& file, WavInfo& outInfo);
-  bool processChunk_(uint8_t* readBuffer, size_t bytesRead, const WavInfo& info);
+  bool processChunk_(const uint8_t* readBuffer, size_t bytesRead, const WavInfo& info);
+  bool decodeG711_(const uint8_t* src, size_t bytes, uint16_t channels, const int16_t* table);
+  bool decodeImaBlock_(const uint8_t* block, const WavInfo& info);
+  bool putFrame_(int16_t left, int16_t right);
+  bool flushPack_();
+  static size_t chunkUnit_(const WavInfo& info);
+  bool startClip_(const AudioBank::Clip& clip);
+  bool configureOutput_(const WavInfo& info);
+  bool emitFrame_(int16_t left, int16_t right);
+  bool writeI2S_(const uint8_t* data, size_t bytes);
+  void writeLeadIn_();
+  void writeTail_();
+  void markPrimed_();
+  void markFirstFrame_();
+  void drainMemory_(size_t frameBytes);
+  static String clipName_(const String& path);
   void finalizePlayback_(bool success);
-  bool writeStereo16_(const int16_t* interleavedStereo, size_t frames);
-  void applyGainInPlace_(int16_t* samples, size_t count) const;
+  bool writePcm_(const int16_t* samples, size_t frames, uint8_t channels);
+  bool refill_(size_t maxBytes);
+  void haltTask_();
+  bool finishHalt_();
+  static void taskEntry_(void* arg);
+  void run_();
   String normalizePath_(const String& filePath) const;
   static uint16_t readU16LE_(const uint8_t* p);
   static uint32_t readU32LE_(const uint8_t* p);
@@ -41,14 +111,46 @@ private:
 private:
   PCMDriver& pcmDriver_;
   bool fsReady_ = false;
-  float outputGain_ = 1.0f;
+  int32_t gainQ12_ = pcm::kUnityGain;
   File currentFile_;
   WavInfo currentInfo_{};
   uint32_t bytesRemaining_ = 0;
   bool playing_ = false;
   bool finishedEvent_ = false;
   bool lastPlaybackSucceeded_ = true;
-  static constexpr size_t kBufferSize = 1024;
-  uint8_t readBuffer_[kBufferSize]{};
-  int16_t stereoBuffer_[kBufferSize]{};
+  FinishedCallback finishedCallback_;
+  PrimedCallback primedCallback_;
+  std::atomic<bool> primed_{false};       // Task -> loop
+  bool primedReported_ = false;
+  int64_t startUs_ = 0;
+  int64_t leadInDueUs_ = 0;               // Task side: end of the lead-in at the DAC
+  volatile int64_t firstFrameDueUs_ = 0;  // Task -> loop, valid once firstFrameWritten_
+  volatile bool firstFrameWritten_ = false;
+  AudioBank* audioBank_ = nullptr;
+  const uint8_t* memData_ = nullptr;      // Current clip in mapped flash, task-owned while streaming
+  size_t memRemaining_ = 0;
+
+  // Loop -> task
+  util::ByteRing<cfg::audio::RING_BYTES> ring_;
+  TaskHandle_t task_ = nullptr;
+  std::atomic<bool> streaming_{false};    // Task may drain the ring
+  std::atomic<bool> endOfData_{false};    // Whole file is in the ring
+  std::atomic<bool> taskIdle_{true};
+  bool haltPending_ = false;              // Stop signalled, task not parked yet (loop side)
+  bool starving_ = false;                 // Task side
+  bool leadInDone_ = false;               // Task side
+  // Task -> loop
+  std::atomic<bool> drained_{false};
+  std::atomic<bool> writeFailed_{false};
+  StreamStats streamStats_;
+
+  static constexpr size_t kBufferSize = cfg::audio::TASK_CHUNK_BYTES;
+  uint8_t fileBuffer_[cfg::audio::READ_CHUNK_BYTES]{};   // Loop side
+  uint8_t readBuffer_[kBufferSize]{};                    // Task side
+
+  // Decoders write frames straight into the I2S slot format
+  static constexpr size_t kPackFrames = 256;
+  int32_t packBuffer_[kPackFrames * 2]{};
+  size_t packFrames_ = 0;
+  Resampler resampler_;
 };
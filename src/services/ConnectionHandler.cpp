@@ -1,4 +1,5 @@
 #include "services/ConnectionHandler.h"
+#include <esp_timer.h>
 
 // Connect two lines
 void ConnectionHandler::connectLines(uint8_t lineA, uint8_t lineB) {
@@ -7,8 +8,9 @@ void ConnectionHandler::connectLines(uint8_t lineA, uint8_t lineB) {
     return;
   }
 
-  mt8816Driver_.setConnection(lineA, lineB, true);
-  mt8816Driver_.setConnection(lineB, lineA, true);
+  if (!switchFabric_.connectLines(lineA, lineB)) {
+    return;
+  }
   addConnection(lineA, lineB);
 
   if (settings.debugLAC >= 1) {
@@ -25,8 +27,7 @@ void ConnectionHandler::connectLines(uint8_t lineA, uint8_t lineB) {
 // Disconnect two lines
 void ConnectionHandler::disconnectLines(uint8_t lineA, uint8_t lineB) {
 
-  mt8816Driver_.setConnection(lineA, lineB, false);
-  mt8816Driver_.setConnection(lineB, lineA, false);
+  switchFabric_.disconnectLines(lineA, lineB);
   removeConnection(lineA, lineB);
 
   if (settings.debugLAC >= 1) {
@@ -42,7 +43,7 @@ void ConnectionHandler::disconnectLines(uint8_t lineA, uint8_t lineB) {
 
 // Connect audio source to line
 void ConnectionHandler::connectAudioToLine(uint8_t line, uint8_t audioSource) {
-  mt8816Driver_.setConnection(audioSource, line, true);
+  switchFabric_.connectSource(audioSource, line);
   if (settings.debugLAC >= 1) {
     Serial.print("ConnectionHandler: ");
     Serial.print("Connected audio source ");
@@ -55,7 +56,7 @@ void ConnectionHandler::connectAudioToLine(uint8_t line, uint8_t audioSource) {
 
 // Disconnect audio source from line
 void ConnectionHandler::disconnectAudioToLine(uint8_t line, uint8_t audioSource) {
-  mt8816Driver_.setConnection(audioSource, line, false);
+  switchFabric_.disconnectSource(audioSource, line);
   if (settings.debugLAC >= 1) {
     Serial.print("ConnectionHandler: ");
     Serial.print("Disconnected audio source ");
@@ -66,6 +67,67 @@ void ConnectionHandler::disconnectAudioToLine(uint8_t line, uint8_t audioSource)
   }
 }
 
+void ConnectionHandler::setAudioPlayer(AudioPlayer* audioPlayer, ToneGenerator* toneGenerator) {
+  audioPlayer_ = audioPlayer;
+  toneGenerator_ = toneGenerator;
+  if (audioPlayer_ == nullptr) return;
+  audioPlayer_->setPrimedCallback([this]() { onAnnouncementPrimed_(); });
+  audioPlayer_->setFinishedCallback([this](bool) { endAnnouncement_(); });
+}
+
+// Starts the clip with the line still open; D_OUTL closes once it is primed
+bool ConnectionHandler::playAnnouncement(uint8_t line, const String& path) {
+  if (audioPlayer_ == nullptr || line >= cfg::lines::MAX_LINES) return false;
+  if (announcementLine_ != kNoLine) stopAnnouncement(announcementLine_);
+
+  if (toneGenerator_ != nullptr && !toneGenerator_->reserveSynth()) {
+    if (settings.debugLAC >= 1) {
+      Serial.println("ConnectionHandler: D_OUTL busy with a tone, announcement for line " + String(line) + " refused");
+      util::UIConsole::log("D_OUTL busy with a tone, announcement for line " + String(line) + " refused", "ConnectionHandler");
+    }
+    return false;
+  }
+
+  announcementLine_ = line;
+  announcementSwitched_ = false;
+  if (!audioPlayer_->startPlayback(path)) {
+    announcementLine_ = kNoLine;
+    if (toneGenerator_ != nullptr) toneGenerator_->releaseSynth();
+    return false;
+  }
+  announcementStats_.started++;
+  return true;
+}
+
+void ConnectionHandler::stopAnnouncement(uint8_t line) {
+  if (audioPlayer_ == nullptr || line != announcementLine_) return;
+  audioPlayer_->stop();
+  endAnnouncement_();
+}
+
+void ConnectionHandler::onAnnouncementPrimed_() {
+  if (announcementLine_ == kNoLine || announcementSwitched_) return;
+  connectAudioToLine(announcementLine_, cfg::mt8816::D_OUTL);
+  announcementSwitched_ = true;
+  announcementCloseUs_ = esp_timer_get_time();
+}
+
+// Clip done or stopped: open D_OUTL and hand the synth back
+void ConnectionHandler::endAnnouncement_() {
+  if (announcementLine_ == kNoLine) return;
+  if (announcementSwitched_) {
+    const int64_t firstFrameUs = audioPlayer_->firstFrameDueUs();
+    if (firstFrameUs != 0) {
+      announcementStats_.closeMarginLastUs = static_cast<int32_t>(firstFrameUs - announcementCloseUs_);
+      if (firstFrameUs < announcementCloseUs_) announcementStats_.lateCloses++;
+    }
+    disconnectAudioToLine(announcementLine_, cfg::mt8816::D_OUTL);
+  }
+  announcementLine_ = kNoLine;
+  announcementSwitched_ = false;
+  if (toneGenerator_ != nullptr) toneGenerator_->releaseSynth();
+}
+
 // Add a connected pair
 void ConnectionHandler::addConnection(uint8_t lineA, uint8_t lineB) {
   activeConnections.push_back(std::make_pair(lineA, lineB));
@@ -3,13 +3,15 @@
 #include <vector>
 #include <stdint.h>
 #include "settings/Settings.h"
-#include "drivers/MT8816Driver.h"
+#include "services/SwitchFabric.h"
+#include "services/AudioPlayer.h"
+#include "services/ToneGenerator.h"
 #include "util/UIConsole.h"
 
 
 class ConnectionHandler {
 public:
-  ConnectionHandler(MT8816Driver& mt8816Driver, Settings& settings) : mt8816Driver_(mt8816Driver), settings(settings) {};
+  ConnectionHandler(SwitchFabric& switchFabric, Settings& settings) : switchFabric_(switchFabric), settings(settings) {};
 
   void connectLines(uint8_t lineA, uint8_t lineB);
   void disconnectLines(uint8_t lineA, uint8_t lineB);
@@ -20,13 +22,39 @@ public:
   void printConnections() const;
   bool isConnected(uint8_t lineA, uint8_t lineB) const;
 
+  // Announcements on D_OUTL. The crosspoint is closed from the player's
+  // primed callback, inside the lead-in silence, and opened again when the
+  // clip ends or stopAnnouncement() is called. The synth channel is reserved
+  // in ToneGenerator while a clip plays, since both use the PCM5102.
+  void setAudioPlayer(AudioPlayer* audioPlayer, ToneGenerator* toneGenerator);
+  bool playAnnouncement(uint8_t line, const String& path);
+  void stopAnnouncement(uint8_t line);
+  bool announcementActive(uint8_t line) const { return announcementLine_ == line; }
+
+  struct AnnouncementStats {
+    uint32_t started = 0;
+    uint32_t lateCloses = 0;        // D_OUTL closed after the first clip frame played
+    int32_t closeMarginLastUs = 0;  // First clip frame at the DAC minus the close time
+  };
+  const AnnouncementStats& announcementStats() const { return announcementStats_; }
+
 private:
 
   std::vector<std::pair<uint8_t, uint8_t>> activeConnections;
   void addConnection(uint8_t lineA, uint8_t lineB);
   void removeConnection(uint8_t lineA, uint8_t lineB);
 
-  MT8816Driver& mt8816Driver_;
+  SwitchFabric& switchFabric_;
   Settings& settings;
 
+  static constexpr uint8_t kNoLine = 0xFF;
+  void onAnnouncementPrimed_();
+  void endAnnouncement_();
+  AudioPlayer* audioPlayer_ = nullptr;
+  ToneGenerator* toneGenerator_ = nullptr;
+  uint8_t announcementLine_ = kNoLine;
+  bool announcementSwitched_ = false;
+  int64_t announcementCloseUs_ = 0;
+  AnnouncementStats announcementStats_;
+
 };
\ No newline at end of file
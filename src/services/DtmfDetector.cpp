@@ -0,0 +1,149 @@
+#include "services/DtmfDetector.h"
+#include <esp_timer.h>
+#include <math.h>
+
+namespace {
+  constexpr uint16_t kToneHz[DtmfDetector::kTones] = {
+    697, 770, 852, 941,          // Rows
+    1209, 1336, 1477, 1633       // Columns
+  };
+
+  constexpr char kKeys[4][4] = {
+    {'1', '2', '3', 'A'},
+    {'4', '5', '6', 'B'},
+    {'7', '8', '9', 'C'},
+    {'*', '0', '#', 'D'}
+  };
+
+  // Power ratios in percent (x100) so the checks stay integer
+  constexpr int64_t kTwistNormalPct  = 251;   // Column may be 4 dB above row
+  constexpr int64_t kTwistReversePct = 631;   // Row may be 8 dB above column
+  constexpr int64_t kPeakRatio       = 4;     // Other tones in the group >= 6 dB down
+  constexpr int64_t kEnergyPct       = 40;    // Row + column share of the block energy
+
+  // |X_k|^2 of the finished Goertzel state
+  inline int64_t power(int32_t s1, int32_t s2, int32_t coeffQ14) {
+    const int64_t cs1 = (static_cast<int64_t>(coeffQ14) * s1) >> 14;
+    return static_cast<int64_t>(s1) * s1 + static_cast<int64_t>(s2) * s2 - cs1 * s2;
+  }
+
+  inline int strongest(const int64_t* p, std::size_t n) {
+    int best = 0;
+    for (std::size_t i = 1; i < n; ++i) {
+      if (p[i] > p[best]) best = static_cast<int>(i);
+    }
+    return best;
+  }
+}
+
+DtmfDetector::DtmfDetector() {
+  // Nearest integer bin for each tone; Q14 coefficient 2cos(2*pi*k/N)
+  for (std::size_t i = 0; i < kTones; ++i) {
+    const float k = roundf(static_cast<float>(kBlock) * kToneHz[i] / cfg::dtmf::SAMPLE_RATE_HZ);
+    coeffQ14_[i] = static_cast<int32_t>(lrintf(2.0f * cosf(2.0f * static_cast<float>(M_PI) * k / kBlock) * 16384.0f));
+  }
+}
+
+void DtmfDetector::reset(uint8_t channel) {
+  if (channel >= cfg::dtmf::MAX_CHANNELS) return;
+  const Stats keep = channels_[channel].stats;
+  channels_[channel] = Channel{};
+  channels_[channel].stats = keep;
+}
+
+void DtmfDetector::process(uint8_t channel, const int16_t* samples, std::size_t count) {
+  if (channel >= cfg::dtmf::MAX_CHANNELS || samples == nullptr) return;
+  Channel& ch = channels_[channel];
+  const int64_t t0 = esp_timer_get_time();
+
+  while (count > 0) {
+    const std::size_t n = (count < kBlock - ch.count) ? count : kBlock - ch.count;
+    runBlock_(ch, samples, n);
+    ch.count += n;
+    samples += n;
+    count -= n;
+    ch.stats.samples += n;
+
+    if (ch.count == kBlock) {
+      ch.stats.blocks++;
+      validate_(channel, ch, evaluate_(ch));
+      for (std::size_t i = 0; i < kTones; ++i) { ch.s1[i] = 0; ch.s2[i] = 0; }
+      ch.energy = 0;
+      ch.count = 0;
+    }
+  }
+
+  ch.stats.busyUs += static_cast<uint64_t>(esp_timer_get_time() - t0);
+}
+
+// Inner loop: the eight filters share each input sample and sit in flat
+// arrays, so the compiler can keep them in registers / vectorise them.
+void DtmfDetector::runBlock_(Channel& ch, const int16_t* x, std::size_t n) {
+  int32_t s1[kTones];
+  int32_t s2[kTones];
+  for (std::size_t i = 0; i < kTones; ++i) { s1[i] = ch.s1[i]; s2[i] = ch.s2[i]; }
+  int64_t energy = ch.energy;
+
+  for (std::size_t j = 0; j < n; ++j) {
+    const int32_t in = x[j];
+    energy += static_cast<int64_t>(in) * in;
+    for (std::size_t i = 0; i < kTones; ++i) {
+      const int32_t s0 = in + static_cast<int32_t>((static_cast<int64_t>(coeffQ14_[i]) * s1[i]) >> 14) - s2[i];
+      s2[i] = s1[i];
+      s1[i] = s0;
+    }
+  }
+
+  for (std::size_t i = 0; i < kTones; ++i) { ch.s1[i] = s1[i]; ch.s2[i] = s2[i]; }
+  ch.energy = energy;
+}
+
+char DtmfDetector::evaluate_(Channel& ch) {
+  constexpr int64_t kMinEnergy = static_cast<int64_t>(kBlock) * cfg::dtmf::MIN_RMS * cfg::dtmf::MIN_RMS;
+  if (ch.energy < kMinEnergy) return '\0';
+
+  int64_t p[kTones];
+  for (std::size_t i = 0; i < kTones; ++i) p[i] = power(ch.s1[i], ch.s2[i], coeffQ14_[i]);
+
+  const int row = strongest(p, 4);
+  const int col = strongest(p + 4, 4);
+  const int64_t pr = p[row];
+  const int64_t pc = p[4 + col];
+  if (pr <= 0 || pc <= 0) return '\0';
+
+  // Twist
+  if (pc * 100 > pr * kTwistNormalPct) return '\0';
+  if (pr * 100 > pc * kTwistReversePct) return '\0';
+
+  // The other tones in each group must be well below the peak
+  for (int i = 0; i < 4; ++i) {
+    if (i != row && p[i] * kPeakRatio > pr) return '\0';
+    if (i != col && p[4 + i] * kPeakRatio > pc) return '\0';
+  }
+
+  // A pure tone of energy E gives |X|^2 = N*E/2; speech and noise spread out
+  if ((pr + pc) * 100 < kEnergyPct * static_cast<int64_t>(kBlock) * (ch.energy / 2)) return '\0';
+
+  return kKeys[row][col];
+}
+
+void DtmfDetector::validate_(uint8_t channel, Channel& ch, char digit) {
+  if (digit == '\0') {
+    if (ch.gapBlocks < 2 && ++ch.gapBlocks == 2) ch.reported = '\0';
+  } else {
+    ch.gapBlocks = 0;
+    if (digit == ch.lastBlock && digit != ch.reported) {
+      ch.reported = digit;
+      ch.stats.digits++;
+      if (digitCallback_) digitCallback_(channel, digit);
+    }
+  }
+  ch.lastBlock = digit;
+}
+
+uint32_t DtmfDetector::cpuPermille(uint8_t channel) const {
+  const Stats& st = stats(channel);
+  if (st.samples == 0) return 0;
+  // busyUs / (samples / rate) seconds of audio, in permille
+  return static_cast<uint32_t>(st.busyUs * cfg::dtmf::SAMPLE_RATE_HZ / (st.samples * 1000u));
+}
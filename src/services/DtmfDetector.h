@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include "config.h"
+
+// Software DTMF decoder: a fixed-point Goertzel bank (4 row + 4 column
+// tones) per channel, evaluated once per BLOCK_SAMPLES block. A block holds
+// a digit when one row and one column tone stand out, their twist is within
+// limits and together they carry most of the block energy. A digit is reported
+// after two equal blocks and re-armed after two blocks without it.
+// Channels are independent, so every line can dial at the same time; digits
+// go to the callback, normally ToneReader::acceptDigit.
+class DtmfDetector {
+public:
+  static constexpr std::size_t kTones = 8;
+  static constexpr std::size_t kBlock = cfg::dtmf::BLOCK_SAMPLES;
+
+  DtmfDetector();
+
+  using DigitCallback = std::function<void(uint8_t /*channel*/, char /*digit*/)>;
+  void setDigitCallback(DigitCallback cb) { digitCallback_ = std::move(cb); }
+
+  // Feed mono samples at cfg::dtmf::SAMPLE_RATE_HZ for one channel
+  void process(uint8_t channel, const int16_t* samples, std::size_t count);
+  void reset(uint8_t channel);
+
+  // Per-channel load: processing time per second of audio, in permille of one core
+  struct Stats {
+    uint32_t blocks = 0;
+    uint32_t digits = 0;
+    uint64_t samples = 0;
+    uint64_t busyUs = 0;
+  };
+  const Stats& stats(uint8_t channel) const { return channels_[channel < cfg::dtmf::MAX_CHANNELS ? channel : 0].stats; }
+  uint32_t cpuPermille(uint8_t channel) const;
+
+private:
+  struct Channel {
+    int32_t s1[kTones] = {};
+    int32_t s2[kTones] = {};
+    int64_t energy = 0;
+    std::size_t count = 0;
+    char lastBlock = '\0';      // Digit seen in the previous block
+    char reported = '\0';       // Digit reported and still present
+    uint8_t gapBlocks = 0;
+    Stats stats;
+  };
+
+  void runBlock_(Channel& ch, const int16_t* x, std::size_t n);
+  char evaluate_(Channel& ch);
+  void validate_(uint8_t channel, Channel& ch, char digit);
+
+  int32_t coeffQ14_[kTones];
+  Channel channels_[cfg::dtmf::MAX_CHANNELS];
+  DigitCallback digitCallback_;
+};
@@ -1,15 +1,35 @@
 #include "LineAction.h"
-#include "net/MqttClient.h"
 
 
 LineAction::LineAction(LineManager& lineManager, Settings& settings, MT8816Driver& mt8816Driver, RingGenerator& ringGenerator, ToneReader& toneReader,
             ToneGenerator& toneGenerator,
-            ConnectionHandler& connectionHandler, net::MqttClient& mqttClient)
+            ConnectionHandler& connectionHandler)
           : lineManager_(lineManager), settings_(settings), mt8816Driver_(mt8816Driver), ringGenerator_(ringGenerator), toneReader_(toneReader),
-            toneGenerator_(toneGenerator), connectionHandler_(connectionHandler), mqttClient_(mqttClient) {
+            toneGenerator_(toneGenerator), connectionHandler_(connectionHandler) {
 };
 
 void LineAction::begin() {
+  // ToneGenerator decides when a line gets (or loses) a tone; we switch the crosspoint
+  toneGenerator_.setAttachCallback([this](uint8_t lineIndex, uint8_t dac) {
+    LineHandler& line = lineManager_.getLine(lineIndex);
+    connectionHandler_.connectAudioToLine(line.lineNumber, dac);
+    // A dual tone attaches two DACs; the first one is the session's handle
+    if (line.toneGenUsed == 0) {
+      line.toneGenUsed = dac;
+      recordDialToneLatency_(line);
+    }
+
+    if (settings_.debugLALevel >= 2) {
+      Serial.println("LineAction: Assigned DAC " + String(dac) + " to line " + String(line.lineNumber));
+      util::UIConsole::log("Assigned DAC " + String(dac) + " to line " + String(line.lineNumber), "LineAction");
+    }
+  });
+
+  toneGenerator_.setDetachCallback([this](uint8_t lineIndex, uint8_t dac) {
+    LineHandler& line = lineManager_.getLine(lineIndex);
+    connectionHandler_.disconnectAudioToLine(line.lineNumber, dac);
+    line.toneGenUsed = 0;
+  });
 }
 
 // Main update loop to check for line status changes and timer expirations
@@ -26,64 +46,21 @@ void LineAction::update() {
 // Check for hook status changes and update line status accordingly
 void LineAction::hookStatusCangeCheck() {
 
-  if(lineManager_.lineHookChangeFlag != 0){
-    uint8_t hookChanges = lineManager_.lineHookChangeFlag & settings_.activeLinesMask;
+  if(lineManager_.lineHookChangeFlag.any()){
+    const model::LineMask hookChanges = lineManager_.lineHookChangeFlag & settings_.activeLinesMask;
 
     // loop through lines with hook status changes and update line status accordingly
-    for (int index = 0; index < 8; ++index)
-      if (hookChanges & (1 << index)) {
-        lineManager_.lineHookChangeFlag &= ~(1 << index); // Clear the hook change flag
-        LineHandler& line = lineManager_.getLine(index);
-        uint8_t incomingFrom = line.incomingFrom; // Store incomingFrom before any potential status changes
-
-      // Update line status based on hook state
-
-      // Hook ON -> Hook OFF & Line status = Idle
-      if (line.previousHookStatus == model::HookStatus::On 
-        && line.currentHookStatus == model::HookStatus::Off 
-        && line.currentLineStatus == model::LineStatus::Idle) {
-
-        // New call - set status to Ready
-        lineManager_.setStatus(index, model::LineStatus::Ready);
-        
-      // Hook ON -> Hook OFF & Line status = Incoming
-      } else if (line.previousHookStatus == model::HookStatus::On
-        && line.currentHookStatus == model::HookStatus::Off
-        && line.currentLineStatus == model::LineStatus::Incoming) {
-
-        // Answer the call - set status to Connected and update connection info
-        lineManager_.setStatus(incomingFrom, model::LineStatus::Connected);
-        line.outgoingTo = incomingFrom;
-        lineManager_.getLine(incomingFrom).incomingFrom = index;
-        lineManager_.setStatus(index, model::LineStatus::Connected);
-          
-      // Hook OFF -> Hook ON & Line status = Connected
-      } else if (line.previousHookStatus == model::HookStatus::Off 
-        && line.currentHookStatus == model::HookStatus::On 
-        && line.currentLineStatus == model::LineStatus::Connected) {
-        
-        lineManager_.setStatus(incomingFrom, model::LineStatus::Disconnected);
-        lineManager_.setStatus(index, model::LineStatus::Idle);
-
-      // Hook OFF -> Hook ON & Line status = Disconnected (other party already hung up)
-      } else if (line.previousHookStatus == model::HookStatus::Off 
-        && line.currentHookStatus == model::HookStatus::On 
-        && line.currentLineStatus == model::LineStatus::Disconnected) {
-        
-        lineManager_.setStatus(index, model::LineStatus::Idle);
-      
-      // Hook OFF -> Hook ON & Line status = Ringing (caller hangs up while phone is ringing)
-      } else if (line.previousHookStatus == model::HookStatus::Off 
-        && line.currentHookStatus == model::HookStatus::On
-        && line.currentLineStatus == model::LineStatus::Ringing) {
-        
-        lineManager_.setStatus(line.outgoingTo, model::LineStatus::Idle);
-        lineManager_.setStatus(index, model::LineStatus::Idle);
-        
-      // Hook OFF -> Hook ON: For any other status, if the hook is put back on, we set the line to Idle
-      } else {
-        lineManager_.setStatus(index, model::LineStatus::Idle);
+    for (uint8_t index : hookChanges) {
+      lineManager_.lineHookChangeFlag.reset(index); // Clear the hook change flag
+      LineHandler& line = lineManager_.getLine(index);
+
+      model::LineEvent event = model::LineEvent::HookOther;
+      if (line.previousHookStatus == model::HookStatus::On && line.currentHookStatus == model::HookStatus::Off) {
+        event = model::LineEvent::HookOff;
+      } else if (line.previousHookStatus == model::HookStatus::Off && line.currentHookStatus == model::HookStatus::On) {
+        event = model::LineEvent::HookOn;
       }
+      applyTransition_(line, event);
 
       // Update previous hook status after processing the change
       line.previousHookStatus = line.currentHookStatus;
@@ -91,12 +68,42 @@ void LineAction::hookStatusCangeCheck() {
   }
 }
 
+// One lookup in model::kTransitions decides what a hook change or timer does
+void LineAction::applyTransition_(LineHandler& line, model::LineEvent event) {
+  const int index = line.lineNumber;
+  const model::Transition& t = model::transitionFor(line.currentLineStatus, event);
+
+  switch (t.kind) {
+    case model::TransitionKind::Stay:
+      return;
+
+    case model::TransitionKind::RouteDialed:
+      routeDialed_(line);
+      return;
+
+    case model::TransitionKind::Set:
+      break;
+  }
+
+  // Read the peer before any setStatus(), Idle clears the call fields
+  const int peer = (t.peer == model::Peer::IncomingFrom) ? line.incomingFrom
+                 : (t.peer == model::Peer::OutgoingTo)   ? line.outgoingTo
+                                                          : -1;
+  if (t.peer != model::Peer::None) {
+    lineManager_.setStatus(peer, t.peerNext);
+  }
+  if (t.link) {
+    line.outgoingTo = peer;
+    lineManager_.getLine(peer).incomingFrom = index;
+  }
+  lineManager_.setStatus(index, t.next);
+}
+
 // Check for line status changes and handle actions
 void LineAction::statusChangeCheck() {
-  if(lineManager_.lineStatusChangeFlag != 0){
-    uint8_t changes = lineManager_.lineStatusChangeFlag & settings_.activeLinesMask;
-    for (int index = 0; index < 8; ++index)
-      if (changes & (1 << index)) {
+  if(lineManager_.lineStatusChangeFlag.any()){
+    const model::LineMask changes = lineManager_.lineStatusChangeFlag & settings_.activeLinesMask;
+    for (uint8_t index : changes) {
         lineManager_.clearChangeFlag(index); // Clear the change flag
         // Handle the action for the line
         action(index);
@@ -106,195 +113,101 @@ void LineAction::statusChangeCheck() {
 
 // Check for timer expirations and handle them
 void LineAction::timerExpiredCheck() {
-  if(lineManager_.activeTimersMask != 0){
+  if(lineManager_.activeTimersMask.any()){
     unsigned long currentTime = millis();
-    uint8_t timers = lineManager_.activeTimersMask & settings_.activeLinesMask;
+    const model::LineMask timers = lineManager_.activeTimersMask & settings_.activeLinesMask;
 
-    for (int index = 0; index < 8; ++index)
-        if (timers & (1 << index)) {
+    for (uint8_t index : timers) {
           LineHandler& line = lineManager_.getLine(index);
           if (line.lineTimerEnd != -1 && currentTime >= line.lineTimerEnd) {
             // Timer has expired
-            lineManager_.activeTimersMask &= ~(1 << index); // Clear the timer active flag
+            lineManager_.activeTimersMask.reset(index); // Clear the timer active flag
             timerExpired(line);
           }
       } 
   }
 }
 
-// Handles actions based on new line status
+// Handles actions based on new line status (model::kEntryActions)
 void LineAction::action(int index) {
   using namespace model;
   LineHandler& line = lineManager_.getLine(index);
-  LineStatus newStatus = line.currentLineStatus;
-  LineStatus previousStatus = line.previousLineStatus;
-
-  mqttClient_.publishLineStatus(index); // Publish line status to MQTT
-
-  switch (newStatus) {
-    
-    case LineStatus::Idle:
-      turnOffToneGenIfUsed(line);
-      ringGenerator_.stopRingingLine(index);
-      break;
-
-    case LineStatus::Ready:
-      startToneGenForStatus(line, model::ToneId::Ready);
-      break;
-    
-    case LineStatus::PulseDialing:
-      turnOffToneGenIfUsed(line);
-      break;
-    
-    case LineStatus::ToneDialing:
-      turnOffToneGenIfUsed(line);
-      break;
-    
-    case LineStatus::Ringing:
-      turnOffToneGenIfUsed(line);
-      startToneGenForStatus(line, model::ToneId::Ring);
-      lineManager_.setLineTimer(index, settings_.timer_Ringing);
-      break;
-    
-    case LineStatus::Incoming:
-      //ringGenerator_.generateRingSignal(index);
-      lineManager_.setLineTimer(index, settings_.timer_incomming);
-      break;
-    
-    case LineStatus::Connected:
-      turnOffToneGenIfUsed(line);
-      ringGenerator_.stopRingingLine(index);
-      connectionHandler_.connectLines(index, line.incomingFrom);
-      break;
-    
-    case LineStatus::Busy:
-      turnOffToneGenIfUsed(line);
-      startToneGenForStatus(line, model::ToneId::Busy);
-      lineManager_.setLineTimer(index, settings_.timer_busy);
-      break;
-
-    case LineStatus::Fail:
-      turnOffToneGenIfUsed(line);
-      startToneGenForStatus(line, model::ToneId::Fail);
-      lineManager_.setLineTimer(index, settings_.timer_fail);
-      break;
-
-    case LineStatus::Disconnected:
-      turnOffToneGenIfUsed(line);
-      lineManager_.setLineTimer(index, settings_.timer_disconnected);
-      connectionHandler_.disconnectLines(index, line.incomingFrom);
-      break;
-    
-    case LineStatus::Timeout:
-      turnOffToneGenIfUsed(line);
-      lineManager_.setLineTimer(index, settings_.timer_timeout);
-      break;
-    
-    case LineStatus::Abandoned:
-      turnOffToneGenIfUsed(line);
-      lineManager_.setLineTimer(index, settings_.timer_timeout);
-      break;
-    
-    case LineStatus::Operator:
-      break;
+  const EntryAction& a = entryActionFor(line.currentLineStatus);
+
+  if (a.flags & kReleaseTone)     turnOffToneGenIfUsed(line);
+  if (a.flags & kStopRing)        ringGenerator_.stopRingingLine(index);
+  if (a.flags & kDisconnectLines) connectionHandler_.disconnectLines(index, line.incomingFrom);
+  if (a.flags & kConnectLines)    connectionHandler_.connectLines(index, line.incomingFrom);
+  if (a.flags & kNoteConnected)   ringGenerator_.noteConnected(index);
+  if (a.flags & kStartTone)       startToneGenForStatus(line, a.tone);
+  if (a.flags & kSetTimer)        lineManager_.setLineTimer(index, timerLimit_(a.timer));
+}
 
-    default:
-      break;
+unsigned long LineAction::timerLimit_(model::LineTimer timer) const {
+  switch (timer) {
+    case model::LineTimer::Ringing:      return settings_.timer_Ringing;
+    case model::LineTimer::Incoming:     return settings_.timer_incomming;
+    case model::LineTimer::Busy:         return settings_.timer_busy;
+    case model::LineTimer::Fail:         return settings_.timer_fail;
+    case model::LineTimer::Disconnected: return settings_.timer_disconnected;
+    case model::LineTimer::Timeout:      return settings_.timer_timeout;
+    case model::LineTimer::None:         break;
   }
+  return 0;
 }
 
 // Handles a line when its timer has expired
 void LineAction::timerExpired(LineHandler& line) {
-  using namespace model;
-  int index = line.lineNumber;
-  LineStatus currentStatus = line.currentLineStatus;
-
   if (settings_.debugLALevel >= 1) {
-    Serial.println("LineAction: Timer expired for line " + String(index) + " in state " + model::LineStatusToString(currentStatus));
-    util::UIConsole::log("LineAction: Timer expired for line " + String(index) + " in state " + model::LineStatusToString(currentStatus), "LineAction");
+    Serial.println("LineAction: Timer expired for line " + String(line.lineNumber) + " in state " + model::LineStatusToString(line.currentLineStatus));
+    util::UIConsole::log("LineAction: Timer expired for line " + String(line.lineNumber) + " in state " + model::LineStatusToString(line.currentLineStatus), "LineAction");
   }
+  applyTransition_(line, model::LineEvent::TimerExpired);
+}
 
-  switch (currentStatus) {
-    case LineStatus::Ready:
-      lineManager_.setStatus(index, LineStatus::Timeout);
-      break;
-
-    case LineStatus::ToneDialing:
-    case LineStatus::PulseDialing: {
-      
-      int lineCalled = lineManager_.searchPhoneNumber(line.dialedDigits);
-      if (settings_.debugLALevel >= 1) {
-        Serial.println("LineAction: ToneDialing line " + String(index) + " dialed digits: " + line.dialedDigits + ", found lineCalled: " + String(lineCalled));
-        util::UIConsole::log("ToneDialing line " + String(index) + " dialed digits: " + line.dialedDigits + ", found lineCalled: " + String(lineCalled), "LineAction");
-      }
-      
-      if (lineCalled == index){
-        Serial.println(RED "LineAction: Line " + String(index) + " dialed its own number. Setting to Fail." + COLOR_RESET);
-        lineManager_.setStatus(index, LineStatus::Fail);
-        break;
-      }
-
-      // Check if a matching phone number was found
-      if (lineCalled != -1){
-
-        // Check if the line that is being called is active
-        if (!lineManager_.getLine(lineCalled).lineActive){
-          Serial.println(RED "LineAction: Line " + String(lineCalled) + " is not active. Setting to Fail." + COLOR_RESET);
-          lineManager_.setStatus(index, LineStatus::Fail);
-          return;
-        }
-        
-        // Check if the called line is idle
-        if (lineManager_.getLine(lineCalled).currentLineStatus != LineStatus::Idle){
-          Serial.println(RED "LineAction: Line " + String(lineCalled) + " is not idle. Setting line " + String(index) + " to Busy." + COLOR_RESET);
-          lineManager_.setStatus(index, LineStatus::Busy);
-          return;
-        }
-
-        // Changing status for the calling line and the called line to start the ringing process
-        line.outgoingTo = lineCalled;
-        lineManager_.getLine(lineCalled).incomingFrom = index;
-        lineManager_.setStatus(index, LineStatus::Ringing);
-        lineManager_.setStatus(lineCalled, LineStatus::Incoming);
-      }
-      // No matching phone number found
-      else {
-        Serial.println(RED "LineAction: No matching phone number found for line " + String(index) + " dialed digits: " + line.dialedDigits + COLOR_RESET);
-        lineManager_.setStatus(index, LineStatus::Fail);
-      }
-          
-      break;
-    }
-
-    case LineStatus::Ringing:
-      lineManager_.setStatus(index, LineStatus::Disconnected);
-      break;
-
-    case LineStatus::Incoming:
-      lineManager_.setStatus(index, LineStatus::Idle);
-      break;
-
-    case LineStatus::Busy:
-      lineManager_.setStatus(index, LineStatus::Timeout);
-      break;
-
-    case LineStatus::Fail:
-      lineManager_.setStatus(index, LineStatus::Timeout);
-      break;
-
-    case LineStatus::Disconnected:
-      lineManager_.setStatus(index, LineStatus::Timeout);
-      break;
-
-    case LineStatus::Timeout:
-      lineManager_.setStatus(index, LineStatus::Abandoned);
+// Dialing finished (timer ran out): find the called line and start ringing, or Busy/Fail
+void LineAction::routeDialed_(LineHandler& line) {
+  using namespace model;
+  const int index = line.lineNumber;
 
-      break;
+  int lineCalled = lineManager_.searchPhoneNumber(line.dialedDigits);
+  if (settings_.debugLALevel >= 1) {
+    Serial.println("LineAction: ToneDialing line " + String(index) + " dialed digits: " + line.dialedDigits + ", found lineCalled: " + String(lineCalled));
+    util::UIConsole::log("ToneDialing line " + String(index) + " dialed digits: " + line.dialedDigits + ", found lineCalled: " + String(lineCalled), "LineAction");
+  }
+  
+  if (lineCalled == index){
+    Serial.println(RED "LineAction: Line " + String(index) + " dialed its own number. Setting to Fail." + COLOR_RESET);
+    lineManager_.setStatus(index, LineStatus::Fail);
+    return;
+  }
 
-    default:
+  // No matching phone number found
+  if (lineCalled == -1){
+    Serial.println(RED "LineAction: No matching phone number found for line " + String(index) + " dialed digits: " + line.dialedDigits + COLOR_RESET);
+    lineManager_.setStatus(index, LineStatus::Fail);
+    return;
+  }
 
-      break;
+  // Check if the line that is being called is active
+  if (!lineManager_.getLine(lineCalled).lineActive){
+    Serial.println(RED "LineAction: Line " + String(lineCalled) + " is not active. Setting to Fail." + COLOR_RESET);
+    lineManager_.setStatus(index, LineStatus::Fail);
+    return;
+  }
+  
+  // Check if the called line is idle
+  if (lineManager_.getLine(lineCalled).currentLineStatus != LineStatus::Idle){
+    Serial.println(RED "LineAction: Line " + String(lineCalled) + " is not idle. Setting line " + String(index) + " to Busy." + COLOR_RESET);
+    lineManager_.setStatus(index, LineStatus::Busy);
+    return;
   }
+
+  // Changing status for the calling line and the called line to start the ringing process
+  line.outgoingTo = lineCalled;
+  lineManager_.getLine(lineCalled).incomingFrom = index;
+  lineManager_.setStatus(index, LineStatus::Ringing);
+  lineManager_.setStatus(lineCalled, LineStatus::Incoming);
 }
 
 // Start tone generator for specific line status
@@ -308,40 +221,42 @@ void LineAction::startToneGenForStatus(LineHandler& line, model::ToneId status)
     util::UIConsole::log("Starting tone generator for line " + String(line.lineNumber) + " with status " + ToneIdToString(status), "LineAction");
   }
 
-  const uint8_t dac = toneGenerator_.startTone(status);
-  if (dac == 0) {
-    Serial.println(RED "LineAction: All tone generators are busy! Cannot play tone for line " + String(line.lineNumber) + COLOR_RESET);
-    util::UIConsole::log("All tone generators are busy! Cannot play tone for line " + String(line.lineNumber), "LineAction");
+  // Shared session: lines needing the same tone are bridged to one generator.
+  // The crosspoint is switched from the attach callback, now or when the line
+  // leaves the wait queue.
+  const uint8_t dac = toneGenerator_.requestTone(line.lineNumber, status);
+  if (dac == 0 && settings_.debugLALevel >= 1) {
+    Serial.println(YELLOW "LineAction: All tone generators are busy, line " + String(line.lineNumber) + " waits for a tone" COLOR_RESET);
+    util::UIConsole::log("All tone generators are busy, line " + String(line.lineNumber) + " waits for a tone", "LineAction");
+  }
+}
+
+// Hook-off to dial tone latency, measured once per hook-off
+void LineAction::recordDialToneLatency_(LineHandler& line) {
+  if (line.hookOffAtUs == 0 || line.currentLineStatus != model::LineStatus::Ready) {
     return;
   }
 
-  line.toneGenUsed = dac;
-  connectionHandler_.connectAudioToLine(line.lineNumber, dac);
+  const uint32_t latencyUs = static_cast<uint32_t>(micros()) - line.hookOffAtUs;
+  line.hookOffAtUs = 0;
+
+  DialToneLatency& stats = settings_.toneReadyPrearmed ? latencyPrearmed_ : latencyCold_;
+  stats.count++;
+  stats.sumUs += latencyUs;
+  if (latencyUs > stats.maxUs) stats.maxUs = latencyUs;
 
   if (settings_.debugLALevel >= 2) {
-    Serial.println("LineAction: Assigned DAC " + String(dac) + " to line " + String(line.lineNumber));
-    util::UIConsole::log("Assigned DAC " + String(dac) + " to line " + String(line.lineNumber), "LineAction");
+    const char* mode = settings_.toneReadyPrearmed ? "prearmed" : "cold";
+    Serial.println("LineAction: Dial tone on line " + String(line.lineNumber) + " after " + String(latencyUs) + " us (" + mode +
+                   ", avg " + String(stats.sumUs / stats.count) + " us, max " + String(stats.maxUs) + " us)");
+    util::UIConsole::log("Dial tone on line " + String(line.lineNumber) + " after " + String(latencyUs) + " us (" + mode +
+                         ", avg " + String(stats.sumUs / stats.count) + " us, max " + String(stats.maxUs) + " us)", "LineAction");
   }
 }
 
-// Turn off tone generator if it is being used by the line
+// Turn off tone generator if it is being used by the line (or drop its place in the queue)
 void LineAction::turnOffToneGenIfUsed(LineHandler& line) {
-  if (line.toneGenUsed == 0) {
-    return;
-  }
-
-  switch (line.toneGenUsed) {
-    case cfg::mt8816::DAC1:
-    case cfg::mt8816::DAC2:
-    case cfg::mt8816::DAC3:
-      toneGenerator_.stopTone(line.toneGenUsed);
-      break;
-    default:
-      // Invalid mapping, clear state to avoid repeated faults.
-      line.toneGenUsed = 0;
-      return;
-  }
-
-  connectionHandler_.disconnectAudioToLine(line.lineNumber, line.toneGenUsed); // Disconnect line from tone generator
+  connectionHandler_.stopAnnouncement(line.lineNumber);   // An announcement is the line's tone too
+  toneGenerator_.releaseLine(line.lineNumber);
   line.toneGenUsed = 0;
 }
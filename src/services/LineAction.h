@@ -2,6 +2,7 @@
 #include <Arduino.h>
 #include "drivers/MT8816Driver.h"
 #include "model/Types.h"
+#include "model/LineStateTable.h"
 #include "settings/Settings.h"
 #include "LineManager.h"
 #include "services/RingGenerator.h"
@@ -9,19 +10,25 @@
 #include "services/ConnectionHandler.h"
 #include "services/ToneGenerator.h"
 
-namespace net { class MqttClient; }
-
 class LineAction {
 public:
   LineAction(LineManager& lineManager, Settings& settings, MT8816Driver& mt8816Driver, RingGenerator& ringGenerator,
              ToneReader& toneReader,
              ToneGenerator& toneGenerator,
-             ConnectionHandler& connectionHandler, net::MqttClient& mqttClient);
+             ConnectionHandler& connectionHandler);
   
   void begin();
   void update();
   void action(int index);
 
+  // Stable hook-off -> dial tone connected, split by pre-armed/cold start
+  struct DialToneLatency {
+    uint32_t count = 0;
+    uint32_t sumUs = 0;
+    uint32_t maxUs = 0;
+  };
+  const DialToneLatency& dialToneLatency(bool prearmed) const { return prearmed ? latencyPrearmed_ : latencyCold_; }
+
 private:
   LineManager& lineManager_;
   Settings&    settings_;
@@ -30,7 +37,6 @@ private:
   ToneReader& toneReader_;
   ToneGenerator& toneGenerator_;
   ConnectionHandler& connectionHandler_;
-  net::MqttClient& mqttClient_;
 
   void hookStatusCangeCheck();
   void statusChangeCheck();
@@ -39,4 +45,11 @@ private:
   void turnOffToneGenIfUsed(LineHandler& line);
   void startToneGenForStatus(LineHandler& line, model::ToneId status);
   void timerExpired(LineHandler& line);
+  void applyTransition_(LineHandler& line, model::LineEvent event);
+  void routeDialed_(LineHandler& line);
+  unsigned long timerLimit_(model::LineTimer timer) const;
+
+  DialToneLatency latencyPrearmed_;
+  DialToneLatency latencyCold_;
+  void recordDialToneLatency_(LineHandler& line);
 };
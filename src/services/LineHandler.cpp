@@ -31,6 +31,7 @@ LineHandler::LineHandler(int line) {
     currentHookStatus = HookStatus::On;
     previousHookStatus = HookStatus::On;
     SHK = 0;
+    hookOffAtUs = 0;
     dialedDigits = "";
     lineTimerEnd = -1;
 }
@@ -28,6 +28,7 @@ public:
     HookStatus currentHookStatus;       // Status of the hook (hook on/off)
     HookStatus previousHookStatus;      // Previous status of the hook
     bool SHK;                           // Current state of the SHK pin (0 = hook on, 1 = hook off)
+    uint32_t hookOffAtUs;               // micros() of the last stable hook-off (dial tone latency), 0 = none
 
     // Pulsing variables
     unsigned gap;                       // Time from last edge
@@ -5,22 +5,21 @@
 
 LineManager::LineManager(Settings& settings)
 :settings_(settings){
-  lines.reserve(8);
+  lines.reserve(cfg::lines::MAX_LINES);
 
   auto& s = Settings::instance();   // singleton
-  for (int i = 0; i < 8; ++i) {
+  for (int i = 0; i < static_cast<int>(cfg::lines::MAX_LINES); ++i) {
     lines.emplace_back(i);
     lines.back().phoneNumber = s.linePhoneNumbers[i];
     lines.back().lineName = s.lineNames[i];
-    bool isActive = ((s.activeLinesMask >> i) & 0x01) != 0;
-    lines.back().lineActive = isActive;
+    lines.back().lineActive = s.activeLinesMask.test(i);
   }
-  lineStatusChangeFlag = 0;     // Intiate to zero (no changes)
-  lineHookChangeFlag = 0;       // Intiate to zero (no hook changes)
-  activeTimersMask = 0;         // Intiate to zero (no active timers)
-  linesNotIdle = 0;             // Intiate to zero (all lines idle)
+  lineStatusChangeFlag.clear(); // Intiate to zero (no changes)
+  lineHookChangeFlag.clear();   // Intiate to zero (no hook changes)
+  activeTimersMask.clear();     // Intiate to zero (no active timers)
+  linesNotIdle.clear();         // Intiate to zero (all lines idle)
   lastLineReady = -1;           // No line is ready at start
-  toneScanMask = 0;             // Intiate to zero (no lines to scan for tones)
+  toneScanMask.clear();         // Intiate to zero (no lines to scan for tones)
 }
 
 void LineManager::begin() {
@@ -31,8 +30,7 @@ void LineManager::begin() {
 
 void LineManager::syncLineActive(size_t i) {
   auto& settings_ = Settings::instance();
-  bool isActive = ((settings_.activeLinesMask >> i) & 0x01) != 0;
-  lines[i].lineActive = isActive;
+  lines[i].lineActive = settings_.activeLinesMask.test(i);
 }
 
 // Returns a reference to the LineHandler object for the specified line index
@@ -67,14 +65,14 @@ void LineManager::setStatus(int index, LineStatus newStatus) {
   switch (newStatus) {
     case LineStatus::Idle:
       lines[index].lineIdle();          // Reset line variables when setting to Idle
-      linesNotIdle &= ~(1 << index);    // Clear the bit for this line
-      toneScanMask &= ~(1 << index);    // Clear the bit to stop scanning this line for tones
+      linesNotIdle.reset(index);        // Clear the bit for this line
+      toneScanMask.reset(index);        // Clear the bit to stop scanning this line for tones
       if (lastLineReady == index) {     // Reset lastLineReady if this was the line that was last ready
         lastLineReady = -1;
       }
 
       // Deactivate MT8870 if no lines need tone scanning
-      if (toneScanMask == 0 && toneReader_ != nullptr) {  
+      if (toneScanMask.none() && toneReader_ != nullptr) {  
         toneReader_->deactivate();
       }
       break;
@@ -83,8 +81,8 @@ void LineManager::setStatus(int index, LineStatus newStatus) {
     case LineStatus::ToneDialing:
     case LineStatus::PulseDialing:
       lastLineReady = index;             // Update the most recent line used for tone scanning
-      linesNotIdle |= (1 << index);      // Set the bit for this line
-      toneScanMask |= (1 << index);      // Set the bit to scan this line for tones
+      linesNotIdle.set(index);           // Set the bit for this line
+      toneScanMask.set(index);           // Set the bit to scan this line for tones
 
       // Activate MT8870 if not already active
       if (toneReader_ != nullptr && !toneReader_->isActive) {
@@ -93,10 +91,10 @@ void LineManager::setStatus(int index, LineStatus newStatus) {
       break;
   
     default:
-      linesNotIdle &= ~(1 << index);     // Clear the bit for this line since we do not need to scan for 
+      linesNotIdle.reset(index);         // Clear the bit for this line since we do not need to scan for 
                                          // tones in lines that are not Ready or PulseDialing
-      toneScanMask &= ~(1 << index);
-      if (toneScanMask == 0 && toneReader_ != nullptr) {
+      toneScanMask.reset(index);
+      if (toneScanMask.none() && toneReader_ != nullptr) {
         toneReader_->deactivate();
       }
       break;
@@ -104,21 +102,50 @@ void LineManager::setStatus(int index, LineStatus newStatus) {
 
   // No matther what the new status is, we want to set the lineStatusChangeFlag so that LineAction 
   // can handle any necessary actions based on the new status
-  lineStatusChangeFlag |= (1 << index);           
-  for (auto& cb : statusChangedCallbacks_) {
-    if (cb) cb(index, newStatus);
-  }
+  lineStatusChangeFlag.set(index);
+  statusEvents.post({static_cast<uint32_t>(millis()), static_cast<uint8_t>(index),
+                     lines[index].previousLineStatus, newStatus});
+}
 
-  if (settings_.debugLmLevel >= 0) {
-    Serial.print(BLUE "LineManager: Line ");
-    Serial.print(index);
-    Serial.print(" status changed to ");
-    Serial.print(model::LineStatusToString(newStatus));
-    Serial.println(COLOR_RESET);
-    util::UIConsole::log("Line " + String(index) + " status changed to " + model::LineStatusToString(newStatus), "LineManager");
+void LineManager::requestStatus(int index, LineStatus newStatus) {
+  if (index < 0 || index >= static_cast<int>(cfg::lines::MAX_LINES)) {
+    return;
   }
+  portENTER_CRITICAL(&requestMux_);
+  requestedStatus_[index] = newStatus;
+  requestedMask_.set(static_cast<size_t>(index));
+  portEXIT_CRITICAL(&requestMux_);
+}
 
-  
+// Apply status requests from other tasks, then log status changes outside
+// setStatus(), from the main loop
+void LineManager::update() {
+  LineStatus requested[cfg::lines::MAX_LINES];
+  portENTER_CRITICAL(&requestMux_);
+  const model::LineMask pending = requestedMask_;
+  for (uint8_t i : pending) requested[i] = requestedStatus_[i];
+  requestedMask_.clear();
+  portEXIT_CRITICAL(&requestMux_);
+
+  for (uint8_t i : pending) setStatus(i, requested[i]);
+
+  model::LineStatusEvent ev;
+  while (statusEvents.poll(logCursor_, ev)) {
+    if (settings_.debugLmLevel >= 0) {
+      Serial.print(BLUE "LineManager: Line ");
+      Serial.print(ev.line);
+      Serial.print(" status changed to ");
+      Serial.print(model::LineStatusToString(ev.to));
+      Serial.println(COLOR_RESET);
+      util::UIConsole::log("Line " + String(ev.line) + " status changed to " + model::LineStatusToString(ev.to), "LineManager");
+    }
+  }
+  if (logCursor_.dropped > 0) {
+    if (settings_.debugLmLevel >= 1) {
+      util::UIConsole::log("Status log missed " + String(logCursor_.dropped) + " events", "LineManager");
+    }
+    logCursor_.dropped = 0;
+  }
 }
 
 // Clear the status change flag for the specified line
@@ -130,17 +157,7 @@ void LineManager::clearChangeFlag(int index) {
     return;
   }
   // Clear the change flag for the specified line
-  lineStatusChangeFlag &= ~(1 << index); 
-}
-
-// 
-void LineManager::setStatusChangedCallback(StatusChangedCallback cb) {
-  statusChangedCallbacks_.clear();
-  if (cb) statusChangedCallbacks_.push_back(std::move(cb));
-}
-
-void LineManager::addStatusChangedCallback(StatusChangedCallback cb) {
-  if (cb) statusChangedCallbacks_.push_back(std::move(cb));
+  lineStatusChangeFlag.reset(index);
 }
 
 // Set a timer for the specified line
@@ -163,7 +180,7 @@ void LineManager::setLineTimer(int index, unsigned int limit) {
                           " with limit " + String(limit) + " ms", "LineManager");
     }
     lines[index].lineTimerEnd = millis() + limit;
-    activeTimersMask |= (1 << index);  // Set the timer active flag
+    activeTimersMask.set(index);  // Set the timer active flag
   }
 }
 
@@ -183,7 +200,7 @@ void LineManager::resetLineTimer(int index) {
     util::UIConsole::log("LineManager: Resetting timer for line " + String(index), "LineManager");
   }
   lines[index].lineTimerEnd = -1;
-  activeTimersMask &= ~(1 << index); // Clear the timer active flag
+  activeTimersMask.reset(index); // Clear the timer active flag
 }
 
 // Set the phone number for the specified line
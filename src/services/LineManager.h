@@ -1,8 +1,11 @@
 #pragma once
 #include <functional>
 #include <vector>
+#include "config.h"
 #include "settings/settings.h"
 #include "model/Types.h"
+#include "model/LineSet.h"
+#include "util/EventBus.h"
 #include "util/UIConsole.h"
 #include "LineHandler.h"
 
@@ -12,9 +15,13 @@ class LineManager {
 public:
   LineManager(Settings& settings);
   void begin();
+  void update();
   void setToneReader(ToneReader* toneReader) { toneReader_ = toneReader; };
   void syncLineActive(size_t i);
   void setStatus(int index, LineStatus newStatus);
+  // From other tasks (AsyncTCP web handlers): the change is queued and
+  // applied by update() on the loop, so setStatus() stays single-threaded.
+  void requestStatus(int index, LineStatus newStatus);
   void clearChangeFlag(int index);
   void setLineTimer(int index, unsigned int limit);
   void resetLineTimer(int index);
@@ -22,21 +29,22 @@ public:
   void setLineName(int index, const String& value);
   int searchPhoneNumber(const String& phoneNumber);
 
-  using StatusChangedCallback = std::function<void(int /*lineIndex*/, model::LineStatus)>;
-  using ActiveLinesChangedCallback = std::function<void(uint8_t)>;
-
-  // Callback functions for webserver
-  void setStatusChangedCallback(StatusChangedCallback cb);
-  void addStatusChangedCallback(StatusChangedCallback cb);
+  using ActiveLinesChangedCallback = std::function<void(const model::LineMask&)>;
   void setActiveLinesChangedCallback(ActiveLinesChangedCallback cb);
 
+  // Status changes are posted here instead of calling listeners from inside
+  // setStatus(). WebServer (SSE), MqttClient and the log in update() each
+  // subscribe a cursor and drain it from their own loop step.
+  using StatusEventBus = util::EventBus<model::LineStatusEvent, cfg::lines::STATUS_EVENT_CAPACITY>;
+  StatusEventBus statusEvents;
+
   LineHandler& getLine(int index);
 
-  uint8_t lineStatusChangeFlag; // Bitmask for lines with status changes
-  uint8_t lineHookChangeFlag;   // Bitmask for lines with hook status changes
-  uint8_t activeTimersMask;     // Bitmask for active line timers
-  uint8_t linesNotIdle;         // Bitmask for lines that are not Idle
-  uint8_t toneScanMask;         // Bitmask for lines that should be scanned for tones
+  model::LineMask lineStatusChangeFlag; // Bitmask for lines with status changes
+  model::LineMask lineHookChangeFlag;   // Bitmask for lines with hook status changes
+  model::LineMask activeTimersMask;     // Bitmask for active line timers
+  model::LineMask linesNotIdle;         // Bitmask for lines that are not Idle
+  model::LineMask toneScanMask;         // Bitmask for lines that should be scanned for tones
 
   int lastLineReady;   // Most recent line that became Ready (for toneReader)
 
@@ -46,6 +54,11 @@ private:
   
   Settings& settings_;
   ToneReader* toneReader_ = nullptr;
-  std::vector<StatusChangedCallback> statusChangedCallbacks_;
+  StatusEventBus::Cursor logCursor_;
+
+  // Latest requestStatus() per line, taken over by update()
+  portMUX_TYPE requestMux_ = portMUX_INITIALIZER_UNLOCKED;
+  model::LineMask requestedMask_;
+  LineStatus requestedStatus_[cfg::lines::MAX_LINES] = {};
 
 };
@@ -0,0 +1,65 @@
+#include "services/PcmPack.h"
+#include <math.h>
+
+namespace {
+  using Mode = PCMDriver::SampleWordMode;
+
+  template <Mode M>
+  inline void store(void* out, size_t i, int16_t s) {
+    if (M == Mode::Bits16) {
+      static_cast<int16_t*>(out)[i] = s;
+    } else {
+      static_cast<int32_t*>(out)[i] = pcm::toSlot32(s, M);
+    }
+  }
+
+  // One instantiation per (slot layout, channel count, gain) so the inner
+  // loop has no branches; unity gain skips the multiply entirely.
+  template <Mode M, bool Mono, bool Gain>
+  void packLoop(const int16_t* in, size_t frames, int32_t gainQ12, void* out) {
+    for (size_t f = 0; f < frames; ++f) {
+      int16_t l = Mono ? in[f] : in[2 * f];
+      int16_t r = Mono ? l : in[2 * f + 1];
+      if (Gain) {
+        l = pcm::applyGain(l, gainQ12);
+        r = Mono ? l : pcm::applyGain(r, gainQ12);
+      }
+      store<M>(out, 2 * f, l);
+      store<M>(out, 2 * f + 1, r);
+    }
+  }
+
+  template <Mode M>
+  void packMode(const int16_t* in, size_t frames, bool mono, int32_t gainQ12, void* out) {
+    const bool gain = (gainQ12 != pcm::kUnityGain);
+    if (mono) {
+      gain ? packLoop<M, true, true>(in, frames, gainQ12, out)
+           : packLoop<M, true, false>(in, frames, gainQ12, out);
+    } else {
+      gain ? packLoop<M, false, true>(in, frames, gainQ12, out)
+           : packLoop<M, false, false>(in, frames, gainQ12, out);
+    }
+  }
+}
+
+namespace pcm {
+
+  int32_t gainFromFloat(float gain) {
+    if (!(gain > 0.0f)) return 0;
+    const long q = lrintf(gain * static_cast<float>(kUnityGain));
+    return (q > kMaxGain) ? kMaxGain : static_cast<int32_t>(q);
+  }
+
+  size_t pack(const int16_t* in, size_t frames, uint8_t channels, int32_t gainQ12,
+              PCMDriver::SampleWordMode mode, void* out) {
+    if (in == nullptr || out == nullptr || frames == 0) return 0;
+    const bool mono = (channels == 1);
+
+    switch (mode) {
+      case Mode::Bits16:       packMode<Mode::Bits16>(in, frames, mono, gainQ12, out); break;
+      case Mode::Bits32High16: packMode<Mode::Bits32High16>(in, frames, mono, gainQ12, out); break;
+      case Mode::Bits32Low16:  packMode<Mode::Bits32Low16>(in, frames, mono, gainQ12, out); break;
+    }
+    return frames * frameBytes(mode);
+  }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "drivers/PCMDriver.h"
+
+// Fused output kernels for AudioPlayer: gain, saturation, mono->stereo and
+// I2S slot packing in one pass over the samples. Gain is Q12 fixed point
+// (kUnityGain = 1.0), so the hot loop is one multiply, divide and clamp. The
+// divide truncates toward zero like the float cast it replaced, so gains the
+// float product holds exactly give the same samples as the old float path.
+namespace pcm {
+
+  constexpr int kGainShift = 12;
+  constexpr int32_t kUnityGain = 1 << kGainShift;
+  constexpr int32_t kMaxGain = (8 << kGainShift) - 1;   // Just under 8x
+
+  int32_t gainFromFloat(float gain);
+
+  inline int16_t applyGain(int16_t s, int32_t gainQ12) {
+    int32_t v = (static_cast<int32_t>(s) * gainQ12) / kUnityGain;
+    if (v > 32767) v = 32767;
+    else if (v < -32768) v = -32768;
+    return static_cast<int16_t>(v);
+  }
+
+  // One sample into the 32-bit slot layout of the given word mode (not Bits16)
+  inline int32_t toSlot32(int16_t s, PCMDriver::SampleWordMode mode) {
+    return (mode == PCMDriver::SampleWordMode::Bits32High16)
+               ? static_cast<int32_t>(static_cast<uint32_t>(static_cast<uint16_t>(s)) << 16)
+               : static_cast<int32_t>(static_cast<uint16_t>(s));
+  }
+
+  // Bytes one stereo output frame takes in the given word mode
+  inline size_t frameBytes(PCMDriver::SampleWordMode mode) {
+    return (mode == PCMDriver::SampleWordMode::Bits16) ? 2u * sizeof(int16_t) : 2u * sizeof(int32_t);
+  }
+
+  // frames input frames (1 or 2 channels, interleaved) -> stereo frames in out.
+  // out must hold frames * frameBytes(mode). Returns the number of bytes written.
+  size_t pack(const int16_t* in, size_t frames, uint8_t channels, int32_t gainQ12,
+              PCMDriver::SampleWordMode mode, void* out);
+}
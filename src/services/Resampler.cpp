@@ -0,0 +1,51 @@
+#include "services/Resampler.h"
+#include <math.h>
+#include <string.h>
+
+bool Resampler::configure(uint32_t inRateHz, uint32_t outRateHz, uint8_t channels) {
+  if (inRateHz == 0 || outRateHz == 0 || (channels != 1 && channels != 2)) {
+    return false;
+  }
+  channels_ = channels;
+  bypass_ = (inRateHz == outRateHz);
+  step_ = static_cast<uint32_t>((static_cast<uint64_t>(inRateHz) << 16) / outRateHz);
+  reset();
+
+  // Same ratio as last time: the filter bank is still valid
+  if (bypass_ || (inRateHz == inRate_ && outRateHz == outRate_)) {
+    return true;
+  }
+  inRate_ = inRateHz;
+  outRate_ = outRateHz;
+
+  // Windowed sinc, cut off below the lower of the two Nyquist rates
+  const float ratio = static_cast<float>(outRateHz) / static_cast<float>(inRateHz);
+  const float fc = 0.9f * (ratio < 1.0f ? ratio : 1.0f);
+  const float half = static_cast<float>(kTaps) / 2.0f;
+
+  for (std::size_t p = 0; p < kPhases; ++p) {
+    float taps[kTaps];
+    float sum = 0.0f;
+    for (std::size_t i = 0; i < kTaps; ++i) {
+      // Tap i multiplies input n-(kTaps-1-i); distance to the output instant in input samples
+      const float x = static_cast<float>(kTaps - 1 - i) - half + static_cast<float>(p) / kPhases;
+      const float arg = static_cast<float>(M_PI) * fc * x;
+      const float sinc = (fabsf(arg) < 1e-6f) ? 1.0f : sinf(arg) / arg;
+      const float w = 0.42f + 0.5f * cosf(static_cast<float>(M_PI) * x / half) +
+                      0.08f * cosf(2.0f * static_cast<float>(M_PI) * x / half);   // Blackman
+      taps[i] = sinc * (fabsf(x) <= half ? w : 0.0f);
+      sum += taps[i];
+    }
+    // Unity DC gain per phase so the phases do not modulate the level
+    for (std::size_t i = 0; i < kTaps; ++i) {
+      coeffs_[p][i] = static_cast<int16_t>(lrintf(taps[i] / sum * 16384.0f));
+    }
+  }
+  return true;
+}
+
+void Resampler::reset() {
+  memset(history_, 0, sizeof(history_));
+  pos_ = 0;
+  acc_ = 0;
+}
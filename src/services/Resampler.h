@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Streaming polyphase resampler, fixed point (Q14 coefficients, int32 MAC).
+// Converts any clip rate to the fixed I2S output rate so the I2S clock is set
+// once at boot. The output position is tracked as a Q16 fraction of an input
+// sample and mapped to one of kPhases precomputed windowed-sinc filters.
+// Equal rates bypass the filter entirely.
+class Resampler {
+public:
+  static constexpr std::size_t kTaps = 16;        // Per phase
+  static constexpr std::size_t kPhaseBits = 5;
+  static constexpr std::size_t kPhases = 1u << kPhaseBits;
+
+  bool configure(uint32_t inRateHz, uint32_t outRateHz, uint8_t channels);
+  void reset();
+  bool bypass() const { return bypass_; }
+
+  // Push one input frame; calls sink(left, right) for every output frame.
+  // Returns false as soon as the sink does.
+  template <class Sink>
+  bool push(int16_t left, int16_t right, Sink&& sink) {
+    write_(0, left);
+    if (channels_ == 2) write_(1, right);
+    pos_ = (pos_ + 1) % kTaps;
+
+    while (acc_ < kOne) {
+      const int16_t* h = coeffs_[acc_ >> (16 - kPhaseBits)];
+      const int16_t l = dot_(h, history_[0] + pos_);
+      const int16_t r = (channels_ == 2) ? dot_(h, history_[1] + pos_) : l;
+      if (!sink(l, r)) return false;
+      acc_ += step_;
+    }
+    acc_ -= kOne;
+    return true;
+  }
+
+private:
+  static constexpr uint32_t kOne = 1u << 16;
+
+  void write_(int ch, int16_t s) {
+    history_[ch][pos_] = s;            // Doubled so the window is always contiguous
+    history_[ch][pos_ + kTaps] = s;
+  }
+
+  // Oldest -> newest sample against coefficients stored in the same order
+  static int16_t dot_(const int16_t* h, const int16_t* x) {
+    int32_t acc = 1 << 13;             // Rounding for the Q14 shift
+    for (std::size_t i = 0; i < kTaps; ++i) {
+      acc += static_cast<int32_t>(h[i]) * x[i];
+    }
+    acc >>= 14;
+    if (acc > 32767) acc = 32767;
+    else if (acc < -32768) acc = -32768;
+    return static_cast<int16_t>(acc);
+  }
+
+  int16_t coeffs_[kPhases][kTaps] = {};
+  int16_t history_[2][2 * kTaps] = {};
+  std::size_t pos_ = 0;
+  uint32_t acc_ = 0;            // Q16 position of the next output after the newest input
+  uint32_t step_ = kOne;        // Q16 input samples per output sample
+  uint32_t inRate_ = 0;
+  uint32_t outRate_ = 0;
+  uint8_t channels_ = 2;
+  bool bypass_ = true;
+};
@@ -22,24 +22,22 @@ void RingGenerator::generateRingSignal(uint8_t lineNumber) {
     return;
   }
 
-  // Start ringing for the specified line
+  // Queue the first burst; update() starts it as soon as a slot is free
   auto& lineState = lineStates_[lineNumber];
   lineState.currentIteration = 0;
-  lineState.state = model::RingState::RingToggling;
+  lineState.state = model::RingState::RingPause;
+  lineState.waiting = true;
+  lineState.waitSince = millis();
+  answerPending_.reset(lineNumber);
 
   if (settings_.debugRGLevel >= 2) {
-    Serial.println("RingGenerator: Line " + String(lineNumber) + " set to RingToggling");
+    Serial.println("RingGenerator: Line " + String(lineNumber) + " queued for ringing");
   }
 
   lineState.stateStartTime = millis();
-  lineState.lastFRToggleTime = millis();
   lineState.frPinState = false;
   lineState.rmPinState = false;
 
-  // Determine which MCP address to use for this line
-  uint8_t mcpAddr = (lineNumber < 4) ? cfg::mcp::MCP_SLIC1_ADDRESS : cfg::mcp::MCP_SLIC2_ADDRESS;
-  uint8_t rmPin = cfg::mcp::RM_PINS[lineNumber];
-  
   if (settings_.debugRGLevel >= 1) {
     Serial.println("RingGenerator: Started ringing for line " + String(lineNumber));
   }
@@ -62,17 +60,11 @@ void RingGenerator::stopRingingLine(uint8_t lineNumber) {
     return;
   }
 
-  // Determine which MCP address to use for this line
-  uint8_t mcpAddr = (lineNumber < 4) ? cfg::mcp::MCP_SLIC1_ADDRESS : cfg::mcp::MCP_SLIC2_ADDRESS;
-  
-  // Set both FR and RM pins LOW
-  uint8_t frPin = cfg::mcp::FR_PINS[lineNumber];
-  uint8_t rmPin = cfg::mcp::RM_PINS[lineNumber];
-  
-  mcpDriver_.digitalWriteMCP(mcpAddr, frPin, LOW);
-  mcpDriver_.digitalWriteMCP(mcpAddr, rmPin, LOW);
-
+  // Drop FR and RM at once (ring trip must not wait for the next update)
   lineState.state = model::RingState::RingIdle;
+  lineState.waiting = false;
+  writeBank_(static_cast<uint8_t>(lineNumber / cfg::lines::LINES_PER_BANK));
+  setShkMasked_(lineNumber, false);
 
   if (settings_.debugRGLevel >= 1) {
     Serial.println("RingGenerator: Stopped ringing for line " + String(lineNumber));
@@ -82,7 +74,7 @@ void RingGenerator::stopRingingLine(uint8_t lineNumber) {
 void RingGenerator::update() {
   unsigned long currentTime = millis();
 
-  // Process each line independently
+  // Process each line independently; pins are written per bank below
   for (uint8_t lineNumber = 0; lineNumber < cfg::mcp::SHK_LINE_COUNT; lineNumber++) {
     auto& lineState = lineStates_[lineNumber];
 
@@ -101,34 +93,10 @@ void RingGenerator::update() {
       continue;
     }
 
-    uint8_t mcpAddr = (lineNumber < 4) ? cfg::mcp::MCP_SLIC1_ADDRESS : cfg::mcp::MCP_SLIC2_ADDRESS;
-    uint8_t frPin = cfg::mcp::FR_PINS[lineNumber];
-
     switch (lineState.state) {
       case model::RingState::RingToggling: {
-
-        // Set RM pin HIGH to activate ring mode
-        if (!lineState.rmPinState) {
-          mcpDriver_.digitalWriteMCP(mcpAddr, cfg::mcp::RM_PINS[lineNumber], HIGH);
-          lineState.rmPinState = true;
-        }
-
-        // Toggle FR pin at 20 Hz (50ms period: 25ms HIGH, 25ms LOW)
-        if (currentTime - lineState.lastFRToggleTime >= 25) {
-          lineState.frPinState = !lineState.frPinState;
-          mcpDriver_.digitalWriteMCP(mcpAddr, frPin, lineState.frPinState);
-          lineState.lastFRToggleTime = currentTime;
-          if (settings_.debugRGLevel >= 2) {
-            Serial.println("RingGenerator: Toggling FR pin to " + String(lineState.frPinState) + " on Line " + String(lineNumber));
-          }
-        }
-
         // Check if ring signal duration has elapsed
         if (currentTime - lineState.stateStartTime >= settings_.ringLengthMs) {
-          // Stop FR pin toggling, set it LOW
-          mcpDriver_.digitalWriteMCP(mcpAddr, frPin, LOW);
-          lineState.frPinState = false;
-
           lineState.currentIteration++;
           
           if (lineState.currentIteration >= settings_.ringIterations) {
@@ -139,9 +107,11 @@ void RingGenerator::update() {
                            " completed all " + String(settings_.ringIterations) + " ring iterations");
             }
           } else {
-            // Move to pause state
+            // Move to pause state, FR goes LOW with the bank write
             lineState.state = model::RingState::RingPause;
             lineState.stateStartTime = currentTime;
+            writeBank_(static_cast<uint8_t>(lineNumber / cfg::lines::LINES_PER_BANK));
+            setShkMasked_(lineNumber, false);
             if (settings_.debugRGLevel >= 2) {
               Serial.println("RingGenerator: Line " + String(lineNumber) + 
                            " ring iteration " + String(lineState.currentIteration) + 
@@ -153,19 +123,10 @@ void RingGenerator::update() {
       }
 
       case model::RingState::RingPause: {
-        // Check if pause duration has elapsed
-        if (currentTime - lineState.stateStartTime >= settings_.ringPauseMs) {
-          // Start next ring signal
-          lineState.state = model::RingState::RingToggling;
-          lineState.stateStartTime = currentTime;
-          lineState.lastFRToggleTime = currentTime;
-          lineState.frPinState = false;
-          lineState.rmPinState = false;
-
-          if (settings_.debugRGLevel >= 2) {
-            Serial.println("RingGenerator: Line " + String(lineNumber) + 
-                         " starting ring iteration " + String(lineState.currentIteration + 1));
-          }
+        // Pause over: the next burst waits for grantBursts_()
+        if (!lineState.waiting && currentTime - lineState.stateStartTime >= settings_.ringPauseMs) {
+          lineState.waiting = true;
+          lineState.waitSince = currentTime;
         }
         break;
       }
@@ -175,4 +136,191 @@ void RingGenerator::update() {
         break;
     }
   }
-}
\ No newline at end of file
+
+  grantBursts_(currentTime);
+
+  // Shared 20 Hz phase per bank (50ms period: 25ms HIGH, 25ms LOW)
+  for (uint8_t bank = 0; bank < cfg::lines::SLIC_BANK_COUNT; bank++) {
+    auto& clock = bankClocks_[bank];
+    bool toggling = false;
+    for (uint8_t k = 0; k < cfg::lines::LINES_PER_BANK; k++) {
+      if (lineStates_[bank * cfg::lines::LINES_PER_BANK + k].state == model::RingState::RingToggling) {
+        toggling = true;
+        break;
+      }
+    }
+
+    if (!toggling) {
+      if (clock.running && settings_.debugRGLevel >= 2) {
+        Serial.println("RingGenerator: Bank " + String(bank) + " clock stopped, " +
+                       String(stats_.bankWrites) + " OLAT writes, " + String(stats_.writeErrors) + " errors, peak " +
+                       String(stats_.peakConcurrent) + " ringers, " + String(stats_.deferredBursts) + " deferred bursts");
+      }
+      clock.running = false;
+    } else if (!clock.running) {
+      clock.running = true;
+      clock.phase = false;
+      clock.lastFlipTime = currentTime;
+      clock.edgeTime = currentTime;
+      clock.tripSampled = false;
+    } else if (currentTime - clock.lastFlipTime >= kFrHalfPeriodMs) {
+      clock.phase = !clock.phase;
+      // Stay on the 25 ms grid unless the loop fell a whole half period behind
+      clock.lastFlipTime += kFrHalfPeriodMs;
+      if (currentTime - clock.lastFlipTime >= kFrHalfPeriodMs) clock.lastFlipTime = currentTime;
+      clock.edgeTime = currentTime;
+      clock.tripSampled = false;
+      stats_.phaseFlips++;
+      if (settings_.debugRGLevel >= 3) {
+        Serial.println("RingGenerator: Bank " + String(bank) + " FR phase " + String(clock.phase));
+      }
+    }
+
+    writeBank_(bank);
+  }
+}
+
+// Start waiting bursts, longest wait first, while fewer than
+// maxConcurrentRingers lines are toggling. While another line is mid-burst a
+// waiting one is held even if a slot is free, so it starts in that line's
+// pause instead of ringing in phase with it; after one ringPauseMs of waiting
+// it shares the burst instead. A held-back line just gets a longer pause;
+// burst length and iteration count are unchanged. With no limit (0) every
+// burst starts at once.
+void RingGenerator::grantBursts_(unsigned long now) {
+  uint8_t toggling = 0;
+  for (uint8_t line = 0; line < cfg::mcp::SHK_LINE_COUNT; line++) {
+    if (lineStates_[line].state == model::RingState::RingToggling) toggling++;
+  }
+
+  const uint8_t limit = settings_.maxConcurrentRingers;
+  while (limit == 0 || toggling < limit) {
+    int8_t next = -1;
+    for (uint8_t line = 0; line < cfg::mcp::SHK_LINE_COUNT; line++) {
+      const auto& ls = lineStates_[line];
+      if (ls.state != model::RingState::RingPause || !ls.waiting) continue;
+      if (next < 0 || (long)(ls.waitSince - lineStates_[next].waitSince) < 0) next = static_cast<int8_t>(line);
+    }
+    if (next < 0) break;
+
+    auto& lineState = lineStates_[next];
+    const uint32_t waited = now - lineState.waitSince;
+    if (limit != 0 && toggling > 0 && waited < settings_.ringPauseMs) break;
+    if (waited > kFrHalfPeriodMs) stats_.deferredBursts++;
+    if (waited > stats_.maxWaitMs) stats_.maxWaitMs = waited;
+
+    lineState.waiting = false;
+    lineState.state = model::RingState::RingToggling;
+    lineState.stateStartTime = now;
+    setShkMasked_(static_cast<uint8_t>(next), true);
+    toggling++;
+
+    if (settings_.debugRGLevel >= 2) {
+      Serial.println("RingGenerator: Line " + String(next) + 
+                     " starting ring iteration " + String(lineState.currentIteration + 1) +
+                     (waited > kFrHalfPeriodMs ? " after waiting " + String(waited) + "ms" : String("")));
+    }
+  }
+
+  if (toggling > stats_.peakConcurrent) stats_.peakConcurrent = toggling;
+}
+
+model::LineMask RingGenerator::takeTripSamplesDue(unsigned long now) {
+  model::LineMask due;
+  for (uint8_t bank = 0; bank < cfg::lines::SLIC_BANK_COUNT; bank++) {
+    auto& clock = bankClocks_[bank];
+    if (!clock.running || clock.tripSampled) continue;
+
+    const unsigned long sinceEdge = now - clock.edgeTime;
+    if (sinceEdge < cfg::ring::TRIP_SAMPLE_OFFSET_MS) continue;
+    clock.tripSampled = true;
+    if (sinceEdge > cfg::ring::TRIP_SAMPLE_LATE_MS) continue;   // Too close to the next edge
+
+    for (uint8_t k = 0; k < cfg::lines::LINES_PER_BANK; k++) {
+      const uint8_t line = bank * cfg::lines::LINES_PER_BANK + k;
+      if (shkMasked_.test(line)) due.set(line);
+    }
+  }
+  return due;
+}
+
+void RingGenerator::noteAnswer(uint8_t lineNumber, unsigned long offHookMs) {
+  if (lineNumber >= cfg::mcp::SHK_LINE_COUNT || answerPending_.test(lineNumber)) return;
+  answerMs_[lineNumber] = offHookMs;
+  answerPending_.set(lineNumber);
+}
+
+void RingGenerator::noteConnected(uint8_t lineNumber) {
+  if (!answerPending_.test(lineNumber)) return;
+  answerPending_.reset(lineNumber);
+
+  const uint32_t latency = millis() - answerMs_[lineNumber];
+  uint8_t bucket = 0;
+  while (bucket < AnswerLatency::kBuckets - 1 && latency >= AnswerLatency::kUpperMs[bucket]) bucket++;
+  answerLatency_.counts[bucket]++;
+  answerLatency_.lastMs = latency;
+  if (latency > answerLatency_.maxMs) answerLatency_.maxMs = latency;
+
+  if (settings_.debugRGLevel >= 1) {
+    String hist;
+    for (uint8_t i = 0; i < AnswerLatency::kBuckets; i++) {
+      if (i) hist += "/";
+      hist += String(answerLatency_.counts[i]);
+    }
+    Serial.println("RingGenerator: Line " + String(lineNumber) + " answer-to-connect " + String(latency) +
+                   " ms (max " + String(answerLatency_.maxMs) + ", <25/50/100/200/500/1000/2000/more: " + hist + ")");
+    util::UIConsole::log("Line " + String(lineNumber) + " answer-to-connect " + String(latency) + " ms", "RingGenerator");
+  }
+}
+
+// SHK interrupt off while the line rings, back on (with a reconcile) when FR stops
+void RingGenerator::setShkMasked_(uint8_t line, bool masked) {
+  if (shkMasked_.test(line) == masked) return;
+
+  if (!mcpDriver_.setShkInterruptEnabled(line, !masked) && settings_.debugRGLevel >= 1) {
+    Serial.println("RingGenerator: GPINTEN write failed for line " + String(line));
+  }
+  // Software mask applies even if the write failed, so the storm is still dropped
+  shkMasked_.assign(line, masked);
+  if (!masked) shkReconcile_.set(line);
+}
+
+// Compose FR/RM for every line on the bank and hand them to the OLAT shadow;
+// nothing goes on the bus unless a pin actually changes.
+void RingGenerator::writeBank_(uint8_t bank) {
+  if (bank >= cfg::lines::SLIC_BANK_COUNT) return;
+
+  const auto& clock = bankClocks_[bank];
+  uint16_t mask = 0;
+  uint16_t bits = 0;
+  for (uint8_t k = 0; k < cfg::lines::LINES_PER_BANK; k++) {
+    const uint8_t line = bank * cfg::lines::LINES_PER_BANK + k;
+    auto& lineState = lineStates_[line];
+    const uint16_t fr = static_cast<uint16_t>(1u << cfg::mcp::FR_PINS[line]);
+    const uint16_t rm = static_cast<uint16_t>(1u << cfg::mcp::RM_PINS[line]);
+    mask |= fr | rm;
+
+    switch (lineState.state) {
+      case model::RingState::RingToggling:
+        lineState.rmPinState = true;             // RM HIGH activates ring mode
+        lineState.frPinState = clock.running && clock.phase;
+        break;
+      case model::RingState::RingPause:
+        lineState.frPinState = false;            // RM stays HIGH between bursts
+        break;
+      case model::RingState::RingIdle:
+        lineState.frPinState = false;
+        lineState.rmPinState = false;
+        break;
+    }
+    if (lineState.frPinState) bits |= fr;
+    if (lineState.rmPinState) bits |= rm;
+  }
+
+  const uint32_t before = mcpDriver_.slicOlatWrites();
+  if (!mcpDriver_.writeSlicOutputs(bank, mask, bits)) {
+    stats_.writeErrors++;
+    return;
+  }
+  stats_.bankWrites += mcpDriver_.slicOlatWrites() - before;
+}
@@ -4,6 +4,7 @@
 #include "drivers/MCPDriver.h"
 #include "Settings.h"
 #include "model/Types.h"
+#include "model/LineSet.h"
 
 class LineManager;
 
@@ -15,6 +16,46 @@ class RingGenerator {
     void stopRinging();
     void stopRingingLine(uint8_t lineNumber);
 
+    // Bus load: OLAT writes issued and phase flips of the bank clocks.
+    // Scheduler: most lines in a burst at once, bursts held back by the limit
+    // and the longest extra pause that caused.
+    struct Stats {
+      uint32_t bankWrites = 0;
+      uint32_t writeErrors = 0;
+      uint32_t phaseFlips = 0;
+      uint8_t  peakConcurrent = 0;
+      uint32_t deferredBursts = 0;
+      uint32_t maxWaitMs = 0;
+    };
+    const Stats& stats() const { return stats_; }
+
+    // Lines whose SHK interrupt is masked while FR toggles; SHKService samples
+    // them for ring trip instead. takeShkReconcile() returns (and clears) the
+    // lines unmasked since the last call, whose hook state must be re-read.
+    model::LineMask shkMaskedLines() const { return shkMasked_; }
+
+    // Masked lines on banks that reached the ring-trip sample point of the
+    // current FR half cycle (once per half cycle; late half cycles are skipped).
+    model::LineMask takeTripSamplesDue(unsigned long now);
+
+    // Answer-to-connect latency: SHKService reports when the handset went off
+    // hook on an incoming call, LineAction when the call is connected.
+    struct AnswerLatency {
+      static constexpr uint8_t  kBuckets = 8;
+      static constexpr uint16_t kUpperMs[kBuckets - 1] = {25, 50, 100, 200, 500, 1000, 2000};
+      uint32_t counts[kBuckets] = {};
+      uint32_t lastMs = 0;
+      uint32_t maxMs = 0;
+    };
+    void noteAnswer(uint8_t lineNumber, unsigned long offHookMs);
+    void noteConnected(uint8_t lineNumber);
+    const AnswerLatency& answerLatency() const { return answerLatency_; }
+    model::LineMask takeShkReconcile() {
+      const model::LineMask lines = shkReconcile_;
+      shkReconcile_.clear();
+      return lines;
+    }
+
     MCPDriver& mcpDriver_;
     Settings& settings_;
     LineManager& lineManager_;
@@ -24,10 +65,36 @@ class RingGenerator {
       model::RingState state = model::RingState::RingIdle;
       uint32_t currentIteration = 0;
       unsigned long stateStartTime = 0;
-      unsigned long lastFRToggleTime = 0;
+      bool waiting = false;              // Pause is over, waiting for a burst slot
+      unsigned long waitSince = 0;
       bool frPinState = false; // Current state of FR pin
       bool rmPinState = false; // Current state of RM pin
     };
 
     LineRingState lineStates_[cfg::mcp::SHK_LINE_COUNT]; // State for each line
+
+    // One 20 Hz ring phase per SLIC bank: every toggling line on the bank
+    // follows it, so FR and RM for the whole bank go out in one OLAT write.
+    static constexpr unsigned long kFrHalfPeriodMs = 25;
+    struct BankClock {
+      unsigned long lastFlipTime = 0;
+      unsigned long edgeTime = 0;   // When FR was actually written for this half cycle
+      bool phase = false;
+      bool running = false;
+      bool tripSampled = false;
+    };
+    BankClock bankClocks_[cfg::lines::SLIC_BANK_COUNT];
+    Stats stats_;
+
+  private:
+    void writeBank_(uint8_t bank);
+    void grantBursts_(unsigned long now);
+    void setShkMasked_(uint8_t line, bool masked);
+
+    model::LineMask shkMasked_;
+    model::LineMask shkReconcile_;
+
+    AnswerLatency answerLatency_;
+    model::LineMask answerPending_;
+    unsigned long answerMs_[cfg::mcp::SHK_LINE_COUNT] = {};
 };
\ No newline at end of file
@@ -20,11 +20,11 @@ SHKService::SHKService(LineManager& lineManager, InterruptManager& interruptMana
   lineState_.resize(maxPhysicalLines_);
 
   // Initial read of SHK states; assumes stable at startup.
-  uint32_t raw = readShkMask_();
+  model::LineMask raw = readShkMask_();
   for (std::size_t i = 0; i < maxPhysicalLines_; ++i) {
     auto& line = lineManager_.getLine((int)i);
     if(!line.lineActive) continue;
-    bool rawHigh = (raw >> i) & 0x1;
+    bool rawHigh = raw.test(i);
     auto& sample = lineState_[i];
     sample.hookCand  = rawHigh;
     sample.fastLevel = rawHigh;
@@ -38,15 +38,15 @@ SHKService::SHKService(LineManager& lineManager, InterruptManager& interruptMana
 }
 
 // Notifies SHKService when MCP reports changes (bitmask per line).
-void SHKService::notifyLinesPossiblyChanged(uint32_t changedMask, uint32_t nowMs, bool value) {
-  uint32_t allowMask = settings_.activeLinesMask & settings_.allowMask;
-  changedMask &= allowMask;
-  if (!changedMask) return;
+void SHKService::notifyLinesPossiblyChanged(model::LineMask changedMask, uint32_t nowMs, bool value) {
+  changedMask &= settings_.activeLinesMask & settings_.allowMask;
+  if (changedMask.none()) return;
 
   if (settings_.debugSHKLevel >= 2) {
-    Serial.printf("SHKService: notifyLinesPossiblyChanged mask=0x%X at %u ms, value=%d\n", changedMask, nowMs, value);
+    const unsigned long long maskBits = changedMask.value();
+    Serial.printf("SHKService: notifyLinesPossiblyChanged mask=0x%llX at %u ms, value=%d\n", maskBits, nowMs, value);
     Serial.flush();  // Ensure immediate output
-    util::UIConsole::log("notifyLinesPossiblyChanged mask=0x" + String(changedMask, HEX) + " at " + String(nowMs) + " ms", "SHKService");
+    util::UIConsole::log("notifyLinesPossiblyChanged mask=0x" + String(maskBits, HEX) + " at " + String(nowMs) + " ms", "SHKService");
   }
 
   activeMask_ |= changedMask;
@@ -67,24 +67,23 @@ bool SHKService::tick(uint32_t nowMs) {
 
   if (!burstActive_ || nowMs < burstNextTickAtMs_) return false;
 
-  uint32_t rawMask = readShkMask_();
-  uint32_t nextActiveMask = 0;
+  model::LineMask rawMask = readShkMask_();
+  model::LineMask nextActiveMask;
 
-  for (std::size_t lineIndex = 0; lineIndex < maxPhysicalLines_; ++lineIndex) {
-    // Process only lines that have recently changed or are active in burst.
-    if ((activeMask_ & (1u << lineIndex)) == 0) {
-      // Reset pulse state for inactive lines.
-      resetPulseState_(static_cast<int>(lineIndex));
-      continue;
-    }
+  // Lines outside the burst only need their pulse state cleared.
+  for (uint8_t lineIndex : ~activeMask_) {
+    resetPulseState_(static_cast<int>(lineIndex));
+  }
 
+  // Process only lines that have recently changed or are active in burst.
+  for (uint8_t lineIndex : activeMask_) {
     auto& line = lineManager_.getLine(static_cast<int>(lineIndex));
     if (!line.lineActive) {
       resetPulseState_(static_cast<int>(lineIndex));
       continue;
     }
 
-    bool rawHigh = (rawMask >> lineIndex) & 0x1U;
+    bool rawHigh = rawMask.test(lineIndex);
     uint32_t hookStableMs = settings_.hookStableMs;
     updateHookFilter_(static_cast<int>(lineIndex), rawHigh, nowMs, hookStableMs);
     updatePulseDetector_(static_cast<int>(lineIndex), rawHigh, nowMs);
@@ -97,10 +96,10 @@ bool SHKService::tick(uint32_t nowMs) {
     bool pdActive = (sample.pdState != PerLine::PDState::Idle);
 
     // Continue ticking lines that are not yet stable.
-    if (hookUnstable || pdActive) nextActiveMask |= (1u << lineIndex);
+    if (hookUnstable || pdActive) nextActiveMask.set(lineIndex);
   }
   activeMask_ = nextActiveMask;
-  if (activeMask_ == 0) {
+  if (activeMask_.none()) {
     burstActive_ = false;
     if (settings_.debugSHKLevel >= 2) {
       Serial.println("SHKService: burst finished, going idle");
@@ -116,122 +115,116 @@ bool SHKService::tick(uint32_t nowMs) {
 
 // Handles interrupts and triggers line change notifications.
 void SHKService::update() {
-  // Poll all SLIC1 events
-  while (true) {
-    IntResult read = interruptManager_.pollEventByAddress(cfg::mcp::MCP_SLIC1_ADDRESS);
-    if (!read.hasEvent) break;
+  // Poll all SLIC events, bank by bank
+  for (uint8_t bank = 0; bank < cfg::lines::SLIC_BANK_COUNT; ++bank) {
+    while (true) {
+      IntResult read = interruptManager_.pollEventByAddress(cfg::mcp::SLIC_BANK_ADDR[bank]);
+      if (!read.hasEvent) break;
+
+      // Masked while ringing; drop anything latched before the mask took effect.
+      if (ringGenerator_.shkMaskedLines().test(read.line)) {
+        continue;
+      }
 
-    // Ignore SHK changes during ringing due to a interference error.
-    if (ringGenerator_.lineStates_[read.line].state == model::RingState::RingToggling) {
-      continue;
+      if (read.line < cfg::lines::MAX_LINES) {
+        notifyLinesPossiblyChanged(model::LineMask::single(read.line), millis(), read.level);
+        yield();
+      }
     }
+  }
 
-    if (read.line < 8) {
-      uint32_t mask = (1u << read.line);
-      notifyLinesPossiblyChanged(mask, millis(), read.level);
-      yield();
-    }
+  uint32_t nowMs = millis();
+
+  // Ringing lines have their SHK interrupt masked: sample them once per FR
+  // half cycle, mid-cycle, instead.
+  const model::LineMask ringing = ringGenerator_.shkMaskedLines();
+  for (uint8_t lineIndex : ~ringing) {
+    if (lineIndex < lineState_.size()) lineState_[lineIndex].tripRun = 0;
+  }
+  const model::LineMask due = ringGenerator_.takeTripSamplesDue(nowMs) & settings_.activeLinesMask & settings_.allowMask;
+  if (due.any()) {
+    sampleRingTrip_(due, nowMs);
   }
-  
-  // Poll all SLIC2 events
-  while (true) {
-    IntResult read = interruptManager_.pollEventByAddress(cfg::mcp::MCP_SLIC2_ADDRESS);
-    if (!read.hasEvent) break;
-
-    // Ignore SHK changes during ringing due to a interference error.
-    if (ringGenerator_.lineStates_[read.line].state == model::RingState::RingToggling) {
-      continue;
-    }
 
-    if (read.line < 8) {
-      uint32_t mask = (1u << read.line);
-      notifyLinesPossiblyChanged(mask, millis(), read.level);
-      yield();
-    }
+  // Lines unmasked since last update may have changed level unseen (CHANGE mode
+  // compares against the previous pin value); let a burst re-read them.
+  const model::LineMask reconcile = ringGenerator_.takeShkReconcile();
+  if (reconcile.any()) {
+    notifyLinesPossiblyChanged(reconcile, nowMs, false);
   }
 
-  uint32_t nowMs = millis();
   if (needsTick(nowMs)) {
     tick(nowMs); // Updates hook status and pulses.
   }
 }
 
-// Reads SHK pin states from MCP and returns as bitmask (1 = input high).
-uint32_t SHKService::readShkMask_() const {
-  uint32_t mask = 0;
-
-  // Build a list of required SLIC addresses based on allowMask.
-  uint8_t addrs[2] = {0};
-  uint16_t gpio[2] = {0};
-  bool have[2] = {false, false};
-  int addrCount = 0;
-
-  auto findOrAdd = [&](uint8_t a) -> int {
-    for (int i = 0; i < addrCount; ++i) {
-      if (addrs[i] == a) return i;
-    }
-    if (addrCount < 2) {
-      addrs[addrCount] = a;
-      return addrCount++;
+// Ring-trip detection for lines with a masked SHK interrupt. Samples are taken
+// mid FR half cycle (see RingGenerator::takeTripSamplesDue), away from the
+// edges where the ring signal makes SHK chatter, so TRIP_CONSECUTIVE off-hook
+// readings in a row are enough: pickup is seen within 50-75 ms instead of at
+// the end of the burst. On trip the ringing stops and the off-hook state is
+// set at once; the reconcile burst that follows re-checks it with the normal filter.
+void SHKService::sampleRingTrip_(model::LineMask lines, uint32_t nowMs) {
+  const model::LineMask raw = readShkMask_();
+
+  for (uint8_t lineIndex : lines) {
+    auto& sample = lineState_[lineIndex];
+    const bool rawHigh = raw.test(lineIndex);
+    if (!rawToOffHook_(rawHigh)) {
+      sample.tripRun = 0;
+      continue;
     }
-    return -1;
-  };
+    if (sample.tripRun == 0) sample.tripRunStartMs = nowMs;
+    if (++sample.tripRun < cfg::ring::TRIP_CONSECUTIVE) continue;
 
-  // Collect addresses for allowed lines only.
-  for (std::size_t i = 0; i < maxPhysicalLines_; ++i) {
-    if ((settings_.allowMask & (1u << i)) != 0) {
-      (void)findOrAdd(cfg::mcp::SHK_LINE_ADDR[i]);
+    sample.tripRun = 0;
+    if (settings_.debugSHKLevel >= 1) {
+      Serial.println("SHKService: Ring trip on line " + String(lineIndex) + " after " +
+                     String(nowMs - sample.tripRunStartMs) + " ms");
+      util::UIConsole::log("Ring trip on line " + String(lineIndex), "SHKService");
     }
+    ringGenerator_.noteAnswer(lineIndex, sample.tripRunStartMs);
+    ringGenerator_.stopRingingLine(lineIndex);
+
+    sample.hookCand = rawHigh;
+    sample.hookCandSince = sample.tripRunStartMs;
+    sample.hookCandConsec = 255;
+    setStableHook(lineIndex, true, rawHigh, nowMs);
   }
+}
 
-  // Read each unique SLIC address if present.
-  for (int k = 0; k < addrCount; ++k) {
-    uint8_t a = addrs[k];
-    bool present = true;
-    // Check presence flags for addresses.
-    if (a == cfg::mcp::MCP_SLIC1_ADDRESS && !settings_.mcpSlic1Present) {
-      present = false;
-    }
-    if (a == cfg::mcp::MCP_SLIC2_ADDRESS && !settings_.mcpSlic2Present) {
-      present = false;
-    }
-    if (!present) {
-      have[k] = false; // Skip reading if chip is missing.
-      continue;
-    }
-    uint16_t g = 0;
-    if (mcpDriver_.readGpioAB16(a, g)) {
-      have[k] = true;
-      gpio[k] = g;
-    } else {
-      // If reading fails, treat bank as missing.
-      have[k] = false;
+// Reads SHK pin states from MCP and returns as bitmask (1 = input high).
+// Each present SLIC bank is read once (one 16-bit GPIO read per bank).
+model::LineMask SHKService::readShkMask_() const {
+  model::LineMask mask;
+
+  for (std::size_t bank = 0; bank < cfg::lines::SLIC_BANK_COUNT; ++bank) {
+    const std::size_t firstLine = bank * cfg::lines::LINES_PER_BANK;
+
+    // Skip banks with no allowed lines.
+    bool anyAllowed = false;
+    for (std::size_t i = 0; i < cfg::lines::LINES_PER_BANK; ++i) {
+      if (settings_.allowMask.test(firstLine + i)) { anyAllowed = true; break; }
     }
-  }
+    if (!anyAllowed) continue;
 
-  // Build raw mask for each allowed line.
-  for (std::size_t i = 0; i < maxPhysicalLines_; ++i) {
-    if ((settings_.allowMask & (1u << i)) == 0) {
-      continue; // Line not allowed.
+    // Skip reading if chip is missing.
+    if (!settings_.isSlicBankPresent(bank)) continue;
+
+    uint16_t gpio = 0;
+    if (!mcpDriver_.readGpioAB16(cfg::mcp::SLIC_BANK_ADDR[bank], gpio)) {
+      continue; // If reading fails, treat bank as missing.
     }
-    uint8_t addr = cfg::mcp::SHK_LINE_ADDR[i];
-    uint8_t pin  = cfg::mcp::SHK_PINS[i];
-    // Find index for current address in addrs[].
-    int bank = -1;
-    for (int k = 0; k < addrCount; ++k) {
-      if (addrs[k] == addr) {
-        bank = k;
-        break;
+
+    // Build raw mask for each allowed line on this bank.
+    for (std::size_t i = 0; i < cfg::lines::LINES_PER_BANK; ++i) {
+      const std::size_t line = firstLine + i;
+      if (!settings_.allowMask.test(line)) continue;
+      const uint8_t pin = cfg::mcp::SHK_PINS[line];
+      if ((gpio >> pin) & 0x1U) {
+        mask.set(line); // Set bit in raw mask if level is high.
       }
     }
-    // Skip line if bank is missing/offline.
-    if (bank < 0 || !have[bank]) {
-      continue;
-    }
-    bool val = ((gpio[bank] >> pin) & 0x1U) != 0U; // Read bit from 16-bit GPIO.
-    if (val) {
-      mask |= (1u << i); // Set bit in raw mask if level is high.
-    }
   }
   return mask;
 }
@@ -275,8 +268,13 @@ void SHKService::setStableHook(int index, bool offHook, bool rawHigh, uint32_t n
   if (newHook != line.currentHookStatus) {
     line.currentHookStatus = newHook;
     line.SHK = offHook;
+    line.hookOffAtUs = offHook ? static_cast<uint32_t>(micros()) : 0;
 
-    lineManager_.lineHookChangeFlag |= (1u << index);
+    lineManager_.lineHookChangeFlag.set(index);
+
+    if (offHook && line.currentLineStatus == model::LineStatus::Incoming) {
+      ringGenerator_.noteAnswer(static_cast<uint8_t>(index), sample.hookCandSince);
+    }
 
     //lineManager_.setStatus(index, offHook ? model::LineStatus::Ready : model::LineStatus::Idle);
 
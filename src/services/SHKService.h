@@ -9,13 +9,14 @@
 #include "services/RingGenerator.h"
 #include "settings/Settings.h"
 #include "model/Types.h"
+#include "model/LineSet.h"
 
 class SHKService {
 public:
   SHKService(LineManager& lineManager, InterruptManager& interruptManager, MCPDriver& mcpDriver, Settings& settings, RingGenerator& ringGenerator);
 
   // Kallas när appen sett att MCP rapporterat ändringar (bitmask per linje)
-  void notifyLinesPossiblyChanged(uint32_t changedMask, uint32_t nowMs, bool value);
+  void notifyLinesPossiblyChanged(model::LineMask changedMask, uint32_t nowMs, bool value);
 
   // Anropa från app.loop()
   bool needsTick(uint32_t nowMs) const;
@@ -38,6 +39,10 @@ private:
     uint32_t lastEdgeMs  = 0;    // senaste godkända stigande kant
     uint8_t  pulseCountWork = 0; // pulser i pågående siffra
     uint32_t blockUntilMs = 0;
+
+    // Ring-trip-sampler: antal lur-av-samplingar i rad och när serien började
+    uint8_t  tripRun = 0;
+    uint32_t tripRunStartMs = 0;
   };
 
   // Hjälp
@@ -49,7 +54,7 @@ private:
   }
 
   // I/O
-  uint32_t readShkMask_() const;
+  model::LineMask readShkMask_() const;
 
   // Logik
   void updateHookFilter_(int idx, bool rawHigh, uint32_t nowMs, uint32_t hookStableMs);
@@ -61,6 +66,7 @@ private:
   void emitDigitAndReset_(int idx, bool rawHigh, uint32_t nowMs);
   void resetPulseState_(int idx);
   void resyncFast_(int idx, bool rawHigh, uint32_t nowMs);
+  void sampleRingTrip_(model::LineMask lines, uint32_t nowMs);
 
 private:
   LineManager& lineManager_;
@@ -71,9 +77,9 @@ private:
 
   std::vector<PerLine> lineState_;
 
-  uint32_t activeMask_ = 0;
+  model::LineMask activeMask_;
   bool     burstActive_     = false;
   uint32_t burstNextTickAtMs_ = 0;
-  std::size_t maxPhysicalLines_ = 8;
+  std::size_t maxPhysicalLines_ = cfg::lines::MAX_LINES;
 
 };
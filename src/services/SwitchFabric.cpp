@@ -0,0 +1,176 @@
+#include "services/SwitchFabric.h"
+
+using namespace cfg;
+
+namespace {
+  constexpr size_t kNodeCount = (mt8816::TRUNK_COUNT > 0) ? mt8816::TRUNK_COUNT * 2 : 1;
+
+  // BFS node = trunk traversed in one direction. dir 0: a -> b, dir 1: b -> a.
+  inline const mt8816::TrunkEnd& nearEnd(size_t node) {
+    const auto& t = mt8816::TRUNKS[node / 2];
+    return (node & 1) ? t.b : t.a;
+  }
+  inline const mt8816::TrunkEnd& farEnd(size_t node) {
+    const auto& t = mt8816::TRUNKS[node / 2];
+    return (node & 1) ? t.a : t.b;
+  }
+}
+
+bool SwitchFabric::connectLines(uint8_t lineA, uint8_t lineB) {
+  if (lineA >= lines::MAX_LINES || lineB >= lines::MAX_LINES || lineA == lineB) return false;
+  if (findRoute_(lineA, lineB) != nullptr) return true;
+
+  Route* slot = nullptr;
+  for (auto& r : routes_) {
+    if (!r.used) { slot = &r; break; }
+  }
+
+  Route route;
+  if (slot == nullptr || !findPath_(lineA, lineB, route)) {
+    blockedCalls_++;
+    if (settings_.debugLAC >= 1) {
+      Serial.println("SwitchFabric: No free path between line " + String(lineA) + " and line " + String(lineB));
+      util::UIConsole::log("No free path between line " + String(lineA) + " and line " + String(lineB), "SwitchFabric");
+    }
+    return false;
+  }
+
+  route.used = true;
+  route.lineA = lineA;
+  route.lineB = lineB;
+  for (uint8_t i = 0; i < route.trunkCount; ++i) trunkBusy_[route.trunks[i]] = true;
+  *slot = route;
+  commit_(*slot, true);
+  return true;
+}
+
+void SwitchFabric::disconnectLines(uint8_t lineA, uint8_t lineB) {
+  if (lineA >= lines::MAX_LINES || lineB >= lines::MAX_LINES) return;
+
+  Route* route = findRoute_(lineA, lineB);
+  if (route == nullptr) {
+    // Unknown call: still open the direct crosspoints so a stale same-chip connection is cleared
+    Route direct;
+    if (!findPath_(lineA, lineB, direct) || direct.trunkCount != 0) return;
+    commit_(direct, false);
+    return;
+  }
+
+  commit_(*route, false);
+  for (uint8_t i = 0; i < route->trunkCount; ++i) trunkBusy_[route->trunks[i]] = false;
+  route->used = false;
+}
+
+bool SwitchFabric::connectSource(uint8_t source, uint8_t line) {
+  if (line >= lines::MAX_LINES) return false;
+  const auto& lp = mt8816::LINE_PORTS[line];
+  mt8816Driver_.setConnection(lp.chip, source, lp.y, true);
+  return true;
+}
+
+void SwitchFabric::disconnectSource(uint8_t source, uint8_t line) {
+  if (line >= lines::MAX_LINES) return;
+  const auto& lp = mt8816::LINE_PORTS[line];
+  mt8816Driver_.setConnection(lp.chip, source, lp.y, false);
+}
+
+uint8_t SwitchFabric::freeTrunks() const {
+  uint8_t free = 0;
+  for (size_t t = 0; t < mt8816::TRUNK_COUNT; ++t) {
+    if (!trunkBusy_[t]) free++;
+  }
+  return free;
+}
+
+// Finds the crosspoints for a call. Same chip: close (Ax,By) and (Bx,Ay) as before.
+// Different chips: shortest chain of free trunks. A crosspoint always joins one
+// X port with one Y port, so a trunk landing on X must leave on a trunk landing on Y.
+bool SwitchFabric::findPath_(uint8_t lineA, uint8_t lineB, Route& out) const {
+  const auto& a = mt8816::LINE_PORTS[lineA];
+  const auto& b = mt8816::LINE_PORTS[lineB];
+  out.xpCount = 0;
+  out.trunkCount = 0;
+
+  if (a.chip == b.chip) {
+    out.xp[out.xpCount++] = {a.chip, a.x, b.y, true};
+    out.xp[out.xpCount++] = {a.chip, b.x, a.y, true};
+    return true;
+  }
+
+  int16_t parent[kNodeCount];
+  uint8_t depth[kNodeCount];
+  bool trunkSeen[kNodeCount];
+  uint8_t queue[kNodeCount];
+  size_t head = 0, tail = 0;
+
+  for (size_t n = 0; n < kNodeCount; ++n) { parent[n] = -1; depth[n] = 0; trunkSeen[n] = false; }
+
+  // Start: any free trunk with an end on line A's chip (the line has both X and Y)
+  for (size_t n = 0; n < mt8816::TRUNK_COUNT * 2; ++n) {
+    if (trunkBusy_[n / 2] || trunkSeen[n / 2]) continue;
+    if (nearEnd(n).chip != a.chip) continue;
+    trunkSeen[n / 2] = true;
+    depth[n] = 1;
+    queue[tail++] = static_cast<uint8_t>(n);
+  }
+
+  int16_t found = -1;
+  while (head < tail) {
+    const uint8_t node = queue[head++];
+    const auto& f = farEnd(node);
+    if (f.chip == b.chip) { found = node; break; }
+    if (depth[node] >= mt8816::MAX_TRUNK_HOPS) continue;
+
+    for (size_t n = 0; n < mt8816::TRUNK_COUNT * 2; ++n) {
+      if (trunkBusy_[n / 2] || trunkSeen[n / 2]) continue;
+      const auto& e = nearEnd(n);
+      if (e.chip != f.chip || e.isX == f.isX) continue;
+      trunkSeen[n / 2] = true;
+      parent[n] = node;
+      depth[n] = static_cast<uint8_t>(depth[node] + 1);
+      queue[tail++] = static_cast<uint8_t>(n);
+    }
+  }
+  if (found < 0) return false;
+
+  // Walk back to the first hop
+  uint8_t chain[mt8816::MAX_TRUNK_HOPS];
+  uint8_t hops = 0;
+  for (int16_t n = found; n >= 0 && hops < mt8816::MAX_TRUNK_HOPS; n = parent[n]) chain[hops++] = static_cast<uint8_t>(n);
+
+  const auto& first = nearEnd(chain[hops - 1]);
+  out.xp[out.xpCount++] = first.isX ? MT8816Driver::Crosspoint{a.chip, first.port, a.y, true}
+                                    : MT8816Driver::Crosspoint{a.chip, a.x, first.port, true};
+  for (int i = hops - 1; i > 0; --i) {
+    const auto& f = farEnd(chain[i]);
+    const auto& e = nearEnd(chain[i - 1]);
+    out.xp[out.xpCount++] = f.isX ? MT8816Driver::Crosspoint{f.chip, f.port, e.port, true}
+                                  : MT8816Driver::Crosspoint{f.chip, e.port, f.port, true};
+  }
+  const auto& last = farEnd(chain[0]);
+  out.xp[out.xpCount++] = last.isX ? MT8816Driver::Crosspoint{b.chip, last.port, b.y, true}
+                                   : MT8816Driver::Crosspoint{b.chip, b.x, last.port, true};
+
+  for (int i = hops - 1; i >= 0; --i) out.trunks[out.trunkCount++] = static_cast<uint8_t>(chain[i] / 2);
+  return true;
+}
+
+SwitchFabric::Route* SwitchFabric::findRoute_(uint8_t lineA, uint8_t lineB) {
+  for (auto& r : routes_) {
+    if (!r.used) continue;
+    if ((r.lineA == lineA && r.lineB == lineB) || (r.lineA == lineB && r.lineB == lineA)) return &r;
+  }
+  return nullptr;
+}
+
+void SwitchFabric::commit_(Route& route, bool state) {
+  for (uint8_t i = 0; i < route.xpCount; ++i) route.xp[i].state = state;
+  const uint16_t writes = mt8816Driver_.apply(route.xp, route.xpCount);
+
+  if (settings_.debugMTLevel >= 2) {
+    Serial.println("SwitchFabric: " + String(state ? "Closed " : "Opened ") + String(route.xpCount) +
+                   " crosspoints over " + String(route.trunkCount) + " trunks in " + String(writes) + " I2C writes");
+    util::UIConsole::log(String(state ? "Closed " : "Opened ") + String(route.xpCount) + " crosspoints over " +
+                         String(route.trunkCount) + " trunks in " + String(writes) + " I2C writes", "SwitchFabric");
+  }
+}
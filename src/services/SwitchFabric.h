@@ -0,0 +1,53 @@
+#pragma once
+#include <Arduino.h>
+#include <stdint.h>
+#include "config.h"
+#include "settings/settings.h"
+#include "drivers/MT8816Driver.h"
+#include "util/UIConsole.h"
+
+// Switching fabric built from one or more MT8816 (cfg::mt8816::CHIPS).
+// Lines on the same chip are switched directly; lines on different chips are
+// routed over inter-chip trunks (cfg::mt8816::TRUNKS) found with a BFS.
+// Each call is programmed as one batch through MT8816Driver::apply().
+class SwitchFabric {
+public:
+  SwitchFabric(MT8816Driver& mt8816Driver, Settings& settings) : mt8816Driver_(mt8816Driver), settings_(settings) {}
+
+  bool connectLines(uint8_t lineA, uint8_t lineB);
+  void disconnectLines(uint8_t lineA, uint8_t lineB);
+
+  // Audio sources (cfg::mt8816::DAC1..3, D_OUTL) are bused to every chip
+  bool connectSource(uint8_t source, uint8_t line);
+  void disconnectSource(uint8_t source, uint8_t line);
+
+  uint8_t freeTrunks() const;
+  uint32_t blockedCalls() const { return blockedCalls_; }
+
+private:
+  static constexpr uint8_t kMaxRouteXp =
+    (cfg::mt8816::MAX_TRUNK_HOPS + 1 > 2) ? cfg::mt8816::MAX_TRUNK_HOPS + 1 : 2;
+  static constexpr uint8_t kMaxRoutes = cfg::lines::MAX_LINES;
+  static constexpr uint8_t kNoTrunk = 0xFF;
+
+  struct Route {
+    bool    used = false;
+    uint8_t lineA = 0;
+    uint8_t lineB = 0;
+    uint8_t xpCount = 0;
+    MT8816Driver::Crosspoint xp[kMaxRouteXp];
+    uint8_t trunks[cfg::mt8816::MAX_TRUNK_HOPS];
+    uint8_t trunkCount = 0;
+  };
+
+  bool findPath_(uint8_t lineA, uint8_t lineB, Route& out) const;
+  Route* findRoute_(uint8_t lineA, uint8_t lineB);
+  void commit_(Route& route, bool state);
+
+  MT8816Driver& mt8816Driver_;
+  Settings& settings_;
+
+  Route routes_[kMaxRoutes];
+  bool trunkBusy_[cfg::mt8816::TRUNK_COUNT > 0 ? cfg::mt8816::TRUNK_COUNT : 1] = {false};
+  uint32_t blockedCalls_ = 0;
+};
@@ -1,5 +1,33 @@
 #include "ToneGenerator.h"
 #include "util/UIConsole.h"
+#include <LittleFS.h>
+
+namespace {
+  constexpr float    kMinPlanHz = 20.0f;
+  constexpr float    kMaxPlanHz = 4000.0f;
+  constexpr uint32_t kMaxPlanMs = 60000;
+
+  bool isNumber(const String& s) {
+    if (s.length() == 0) return false;
+    for (unsigned i = 0; i < s.length(); ++i) {
+      const char c = s[i];
+      if ((c < '0' || c > '9') && c != '.') return false;
+    }
+    return true;
+  }
+
+  bool validPlanHz(float hz) {
+    return hz == 0.0f || (hz >= kMinPlanHz && hz <= kMaxPlanHz);
+  }
+
+  int toneIndexFromName(const String& name) {
+    if (name == "ready") return static_cast<int>(model::ToneId::Ready);
+    if (name == "ring")  return static_cast<int>(model::ToneId::Ring);
+    if (name == "busy")  return static_cast<int>(model::ToneId::Busy);
+    if (name == "fail")  return static_cast<int>(model::ToneId::Fail);
+    return -1;
+  }
+}
 
 ToneGenerator::ToneGenerator(AD9833Driver& driver1, AD9833Driver& driver2, AD9833Driver& driver3) {
   channels_[0].driver = &driver1;
@@ -8,37 +36,203 @@ ToneGenerator::ToneGenerator(AD9833Driver& driver1, AD9833Driver& driver2, AD983
   channels_[1].dac = cfg::mt8816::DAC2;
   channels_[2].driver = &driver3;
   channels_[2].dac = cfg::mt8816::DAC3;
+  channels_[kSynthChannel].dac = cfg::mt8816::D_OUTL;   // ToneSynth, see setSynth()
 }
 
 void ToneGenerator::begin() {
+  if (mutex_ == nullptr) {
+    mutex_ = xSemaphoreCreateMutex();
+  }
+
   for (auto& channel : channels_) {
     if (channel.driver != nullptr) {
       channel.driver->begin();
+      channel.loadedWord[0] = 0;   // begin() clears both frequency registers
+      channel.loadedWord[1] = 0;
     }
     stopChannel_(channel);
+
+    channel.owner = this;
+    if (channel.timer == nullptr && channel.driver != nullptr) {
+      esp_timer_create_args_t args = {};
+      args.callback = &ToneGenerator::onStepTimer_;
+      args.arg = &channel;
+      args.dispatch_method = ESP_TIMER_TASK;
+      args.name = "toneStep";
+      if (esp_timer_create(&args, &channel.timer) != ESP_OK) {
+        channel.timer = nullptr;   // update() advances this channel instead
+        Serial.println("ToneGenerator: esp_timer_create failed for DAC " + String(channel.dac) + ", using loop timing");
+        util::UIConsole::log("esp_timer_create failed for DAC " + String(channel.dac) + ", using loop timing", "ToneGenerator");
+      }
+    }
   }
+
+  loadTonePlan(Settings::instance().tonePlan);
 }
 
-uint8_t ToneGenerator::startTone(model::ToneId sequence) {
-  if (!Settings::instance().toneGeneratorEnabled) return 0;
+bool ToneGenerator::canLoadTonePlan() const {
+  // A partner follows its leader's session, the leader decides
+  for (const auto& channel : channels_) {
+    if (!channel.playing || channel.isPartner) continue;
+    if (!(channel.pinned && channel.listeners == 0)) return false;
+  }
+  return true;
+}
 
-  ChannelState* channel = findFreeChannel_();
-  if (channel == nullptr) {
-    return 0;
+bool ToneGenerator::loadTonePlan(const String& name) {
+  // Sequences point into planSteps_, so only swap the table while silent.
+  // An idle pre-armed dial tone is restarted by update() with the new plan.
+  if (canLoadTonePlan()) {
+    reclaimIdlePinned_();
+  }
+  if (isPlaying()) {
+    Serial.println("ToneGenerator: Tone plan not loaded, tones are playing");
+    util::UIConsole::log("Tone plan not loaded, tones are playing", "ToneGenerator");
+    return false;
   }
+  planLoaded_ = false;
 
-  channel->currentSequence = getSequence_(sequence);
-  channel->currentStepIndex = 0;
-  channel->stepStartTimeMs = millis();
+  const String path = "/tones/" + name + ".txt";
+  if (!LittleFS.begin(true) || !LittleFS.exists(path)) {
+    Serial.println("ToneGenerator: Tone plan " + path + " not found, using built-in tones");
+    util::UIConsole::log("Tone plan " + path + " not found, using built-in tones", "ToneGenerator");
+    return false;
+  }
+  File file = LittleFS.open(path, "r");
+  if (!file) {
+    Serial.println("ToneGenerator: Could not open " + path + ", using built-in tones");
+    util::UIConsole::log("Could not open " + path + ", using built-in tones", "ToneGenerator");
+    return false;
+  }
 
-  if (channel->currentSequence.steps == nullptr || channel->currentSequence.length == 0) {
-    stopChannel_(*channel);
-    return 0;
+  // Compile into a scratch table first; a bad line rejects the whole plan
+  Step steps[kMaxPlanSteps];
+  StepSequence seqs[kToneCount] = {};
+  std::size_t used = 0;
+  unsigned lineNo = 0;
+  String error;
+  bool ok = true;
+  while (file.available() > 0) {
+    const String line = file.readStringUntil('\n');
+    lineNo++;
+    if (!parsePlanLine_(line, steps, used, seqs, error)) {
+      ok = false;
+      break;
+    }
+  }
+  file.close();
+
+  if (!ok) {
+    Serial.println("ToneGenerator: " + path + " line " + String(lineNo) + ": " + error + ", using built-in tones");
+    util::UIConsole::log(path + " line " + String(lineNo) + ": " + error + ", using built-in tones", "ToneGenerator");
+    return false;
   }
 
-  channel->playing = true;
-  applyStep_(*channel, channel->currentSequence.steps[channel->currentStepIndex]);
-  channel->stepStartTimeMs = millis();
+  for (std::size_t i = 0; i < used; ++i) {
+    planSteps_[i] = steps[i];
+  }
+  for (std::size_t t = 0; t < kToneCount; ++t) {
+    planSequences_[t] = seqs[t];
+    if (seqs[t].steps != nullptr) {
+      planSequences_[t].steps = planSteps_ + (seqs[t].steps - steps);
+    }
+  }
+  planLoaded_ = true;
+
+  if (Settings::instance().debugTonGenLevel >= 1) {
+    Serial.println("ToneGenerator: Loaded tone plan " + path + " (" + String(static_cast<unsigned>(used)) + " steps)");
+    util::UIConsole::log("Loaded tone plan " + path + " (" + String(static_cast<unsigned>(used)) + " steps)", "ToneGenerator");
+  }
+  return true;
+}
+
+// One plan line: "<tone> = <hz>[+<hz2>]/<ms>, ..."; blank lines and '#' comments are skipped
+bool ToneGenerator::parsePlanLine_(const String& raw, Step* steps, std::size_t& used,
+                                   StepSequence (&seqs)[kToneCount], String& error) {
+  String line = raw;
+  line.trim();
+  if (line.length() == 0 || line.startsWith("#")) return true;
+
+  const int eq = line.indexOf('=');
+  if (eq <= 0) { error = "expected <tone> = <steps>"; return false; }
+
+  String name = line.substring(0, eq);
+  name.trim();
+  name.toLowerCase();
+  const int tone = toneIndexFromName(name);
+  if (tone < 0) { error = "unknown tone '" + name + "'"; return false; }
+  if (seqs[tone].length > 0) { error = "tone '" + name + "' defined twice"; return false; }
+
+  const std::size_t first = used;
+  bool dual = false;
+  bool audible = false;
+  String rest = line.substring(eq + 1);
+  while (rest.length() > 0) {
+    const int comma = rest.indexOf(',');
+    String item = comma >= 0 ? rest.substring(0, comma) : rest;
+    rest = comma >= 0 ? rest.substring(comma + 1) : String("");
+    item.trim();
+
+    const int slash = item.indexOf('/');
+    if (slash <= 0) { error = "expected <hz>/<ms>, got '" + item + "'"; return false; }
+    String freq = item.substring(0, slash);
+    String dur = item.substring(slash + 1);
+    freq.trim();
+    dur.trim();
+
+    String freq2 = "0";
+    const int plus = freq.indexOf('+');
+    if (plus >= 0) {
+      freq2 = freq.substring(plus + 1);
+      freq = freq.substring(0, plus);
+      freq.trim();
+      freq2.trim();
+    }
+    if (!isNumber(freq) || !isNumber(freq2) || !isNumber(dur)) {
+      error = "bad number in '" + item + "'";
+      return false;
+    }
+
+    const float hz = freq.toFloat();
+    const float hz2 = freq2.toFloat();
+    const long ms = dur.toInt();
+    if (!validPlanHz(hz) || !validPlanHz(hz2)) {
+      error = "frequency out of range in '" + item + "'";
+      return false;
+    }
+    if (hz2 > 0.0f && hz == 0.0f) { error = "second frequency without first in '" + item + "'"; return false; }
+    if (ms < 0 || ms > static_cast<long>(kMaxPlanMs)) { error = "duration out of range in '" + item + "'"; return false; }
+    if (used - first >= kMaxStepsPerTone) { error = "more than " + String(static_cast<unsigned>(kMaxStepsPerTone)) + " steps"; return false; }
+    if (used >= kMaxPlanSteps) { error = "plan exceeds " + String(static_cast<unsigned>(kMaxPlanSteps)) + " steps"; return false; }
+
+    steps[used++] = Step(hz, hz2, static_cast<uint32_t>(ms));
+    dual = dual || hz2 > 0.0f;
+    audible = audible || hz > 0.0f;
+  }
+
+  const std::size_t count = used - first;
+  if (count == 0) { error = "no steps"; return false; }
+  if (!audible) { error = "no audible step"; return false; }
+  if (count > 1) {
+    for (std::size_t i = first; i < used; ++i) {
+      if (steps[i].durationMs == 0) { error = "zero duration in a cadence"; return false; }
+    }
+  }
+
+  seqs[tone] = StepSequence{steps + first, count, dual};
+  return true;
+}
+
+uint8_t ToneGenerator::startTone(model::ToneId sequence) {
+  if (!Settings::instance().toneGeneratorEnabled) return 0;
+
+  // A dual tone on the synth costs one channel instead of two AD9833s
+  ChannelState* channel = getSequence_(sequence).dual ? findFreeSynth_() : nullptr;
+  if (channel == nullptr) channel = findFreeChannel_();
+  if (channel == nullptr || !startChannel_(*channel, sequence)) {
+    return 0;
+  }
+  channel->listeners = 1;
 
   if (Settings::instance().debugTonGenLevel >= 1) {
     Serial.println("ToneGenerator: Started tone sequence " + String(ToneIdToString(sequence)) + " on DAC " + String(channel->dac));
@@ -47,6 +241,58 @@ uint8_t ToneGenerator::startTone(model::ToneId sequence) {
   return channel->dac;
 }
 
+uint8_t ToneGenerator::acquireTone(model::ToneId sequence) {
+  if (!Settings::instance().toneGeneratorEnabled) return 0;
+
+  // Join a running session for the same tone
+  ChannelState* channel = findSharedChannel_(sequence);
+  if (channel != nullptr) {
+    channel->listeners++;
+    if (Settings::instance().debugTonGenLevel >= 2) {
+      Serial.println("ToneGenerator: Joined " + String(ToneIdToString(sequence)) + " on DAC " + String(channel->dac) +
+                     " (" + String(channel->listeners) + " listeners)");
+      util::UIConsole::log("Joined " + String(ToneIdToString(sequence)) + " on DAC " + String(channel->dac) +
+                           " (" + String(channel->listeners) + " listeners)", "ToneGenerator");
+    }
+    return channel->dac;
+  }
+
+  const uint8_t dac = startTone(sequence);
+  if (dac != 0) {
+    findChannelByDac_(dac)->shared = true;
+  }
+  return dac;
+}
+
+void ToneGenerator::releaseTone(uint8_t dac) {
+  ChannelState* channel = findChannelByDac_(dac);
+  if (channel == nullptr || !channel->playing) {
+    return;
+  }
+  if (channel->pinned && channel->listeners <= 1) {
+    channel->listeners = 0;   // Pre-armed dial tone keeps running
+    return;
+  }
+  if (channel->listeners > 1) {
+    channel->listeners--;
+    if (Settings::instance().debugTonGenLevel >= 2) {
+      Serial.println("ToneGenerator: Left DAC " + String(dac) + " (" + String(channel->listeners) + " listeners)");
+      util::UIConsole::log("Left DAC " + String(dac) + " (" + String(channel->listeners) + " listeners)", "ToneGenerator");
+    }
+    return;
+  }
+  stopTone(dac);
+}
+
+uint8_t ToneGenerator::listenerCount(uint8_t dac) const {
+  for (const auto& channel : channels_) {
+    if (channel.dac == dac) {
+      return channel.playing ? channel.listeners : 0;
+    }
+  }
+  return 0;
+}
+
 void ToneGenerator::stopTone(uint8_t dac) {
   ChannelState* channel = findChannelByDac_(dac);
   if (channel == nullptr) {
@@ -60,6 +306,218 @@ void ToneGenerator::stopTone(uint8_t dac) {
   }
 }
 
+uint8_t ToneGenerator::priority_(model::ToneId tone) {
+  switch (tone) {
+    case model::ToneId::Ready: return 3;
+    case model::ToneId::Busy:  return 2;
+    case model::ToneId::Fail:  return 1;
+    case model::ToneId::Ring:  return 0;
+    default:                   return 0;
+  }
+}
+
+uint8_t ToneGenerator::requestTone(uint8_t line, model::ToneId sequence) {
+  if (line >= cfg::lines::MAX_LINES || !Settings::instance().toneGeneratorEnabled) return 0;
+
+  releaseLine(line);
+  stats_.requests++;
+
+  const uint8_t dac = attachLine_(line, sequence, true);
+  if (dac != 0) {
+    stats_.immediate++;
+    return dac;
+  }
+
+  enqueue_(line, sequence, millis());
+  if (Settings::instance().debugTonGenLevel >= 1) {
+    Serial.println("ToneGenerator: No channel for " + String(ToneIdToString(sequence)) + ", line " + String(line) +
+                   " queued (" + String(waitCount_) + " waiting)");
+    util::UIConsole::log("No channel for " + String(ToneIdToString(sequence)) + ", line " + String(line) +
+                         " queued (" + String(waitCount_) + " waiting)", "ToneGenerator");
+  }
+  return 0;
+}
+
+void ToneGenerator::releaseLine(uint8_t line) {
+  if (line >= cfg::lines::MAX_LINES) return;
+
+  const int waiting = findWaiting_(line);
+  if (waiting >= 0) {
+    removeWaiting_(waiting);
+  }
+
+  const uint8_t dac = lineDac_[line];
+  if (dac == 0) return;
+  lineDac_[line] = 0;
+  notifyLine_(line, dac, false);
+
+  releaseTone(dac);
+  serviceQueue_();
+}
+
+// Attach a line to a shared session for the tone. Starts a new session if a
+// channel is free, or preempts a lower-priority session if allowed.
+uint8_t ToneGenerator::attachLine_(uint8_t line, model::ToneId tone, bool allowPreempt) {
+  uint8_t dac = acquireTone(tone);
+  if (dac == 0 && reclaimIdlePinned_()) {
+    dac = acquireTone(tone);
+  }
+  // A dual tone may need two generators freed, hence more than one round
+  for (int round = 0; dac == 0 && allowPreempt && round < 2; ++round) {
+    if (!preemptFor_(tone)) break;
+    dac = acquireTone(tone);
+  }
+  if (dac == 0) return 0;
+
+  lineDac_[line] = dac;
+  notifyLine_(line, dac, true);
+  return dac;
+}
+
+// Attach/detach callbacks for the session's generator and, for a dual tone, its partner
+void ToneGenerator::notifyLine_(uint8_t line, uint8_t dac, bool attach) {
+  const auto& callback = attach ? attachCallback_ : detachCallback_;
+  if (!callback) return;
+  callback(line, dac);
+  const ChannelState* channel = findChannelByDac_(dac);
+  if (channel != nullptr && channel->partner != nullptr) {
+    callback(line, channel->partner->dac);
+  }
+}
+
+// Stop the lowest-priority shared session below 'tone' (fewest listeners on a tie)
+// and put its lines back in the wait queue.
+bool ToneGenerator::preemptFor_(model::ToneId tone) {
+  ChannelState* victim = nullptr;
+  for (auto& channel : channels_) {
+    if (!channel.playing || !channel.shared) continue;
+    if (priority_(channel.tone) >= priority_(tone)) continue;
+    if (victim == nullptr || priority_(channel.tone) < priority_(victim->tone) ||
+        (priority_(channel.tone) == priority_(victim->tone) && channel.listeners < victim->listeners)) {
+      victim = &channel;
+    }
+  }
+  if (victim == nullptr) return false;
+
+  const uint8_t dac = victim->dac;
+  const model::ToneId victimTone = victim->tone;
+  const uint32_t now = millis();
+  for (uint8_t l = 0; l < cfg::lines::MAX_LINES; ++l) {
+    if (lineDac_[l] != dac) continue;
+    lineDac_[l] = 0;
+    notifyLine_(l, dac, false);
+    enqueue_(l, victimTone, now);
+  }
+  stopTone(dac);
+  stats_.preemptions++;
+
+  if (Settings::instance().debugTonGenLevel >= 1) {
+    Serial.println("ToneGenerator: Preempted " + String(ToneIdToString(victimTone)) + " on DAC " + String(dac) +
+                   " for " + String(ToneIdToString(tone)));
+    util::UIConsole::log("Preempted " + String(ToneIdToString(victimTone)) + " on DAC " + String(dac) +
+                         " for " + String(ToneIdToString(tone)), "ToneGenerator");
+  }
+  return true;
+}
+
+// Attach waiting lines, highest priority first and FIFO within a priority.
+// No preemption here: a waiting line already lost against everything playing.
+void ToneGenerator::serviceQueue_() {
+  if (waitCount_ == 0 || !Settings::instance().toneGeneratorEnabled) return;
+
+  const uint32_t now = millis();
+  bool attachedAny = true;
+  while (attachedAny && waitCount_ > 0) {
+    attachedAny = false;
+    for (int prio = 3; prio >= 0 && !attachedAny; --prio) {
+      for (int i = 0; i < waitCount_; ++i) {
+        const WaitEntry entry = waitQueue_[i];
+        if (priority_(entry.tone) != prio) continue;
+        if (attachLine_(entry.line, entry.tone, false) == 0) continue;
+
+        removeWaiting_(i);
+        const uint32_t waited = now - entry.sinceMs;
+        stats_.waitedAttach++;
+        stats_.waitSumMs += waited;
+        if (waited > stats_.waitMaxMs) stats_.waitMaxMs = waited;
+        if (Settings::instance().debugTonGenLevel >= 2) {
+          Serial.println("ToneGenerator: Line " + String(entry.line) + " attached after " + String(waited) + " ms");
+          util::UIConsole::log("Line " + String(entry.line) + " attached after " + String(waited) + " ms", "ToneGenerator");
+        }
+        attachedAny = true;
+        break;
+      }
+    }
+  }
+}
+
+// An idle pre-armed dial tone is the first channel to give up
+bool ToneGenerator::reclaimIdlePinned_() {
+  for (auto& channel : channels_) {
+    if (channel.playing && channel.pinned && channel.listeners == 0) {
+      stopTone(channel.dac);
+      return true;
+    }
+  }
+  return false;
+}
+
+// Keep one channel playing the Ready tone when toneReadyPrearmed is set, so
+// hook-off only needs acquireTone() plus a crosspoint close. Waiting lines
+// get free channels first.
+void ToneGenerator::ensurePrearmed_() {
+  ChannelState* ready = findSharedChannel_(model::ToneId::Ready);
+  if (!Settings::instance().toneReadyPrearmed) {
+    if (ready != nullptr && ready->pinned) {
+      ready->pinned = false;
+      if (ready->listeners == 0) stopTone(ready->dac);
+    }
+    return;
+  }
+
+  if (ready != nullptr) {
+    ready->pinned = true;
+    return;
+  }
+  if (waitCount_ > 0) return;
+
+  ChannelState* channel = findFreeChannel_();
+  if (channel == nullptr || !startChannel_(*channel, model::ToneId::Ready)) return;
+  channel->shared = true;
+  channel->pinned = true;
+  channel->listeners = 0;
+
+  if (Settings::instance().debugTonGenLevel >= 1) {
+    Serial.println("ToneGenerator: Pre-armed dial tone on DAC " + String(channel->dac));
+    util::UIConsole::log("Pre-armed dial tone on DAC " + String(channel->dac), "ToneGenerator");
+  }
+}
+
+void ToneGenerator::enqueue_(uint8_t line, model::ToneId tone, uint32_t sinceMs) {
+  const int existing = findWaiting_(line);
+  if (existing >= 0) removeWaiting_(existing);
+  if (waitCount_ >= cfg::lines::MAX_LINES) return;
+
+  waitQueue_[waitCount_++] = WaitEntry{line, tone, sinceMs, false};
+  stats_.queued++;
+  if (waitCount_ > stats_.queueHighWater) stats_.queueHighWater = waitCount_;
+}
+
+int ToneGenerator::findWaiting_(uint8_t line) const {
+  for (int i = 0; i < waitCount_; ++i) {
+    if (waitQueue_[i].line == line) return i;
+  }
+  return -1;
+}
+
+// Keep FIFO order when removing
+void ToneGenerator::removeWaiting_(int index) {
+  for (int i = index; i + 1 < waitCount_; ++i) {
+    waitQueue_[i] = waitQueue_[i + 1];
+  }
+  waitCount_--;
+}
+
 bool ToneGenerator::isPlaying() const {
   for (const auto& channel : channels_) {
     if (channel.playing) {
@@ -79,56 +537,237 @@ void ToneGenerator::update() {
     return;
   }
 
+  // Count lines that have waited too long, then retry the queue
+  const uint32_t nowMs = millis();
+  for (int i = 0; i < waitCount_; ++i) {
+    WaitEntry& entry = waitQueue_[i];
+    if (!entry.starvedCounted && (nowMs - entry.sinceMs) >= kStarvationMs) {
+      entry.starvedCounted = true;
+      stats_.starved++;
+      if (Settings::instance().debugTonGenLevel >= 1) {
+        Serial.println("ToneGenerator: Line " + String(entry.line) + " starved waiting for " + String(ToneIdToString(entry.tone)));
+        util::UIConsole::log("Line " + String(entry.line) + " starved waiting for " + String(ToneIdToString(entry.tone)), "ToneGenerator");
+      }
+    }
+  }
+  serviceQueue_();
+  ensurePrearmed_();
+
+  // Fallback for channels without a timer: advance from the loop
+  const int64_t nowUs = esp_timer_get_time();
   for (auto& channel : channels_) {
-    if (!channel.playing || channel.currentSequence.steps == nullptr || channel.currentSequence.length == 0) {
+    if (channel.timer != nullptr || channel.synth != nullptr || !channel.playing || channel.currentSequence.length == 0) {
       continue;
     }
-
-    const Step& step = channel.currentSequence.steps[channel.currentStepIndex];
-    if (step.durationMs == 0) {
+    if (channel.currentSequence.steps[channel.currentStepIndex].durationMs == 0 || nowUs < channel.stepDeadlineUs) {
       continue;
     }
+    advanceStep_(channel);
+  }
+}
 
-    const uint32_t now = millis();
-    const uint32_t elapsed = now - channel.stepStartTimeMs;
-    if (elapsed < step.durationMs) {
-      continue;
+void ToneGenerator::onStepTimer_(void* arg) {
+  auto* channel = static_cast<ChannelState*>(arg);
+  // Snapshot before waiting for the mutex: a start/stop that gets in first
+  // bumps the generation, and this callback then belongs to the old cadence
+  const uint32_t generation = channel->generation;
+  channel->owner->timerStep_(*channel, generation);
+}
+
+// Runs in the esp_timer task. Never waits long on the loop: a busy mutex
+// re-arms a short retry instead of stalling every other esp_timer callback.
+void ToneGenerator::timerStep_(ChannelState& channel, uint32_t generation) {
+  if (mutex_ != nullptr && xSemaphoreTake(mutex_, pdMS_TO_TICKS(kTimerLockWaitMs)) != pdTRUE) {
+    if (channel.generation == generation) {
+      cadenceStats_.lockRetries++;
+      esp_timer_start_once(channel.timer, kTimerRetryUs);
+    }
+    return;
+  }
+  if (channel.generation != generation) {
+    cadenceStats_.staleDropped++;
+    unlock_();
+    return;
+  }
+  advanceLocked_(channel);
+  unlock_();
+}
+
+// Loop fallback for channels without a timer
+void ToneGenerator::advanceStep_(ChannelState& channel) {
+  lock_();
+  advanceLocked_(channel);
+  unlock_();
+}
+
+void ToneGenerator::advanceLocked_(ChannelState& channel) {
+  if (!channel.playing || channel.currentSequence.steps == nullptr || channel.currentSequence.length == 0) {
+    return;
+  }
+
+  const int64_t lateUs = esp_timer_get_time() - channel.stepDeadlineUs;
+  const uint32_t late = lateUs > 0 ? static_cast<uint32_t>(lateUs) : 0;
+  cadenceStats_.steps++;
+  cadenceStats_.lateSumUs += late;
+  if (late > cadenceStats_.lateMaxUs) cadenceStats_.lateMaxUs = late;
+
+  channel.currentStepIndex = (channel.currentStepIndex + 1) % channel.currentSequence.length;
+  applyStep_(channel);
+  armStepTimer_(channel);
+}
+
+// Next deadline is relative to the previous deadline, not to "now", so a late
+// callback does not push the rest of the cadence.
+void ToneGenerator::armStepTimer_(ChannelState& channel) {
+  const uint32_t durationMs = channel.currentSequence.steps[channel.currentStepIndex].durationMs;
+  if (durationMs == 0) {
+    return;   // Continuous tone
+  }
+
+  channel.stepDeadlineUs += static_cast<int64_t>(durationMs) * 1000;
+  if (channel.timer == nullptr) {
+    return;
+  }
+
+  int64_t delayUs = channel.stepDeadlineUs - esp_timer_get_time();
+  if (delayUs < 0) delayUs = 0;
+  esp_timer_start_once(channel.timer, static_cast<uint64_t>(delayUs));
+}
+
+void ToneGenerator::lock_() {
+  if (mutex_) xSemaphoreTake(mutex_, portMAX_DELAY);
+}
+
+void ToneGenerator::unlock_() {
+  if (mutex_) xSemaphoreGive(mutex_);
+}
+
+bool ToneGenerator::startChannel_(ChannelState& channel, model::ToneId sequence) {
+  const StepSequence seq = getSequence_(sequence);
+  if (seq.steps == nullptr || seq.length == 0) {
+    stopChannel_(channel);
+    return false;
+  }
+  if (channel.synth != nullptr) {
+    return startSynth_(channel, seq, sequence);
+  }
+
+  // Dual tone: a second free generator plays frequency2Hz, mixed in the crosspoint
+  ChannelState* partner = nullptr;
+  if (seq.dual) {
+    for (auto& other : channels_) {
+      if (&other != &channel && !other.playing && other.driver != nullptr) { partner = &other; break; }
     }
+    if (partner == nullptr) {
+      return false;
+    }
+  }
 
-    channel.currentStepIndex = (channel.currentStepIndex + 1) % channel.currentSequence.length;
-    applyStep_(channel, channel.currentSequence.steps[channel.currentStepIndex]);
-    channel.stepStartTimeMs = millis();
+  lock_();
+  channel.generation++;
+  if (channel.timer != nullptr) {
+    esp_timer_stop(channel.timer);
+  }
+  channel.currentSequence = seq;
+  channel.currentStepIndex = 0;
+  channel.tone = sequence;
+  channel.shared = false;
+  channel.partner = partner;
+  if (partner != nullptr) {
+    partner->playing = true;
+    partner->isPartner = true;
   }
+  channel.playing = true;
+  applyStep_(channel);
+  channel.stepDeadlineUs = esp_timer_get_time();
+  armStepTimer_(channel);
+  unlock_();
+  return true;
 }
 
-void ToneGenerator::applyStep_(ChannelState& channel, const Step& step) {
+// Step change at the cadence boundary: one control write per generator when
+// the word is already loaded (FSELECT flip or SLEEP), then preload the idle register.
+void ToneGenerator::applyStep_(ChannelState& channel) {
+  const StepSequence& seq = channel.currentSequence;
+  const Step& step = seq.steps[channel.currentStepIndex];
+
+  applyWord_(channel, step.freqWord);
+  preloadNext_(channel, seq, channel.currentStepIndex, false);
+
+  if (channel.partner != nullptr) {
+    applyWord_(*channel.partner, step.freqWord2);
+    preloadNext_(*channel.partner, seq, channel.currentStepIndex, true);
+  }
+}
+
+void ToneGenerator::applyWord_(ChannelState& channel, uint32_t word) {
   if (channel.driver == nullptr) {
     return;
   }
-  channel.driver->setToneFrequency(step.frequencyHz);
+
+  if (word == 0) {
+    channel.driver->pause();
+  } else if (channel.loadedWord[0] == word) {
+    channel.driver->select(0);
+  } else if (channel.loadedWord[1] == word) {
+    channel.driver->select(1);
+  } else {
+    // Not preloaded (first step): load into the idle register
+    const uint8_t reg = channel.driver->selectedReg() ^ 1;
+    channel.driver->loadFrequencyWord(reg, word);
+    channel.loadedWord[reg] = word;
+    channel.driver->select(reg);
+  }
+}
+
+// Load the next audible frequency of the cadence into the register that is not playing
+void ToneGenerator::preloadNext_(ChannelState& channel, const StepSequence& seq, std::size_t index, bool second) {
+  if (channel.driver == nullptr) {
+    return;
+  }
+  for (std::size_t n = 1; n <= seq.length; ++n) {
+    const Step& next = seq.steps[(index + n) % seq.length];
+    const uint32_t word = second ? next.freqWord2 : next.freqWord;
+    if (word == 0) continue;
+    if (word == channel.loadedWord[0] || word == channel.loadedWord[1]) return;
+
+    const uint8_t idle = channel.driver->selectedReg() ^ 1;
+    channel.driver->loadFrequencyWord(idle, word);
+    channel.loadedWord[idle] = word;
+    return;
+  }
 }
 
 ToneGenerator::StepSequence ToneGenerator::getSequence_(model::ToneId sequence) const {
+  const std::size_t index = static_cast<std::size_t>(sequence);
+  if (planLoaded_ && index < kToneCount && planSequences_[index].length > 0) {
+    return planSequences_[index];
+  }
+  return builtinSequence_(sequence);
+}
+
+// Built-in Swedish cadences, used when no tone plan is loaded
+ToneGenerator::StepSequence ToneGenerator::builtinSequence_(model::ToneId sequence) const {
   switch (sequence) {
     case model::ToneId::Ready: {
       static constexpr Step steps[] = {
         {425.0f, 0},
       };
-      return {steps, sizeof(steps) / sizeof(steps[0])};
+      return {steps, sizeof(steps) / sizeof(steps[0]), false};
     }
     case model::ToneId::Ring: {
       static constexpr Step steps[] = {
         {425.0f, 1000},
         {0.0f, 5000},
       };
-      return {steps, sizeof(steps) / sizeof(steps[0])};
+      return {steps, sizeof(steps) / sizeof(steps[0]), false};
     }
     case model::ToneId::Busy: {
       static constexpr Step steps[] = {
         {425.0f, 250},
         {0.0f, 250},
       };
-      return {steps, sizeof(steps) / sizeof(steps[0])};
+      return {steps, sizeof(steps) / sizeof(steps[0]), false};
     }
     case model::ToneId::Fail: {
       static constexpr Step steps[] = {
@@ -137,12 +776,12 @@ ToneGenerator::StepSequence ToneGenerator::getSequence_(model::ToneId sequence)
         {1800.0f, 330},
         {0.0f, 1000},
       };
-      return {steps, sizeof(steps) / sizeof(steps[0])};
+      return {steps, sizeof(steps) / sizeof(steps[0]), false};
     }
     default:
       break;
   }
-  return {nullptr, 0};
+  return {nullptr, 0, false};
 }
 
 ToneGenerator::ChannelState* ToneGenerator::findChannelByDac_(uint8_t dac) {
@@ -154,21 +793,100 @@ ToneGenerator::ChannelState* ToneGenerator::findChannelByDac_(uint8_t dac) {
   return nullptr;
 }
 
+ToneGenerator::ChannelState* ToneGenerator::findSharedChannel_(model::ToneId sequence) {
+  for (auto& channel : channels_) {
+    if (channel.playing && channel.shared && channel.tone == sequence) {
+      return &channel;
+    }
+  }
+  return nullptr;
+}
+
 ToneGenerator::ChannelState* ToneGenerator::findFreeChannel_() {
   for (auto& channel : channels_) {
-    if (!channel.playing) {
+    if (!channel.playing && isUsable_(channel)) {
       return &channel;
     }
   }
   return nullptr;
 }
 
+ToneGenerator::ChannelState* ToneGenerator::findFreeSynth_() {
+  ChannelState& channel = channels_[kSynthChannel];
+  return (!channel.playing && isUsable_(channel) && channel.synth != nullptr) ? &channel : nullptr;
+}
+
+bool ToneGenerator::isUsable_(const ChannelState& channel) const {
+  return channel.driver != nullptr || (channel.synth != nullptr && channel.synth->isReady() && !synthReserved_);
+}
+
+bool ToneGenerator::reserveSynth() {
+  ChannelState& channel = channels_[kSynthChannel];
+  if (channel.playing) {
+    if (!(channel.pinned && channel.listeners == 0)) return false;
+    stopTone(channel.dac);   // update() re-arms the dial tone on an AD9833
+  }
+  synthReserved_ = true;
+  return true;
+}
+
+// The synth counts cadence steps in samples itself, so no step timer here
+bool ToneGenerator::startSynth_(ChannelState& channel, const StepSequence& seq, model::ToneId sequence) {
+  if (seq.length > ToneSynth::kMaxSteps) {
+    return false;
+  }
+  ToneSynth::Step steps[ToneSynth::kMaxSteps];
+  for (std::size_t i = 0; i < seq.length; ++i) {
+    steps[i].frequencyHz = seq.steps[i].frequencyHz;
+    steps[i].frequency2Hz = seq.steps[i].frequency2Hz;
+    steps[i].durationMs = seq.steps[i].durationMs;
+  }
+  if (!channel.synth->play(steps, seq.length)) {
+    return false;
+  }
+
+  lock_();
+  channel.currentSequence = seq;
+  channel.currentStepIndex = 0;
+  channel.tone = sequence;
+  channel.shared = false;
+  channel.partner = nullptr;
+  channel.playing = true;
+  unlock_();
+  return true;
+}
+
 void ToneGenerator::stopChannel_(ChannelState& channel) {
+  lock_();
+  channel.generation++;
+  if (channel.timer != nullptr) {
+    esp_timer_stop(channel.timer);   // Not running is fine
+  }
   if (channel.driver != nullptr) {
     channel.driver->stopOutput();
   }
+  if (channel.synth != nullptr && channel.playing) {
+    channel.synth->stop();
+  }
+  ChannelState* partner = channel.partner;
+  if (channel.isPartner) {
+    // Stopped on its own: the primary carries on single-tone
+    for (auto& other : channels_) {
+      if (other.partner == &channel) other.partner = nullptr;
+    }
+  }
   channel.playing = false;
-  channel.currentSequence = StepSequence{nullptr, 0};
+  channel.shared = false;
+  channel.pinned = false;
+  channel.listeners = 0;
+  channel.partner = nullptr;
+  channel.isPartner = false;
+  channel.currentSequence = StepSequence{nullptr, 0, false};
   channel.currentStepIndex = 0;
-  channel.stepStartTimeMs = 0;
+  channel.stepDeadlineUs = 0;
+  unlock_();
+
+  if (partner != nullptr) {
+    stopChannel_(*partner);
+  }
 }
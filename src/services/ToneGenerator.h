@@ -3,9 +3,12 @@
 #include <Arduino.h>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <esp_timer.h>
 
 #include "config.h"
 #include "drivers/AD9833Driver.h"
+#include "services/ToneSynth.h"
 #include "model/Types.h"
 #include "settings/Settings.h"
 
@@ -13,37 +16,189 @@ class ToneGenerator {
 public:
   ToneGenerator(AD9833Driver& driver1, AD9833Driver& driver2, AD9833Driver& driver3);
   void begin();
+
+  // Optional software synth on D_OUTL, used as a fourth channel once the
+  // AD9833s are taken. Dual tones prefer it since it needs no partner.
+  void setSynth(ToneSynth* synth) { channels_[kSynthChannel].synth = synth; }
+  // D_OUTL carries one stream. An announcement (AudioPlayer) reserves it:
+  // fails while a line listens to the synth, stops an idle pre-armed tone,
+  // and keeps the allocator off the synth until releaseSynth().
+  bool reserveSynth();
+  void releaseSynth() { synthReserved_ = false; }
+  bool synthReserved() const { return synthReserved_; }
   uint8_t startTone(model::ToneId sequence);
   void stopTone(uint8_t dac);
+
+  // Shared tone sessions: one channel per ToneId is bridged to every line that
+  // needs it. acquireTone() joins a running session or starts a new one and
+  // returns its DAC (0 if no channel is free). releaseTone() stops the channel
+  // when the last listener leaves.
+  uint8_t acquireTone(model::ToneId sequence);
+  void releaseTone(uint8_t dac);
+  uint8_t listenerCount(uint8_t dac) const;
+
+  // Per-line allocator on top of the shared sessions. Each ToneId has a
+  // priority (Ready > Busy > Fail > Ring). If no channel is free a request may
+  // preempt a lower-priority session; otherwise the line waits in a queue and
+  // is attached when a channel frees up. Attach/detach are reported through
+  // the callbacks so the owner can switch the crosspoint.
+  using ToneAttachCallback = std::function<void(uint8_t /*line*/, uint8_t /*dac*/)>;
+  using ToneDetachCallback = std::function<void(uint8_t /*line*/, uint8_t /*dac*/)>;
+  void setAttachCallback(ToneAttachCallback cb) { attachCallback_ = std::move(cb); }
+  void setDetachCallback(ToneDetachCallback cb) { detachCallback_ = std::move(cb); }
+
+  uint8_t requestTone(uint8_t line, model::ToneId sequence);  // DAC if attached now, 0 if queued/refused
+  void releaseLine(uint8_t line);                              // Detach or dequeue
+
+  struct AllocatorStats {
+    uint32_t requests = 0;
+    uint32_t immediate = 0;        // Attached without waiting
+    uint32_t queued = 0;
+    uint32_t preemptions = 0;      // Sessions stopped for a higher-priority tone
+    uint32_t starved = 0;          // Waits longer than kStarvationMs
+    uint32_t waitedAttach = 0;     // Attached from the queue
+    uint32_t waitSumMs = 0;
+    uint32_t waitMaxMs = 0;
+    uint8_t  queueHighWater = 0;
+  };
+  const AllocatorStats& stats() const { return stats_; }
+
+  static constexpr uint32_t kStarvationMs = 2000;
+  static constexpr uint32_t kTimerLockWaitMs = 2;     // Timer callback never blocks longer than this
+  static constexpr uint64_t kTimerRetryUs = 1000;     // Re-arm delay when the mutex was busy
+
+  // Cadence steps are advanced from a one-shot esp_timer per channel, with
+  // deadlines on an absolute time base so loop stalls do not add jitter.
+  struct CadenceStats {
+    uint32_t steps = 0;
+    uint32_t lateSumUs = 0;     // Timer callback vs. step deadline
+    uint32_t lateMaxUs = 0;
+    uint32_t staleDropped = 0;  // Callback from a cadence that was stopped or restarted
+    uint32_t lockRetries = 0;   // Callback could not take the mutex in time, re-armed
+  };
+  const CadenceStats& cadenceStats() const { return cadenceStats_; }
+
+  // Tone plans: /tones/<name>.txt on LittleFS, one line per tone:
+  //   busy = 425/250, 0/250        (frequency Hz / duration ms, 0 Hz = silence)
+  //   ready = 350+440/0            (dual tone, uses two generators)
+  // The plan is validated and compiled into a flat step table once; on any
+  // error the built-in Swedish cadences are kept.
+  bool loadTonePlan(const String& name);
+  bool hasTonePlan() const { return planLoaded_; }
+  // True when nothing but an idle pre-armed dial tone is playing, which
+  // loadTonePlan() stops itself
+  bool canLoadTonePlan() const;
+
   void update();
   bool isPlaying() const;
 
 private:
+  // Frequency words are computed at compile time for the built-in cadences
+  // and once at load for tone plans. frequency2Hz > 0 makes it a dual tone.
   struct Step {
     float     frequencyHz;
+    float     frequency2Hz;
     uint32_t  durationMs;
+    uint32_t  freqWord;
+    uint32_t  freqWord2;
+    constexpr Step() : Step(0.0f, 0.0f, 0) {}
+    constexpr Step(float hz, uint32_t ms) : Step(hz, 0.0f, ms) {}
+    constexpr Step(float hz, float hz2, uint32_t ms)
+      : frequencyHz(hz), frequency2Hz(hz2), durationMs(ms),
+        freqWord(cfg::ad9833::frequencyWord(hz)), freqWord2(cfg::ad9833::frequencyWord(hz2)) {}
   };
 
+  static constexpr std::size_t kToneCount = 4;          // model::ToneId values
+  static constexpr std::size_t kMaxPlanSteps = 32;
+  static constexpr std::size_t kMaxStepsPerTone = 8;
+
+  static constexpr uint32_t kNoWord = 0xFFFFFFFFu;
+
   struct StepSequence {
     const Step* steps;
     std::size_t length;
+    bool dual;                // Needs a partner channel for frequency2Hz
   };
 
   struct ChannelState {
     AD9833Driver* driver = nullptr;
+    ToneSynth* synth = nullptr;        // Virtual channel: cadence runs in the synth task
     uint8_t dac = 0;
     bool playing = false;
-    StepSequence currentSequence{nullptr, 0};
+    StepSequence currentSequence{nullptr, 0, false};
     std::size_t currentStepIndex = 0;
-    uint32_t stepStartTimeMs = 0;
+    int64_t stepDeadlineUs = 0;      // End of the current step (esp_timer time base)
+    esp_timer_handle_t timer = nullptr;
+    volatile uint32_t generation = 0;  // Bumped on every start/stop, stale timer callbacks compare it
+    ToneGenerator* owner = nullptr;
+    model::ToneId tone = model::ToneId::Ready;
+    bool shared = false;       // Started through acquireTone()
+    uint8_t listeners = 0;     // Lines bridged to this channel
+    bool pinned = false;       // Pre-armed dial tone, keeps playing with no listeners
+    uint32_t loadedWord[2] = {kNoWord, kNoWord};   // What FREQ0/FREQ1 currently hold
+    ChannelState* partner = nullptr;   // Second generator of a dual tone
+    bool isPartner = false;            // Driven by another channel's cadence
   };
 
-  void applyStep_(ChannelState& channel, const Step& step);
+  void applyStep_(ChannelState& channel);
+  void applyWord_(ChannelState& channel, uint32_t word);
+  void preloadNext_(ChannelState& channel, const StepSequence& seq, std::size_t index, bool second);
+  void notifyLine_(uint8_t line, uint8_t dac, bool attach);
+  StepSequence builtinSequence_(model::ToneId sequence) const;
+  bool parsePlanLine_(const String& line, Step* steps, std::size_t& used,
+                      StepSequence (&seqs)[kToneCount], String& error);
+  static void onStepTimer_(void* arg);
+  void timerStep_(ChannelState& channel, uint32_t generation);
+  void advanceStep_(ChannelState& channel);
+  void advanceLocked_(ChannelState& channel);
+  void armStepTimer_(ChannelState& channel);
+  void lock_();
+  void unlock_();
   ChannelState* findChannelByDac_(uint8_t dac);
   ChannelState* findFreeChannel_();
+  ChannelState* findFreeSynth_();
+  bool isUsable_(const ChannelState& channel) const;
+  bool startSynth_(ChannelState& channel, const StepSequence& seq, model::ToneId sequence);
+  ChannelState* findSharedChannel_(model::ToneId sequence);
+  bool startChannel_(ChannelState& channel, model::ToneId sequence);
   StepSequence getSequence_(model::ToneId sequence) const;
   void stopChannel_(ChannelState& channel);
 
+  struct WaitEntry {
+    uint8_t line;
+    model::ToneId tone;
+    uint32_t sinceMs;
+    bool starvedCounted;
+  };
+
+  static uint8_t priority_(model::ToneId tone);
+  uint8_t attachLine_(uint8_t line, model::ToneId tone, bool allowPreempt);
+  bool preemptFor_(model::ToneId tone);
+  bool reclaimIdlePinned_();
+  void ensurePrearmed_();
+  void serviceQueue_();
+  void enqueue_(uint8_t line, model::ToneId tone, uint32_t sinceMs);
+  int findWaiting_(uint8_t line) const;
+  void removeWaiting_(int index);
+
 private:
-  ChannelState channels_[3];
+  static constexpr std::size_t kSynthChannel = 3;
+  ChannelState channels_[4];
+  bool synthReserved_ = false;
+
+  uint8_t lineDac_[cfg::lines::MAX_LINES] = {0};   // DAC a line is bridged to, 0 = none
+  WaitEntry waitQueue_[cfg::lines::MAX_LINES];
+  uint8_t waitCount_ = 0;
+  ToneAttachCallback attachCallback_;
+  ToneDetachCallback detachCallback_;
+  AllocatorStats stats_;
+
+  // Guards channel playback state and SPI between loop and esp_timer task
+  SemaphoreHandle_t mutex_ = nullptr;
+  CadenceStats cadenceStats_;
+
+  // Compiled tone plan (flat table, no allocation after load)
+  Step planSteps_[kMaxPlanSteps];
+  StepSequence planSequences_[kToneCount] = {};
+  bool planLoaded_ = false;
 };
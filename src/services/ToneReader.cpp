@@ -2,7 +2,11 @@
 #include "services/LineManager.h"
 
 ToneReader::ToneReader(InterruptManager& interruptManager, MCPDriver& mcpDriver, Settings& settings, LineManager& lineManager)
-  : interruptManager_(interruptManager), mcpDriver_(mcpDriver), settings_(settings), lineManager_(lineManager) {}
+  : interruptManager_(interruptManager), mcpDriver_(mcpDriver), settings_(settings), lineManager_(lineManager) {
+  for (std::size_t i = 0; i < cfg::lines::MAX_LINES; ++i) {
+    lastDtmfDigitByLine_[i] = '\0';
+  }
+}
 
 
 void ToneReader::activate()
@@ -13,39 +17,73 @@ void ToneReader::activate()
   }
   isActive = true;
   mcpDriver_.digitalWriteMCP(cfg::mcp::MCP_MAIN_ADDRESS, cfg::mcp::PWDN_MT8870 , false);
-  
-  // Small delay to let MT8870 stabilize after power on
-  delay(10);
+
+  // MT8870 needs a moment to start its oscillator; update() waits it out
+  // (Powering -> Settling -> Active) instead of blocking the loop here.
+  powerState_ = PowerState::Powering;
+  powerStateSinceMs_ = millis();
+  settleStdEvents_ = 0;
   
   // Reset all state variables to ensure clean start
   lastStdLevel_ = false;
   stdRisingEdgePending_ = false;
   stdRisingEdgeTime_ = 0;
-  for (int i = 0; i < 8; ++i) {
+  stdCaptureValid_ = false;
+  for (std::size_t i = 0; i < cfg::lines::MAX_LINES; ++i) {
     lastDtmfTimeByLine_[i] = 0;
-    lastDtmfNibbleByLine_[i] = INVALID_DTMF_NIBBLE;
+    lastDtmfDigitByLine_[i] = '\0';
+    scanJoinMs_[i] = 0;
+    lastVisitMs_[i] = 0;
   }
+  cycleSeen_.clear();
   scanCursor_ = -1;
   currentScanLine_ = -1;
   stdLineIndex_ = -1;
   lastTmuxSwitchAtMs_ = 0;
+  prevScanMask_.clear();
+  cycleStartMs_ = millis();
   scanPauseLogged_ = false;
-  lastLoggedScanMask_ = 0xFF;
-  
-  // Clear any pending STD interrupts that might have accumulated
-  int clearedCount = 0;
+  lastLoggedScanMask_ = model::LineMask::all();
+}
+
+// Powering/Settling: STD events are drained and dropped. Settling ends once
+// STD has been quiet (and low) for MT8870_SETTLE_QUIET_MS, or after
+// MT8870_SETTLE_MAX_MS regardless, with lastStdLevel_ taken from the last event.
+bool ToneReader::updatePower_(unsigned long now) {
+  if (powerState_ == PowerState::Active) return true;
+
   while (true) {
     IntResult ir = interruptManager_.pollEvent(cfg::mcp::MCP_MAIN_ADDRESS, cfg::mcp::STD);
     if (!ir.hasEvent) break;
-    clearedCount++;
+    settleStdEvents_++;
+    lastStdLevel_ = ir.level;
+    if (powerState_ == PowerState::Settling) powerStateSinceMs_ = now;   // Restart the quiet period
   }
-  
+
+  const unsigned long inState = now - powerStateSinceMs_;
+  if (powerState_ == PowerState::Powering) {
+    if (inState < MT8870_POWER_UP_MS) return false;
+    powerState_ = PowerState::Settling;
+    powerStateSinceMs_ = now;
+    settleStartMs_ = now;
+    return false;
+  }
+
+  const bool quiet = !lastStdLevel_ && inState >= MT8870_SETTLE_QUIET_MS;
+  if (!quiet && now - settleStartMs_ < MT8870_SETTLE_MAX_MS) return false;
+
+  powerState_ = PowerState::Active;
+  cycleStartMs_ = now;
   if (settings_.debugTRLevel >= 2) {
-    Serial.print(F("ToneReader: State reset after activation, cleared "));
-    Serial.print(clearedCount);
+    Serial.print(F("ToneReader: MT8870 active after "));
+    Serial.print(now - settleStartMs_ + MT8870_POWER_UP_MS);
+    Serial.print(F("ms, cleared "));
+    Serial.print(settleStdEvents_);
     Serial.println(F(" pending interrupts"));
-    util::UIConsole::log("State reset after activation, cleared " + String(clearedCount) + " pending interrupts", "ToneReader");
+    util::UIConsole::log("MT8870 active after " + String(now - settleStartMs_ + MT8870_POWER_UP_MS) +
+                         "ms, cleared " + String(settleStdEvents_) + " pending interrupts", "ToneReader");
   }
+  return true;
 }
 
 
@@ -56,16 +94,27 @@ void ToneReader::deactivate()
     util::UIConsole::log("ToneReader: Deactivating MT8870 power", "ToneReader");
   }
   isActive = false;
+  powerState_ = PowerState::Off;
   mcpDriver_.digitalWriteMCP(cfg::mcp::MCP_MAIN_ADDRESS, cfg::mcp::PWDN_MT8870 , true);
+
+  if (settings_.debugTRLevel >= 1 && scanStats_.digits > 0) {
+    const String summary = "digits=" + String(scanStats_.digits) +
+                           " latency avg/max=" + String(scanStats_.latencySumMs / scanStats_.digits) + "/" +
+                           String(scanStats_.latencyMaxMs) + "ms short=" + String(scanStats_.shortTones) +
+                           " cycle max=" + String(scanStats_.cycleMaxMs) + "ms tone avg=" + String(avgToneMs_) + "ms";
+    Serial.println("ToneReader: Scan stats " + summary);
+    util::UIConsole::log("Scan stats " + summary, "ToneReader");
+  }
   
   // Reset state variables when deactivating
   lastStdLevel_ = false;
   stdRisingEdgePending_ = false;
   stdRisingEdgeTime_ = 0;
+  stdCaptureValid_ = false;
   currentScanLine_ = -1;
   stdLineIndex_ = -1;
   scanPauseLogged_ = false;
-  lastLoggedScanMask_ = 0xFF;
+  lastLoggedScanMask_ = model::LineMask::all();
 }
 
 void ToneReader::update() {
@@ -77,13 +126,10 @@ void ToneReader::update() {
   // instead of direct GPIO polling for more reliable edge detection
   
   unsigned long now = millis();
-  uint8_t scanMaskNow = lineManager_.toneScanMask;
-  uint8_t activeScanLines = 0;
-  for (int i = 0; i < 8; ++i) {
-    if (scanMaskNow & (1u << i)) {
-      activeScanLines++;
-    }
+  if (!updatePower_(now)) {
+    return;
   }
+  const unsigned activeScanLines = lineManager_.toneScanMask.count();
   unsigned long requiredStdStableMs = settings_.dtmfStdStableMs;
   if (activeScanLines > 1 && requiredStdStableMs > 8) {
     requiredStdStableMs = 8;
@@ -110,7 +156,7 @@ void ToneReader::update() {
       
       // Only process DTMF if we know which line generated the current STD cycle.
       int idx = stdLineIndex_;
-      if (idx < 0 || idx >= 8) {
+      if (idx < 0 || idx >= static_cast<int>(cfg::lines::MAX_LINES)) {
         if (settings_.debugTRLevel >= 1) {
           Serial.println(F("ToneReader: Ignoring DTMF - no scanned line associated with STD"));
           util::UIConsole::log("Ignoring DTMF - no scanned line associated with STD", "ToneReader");
@@ -131,94 +177,31 @@ void ToneReader::update() {
           return; // Don't update debounce variables, completely ignore this interrupt
         }
         
-        // Check debouncing: ignore if same digit detected within debounce period
-        // Use unsigned subtraction which handles millis() rollover correctly
-        unsigned long timeSinceLastDtmf = now - lastDtmfTimeByLine_[idx];
-        bool isSameDigit = (nibble == lastDtmfNibbleByLine_[idx]);
-        bool withinDebounceWindow = (timeSinceLastDtmf < settings_.dtmfDebounceMs);
-        bool isDuplicate = isSameDigit && withinDebounceWindow;
-        
+        char ch = decodeDtmf(nibble);
         if (settings_.debugTRLevel >= 2) {
-          Serial.print(F("ToneReader: Debounce check - timeSince="));
-          Serial.print(timeSinceLastDtmf);
-          Serial.print(F("ms isSameDigit="));
-          Serial.print(isSameDigit ? F("YES") : F("NO"));
-          Serial.print(F(" withinWindow="));
-          Serial.print(withinDebounceWindow ? F("YES") : F("NO"));
-          Serial.print(F(" isDuplicate="));
-          Serial.println(isDuplicate ? F("YES") : F("NO"));
+          Serial.print(F("ToneReader: DECODED - nibble=0x"));
+          Serial.print(nibble, HEX);
+          Serial.print(F(" => char='"));
+          Serial.print(ch);
+          Serial.println('\'');
+          util::UIConsole::log("ToneReader DECODED: nibble=0x" + String(nibble, HEX) +
+                                   " => '" + String(ch) + "'",
+                               "ToneReader");
         }
-        
-        if (!isDuplicate) {
-          lastDtmfTimeByLine_[idx] = now;
-          lastDtmfNibbleByLine_[idx] = nibble;
-          
-          char ch = decodeDtmf(nibble);
-          if (settings_.debugTRLevel >= 2) {
-            Serial.print(F("ToneReader: DECODED - nibble=0x"));
-            Serial.print(nibble, HEX);
-            Serial.print(F(" => char='"));
-            Serial.print(ch);
-            Serial.println('\'');
-            util::UIConsole::log("ToneReader DECODED: nibble=0x" + String(nibble, HEX) +
-                                     " => '" + String(ch) + "'",
-                                 "ToneReader");
-          }
 
-          if (ch != '\0') {
-            lineManager_.lastLineReady = idx;
-
-            // Only set status to ToneDialing if the line is currently in Ready state and we have a valid digit
-            if (idx >= 0 && lineManager_.getLine(idx).currentLineStatus == model::LineStatus::Ready) {
-              lineManager_.setStatus(idx, model::LineStatus::ToneDialing);
-            }
-            lineManager_.resetLineTimer(idx);
-
-            // To avoid strange signals thats detected as dtomf tones, only accept tones when line is in Ready or ToneDialing state
-            if (idx >= 0 && (lineManager_.getLine(idx).currentLineStatus == model::LineStatus::Ready || 
-                     lineManager_.getLine(idx).currentLineStatus == model::LineStatus::ToneDialing)) {
-              auto& line = lineManager_.getLine(idx);
-              line.dialedDigits += ch;
-              Serial.print(MAGENTA);
-              Serial.print(F("ToneReader: Added to line "));
-              Serial.print(idx);
-              Serial.print(F(" digit='"));
-              Serial.print(ch);
-              Serial.print(F("' dialedDigits=\""));
-              Serial.print(line.dialedDigits);
-              Serial.println('"');
-              Serial.print(COLOR_RESET);
-              util::UIConsole::log("ToneReader: line " + String(idx) + " +=" + String(ch) + 
-                  " dialedDigits=\"" + line.dialedDigits + "\"", "ToneReader");
-            } else if (idx >= 0) {
-              if (settings_.debugTRLevel >= 1) {
-                Serial.println(F("ToneReader: WARNING - Line not in Ready/ToneDialing state"));
-                util::UIConsole::log("WARNING - Line not in valid state for DTMF", "ToneReader");
-              }
-            } else {
-              if (settings_.debugTRLevel >= 1) {
-                Serial.println(F("ToneReader: WARNING - No valid scanned line to store digit"));
-                util::UIConsole::log("WARNING - No valid scanned line to store digit", "ToneReader");
-              }
-            }
-          } else {
-            if (settings_.debugTRLevel >= 1) {
-              Serial.print(F("ToneReader: WARNING - Decoded character is NULL (invalid nibble=0x"));
-              Serial.print(nibble, HEX);
-              Serial.println(F(")"));
-              util::UIConsole::log("WARNING - Decoded character is NULL (invalid nibble=0x" + 
-                        String(nibble, HEX) + ")", "ToneReader");
-            }
+        if (ch == '\0') {
+          if (settings_.debugTRLevel >= 1) {
+            Serial.print(F("ToneReader: WARNING - Decoded character is NULL (invalid nibble=0x"));
+            Serial.print(nibble, HEX);
+            Serial.println(F(")"));
+            util::UIConsole::log("WARNING - Decoded character is NULL (invalid nibble=0x" + 
+                      String(nibble, HEX) + ")", "ToneReader");
           }
-        } else if (settings_.debugTRLevel >= 1) {
-          Serial.print(F("ToneReader: Duplicate ignored (debouncing) nibble=0x"));
-          Serial.print(nibble, HEX);
-          Serial.print(F(" time="));
-          Serial.print(timeSinceLastDtmf);
-          Serial.println(F("ms"));
-          util::UIConsole::log("Duplicate ignored (debouncing) nibble=0x" + 
-                              String(nibble, HEX) + " time=" + String(timeSinceLastDtmf) + "ms", 
-                              "ToneReader");
+        } else if (acceptDigit(idx, ch, now)) {
+          const uint32_t latency = now - stdRisingEdgeTime_;
+          scanStats_.digits++;
+          scanStats_.latencySumMs += latency;
+          if (latency > scanStats_.latencyMaxMs) scanStats_.latencyMaxMs = latency;
         }
       } else {
         if (settings_.debugTRLevel >= 1) {
@@ -283,23 +266,12 @@ void ToneReader::update() {
         util::UIConsole::log("ToneReader: Rising edge detected - marking for stability check", "ToneReader");
       }
       
-      // Debug: Read Q pins immediately at rising edge
+      // INTCAP latched Q1-Q4 together with STD; keep it so no extra read is needed
+      stdCapturePort_ = ir.intcap;
+      stdCaptureValid_ = true;
       if (settings_.debugTRLevel >= 2) {
-        uint16_t gpioAB = 0;
-        if (mcpDriver_.readGpioAB16(cfg::mcp::MCP_MAIN_ADDRESS, gpioAB)) {
-          uint8_t q1 = (gpioAB >> cfg::mcp::Q1) & 0x1;
-          uint8_t q2 = (gpioAB >> cfg::mcp::Q2) & 0x1;
-          uint8_t q3 = (gpioAB >> cfg::mcp::Q3) & 0x1;
-          uint8_t q4 = (gpioAB >> cfg::mcp::Q4) & 0x1;
-          Serial.print(F("ToneReader: Q-pins at rising edge: Q4="));
-          Serial.print(q4);
-          Serial.print(F(" Q3="));
-          Serial.print(q3);
-          Serial.print(F(" Q2="));
-          Serial.print(q2);
-          Serial.print(F(" Q1="));
-          Serial.println(q1);
-        }
+        Serial.print(F("ToneReader: Q-pins at rising edge (INTCAP): nibble=0x"));
+        Serial.println(nibbleFromPort_(ir.intcap), HEX);
       }
       
       // Mark the rising edge and record the time
@@ -326,6 +298,7 @@ void ToneReader::update() {
           Serial.println(F("ms"));
         }
         if (toneDuration < settings_.dtmfMinToneDurationMs) {
+          scanStats_.shortTones++;
           if (settings_.debugTRLevel >= 1) {
             Serial.print(F("ToneReader: Tone too short ("));
             Serial.print(toneDuration);
@@ -338,6 +311,7 @@ void ToneReader::update() {
           }
           // Cancel the pending tone - don't process it
           stdRisingEdgePending_ = false;
+          stdCaptureValid_ = false;
           stdLineIndex_ = -1;
           if (settings_.debugTRLevel >= 2) {
             Serial.println(F("ToneReader: Scan RESUMED - tone rejected (too short)"));
@@ -350,6 +324,14 @@ void ToneReader::update() {
         stdRisingEdgePending_ = false;
       }
       
+      // Track how long real tones last; the scan cycle is sized from it
+      if (stdLineIndex_ >= 0) {
+        const uint32_t duration = millis() - stdRisingEdgeTime_;
+        if (duration >= settings_.dtmfMinToneDurationMs && duration < 2000) {
+          avgToneMs_ = (avgToneMs_ * 7 + duration) / 8;
+        }
+      }
+
       // Only set timer if line is in ToneDialing state (meaning a valid digit was processed)
       if (stdLineIndex_ >= 0) {
         auto& line = lineManager_.getLine(stdLineIndex_);
@@ -388,6 +370,8 @@ void ToneReader::update() {
       if (stdHigh) {
         stdRisingEdgePending_ = true;
         stdRisingEdgeTime_ = now;
+        stdCapturePort_ = gpioAB;     // STD already high: Q1-Q4 are valid in this read
+        stdCaptureValid_ = true;
         stdLineIndex_ = currentScanLine_;
         lastStdLevel_ = true;
         if (settings_.debugTRLevel >= 2) {
@@ -450,15 +434,31 @@ void ToneReader::update() {
   }
 }
 
+// Q1..Q4 i cfg::mcp är pinindex 0..15 i 16-bitarsordet (A=0..7, B=8..15)
+uint8_t ToneReader::nibbleFromPort_(uint16_t port) {
+  return static_cast<uint8_t>((((port >> cfg::mcp::Q4) & 0x1u) << 3) |
+                              (((port >> cfg::mcp::Q3) & 0x1u) << 2) |
+                              (((port >> cfg::mcp::Q2) & 0x1u) << 1) |
+                              (((port >> cfg::mcp::Q1) & 0x1u) << 0));
+}
+
+// The nibble comes from the port latched on the STD edge; one GPIO read after
+// the stability wait confirms it. Without a capture that read is the source.
 bool ToneReader::readDtmfNibble(uint8_t& nibble) {
-  if (settings_.debugTRLevel >= 2) {
-    Serial.println(F("ToneReader: Reading DTMF nibble from MCP GPIO..."));
-    util::UIConsole::log("Reading DTMF nibble from MCP GPIO...", "ToneReader");
-  }
-  
+  const bool haveCapture = stdCaptureValid_;
+  stdCaptureValid_ = false;
+
   // Läs aktuell GPIO-status (STD är hög nu => MT8870 håller data stabil)
   uint16_t gpioAB = 0;
   if (!mcpDriver_.readGpioAB16(cfg::mcp::MCP_MAIN_ADDRESS, gpioAB)) {
+    if (haveCapture) {
+      nibble = nibbleFromPort_(stdCapturePort_);
+      if (settings_.debugTRLevel >= 1) {
+        Serial.println(F("ToneReader: Verification read failed, using INTCAP nibble"));
+        util::UIConsole::log("Verification read failed, using INTCAP nibble", "ToneReader");
+      }
+      return true;
+    }
     if (settings_.debugTRLevel >= 1) {
       Serial.println(F("ToneReader: ERROR - Failed to read GPIO from MCP_MAIN"));
       util::UIConsole::log("ERROR - Failed to read GPIO from MCP_MAIN", "ToneReader");
@@ -466,50 +466,116 @@ bool ToneReader::readDtmfNibble(uint8_t& nibble) {
     return false;
   }
 
-  if (settings_.debugTRLevel >= 2) {
-    Serial.print(F("ToneReader: Raw GPIOAB=0b"));
-    for (int i = 15; i >= 0; i--) {
-      Serial.print((gpioAB & (1 << i)) ? '1' : '0');
+  const uint8_t live = nibbleFromPort_(gpioAB);
+  const bool stdHigh = (gpioAB & (1u << cfg::mcp::STD)) != 0;
+  if (!haveCapture) {
+    nibble = live;
+  } else {
+    nibble = nibbleFromPort_(stdCapturePort_);
+    // STD still high means the MT8870 latch is settled; trust it over the edge snapshot
+    if (stdHigh && live != nibble) {
+      if (settings_.debugTRLevel >= 1) {
+        Serial.print(F("ToneReader: INTCAP nibble=0x"));
+        Serial.print(nibble, HEX);
+        Serial.print(F(" differs from GPIO nibble=0x"));
+        Serial.print(live, HEX);
+        Serial.println(F(", using GPIO"));
+        util::UIConsole::log("INTCAP nibble=0x" + String(nibble, HEX) + " differs from GPIO nibble=0x" +
+                             String(live, HEX) + ", using GPIO", "ToneReader");
+      }
+      nibble = live;
     }
-    Serial.print(F(" (0x"));
+  }
+
+  if (settings_.debugTRLevel >= 1) {
+    Serial.print(F("ToneReader: MT8870 nibble=0x"));
+    Serial.print(nibble, HEX);
+    Serial.print(F(" (GPIOAB=0x"));
     Serial.print(gpioAB, HEX);
+    Serial.print(haveCapture ? F(", INTCAP=0x") : F(", no INTCAP"));
+    if (haveCapture) Serial.print(stdCapturePort_, HEX);
     Serial.println(F(")"));
-    util::UIConsole::log("Raw GPIOAB=0b" + String(gpioAB, BIN) +
-                             " (0x" + String(gpioAB, HEX) + ")",
+    util::UIConsole::log("ToneReader: nibble=0x" + String(nibble, HEX) +
+                             " GPIOAB=0x" + String(gpioAB, HEX) +
+                             (haveCapture ? " INTCAP=0x" + String(stdCapturePort_, HEX) : String(" no INTCAP")),
                          "ToneReader");
   }
+  return true;
+}
 
-  // Q1..Q4 i cfg::mcp är pinindex 0..15 i 16-bitarsordet (A=0..7, B=8..15)
-  const bool q1 = (gpioAB & (1u << cfg::mcp::Q1)) != 0; // LSB
-  const bool q2 = (gpioAB & (1u << cfg::mcp::Q2)) != 0;
-  const bool q3 = (gpioAB & (1u << cfg::mcp::Q3)) != 0;
-  const bool q4 = (gpioAB & (1u << cfg::mcp::Q4)) != 0; // MSB
+// Common digit sink for the MT8870 path and any other DTMF source (e.g. DtmfDetector).
+// Applies the per-line debounce and only stores digits for Ready/ToneDialing lines.
+// Returns true if the digit was not a debounced duplicate.
+bool ToneReader::acceptDigit(int idx, char ch, unsigned long now) {
+  if (idx < 0 || idx >= static_cast<int>(cfg::lines::MAX_LINES) || ch == '\0') {
+    if (settings_.debugTRLevel >= 1) {
+      Serial.println(F("ToneReader: WARNING - No valid scanned line to store digit"));
+      util::UIConsole::log("WARNING - No valid scanned line to store digit", "ToneReader");
+    }
+    return false;
+  }
 
-  nibble = (static_cast<uint8_t>(q4) << 3) |
-           (static_cast<uint8_t>(q3) << 2) |
-           (static_cast<uint8_t>(q2) << 1) |
-           (static_cast<uint8_t>(q1) << 0);
+  // Check debouncing: ignore if same digit detected within debounce period
+  // Use unsigned subtraction which handles millis() rollover correctly
+  unsigned long timeSinceLastDtmf = now - lastDtmfTimeByLine_[idx];
+  bool isSameDigit = (ch == lastDtmfDigitByLine_[idx]);
+  bool withinDebounceWindow = (timeSinceLastDtmf < settings_.dtmfDebounceMs);
+  bool isDuplicate = isSameDigit && withinDebounceWindow;
+  
+  if (settings_.debugTRLevel >= 2) {
+    Serial.print(F("ToneReader: Debounce check - timeSince="));
+    Serial.print(timeSinceLastDtmf);
+    Serial.print(F("ms isSameDigit="));
+    Serial.print(isSameDigit ? F("YES") : F("NO"));
+    Serial.print(F(" withinWindow="));
+    Serial.print(withinDebounceWindow ? F("YES") : F("NO"));
+    Serial.print(F(" isDuplicate="));
+    Serial.println(isDuplicate ? F("YES") : F("NO"));
+  }
 
-  if (settings_.debugTRLevel >= 1) {
-    Serial.print(F("ToneReader: MT8870 pins - Q4="));
-    Serial.print(q4);
-    Serial.print(F(" Q3="));
-    Serial.print(q3);
-    Serial.print(F(" Q2="));
-    Serial.print(q2);
-    Serial.print(F(" Q1="));
-    Serial.print(q1);
-    Serial.print(F(" => nibble=0b"));
-    for (int i = 3; i >= 0; i--) {
-      Serial.print((nibble & (1 << i)) ? '1' : '0');
+  if (isDuplicate) {
+    if (settings_.debugTRLevel >= 1) {
+      Serial.print(F("ToneReader: Duplicate ignored (debouncing) digit='"));
+      Serial.print(ch);
+      Serial.print(F("' time="));
+      Serial.print(timeSinceLastDtmf);
+      Serial.println(F("ms"));
+      util::UIConsole::log("Duplicate ignored (debouncing) digit='" + 
+                          String(ch) + "' time=" + String(timeSinceLastDtmf) + "ms", 
+                          "ToneReader");
     }
-    Serial.print(F(" (0x"));
-    Serial.print(nibble, HEX);
-    Serial.println(F(")"));
-    util::UIConsole::log("ToneReader: Q4=" + String(q4) + " Q3=" + String(q3) +
-                             " Q2=" + String(q2) + " Q1=" + String(q1) + 
-                             " nibble=0x" + String(nibble, HEX),
-                         "ToneReader");
+    return false;
+  }
+
+  lastDtmfTimeByLine_[idx] = now;
+  lastDtmfDigitByLine_[idx] = ch;
+  lineManager_.lastLineReady = idx;
+
+  // Only set status to ToneDialing if the line is currently in Ready state and we have a valid digit
+  if (lineManager_.getLine(idx).currentLineStatus == model::LineStatus::Ready) {
+    lineManager_.setStatus(idx, model::LineStatus::ToneDialing);
+  }
+  lineManager_.resetLineTimer(idx);
+
+  // To avoid strange signals thats detected as dtomf tones, only accept tones when line is in Ready or ToneDialing state
+  auto& line = lineManager_.getLine(idx);
+  if (line.currentLineStatus == model::LineStatus::Ready || 
+      line.currentLineStatus == model::LineStatus::ToneDialing) {
+    line.dialedDigits += ch;
+    Serial.print(MAGENTA);
+    Serial.print(F("ToneReader: Added to line "));
+    Serial.print(idx);
+    Serial.print(F(" digit='"));
+    Serial.print(ch);
+    Serial.print(F("' dialedDigits=\""));
+    Serial.print(line.dialedDigits);
+    Serial.println('"');
+    Serial.print(COLOR_RESET);
+    util::UIConsole::log("ToneReader: line " + String(idx) + " +=" + String(ch) + 
+        " dialedDigits=\"" + line.dialedDigits + "\"", "ToneReader");
+  } else if (settings_.debugTRLevel >= 1) {
+    Serial.println(F("ToneReader: WARNING - Line not in Ready/ToneDialing state"));
+    util::UIConsole::log("WARNING - Line not in valid state for DTMF", "ToneReader");
   }
   return true;
 }
@@ -519,47 +585,112 @@ char ToneReader::decodeDtmf(uint8_t nibble) {
   return '\0';
 }
 
+// scanJoinMs_/lastDtmfTimeByLine_ of 0 mean "never", so nothing is hot at boot
+bool ToneReader::isHot_(int line, unsigned long now) const {
+  if (line < 0 || line >= static_cast<int>(cfg::lines::MAX_LINES)) return false;
+  if (scanJoinMs_[line] != 0 && (now - scanJoinMs_[line]) < SCAN_HOT_MS) return true;
+  return lastDtmfTimeByLine_[line] != 0 && (now - lastDtmfTimeByLine_[line]) < SCAN_HOT_MS;
+}
+
+// Long enough for the MT8870 to raise STD and for the stability check
+unsigned long ToneReader::baseDwellMs_() const {
+  const unsigned long recommendedDwell =
+      settings_.dtmfMinToneDurationMs + settings_.dtmfStdStableMs + 8;
+  const unsigned long configuredMinDwell =
+      (settings_.tmuxScanDwellMinMs < 1) ? 1 : settings_.tmuxScanDwellMinMs;
+  return (recommendedDwell > configuredMinDwell) ? recommendedDwell : configuredMinDwell;
+}
+
+// How soon a line should be listened to again, from the observed tone length
+unsigned long ToneReader::revisitMs_(int line, unsigned long now) const {
+  const unsigned long tone = (avgToneMs_ > baseDwellMs_()) ? avgToneMs_ : baseDwellMs_();
+  return isHot_(line, now) ? tone : tone * SCAN_COLD_FACTOR;
+}
+
+// Most overdue eligible line other than the current one; ties go round-robin
+// from the cursor, so with no hot lines this is a plain rotation.
+int ToneReader::pickNextLine_(model::LineMask eligible, unsigned long now) const {
+  model::LineMask others = eligible;
+  if (currentScanLine_ >= 0) others.reset(currentScanLine_);
+  if (others.none()) return eligible.first();
+
+  int best = -1;
+  long bestOverdue = 0;
+  const int first = others.nextAfter(scanCursor_);
+  int l = first;
+  do {
+    unsigned long since = now - lastVisitMs_[l];
+    if (since > SCAN_HOT_MS) since = SCAN_HOT_MS;   // Long unvisited lines are simply due
+    const long overdue = static_cast<long>(since) - static_cast<long>(revisitMs_(l, now));
+    if (best < 0 || overdue > bestOverdue) {
+      best = l;
+      bestOverdue = overdue;
+    }
+    l = others.nextAfter(l);
+  } while (l != first);
+  return best;
+}
+
 void ToneReader::toneScan(){
-  const uint8_t scanMask = lineManager_.toneScanMask;
+  const model::LineMask scanMask = lineManager_.toneScanMask;
 
   if (settings_.debugTRLevel >= 2 && scanMask != lastLoggedScanMask_) {
+    const unsigned long long maskBits = scanMask.value();
     Serial.print(F("ToneReader: Scan mask changed -> 0b"));
-    Serial.println(scanMask, BIN);
-    util::UIConsole::log("Scan mask changed -> 0b" + String(scanMask, BIN), "ToneReader");
+    Serial.println(String(maskBits, BIN));
+    util::UIConsole::log("Scan mask changed -> 0b" + String(maskBits, BIN), "ToneReader");
     lastLoggedScanMask_ = scanMask;
   }
 
-  if (scanMask == 0) {
-    currentScanLine_ = -1;
-    return;
+  const unsigned long now = millis();
+
+  // Lines that just entered the scan (went Ready) start out hot
+  for (uint8_t l : scanMask & ~prevScanMask_) {
+    scanJoinMs_[l] = now ? now : 1;
   }
+  prevScanMask_ = scanMask;
 
-  const unsigned long now = millis();
-  const unsigned long recommendedDwell =
-      settings_.dtmfMinToneDurationMs + settings_.dtmfStdStableMs + 8;
-  const unsigned long configuredMinDwell =
-      (settings_.tmuxScanDwellMinMs < 1) ? 1 : settings_.tmuxScanDwellMinMs;
-  const unsigned long dwellMs =
-      (recommendedDwell > configuredMinDwell) ? recommendedDwell : configuredMinDwell;
+  // Pulse dialing lines send no tones; leave the MT8870 to the others
+  model::LineMask eligible;
+  for (uint8_t l : scanMask) {
+    if (lineManager_.getLine(l).currentLineStatus != model::LineStatus::PulseDialing) eligible.set(l);
+  }
 
-  if ((now - lastTmuxSwitchAtMs_) < dwellMs && currentScanLine_ >= 0) {
+  if (eligible.none()) {
+    currentScanLine_ = -1;
     return;
   }
 
-  int nextLine = -1;
-  for (int offset = 1; offset <= 8; ++offset) {
-    const int candidate = (scanCursor_ + offset) & 0x07;
-    if ((scanMask & (1u << candidate)) != 0) {
-      nextLine = candidate;
-      break;
-    }
+  const bool onEligible = currentScanLine_ >= 0 && eligible.test(currentScanLine_);
+  if ((now - lastTmuxSwitchAtMs_) < baseDwellMs_() && onEligible) {
+    return;
   }
 
+  const int nextLine = pickNextLine_(eligible, now);
+
   if (nextLine < 0) {
     currentScanLine_ = -1;
     return;
   }
 
+  // Only one line to listen to and already there: no TMUX write needed
+  if (nextLine == currentScanLine_) {
+    return;
+  }
+  const int plainNext = scanMask.nextAfter(scanCursor_);
+  if (plainNext >= 0 && !eligible.test(plainNext)) scanStats_.pulseSkips++;
+
+  // Every eligible line heard at least once: one full cycle
+  cycleSeen_.set(nextLine);
+  cycleSeen_ &= eligible;
+  if (cycleSeen_ == eligible) {
+    const uint32_t cycle = now - cycleStartMs_;
+    scanStats_.cycleLastMs = cycle;
+    if (cycle > scanStats_.cycleMaxMs) scanStats_.cycleMaxMs = cycle;
+    cycleStartMs_ = now;
+    cycleSeen_.clear();
+  }
+
   const auto& line = lineManager_.getLine(nextLine);
   const uint8_t tmuxSel =
       static_cast<uint8_t>((line.tmuxAddress[0] ? 0x4u : 0x0u) |
@@ -571,7 +702,6 @@ void ToneReader::toneScan(){
 
   scanCursor_ = nextLine;
   currentScanLine_ = nextLine;
+  lastVisitMs_[nextLine] = now;
   lastTmuxSwitchAtMs_ = now;
-
-  (void)dwellMs; // Kept for tuning logic; scan-line switch logging intentionally reduced.
 }
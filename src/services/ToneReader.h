@@ -4,6 +4,7 @@
 #include "drivers/InterruptManager.h"
 #include "drivers/MCPDriver.h"
 #include "settings/Settings.h"
+#include "model/LineSet.h"
 
 class LineManager;
 
@@ -14,39 +15,92 @@ class ToneReader {
     void activate();
     void deactivate();
     void toneScan();
-    bool isActive = false;
+    bool isActive = false;            // MT8870 powered (possibly still settling)
+    bool isReady() const { return powerState_ == PowerState::Active; }
+
+    // Digit from any DTMF source (MT8870 here, or a DtmfDetector callback) for
+    // a line: debounce, Ready -> ToneDialing and dialedDigits, as for the MT8870.
+    bool acceptDigit(int line, char digit, unsigned long nowMs);
+
+    // Scan/detection figures: digit latency is STD rising edge -> digit accepted,
+    // short tones are STD pulses below dtmfMinToneDurationMs (likely cut by a switch).
+    struct ScanStats {
+      uint32_t digits = 0;
+      uint32_t shortTones = 0;
+      uint32_t latencySumMs = 0;
+      uint32_t latencyMaxMs = 0;
+      uint32_t cycleLastMs = 0;      // Time to visit every eligible line once
+      uint32_t cycleMaxMs = 0;
+      uint32_t pulseSkips = 0;       // Scan steps that skipped a pulse-dialing line
+    };
+    const ScanStats& scanStats() const { return scanStats_; }
+    uint32_t averageToneMs() const { return avgToneMs_; }
 
   private:
     // Ignore/avoid locking STD immediately after TMUX switch to reduce wrong-line locks.
     static constexpr unsigned long TMUX_POST_SWITCH_GUARD_MS = 8;
 
+    // Weighted scan: every visit is one base dwell (minimum valid tone + STD
+    // stability). Lines that just joined the scan or dialled a digit recently
+    // are "hot" and are due again after one observed tone length, cold lines
+    // after SCAN_COLD_FACTOR of them; the most overdue line is visited next.
+    // With more lines than fit, hot lines get proportionally more visits per
+    // cycle instead of a longer dwell that the budget could never pay for.
+    static constexpr unsigned long SCAN_HOT_MS = 3000;
+    static constexpr uint32_t TONE_LENGTH_INITIAL_MS = 100;
+    static constexpr uint32_t SCAN_COLD_FACTOR = 2;
+
+    // MT8870 power-up, run from update() so activate() never blocks the loop
+    static constexpr unsigned long MT8870_POWER_UP_MS = 10;      // PWDN released -> oscillator running
+    static constexpr unsigned long MT8870_SETTLE_QUIET_MS = 5;   // STD low and silent this long
+    static constexpr unsigned long MT8870_SETTLE_MAX_MS = 100;   // Go active anyway after this
+
+    enum class PowerState : uint8_t { Off, Powering, Settling, Active };
+    PowerState powerState_ = PowerState::Off;
+    unsigned long powerStateSinceMs_ = 0;
+    unsigned long settleStartMs_ = 0;
+    uint16_t settleStdEvents_ = 0;
+    bool updatePower_(unsigned long now);
+
     InterruptManager& interruptManager_;
     MCPDriver& mcpDriver_;
     Settings& settings_;
     LineManager& lineManager_;
 
     // Debouncing state
-    static constexpr uint8_t INVALID_DTMF_NIBBLE = 0xFF;
-    
-    unsigned long lastDtmfTimeByLine_[8] = {0};
-    uint8_t lastDtmfNibbleByLine_[8] = {
-      INVALID_DTMF_NIBBLE, INVALID_DTMF_NIBBLE, INVALID_DTMF_NIBBLE, INVALID_DTMF_NIBBLE,
-      INVALID_DTMF_NIBBLE, INVALID_DTMF_NIBBLE, INVALID_DTMF_NIBBLE, INVALID_DTMF_NIBBLE
-    };
+    unsigned long lastDtmfTimeByLine_[cfg::lines::MAX_LINES] = {0};
+    char lastDtmfDigitByLine_[cfg::lines::MAX_LINES];       // '\0' = none, set in ctor/activate()
     bool lastStdLevel_ = false;
     int scanCursor_ = -1;
     int currentScanLine_ = -1;
     int stdLineIndex_ = -1;
     unsigned long lastTmuxSwitchAtMs_ = 0;
     bool scanPauseLogged_ = false;
-    uint8_t lastLoggedScanMask_ = 0xFF;
+    model::LineMask lastLoggedScanMask_ = model::LineMask::all();
     
     // STD signal stability tracking
     unsigned long stdRisingEdgeTime_ = 0;  // When STD went high
     bool stdRisingEdgePending_ = false;    // Whether we're waiting to process a rising edge
 
+    // MAIN port as latched on the STD rising edge (INTCAP), Q1-Q4 included
+    uint16_t stdCapturePort_ = 0;
+    bool stdCaptureValid_ = false;
+
     // MT8870 utgångar: Q1 är LSB, Q4 är MSB
     bool readDtmfNibble(uint8_t& nibble);
+    bool isHot_(int line, unsigned long now) const;
+    unsigned long baseDwellMs_() const;
+    unsigned long revisitMs_(int line, unsigned long now) const;
+    int pickNextLine_(model::LineMask eligible, unsigned long now) const;
+
+    model::LineMask prevScanMask_;
+    unsigned long scanJoinMs_[cfg::lines::MAX_LINES] = {0};    // 0 = not joined since boot
+    unsigned long lastVisitMs_[cfg::lines::MAX_LINES] = {0};
+    model::LineMask cycleSeen_;                                 // Lines visited this cycle
+    unsigned long cycleStartMs_ = 0;
+    uint32_t avgToneMs_ = TONE_LENGTH_INITIAL_MS;
+    ScanStats scanStats_;
+    static uint8_t nibbleFromPort_(uint16_t port);
     char decodeDtmf(uint8_t nibble);
 
     static constexpr char dtmf_map_[16] = {
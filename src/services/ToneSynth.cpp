@@ -0,0 +1,245 @@
+#include "services/ToneSynth.h"
+#include "services/PcmPack.h"
+#include "settings/Settings.h"
+#include "util/UIConsole.h"
+#include <esp_timer.h>
+#include <math.h>
+
+int16_t ToneSynth::sineTable_[ToneSynth::kTableSize + 1];
+bool ToneSynth::tableReady_ = false;
+
+ToneSynth::ToneSynth(PCMDriver& pcmDriver)
+  : pcmDriver_(pcmDriver) {
+}
+
+bool ToneSynth::begin() {
+  if (!tableReady_) {
+    for (std::size_t i = 0; i <= kTableSize; ++i) {
+      const float s = sinf(2.0f * static_cast<float>(M_PI) * static_cast<float>(i) / static_cast<float>(kTableSize));
+      sineTable_[i] = static_cast<int16_t>(lrintf(s * static_cast<float>(cfg::synth::AMPLITUDE_Q15)));
+    }
+    tableReady_ = true;
+  }
+
+  if (mutex_ == nullptr) {
+    mutex_ = xSemaphoreCreateMutex();
+  }
+
+  // PCM5102 wants 32-bit slots; the sample sits in the high half of each slot
+  pcmDriver_.setCommFormat(PCMDriver::CommFormat::StandardI2S);
+  pcmDriver_.setForce32BitSlots(true);
+  pcmDriver_.setSampleWordMode(PCMDriver::SampleWordMode::Bits32High16);
+  if (!pcmDriver_.begin(cfg::synth::SAMPLE_RATE_HZ, 32, 2)) {
+    Serial.println("ToneSynth: PCM output not available, synth disabled");
+    util::UIConsole::log("PCM output not available, synth disabled", "ToneSynth");
+    return false;
+  }
+
+  if (task_ == nullptr) {
+    if (xTaskCreatePinnedToCore(&ToneSynth::taskEntry_, "toneSynth", cfg::synth::TASK_STACK, this,
+                                cfg::synth::TASK_PRIORITY, &task_, cfg::synth::TASK_CORE) != pdPASS) {
+      task_ = nullptr;
+      Serial.println("ToneSynth: Could not create synth task");
+      util::UIConsole::log("Could not create synth task", "ToneSynth");
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ToneSynth::play(const Step* steps, std::size_t count) {
+  if (task_ == nullptr || steps == nullptr || count == 0 || count > kMaxSteps) {
+    return false;
+  }
+
+  xSemaphoreTake(mutex_, portMAX_DELAY);
+  for (std::size_t i = 0; i < count; ++i) {
+    pendingSteps_[i] = steps[i];
+  }
+  pendingCount_ = count;
+  pendingGen_ = pendingGen_ + 1;
+  requested_ = true;
+  xSemaphoreGive(mutex_);
+
+  xTaskNotifyGive(task_);
+  return true;
+}
+
+void ToneSynth::stop() {
+  if (task_ == nullptr) {
+    return;
+  }
+
+  xSemaphoreTake(mutex_, portMAX_DELAY);
+  pendingCount_ = 0;
+  pendingGen_ = pendingGen_ + 1;
+  requested_ = false;
+  xSemaphoreGive(mutex_);
+
+  xTaskNotifyGive(task_);
+}
+
+uint32_t ToneSynth::samplesPerSecondPerTone() const {
+  if (stats_.blocks == 0 || stats_.renderUsSum == 0) {
+    return 0;
+  }
+  // Two oscillators run per block, whether or not the second one is audible
+  const uint64_t samples = static_cast<uint64_t>(stats_.blocks) * cfg::synth::BLOCK_FRAMES * 2u;
+  return static_cast<uint32_t>(samples * 1000000ULL / stats_.renderUsSum);
+}
+
+std::size_t ToneSynth::renderNext(int16_t* out, std::size_t frames) {
+  syncCommand_();
+  if (stepCount_ == 0) {
+    return 0;
+  }
+  renderBlock_(out, frames);
+  return frames;
+}
+
+void ToneSynth::taskEntry_(void* arg) {
+  static_cast<ToneSynth*>(arg)->run_();
+}
+
+void ToneSynth::run_() {
+  const uint32_t blockUs = static_cast<uint32_t>(cfg::synth::BLOCK_FRAMES * 1000000ULL / cfg::synth::SAMPLE_RATE_HZ);
+
+  for (;;) {
+    syncCommand_();
+
+    if (stepCount_ == 0) {
+      if (outputRunning_) {
+        // One block of silence so the tone ends cleanly; the DMA auto-clears after that
+        memset(renderBuffer_, 0, sizeof(renderBuffer_));
+        writeBlock_(renderBuffer_, cfg::synth::BLOCK_FRAMES);
+        outputRunning_ = false;
+      }
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      continue;
+    }
+    outputRunning_ = true;
+
+    const int64_t t0 = esp_timer_get_time();
+    renderBlock_(renderBuffer_, cfg::synth::BLOCK_FRAMES);
+    const uint32_t renderUs = static_cast<uint32_t>(esp_timer_get_time() - t0);
+
+    stats_.blocks++;
+    stats_.renderUsSum += renderUs;
+    if (renderUs > stats_.renderUsMax) stats_.renderUsMax = renderUs;
+    if (renderUs > blockUs) stats_.lateBlocks++;
+
+    // Blocks until the DMA has room, i.e. while the previous block plays
+    if (!writeBlock_(renderBuffer_, cfg::synth::BLOCK_FRAMES)) {
+      stats_.writeFailures++;
+    }
+  }
+}
+
+// Take over a new command from play()/stop() at a block boundary
+void ToneSynth::syncCommand_() {
+  if (pendingGen_ == activeGen_) {
+    return;
+  }
+
+  xSemaphoreTake(mutex_, portMAX_DELAY);
+  activeGen_ = pendingGen_;
+  stepCount_ = pendingCount_;
+  for (std::size_t i = 0; i < stepCount_; ++i) {
+    const Step& src = pendingSteps_[i];
+    steps_[i].increment1 = phaseIncrement_(src.frequencyHz);
+    steps_[i].increment2 = phaseIncrement_(src.frequency2Hz);
+    steps_[i].samples = static_cast<uint32_t>(static_cast<uint64_t>(src.durationMs) * cfg::synth::SAMPLE_RATE_HZ / 1000u);
+  }
+  xSemaphoreGive(mutex_);
+
+  osc_[0].phase = 0;
+  osc_[1].phase = 0;
+  if (stepCount_ > 0) {
+    enterStep_(0);
+  }
+
+  if (Settings::instance().debugTonGenLevel >= 2) {
+    Serial.println("ToneSynth: " + String(stepCount_ > 0 ? "Playing " + String(static_cast<unsigned>(stepCount_)) + " steps" : String("Stopped")));
+    util::UIConsole::log(stepCount_ > 0 ? "Playing " + String(static_cast<unsigned>(stepCount_)) + " steps" : String("Stopped"), "ToneSynth");
+  }
+}
+
+void ToneSynth::enterStep_(std::size_t index) {
+  stepIndex_ = index;
+  samplesLeft_ = steps_[index].samples;
+  osc_[0].increment = steps_[index].increment1;
+  osc_[1].increment = steps_[index].increment2;
+}
+
+void ToneSynth::renderBlock_(int16_t* out, std::size_t frames) {
+  std::size_t done = 0;
+  while (done < frames) {
+    // Render up to the end of the current cadence step
+    std::size_t n = frames - done;
+    const bool continuous = steps_[stepIndex_].samples == 0;
+    if (!continuous && samplesLeft_ < n) {
+      n = samplesLeft_;
+    }
+
+    const uint32_t inc1 = osc_[0].increment;
+    const uint32_t inc2 = osc_[1].increment;
+    uint32_t ph1 = osc_[0].phase;
+    uint32_t ph2 = osc_[1].phase;
+    for (std::size_t i = 0; i < n; ++i) {
+      int32_t s = 0;
+      if (inc1 != 0) { s += lookup_(ph1); ph1 += inc1; }
+      if (inc2 != 0) { s += lookup_(ph2); ph2 += inc2; }
+      out[done + i] = static_cast<int16_t>(s);
+    }
+    osc_[0].phase = ph1;
+    osc_[1].phase = ph2;
+    done += n;
+
+    if (!continuous) {
+      samplesLeft_ -= static_cast<uint32_t>(n);
+      if (samplesLeft_ == 0) {
+        enterStep_((stepIndex_ + 1) % stepCount_);
+      }
+    }
+  }
+}
+
+// D_OUTL is fed from the left channel; the right channel stays silent
+bool ToneSynth::writeBlock_(const int16_t* mono, std::size_t frames) {
+  const PCMDriver::SampleWordMode mode = pcmDriver_.sampleWordMode();
+  int32_t* packed = packed_;
+
+  std::size_t bytes = 0;
+  if (mode == PCMDriver::SampleWordMode::Bits16) {
+    int16_t* out = reinterpret_cast<int16_t*>(packed);
+    for (std::size_t i = 0; i < frames; ++i) {
+      out[2 * i] = mono[i];
+      out[2 * i + 1] = 0;
+    }
+    bytes = frames * 2u * sizeof(int16_t);
+  } else {
+    for (std::size_t i = 0; i < frames; ++i) {
+      packed[2 * i] = pcm::toSlot32(mono[i], mode);
+      packed[2 * i + 1] = 0;
+    }
+    bytes = frames * 2u * sizeof(int32_t);
+  }
+
+  size_t written = 0;
+  return pcmDriver_.write(reinterpret_cast<const uint8_t*>(packed), bytes, &written) && written == bytes;
+}
+
+// 32-bit phase accumulator: increment = f * 2^32 / fs
+uint32_t ToneSynth::phaseIncrement_(float hz) {
+  if (hz <= 0.0f) return 0;
+  return static_cast<uint32_t>(static_cast<double>(hz) * 4294967296.0 / cfg::synth::SAMPLE_RATE_HZ + 0.5);
+}
+
+// Table lookup with linear interpolation on the next 8 phase bits
+int16_t ToneSynth::lookup_(uint32_t phase) {
+  const uint32_t index = phase >> (32 - kTableBits);
+  const int32_t frac = static_cast<int32_t>((phase >> (24 - kTableBits)) & 0xFF);
+  const int32_t a = sineTable_[index];
+  const int32_t b = sineTable_[index + 1];
+  return static_cast<int16_t>(a + (((b - a) * frac) >> 8));
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+
+#include "config.h"
+#include "drivers/PCMDriver.h"
+
+// Fixed-point wavetable DDS on the PCM5102 path (D_OUTL crosspoint input).
+// Plays one cadenced tone, single or dual frequency, and is used by
+// ToneGenerator as a fourth, virtual tone generator. A streaming task renders
+// one block at a time while the I2S DMA descriptors play the blocks before it;
+// cadence steps are counted in samples.
+class ToneSynth {
+public:
+  struct Step {
+    float    frequencyHz = 0.0f;
+    float    frequency2Hz = 0.0f;   // 0 = single tone
+    uint32_t durationMs = 0;        // 0 = continuous
+  };
+
+  struct Stats {
+    uint32_t blocks = 0;
+    uint32_t lateBlocks = 0;        // Render took longer than the block lasts
+    uint32_t renderUsSum = 0;
+    uint32_t renderUsMax = 0;
+    uint32_t writeFailures = 0;
+  };
+
+  static constexpr std::size_t kMaxSteps = 8;
+
+  explicit ToneSynth(PCMDriver& pcmDriver);
+
+  bool begin();
+  bool play(const Step* steps, std::size_t count);
+  void stop();
+  bool isActive() const { return requested_; }
+  bool isReady() const { return task_ != nullptr; }
+
+  const Stats& stats() const { return stats_; }
+  // Samples the task can render per second of CPU time, per oscillator
+  uint32_t samplesPerSecondPerTone() const;
+  // Picks up the latest play()/stop() and renders the next block into 'out',
+  // like one pass of the task without the I2S write. Returns 0 when stopped.
+  // Only for callers that own the render side, i.e. host tests and benchmarks.
+  std::size_t renderNext(int16_t* out, std::size_t frames);
+
+private:
+  struct Oscillator {
+    uint32_t phase = 0;
+    uint32_t increment = 0;   // 0 = silent
+  };
+
+  struct ActiveStep {
+    uint32_t increment1 = 0;
+    uint32_t increment2 = 0;
+    uint32_t samples = 0;     // 0 = continuous
+  };
+
+  static void taskEntry_(void* arg);
+  void run_();
+  void syncCommand_();
+  void renderBlock_(int16_t* out, std::size_t frames);
+  bool writeBlock_(const int16_t* mono, std::size_t frames);
+  void enterStep_(std::size_t index);
+  static uint32_t phaseIncrement_(float hz);
+  static int16_t lookup_(uint32_t phase);
+
+  PCMDriver& pcmDriver_;
+  TaskHandle_t task_ = nullptr;
+  SemaphoreHandle_t mutex_ = nullptr;
+
+  // Command from the loop, picked up by the task at the next block
+  Step pendingSteps_[kMaxSteps];
+  std::size_t pendingCount_ = 0;
+  volatile uint32_t pendingGen_ = 0;
+  uint32_t activeGen_ = 0;
+  volatile bool requested_ = false;
+
+  // Task-owned playback state
+  ActiveStep steps_[kMaxSteps];
+  std::size_t stepCount_ = 0;
+  std::size_t stepIndex_ = 0;
+  uint32_t samplesLeft_ = 0;
+  Oscillator osc_[2];
+  bool outputRunning_ = false;
+
+  static constexpr std::size_t kTableBits = 8;
+  static constexpr std::size_t kTableSize = 1u << kTableBits;
+  static int16_t sineTable_[kTableSize + 1];   // +1 guard for interpolation
+  static bool tableReady_;
+
+  int16_t renderBuffer_[cfg::synth::BLOCK_FRAMES]{};
+  int32_t packed_[cfg::synth::BLOCK_FRAMES * 2]{};
+
+  Stats stats_;
+};
@@ -4,18 +4,24 @@ Settings::Settings() {
   resetDefaults();        // ensure fields have initial values
 }
 
+bool Settings::isSlicBankPresent(std::size_t bank) const {
+  if (bank >= cfg::lines::SLIC_BANK_COUNT) return false;
+  return mcpSlicPresent[bank];
+}
+
 void Settings::adjustActiveLines() {
   // Adjust activeLinesMask to take physical MCP connections into account
-  uint8_t userMask = activeLinesMask;
-  if (mcpSlic1Present && !mcpSlic2Present) {
-    // Only SLIC1 exists: allow only lines 0–3
-    allowMask = 0b00001111;
-  } else if (!mcpSlic1Present && mcpSlic2Present) {
-    // Only SLIC2 exists: allow only lines 4–7
-    allowMask = 0b11110000;
-  } else {
-    // Both exist: allow all lines
-    allowMask = 0b11111111;
+  model::LineMask userMask = activeLinesMask;
+  allowMask.clear();
+  for (std::size_t bank = 0; bank < cfg::lines::SLIC_BANK_COUNT; ++bank) {
+    if (!isSlicBankPresent(bank)) continue;
+    for (std::size_t i = 0; i < cfg::lines::LINES_PER_BANK; ++i) {
+      allowMask.set(bank * cfg::lines::LINES_PER_BANK + i);
+    }
+  }
+  // No bank detected at all: keep every line allowed (same as before)
+  if (allowMask.none()) {
+    allowMask = model::LineMask::all();
   }
   // Mask the user's mask so disallowed lines are always inactive
   activeLinesMask = userMask & allowMask;
@@ -23,7 +29,8 @@ void Settings::adjustActiveLines() {
 
 void Settings::resetDefaults() {
   // Save only *settings*, not runtime status
-  activeLinesMask       = 0b11111111;
+  activeLinesMask       = model::LineMask::all();
+  allowMask             = model::LineMask::all();
 
   // -- Debug levels ---
   debugSHKLevel         = 0; // Debug for SHKService
@@ -40,6 +47,9 @@ void Settings::resetDefaults() {
   debugLAC              = 0; // Debug for LineAudioConnections
 
   toneGeneratorEnabled  = true;
+  toneReadyPrearmed     = false;
+  toneSynthEnabled      = true;
+  tonePlan              = "se";
   pulseAdjustment       = 1;
 
   // MQTT settings
@@ -73,6 +83,7 @@ void Settings::resetDefaults() {
   ringPauseMs           = 5000; // Pause between rings in ms
 
   ringIterations        = 5;    // Iterations of ringing signal
+  maxConcurrentRingers  = 2;    // Bursts go in the others' pauses; past one pause of waiting, up to this many share
 
   // --- ToneReader (DTMF) settings ---
   dtmfDebounceMs        = 100;   // Debounce time for DTMF detection (minimum time between detections of the same digit)
@@ -94,13 +105,14 @@ void Settings::resetDefaults() {
 
 
   // --- Phone numbers ---
-  for (int i = 0; i < 8; ++i) {
-    linePhoneNumbers[i] = String(i);
+  for (std::size_t i = 0; i < cfg::lines::MAX_LINES; ++i) {
+    linePhoneNumbers[i] = String(static_cast<unsigned>(i));
     lineNames[i] = "";
   }
 
   // Runtime flags kept false here; set by MCPDriver::begin()
-  mcpSlic1Present = mcpSlic2Present = mcpMainPresent = mcpMt8816Present = false;
+  for (bool& present : mcpSlicPresent) present = false;
+  mcpMainPresent = mcpMt8816Present = false;
   Serial.println("Settings reset to defaults");
   util::UIConsole::log("Settings reset to defaults", "Settings");
 }
@@ -114,11 +126,18 @@ bool Settings::load() {
     return false;
   }
   uint16_t v = prefs.getUShort("ver", 0);
-  const bool supportedVersion = (v == kVersion || v == 4 || v == 3);
+  const bool supportedVersion = (v == kVersion || v == 5 || v == 4 || v == 3);
   const bool needsUpgrade = (v != kVersion) && supportedVersion;
   bool ok = supportedVersion;
   if (ok) {
-    activeLinesMask       = prefs.getUChar ("activeMask", activeLinesMask);
+    // Versions before 6 stored the active mask as a single byte (8 lines)
+    if (v >= 6) {
+      activeLinesMask     = model::LineMask(static_cast<model::LineMask::word_type>(
+                              prefs.getULong64("activeMask64", activeLinesMask.value())));
+    } else {
+      activeLinesMask     = model::LineMask(static_cast<model::LineMask::word_type>(
+                              prefs.getUChar("activeMask", static_cast<uint8_t>(activeLinesMask.value()))));
+    }
     pulseDebounceMs        = prefs.getUShort("pulseDebounceMs", pulseDebounceMs);
 
     // --- Debug levels ---
@@ -146,6 +165,9 @@ bool Settings::load() {
     globalPulseTimeoutMs  = prefs.getUInt ("globalPulseTO",     globalPulseTimeoutMs);
     highMeansOffHook      = prefs.getBool ("hiOffHook",         highMeansOffHook);
     toneGeneratorEnabled  = prefs.getBool ("toneGenEn",         toneGeneratorEnabled);
+    toneReadyPrearmed     = prefs.getBool ("toneReadyPre",      toneReadyPrearmed);
+    toneSynthEnabled      = prefs.getBool ("toneSynth",         toneSynthEnabled);
+    tonePlan              = prefs.getString("tonePlan",         tonePlan);
     mqttEnabled           = prefs.getBool ("mqttEnabled",       mqttEnabled);
     mqttHost              = prefs.getString("mqttHost",         mqttHost);
     mqttPort              = prefs.getUShort("mqttPort",         mqttPort);
@@ -159,6 +181,7 @@ bool Settings::load() {
     ringLengthMs          = prefs.getUInt ("ringLengthMs",      ringLengthMs);
     ringPauseMs           = prefs.getUInt ("ringPauseMs",       ringPauseMs);
     ringIterations        = prefs.getUInt ("ringIterations",    ringIterations);
+    maxConcurrentRingers  = prefs.getUChar ("maxRingers",       maxConcurrentRingers);
 
     // --- ToneReader (DTMF) settings ---
     dtmfDebounceMs        = prefs.getUInt ("dtmfDebounce",      dtmfDebounceMs);
@@ -180,10 +203,10 @@ bool Settings::load() {
     
 
     // --- Phone numbers ---
-    for (int i = 0; i < 8; ++i) {
-      String key = String("linePhone") + i;
+    for (std::size_t i = 0; i < cfg::lines::MAX_LINES; ++i) {
+      String key = String("linePhone") + static_cast<unsigned>(i);
       linePhoneNumbers[i] = prefs.getString(key.c_str(), linePhoneNumbers[i]);
-      key = String("lineName") + i;
+      key = String("lineName") + static_cast<unsigned>(i);
       lineNames[i] = prefs.getString(key.c_str(), lineNames[i]);
     }
 
@@ -203,7 +226,7 @@ void Settings::save() const {
   prefs.putUShort("ver", kVersion);
 
   // --- General settings ---
-  prefs.putUChar ("activeMask", activeLinesMask);
+  prefs.putULong64("activeMask64", activeLinesMask.value());
   prefs.putUShort("pulseDebounceMs", pulseDebounceMs);
 
   // --- Debug levels ---
@@ -230,6 +253,9 @@ void Settings::save() const {
   prefs.putUInt ("globalPulseTO",         globalPulseTimeoutMs);
   prefs.putBool ("hiOffHook",             highMeansOffHook);
   prefs.putBool ("toneGenEn",             toneGeneratorEnabled);
+  prefs.putBool ("toneReadyPre",          toneReadyPrearmed);
+  prefs.putBool ("toneSynth",             toneSynthEnabled);
+  prefs.putString("tonePlan",             tonePlan);
   prefs.putBool ("mqttEnabled",           mqttEnabled);
   prefs.putString("mqttHost",             mqttHost);
   prefs.putUShort("mqttPort",             mqttPort);
@@ -243,6 +269,7 @@ void Settings::save() const {
   prefs.putUInt ("ringLengthMs",          ringLengthMs);
   prefs.putUInt ("ringPauseMs",           ringPauseMs);
   prefs.putUInt ("ringIterations",        ringIterations);
+  prefs.putUChar ("maxRingers",           maxConcurrentRingers);
 
   // --- ToneReader (DTMF) settings ---
   prefs.putUInt ("dtmfDebounce",          dtmfDebounceMs);
@@ -264,10 +291,10 @@ void Settings::save() const {
   prefs.putUInt ("timerBusy",             timer_busy);
 
   // --- Phone numbers ---
-  for (int i = 0; i < 8; ++i) {
-    String key = String("linePhone") + i;
+  for (std::size_t i = 0; i < cfg::lines::MAX_LINES; ++i) {
+    String key = String("linePhone") + static_cast<unsigned>(i);
     prefs.putString(key.c_str(), linePhoneNumbers[i]);
-    key = String("lineName") + i;
+    key = String("lineName") + static_cast<unsigned>(i);
     prefs.putString(key.c_str(), lineNames[i]);
   }
 
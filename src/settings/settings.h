@@ -3,6 +3,8 @@
 #include <Preferences.h>
 #include <stdint.h>
 #include "util/UIConsole.h"
+#include "config.h"
+#include "model/LineSet.h"
 
 class Settings {
 public:
@@ -21,10 +23,10 @@ public:
   void save() const;      // Saves current settings to NVS
 
   // ---- Public fields ----
-  uint8_t activeLinesMask;        // Bitmask for active lines (1-4)
+  model::LineMask activeLinesMask; // Bitmask for active lines
   uint16_t pulseDebounceMs;            // Debounce time for line state changes
-  String linePhoneNumbers[8];     // Stored phone number per line
-  String lineNames[8];            // Stored display name per line
+  String linePhoneNumbers[cfg::lines::MAX_LINES]; // Stored phone number per line
+  String lineNames[cfg::lines::MAX_LINES];        // Stored display name per line
 
   // ---- Debugging ----
   uint8_t debugSHKLevel;          // 0=none, 1=low, 2=high Debug level for SHK service
@@ -42,6 +44,9 @@ public:
   uint8_t debugI2CLevel;         // 0=none, 1=low, 2=high
 
   bool    toneGeneratorEnabled = true; // Enable tone generators
+  bool    toneReadyPrearmed = false;   // Keep one generator playing dial tone so hook-off only needs a crosspoint
+  bool    toneSynthEnabled = true;    // Use the PCM5102 (D_OUTL) as a fourth tone generator
+  String  tonePlan = "se";            // Tone plan file /tones/<name>.txt on LittleFS
   uint8_t pulseAdjustment;         // Pulse adjustment (1 means 1 pulse = 0, 2 pulses = 1, etc.)
 
   // ---- MQTT settings ----
@@ -69,6 +74,7 @@ public:
   uint32_t ringLengthMs;          // Length of ringing signal in ms
   uint32_t ringPauseMs;           // Pause between rings in ms
   uint32_t ringIterations;        // Iterations of ringing signal
+  uint8_t  maxConcurrentRingers;  // Lines allowed in a ring burst at once (0 = no limit, no staggering)
 
   // ---- ToneReader (DTMF) settings ----
   uint32_t dtmfDebounceMs;        // Minimum time between detections of the same digit (ms)
@@ -76,11 +82,10 @@ public:
   uint32_t dtmfStdStableMs;       // Minimum time STD signal must be stable before reading (ms)
   uint32_t tmuxScanDwellMinMs;    // Minimum TMUX dwell time per scanned line (ms)
 
-  uint8_t allowMask;
+  model::LineMask allowMask;      // Lines backed by a present SLIC bank (runtime only)
 
   // ---- MCP statuses (not saved to NVS, runtime only) ----
-  bool mcpSlic1Present = false;
-  bool mcpSlic2Present = false;
+  bool mcpSlicPresent[cfg::lines::SLIC_BANK_COUNT] = {};   // Per SLIC bank
   bool mcpMainPresent  = false;
   bool mcpMt8816Present= false;
 
@@ -96,13 +101,12 @@ public:
   unsigned long timer_timeout;
   unsigned long timer_busy;
 
-  inline uint8_t activeLinesCount() const {
-    uint8_t x = activeLinesMask, c = 0;
-    while (x) { c += (x & 1u); x >>= 1; }
-    return c;
-  }
+  inline uint8_t activeLinesCount() const { return static_cast<uint8_t>(activeLinesMask.count()); }
+
+  inline bool isLineActive(uint8_t i) const { return activeLinesMask.test(i); }
 
-  inline bool isLineActive(uint8_t i) const { return (activeLinesMask >> i) & 1u; }
+  // Presence of the MCP behind SLIC bank 'bank' (see cfg::mcp::SLIC_BANK_ADDR)
+  bool isSlicBankPresent(std::size_t bank) const;
 
 private:
   // === Singleton protection ===
@@ -111,5 +115,5 @@ private:
   Settings& operator=(const Settings&) = delete;
 
   static constexpr const char* kNamespace = "myapp";
-  static constexpr uint16_t kVersion = 5;    // increase if layout changes
+  static constexpr uint16_t kVersion = 6;    // increase if layout changes
 };
@@ -0,0 +1,66 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace util {
+
+// Lock-free single-producer/single-consumer byte ring.
+// En skrivare (t.ex. loop) och en läsare (t.ex. ljudtask) utan mutex:
+// head ägs av skrivaren, tail av läsaren. Capacity måste vara en 2-potens.
+template <std::size_t Capacity>
+class ByteRing {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "ByteRing capacity must be a power of two");
+
+public:
+  static constexpr std::size_t kCapacity = Capacity;
+
+  std::size_t available() const {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_relaxed);
+  }
+  std::size_t space() const {
+    return Capacity - (head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_acquire));
+  }
+
+  // Producer side. Returns bytes actually written.
+  std::size_t write(const uint8_t* data, std::size_t len) {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    const std::size_t free = Capacity - (head - tail_.load(std::memory_order_acquire));
+    if (len > free) len = free;
+
+    const std::size_t at = head & (Capacity - 1);
+    const std::size_t first = (len < Capacity - at) ? len : Capacity - at;
+    memcpy(buffer_ + at, data, first);
+    memcpy(buffer_, data + first, len - first);
+    head_.store(head + len, std::memory_order_release);
+    return len;
+  }
+
+  // Consumer side. Returns bytes actually read.
+  std::size_t read(uint8_t* out, std::size_t len) {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    const std::size_t used = head_.load(std::memory_order_acquire) - tail;
+    if (len > used) len = used;
+
+    const std::size_t at = tail & (Capacity - 1);
+    const std::size_t first = (len < Capacity - at) ? len : Capacity - at;
+    memcpy(out, buffer_ + at, first);
+    memcpy(out + first, buffer_, len - first);
+    tail_.store(tail + len, std::memory_order_release);
+    return len;
+  }
+
+  // Only when neither side is running
+  void reset() {
+    head_.store(0, std::memory_order_relaxed);
+    tail_.store(0, std::memory_order_relaxed);
+  }
+
+private:
+  uint8_t buffer_[Capacity];
+  std::atomic<std::size_t> head_{0};
+  std::atomic<std::size_t> tail_{0};
+};
+
+}
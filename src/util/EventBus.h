@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace util {
+
+// Fixed-capacity broadcast queue for small POD events.
+// Producers post() in O(1) without heap or I/O; every consumer keeps its own
+// Cursor and drains with poll() from its own loop step. When a consumer falls
+// more than Capacity events behind, the oldest are overwritten and counted as
+// dropped for that cursor. Not thread-safe: post() and poll() must run on the
+// main loop. Other tasks do not post directly; web handlers queue their line
+// changes with LineManager::requestStatus(), which update() applies on the loop.
+template <typename Event, std::size_t Capacity>
+class EventBus {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "EventBus capacity must be a power of two");
+
+public:
+  static constexpr std::size_t kCapacity = Capacity;
+
+  struct Cursor {
+    uint32_t next = 0;       // Sequence number of the next event to read
+    uint32_t dropped = 0;    // Events overwritten before this consumer saw them
+  };
+
+  void post(const Event& e) {
+    buffer_[head_ & (Capacity - 1)] = e;
+    head_++;
+  }
+
+  // A cursor that only sees events posted from now on
+  Cursor subscribe() const {
+    Cursor c;
+    c.next = head_;
+    return c;
+  }
+
+  bool poll(Cursor& c, Event& out) const {
+    if (c.next == head_) return false;
+    if (head_ - c.next > Capacity) {
+      c.dropped += head_ - c.next - static_cast<uint32_t>(Capacity);
+      c.next = head_ - static_cast<uint32_t>(Capacity);
+    }
+    out = buffer_[c.next & (Capacity - 1)];
+    c.next++;
+    return true;
+  }
+
+  std::size_t pending(const Cursor& c) const {
+    const uint32_t n = head_ - c.next;
+    return n > Capacity ? Capacity : n;
+  }
+  uint32_t posted() const { return head_; }
+
+private:
+  Event buffer_[Capacity] = {};
+  uint32_t head_ = 0;
+};
+
+} // namespace util
@@ -102,7 +102,7 @@ void Functions::testRing() {
     
     int RM = cfg::mcp::RM_PINS[0];
     int FR = cfg::mcp::FR_PINS[0];
-    uint8_t addr = cfg::mcp::MCP_SLIC1_ADDRESS;
+    uint8_t addr = cfg::mcp::SHK_LINE_ADDR[0];
   
     mcp_ks083f.digitalWriteMCP(addr, RM, HIGH);        // enable ring mode on line 0
     for (int i = 0; i < 4; i++) {
@@ -0,0 +1,55 @@
+#include "util/LoopProfiler.h"
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "util/UIConsole.h"
+
+namespace util {
+
+void LoopProfiler::startLoop() {
+  loopStartUs_ = esp_timer_get_time();
+  lastMarkUs_ = loopStartUs_;
+}
+
+void LoopProfiler::mark(const char* stage) {
+  const int64_t now = esp_timer_get_time();
+  const uint32_t us = static_cast<uint32_t>(now - lastMarkUs_);
+  lastMarkUs_ = now;
+
+  std::size_t i = 0;
+  while (i < count_ && stages_[i].name != stage) ++i;
+  if (i == count_) {
+    if (count_ == kMaxStages) return;
+    stages_[count_++].name = stage;
+  }
+
+  Stage& st = stages_[i];
+  st.lastUs = us;
+  st.totalUs += us;
+  if (us > kBudgetUs) st.overBudget++;
+  if (us > st.maxUs) {
+    st.maxUs = us;
+    if (us > kBudgetUs) {
+      Serial.printf("LoopProfiler: %s took %lu us (new max, budget %lu us)\n", stage,
+                    static_cast<unsigned long>(us), static_cast<unsigned long>(kBudgetUs));
+      UIConsole::log(String(stage) + " took " + String(us) + " us (new max)", "LoopProfiler");
+    }
+  }
+}
+
+void LoopProfiler::endLoop() {
+  const uint32_t us = static_cast<uint32_t>(esp_timer_get_time() - loopStartUs_);
+  if (us > loopMaxUs_) loopMaxUs_ = us;
+  loops_++;
+}
+
+void LoopProfiler::reset() {
+  for (std::size_t i = 0; i < count_; ++i) {
+    const char* name = stages_[i].name;
+    stages_[i] = Stage{};
+    stages_[i].name = name;
+  }
+  loops_ = 0;
+  loopMaxUs_ = 0;
+}
+
+} // namespace util
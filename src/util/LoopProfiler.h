@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace util {
+
+// Per-stage timing of App::update(). startLoop() opens a pass, each mark(name)
+// charges the time since the previous mark to that stage. Stage names must be
+// string literals (matched by pointer). A stage going over kBudgetUs is logged
+// whenever it sets a new worst case, so a blocking call shows up once, not per loop.
+class LoopProfiler {
+public:
+  static constexpr std::size_t kMaxStages = 16;
+  static constexpr uint32_t kBudgetUs = 1000;
+
+  struct Stage {
+    const char* name = nullptr;
+    uint32_t lastUs = 0;
+    uint32_t maxUs = 0;
+    uint32_t overBudget = 0;     // Passes where the stage took more than kBudgetUs
+    uint64_t totalUs = 0;
+  };
+
+  void startLoop();
+  void mark(const char* stage);
+  void endLoop();
+
+  const Stage* stages() const { return stages_; }
+  std::size_t stageCount() const { return count_; }
+  uint32_t loops() const { return loops_; }
+  uint32_t loopMaxUs() const { return loopMaxUs_; }
+  void reset();
+
+private:
+  Stage stages_[kMaxStages];
+  std::size_t count_ = 0;
+  int64_t loopStartUs_ = 0;
+  int64_t lastMarkUs_ = 0;
+  uint32_t loops_ = 0;
+  uint32_t loopMaxUs_ = 0;
+};
+
+} // namespace util
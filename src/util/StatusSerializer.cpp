@@ -23,7 +23,7 @@ namespace net {
 String buildLinesStatusJson(const LineManager& lm) {
   // Bygg manuellt för att slippa externa libbar. Lätt att utöka fält senare.
   String out = "{\"lines\":[";
-  for (int i = 0; i < 8; ++i) {
+  for (int i = 0; i < static_cast<int>(cfg::lines::MAX_LINES); ++i) {
     const auto& line = const_cast<LineManager&>(lm).getLine(i); // getLine saknar const-variant
     out += "{\"id\":" + String(i);
     out += ",\"status\":\""; out += model::LineStatusToString(line.currentLineStatus); out += "\"";
@@ -33,7 +33,7 @@ String buildLinesStatusJson(const LineManager& lm) {
     // out += ",\"active\":"; out += (line.lineActive ? "true" : "false");
     // out += ",\"hook\":\"";  out += (line.SHK ? "Off" : "On"); out += "\"";
     out += "}";
-    if (i < 7) out += ",";
+    if (i + 1 < static_cast<int>(cfg::lines::MAX_LINES)) out += ",";
   }
   out += "]}";
   return out;
@@ -0,0 +1,71 @@
+#pragma once
+// Host stand-in for Adafruit_MCP23X17 on top of the Wire stub. Each call does
+// the register traffic the library does (pinMode and digitalWrite are a read
+// followed by a write of the port register), so bus time and the hosti2c log
+// match what the expander sees on the board.
+#include <Arduino.h>
+#include <Wire.h>
+
+class Adafruit_MCP23X17 {
+public:
+  bool begin_I2C(uint8_t addr = 0x20, TwoWire* wire = &Wire) {
+    addr_ = addr;
+    wire_ = wire;
+    wire_->beginTransmission(addr_);
+    return wire_->endTransmission() == 0;
+  }
+
+  void pinMode(uint8_t pin, uint8_t mode) {
+    const uint8_t port = pin < 8 ? 0 : 1;
+    const uint8_t bit = static_cast<uint8_t>(1u << (pin % 8));
+    const uint8_t iodir = readReg_(static_cast<uint8_t>(0x00 + port));
+    writeReg_(static_cast<uint8_t>(0x00 + port), mode == OUTPUT ? static_cast<uint8_t>(iodir & ~bit)
+                                                                : static_cast<uint8_t>(iodir | bit));
+    if (mode != OUTPUT) {
+      const uint8_t gppu = readReg_(static_cast<uint8_t>(0x0C + port));
+      writeReg_(static_cast<uint8_t>(0x0C + port), mode == INPUT_PULLUP ? static_cast<uint8_t>(gppu | bit)
+                                                                        : static_cast<uint8_t>(gppu & ~bit));
+    }
+  }
+
+  void digitalWrite(uint8_t pin, uint8_t value) {
+    const uint8_t reg = static_cast<uint8_t>(0x12 + (pin < 8 ? 0 : 1));
+    const uint8_t bit = static_cast<uint8_t>(1u << (pin % 8));
+    const uint8_t gpio = readReg_(reg);
+    writeReg_(reg, value ? static_cast<uint8_t>(gpio | bit) : static_cast<uint8_t>(gpio & ~bit));
+  }
+
+  uint8_t digitalRead(uint8_t pin) {
+    return (readReg_(static_cast<uint8_t>(0x12 + (pin < 8 ? 0 : 1))) >> (pin % 8)) & 1;
+  }
+
+  uint16_t readGPIOAB() {
+    wire_->beginTransmission(addr_);
+    wire_->write(static_cast<uint8_t>(0x12));
+    wire_->endTransmission(false);
+    wire_->requestFrom(static_cast<int>(addr_), 2);
+    const uint8_t a = static_cast<uint8_t>(wire_->read());
+    const uint8_t b = static_cast<uint8_t>(wire_->read());
+    return static_cast<uint16_t>(a | (b << 8));
+  }
+
+private:
+  uint8_t readReg_(uint8_t reg) {
+    wire_->beginTransmission(addr_);
+    wire_->write(reg);
+    wire_->endTransmission(false);
+    wire_->requestFrom(static_cast<int>(addr_), 1);
+    const int v = wire_->read();
+    return static_cast<uint8_t>(v < 0 ? 0 : v);
+  }
+
+  void writeReg_(uint8_t reg, uint8_t value) {
+    wire_->beginTransmission(addr_);
+    wire_->write(reg);
+    wire_->write(value);
+    wire_->endTransmission();
+  }
+
+  uint8_t addr_ = 0x20;
+  TwoWire* wire_ = &Wire;
+};
@@ -0,0 +1,365 @@
+#pragma once
+// Host stand-in for the Arduino-ESP32 core (and the FreeRTOS names it pulls
+// in) for the [env:native] tests. Header-only, so every suite links the same
+// firmware sources without extra objects:
+//  - String on top of std::string
+//  - Serial that swallows output
+//  - millis()/micros()/delay() on the host clock (host_clock.h)
+//  - GPIO levels kept in a table
+//  - FreeRTOS tasks are recorded, not run; mutexes always succeed unless a
+//    test holds them through hostrtos::holdMutexes()
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <ctime>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "esp_err.h"
+#include "host_clock.h"
+
+using std::max;
+using std::min;
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define F(x) (x)
+#define PSTR(x) (x)
+#define IRAM_ATTR
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+// Pin modes, levels and interrupt edges used in the cfg:: tables
+#define LOW 0x0
+#define HIGH 0x1
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+// ---- String ----
+
+class String {
+public:
+  String() = default;
+  String(const char* s) : s_(s ? s : "") {}
+  String(const String&) = default;
+  String(String&&) = default;
+  String(char c) : s_(1, c) {}
+  String(int v, unsigned char base = 10) : s_(fromSigned_(v, base)) {}
+  String(long v, unsigned char base = 10) : s_(fromSigned_(v, base)) {}
+  String(long long v, unsigned char base = 10) : s_(fromSigned_(v, base)) {}
+  String(unsigned char v, unsigned char base = 10) : s_(fromUnsigned_(v, base)) {}
+  String(unsigned int v, unsigned char base = 10) : s_(fromUnsigned_(v, base)) {}
+  String(unsigned long v, unsigned char base = 10) : s_(fromUnsigned_(v, base)) {}
+  String(unsigned long long v, unsigned char base = 10) : s_(fromUnsigned_(v, base)) {}
+  String(float v, unsigned int decimals = 2) : s_(fromDouble_(v, decimals)) {}
+  String(double v, unsigned int decimals = 2) : s_(fromDouble_(v, decimals)) {}
+
+  String& operator=(const String&) = default;
+  String& operator=(String&&) = default;
+  String& operator=(const char* s) { s_ = s ? s : ""; return *this; }
+
+  const char* c_str() const { return s_.c_str(); }
+  unsigned int length() const { return static_cast<unsigned int>(s_.size()); }
+  bool isEmpty() const { return s_.empty(); }
+  bool reserve(unsigned int size) { s_.reserve(size); return true; }
+
+  char charAt(unsigned int i) const { return i < s_.size() ? s_[i] : '\0'; }
+  char operator[](unsigned int i) const { return charAt(i); }
+  char& operator[](unsigned int i) { return s_[i]; }
+  void setCharAt(unsigned int i, char c) { if (i < s_.size()) s_[i] = c; }
+
+  bool concat(const String& o) { s_ += o.s_; return true; }
+  bool concat(const char* o) { if (o) s_ += o; return true; }
+  bool concat(char c) { s_ += c; return true; }
+  String& operator+=(const String& o) { s_ += o.s_; return *this; }
+  String& operator+=(const char* o) { if (o) s_ += o; return *this; }
+  String& operator+=(char c) { s_ += c; return *this; }
+  template <typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+  String& operator+=(T v) { s_ += String(v).s_; return *this; }
+
+  bool equals(const String& o) const { return s_ == o.s_; }
+  bool equalsIgnoreCase(const String& o) const {
+    if (s_.size() != o.s_.size()) return false;
+    for (std::size_t i = 0; i < s_.size(); ++i) {
+      if (std::tolower(static_cast<unsigned char>(s_[i])) != std::tolower(static_cast<unsigned char>(o.s_[i]))) return false;
+    }
+    return true;
+  }
+  bool operator==(const String& o) const { return s_ == o.s_; }
+  bool operator==(const char* o) const { return s_ == (o ? o : ""); }
+  bool operator!=(const String& o) const { return s_ != o.s_; }
+  bool operator!=(const char* o) const { return !(*this == o); }
+  bool operator<(const String& o) const { return s_ < o.s_; }
+
+  bool startsWith(const String& p) const { return s_.compare(0, p.s_.size(), p.s_) == 0; }
+  bool endsWith(const String& p) const {
+    return s_.size() >= p.s_.size() && s_.compare(s_.size() - p.s_.size(), p.s_.size(), p.s_) == 0;
+  }
+
+  int indexOf(char c, unsigned int from = 0) const { return toIndex_(s_.find(c, from)); }
+  int indexOf(const String& p, unsigned int from = 0) const { return toIndex_(s_.find(p.s_, from)); }
+  int lastIndexOf(char c) const { return toIndex_(s_.rfind(c)); }
+  int lastIndexOf(const String& p) const { return toIndex_(s_.rfind(p.s_)); }
+
+  String substring(unsigned int from) const { return from < s_.size() ? String(s_.substr(from).c_str()) : String(); }
+  String substring(unsigned int from, unsigned int to) const {
+    if (from > to) std::swap(from, to);
+    if (from >= s_.size()) return String();
+    return String(s_.substr(from, to - from).c_str());
+  }
+
+  void trim() {
+    const auto first = s_.find_first_not_of(" \t\r\n\f\v");
+    if (first == std::string::npos) { s_.clear(); return; }
+    const auto last = s_.find_last_not_of(" \t\r\n\f\v");
+    s_ = s_.substr(first, last - first + 1);
+  }
+  void toLowerCase() { for (char& c : s_) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c))); }
+  void toUpperCase() { for (char& c : s_) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c))); }
+  void remove(unsigned int index) { if (index < s_.size()) s_.erase(index); }
+  void remove(unsigned int index, unsigned int count) { if (index < s_.size()) s_.erase(index, count); }
+  void replace(const String& from, const String& to) {
+    if (from.s_.empty()) return;
+    for (std::size_t pos = 0; (pos = s_.find(from.s_, pos)) != std::string::npos; pos += to.s_.size()) {
+      s_.replace(pos, from.s_.size(), to.s_);
+    }
+  }
+  void replace(char from, char to) { for (char& c : s_) if (c == from) c = to; }
+
+  long toInt() const { return std::strtol(s_.c_str(), nullptr, 10); }
+  float toFloat() const { return std::strtof(s_.c_str(), nullptr); }
+  double toDouble() const { return std::strtod(s_.c_str(), nullptr); }
+
+  friend String operator+(const String& a, const String& b) { String r(a); r.s_ += b.s_; return r; }
+  friend String operator+(const String& a, const char* b) { String r(a); r += b; return r; }
+  friend String operator+(const char* a, const String& b) { String r(a); r.s_ += b.s_; return r; }
+  friend String operator+(const String& a, char c) { String r(a); r.s_ += c; return r; }
+  template <typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+  friend String operator+(const String& a, T v) { String r(a); r.s_ += String(v).s_; return r; }
+
+private:
+  static int toIndex_(std::size_t pos) { return pos == std::string::npos ? -1 : static_cast<int>(pos); }
+
+  static std::string fromUnsigned_(unsigned long long v, unsigned char base) {
+    if (base < 2 || base > 36) base = 10;
+    if (v == 0) return "0";
+    std::string out;
+    while (v > 0) {
+      const unsigned digit = static_cast<unsigned>(v % base);
+      out.insert(out.begin(), static_cast<char>(digit < 10 ? '0' + digit : 'a' + digit - 10));
+      v /= base;
+    }
+    return out;
+  }
+  static std::string fromSigned_(long long v, unsigned char base) {
+    if (base == 10 && v < 0) return "-" + fromUnsigned_(static_cast<unsigned long long>(-(v + 1)) + 1, 10);
+    return fromUnsigned_(static_cast<unsigned long long>(v), base);
+  }
+  static std::string fromDouble_(double v, unsigned int decimals) {
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "%.*f", static_cast<int>(decimals), v);
+    return buf;
+  }
+
+  std::string s_;
+};
+
+// ---- Serial ----
+
+class Print {
+public:
+  virtual ~Print() = default;
+  size_t print(const String& s) { return s.length(); }
+  size_t print(const char* s) { return s ? std::strlen(s) : 0; }
+  size_t print(char) { return 1; }
+  template <typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+  size_t print(T v, int base = 10) { (void)base; (void)v; return 1; }
+  size_t println() { return 1; }
+  template <typename T>
+  size_t println(const T& v) { return print(v) + 1; }
+  template <typename T>
+  size_t println(const T& v, int base) { return print(v, base) + 1; }
+  size_t printf(const char*, ...) { return 0; }
+  size_t write(uint8_t) { return 1; }
+  size_t write(const uint8_t*, size_t n) { return n; }
+  void flush() {}
+};
+
+class HardwareSerial : public Print {
+public:
+  void begin(unsigned long) {}
+  void end() {}
+  int available() { return 0; }
+  int read() { return -1; }
+  explicit operator bool() const { return true; }
+};
+
+inline HardwareSerial Serial;
+
+// ---- Time ----
+
+inline unsigned long millis() { return static_cast<unsigned long>(hostclock::nowUs() / 1000); }
+inline unsigned long micros() { return static_cast<unsigned long>(hostclock::nowUs()); }
+inline void delay(unsigned long ms) { hostclock::advanceUs(static_cast<int64_t>(ms) * 1000); }
+inline void delayMicroseconds(unsigned int us) { hostclock::advanceUs(us); }
+inline void yield() {}
+inline bool getLocalTime(struct tm*, uint32_t = 5000) { return false; }
+
+// ---- GPIO ----
+
+namespace hostpins {
+  struct State {
+    uint8_t level[256] = {};
+    uint8_t mode[256] = {};
+    int lastLow = -1;           // Last pin driven low (SPI chip select)
+    uint32_t writes = 0;
+    void (*isr[256])(void*) = {};   // attachInterruptArg(), FALLING only
+    void* isrArg[256] = {};
+  };
+  inline State& state() {
+    static State s;
+    return s;
+  }
+}
+
+inline void pinMode(uint8_t pin, uint8_t mode) { hostpins::state().mode[pin] = mode; }
+inline void digitalWrite(uint8_t pin, uint8_t value) {
+  hostpins::State& s = hostpins::state();
+  s.level[pin] = value ? HIGH : LOW;
+  if (!value) s.lastLow = pin;
+  s.writes++;
+}
+inline int digitalRead(uint8_t pin) { return hostpins::state().level[pin]; }
+inline int digitalPinToInterrupt(uint8_t pin) { return pin; }
+inline void attachInterrupt(uint8_t, void (*)(), int) {}
+inline void attachInterruptArg(uint8_t pin, void (*fn)(void*), void* arg, int) {
+  hostpins::state().isr[pin] = fn;
+  hostpins::state().isrArg[pin] = arg;
+}
+inline void detachInterrupt(uint8_t pin) { hostpins::state().isr[pin] = nullptr; }
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+namespace hostpins {
+  // An external device drives 'pin'; a falling edge runs the attached ISR
+  inline void drive(uint8_t pin, uint8_t level) {
+    State& s = state();
+    const bool falling = s.level[pin] == HIGH && level == LOW;
+    s.level[pin] = level;
+    if (falling && s.isr[pin] != nullptr) s.isr[pin](s.isrArg[pin]);
+  }
+}
+
+// ---- FreeRTOS ----
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef void (*TaskFunction_t)(void*);
+
+#define portMAX_DELAY 0xffffffffu
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) (static_cast<TickType_t>(ms))
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define pdFAIL 0
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+namespace hostrtos {
+  struct Task {
+    TaskFunction_t function = nullptr;
+    void* arg = nullptr;
+    const char* name = nullptr;
+    uint32_t notifications = 0;
+  };
+  struct Semaphore {
+    bool mutex = false;
+    uint32_t count = 0;
+  };
+  struct State {
+    std::vector<Task*> tasks;
+    bool holdMutexes = false;   // Another task owns every mutex: timed takes fail
+    uint32_t failedTakes = 0;
+  };
+  inline State& state() {
+    static State s;
+    return s;
+  }
+  // Simulates the loop holding the firmware's mutexes (a long SPI or I2C
+  // burst): takes with a timeout wait it out on the host clock and fail
+  inline void holdMutexes(bool hold) { state().holdMutexes = hold; }
+}
+
+typedef hostrtos::Task* TaskHandle_t;
+typedef hostrtos::Semaphore* SemaphoreHandle_t;
+
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t, void* arg,
+                                          UBaseType_t, TaskHandle_t* handle, BaseType_t) {
+  auto* task = new hostrtos::Task{fn, arg, name, 0};
+  hostrtos::state().tasks.push_back(task);
+  if (handle) *handle = task;
+  return pdPASS;
+}
+inline BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stack, void* arg,
+                              UBaseType_t prio, TaskHandle_t* handle) {
+  return xTaskCreatePinnedToCore(fn, name, stack, arg, prio, handle, tskNO_AFFINITY);
+}
+inline void vTaskDelete(TaskHandle_t) {}
+inline void vTaskDelay(TickType_t ticks) { delay(ticks); }
+inline TickType_t xTaskGetTickCount() { return static_cast<TickType_t>(millis()); }
+inline void vTaskDelayUntil(TickType_t* last, TickType_t period) {
+  *last += period;
+  const TickType_t now = xTaskGetTickCount();
+  if (*last > now) delay(*last - now);
+}
+inline BaseType_t xTaskNotifyGive(TaskHandle_t task) { if (task) task->notifications++; return pdPASS; }
+inline void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t*) { xTaskNotifyGive(task); }
+inline uint32_t ulTaskNotifyTake(BaseType_t, TickType_t) { return 0; }
+inline TaskHandle_t xTaskGetCurrentTaskHandle() { return nullptr; }
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex() { return new hostrtos::Semaphore{true, 1}; }
+inline SemaphoreHandle_t xSemaphoreCreateBinary() { return new hostrtos::Semaphore{false, 0}; }
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t timeout) {
+  hostrtos::State& s = hostrtos::state();
+  if (sem != nullptr && sem->mutex && s.holdMutexes && timeout != portMAX_DELAY) {
+    s.failedTakes++;
+    delay(timeout);
+    return pdFALSE;
+  }
+  if (sem != nullptr && !sem->mutex) {
+    if (sem->count == 0) return pdFALSE;
+    sem->count--;
+  }
+  return pdTRUE;
+}
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+  if (sem != nullptr && !sem->mutex) sem->count = 1;
+  return pdTRUE;
+}
+inline BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t sem, BaseType_t*) { return xSemaphoreGive(sem); }
+inline void vSemaphoreDelete(SemaphoreHandle_t sem) { delete sem; }
+
+typedef struct { int owner; } portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED {0}
+inline void portENTER_CRITICAL(portMUX_TYPE*) {}
+inline void portEXIT_CRITICAL(portMUX_TYPE*) {}
+inline void portENTER_CRITICAL_ISR(portMUX_TYPE*) {}
+inline void portEXIT_CRITICAL_ISR(portMUX_TYPE*) {}
+inline void taskENTER_CRITICAL(portMUX_TYPE*) {}
+inline void taskEXIT_CRITICAL(portMUX_TYPE*) {}
+#define portYIELD_FROM_ISR(x) ((void)(x))
@@ -0,0 +1,75 @@
+#pragma once
+// Host stand-in for LittleFS: files live in memory (hostfs::files()), so a
+// test writes "/tones/se.txt" or a WAV clip before the code under test opens it.
+#include <Arduino.h>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace hostfs {
+  inline std::map<std::string, std::string>& files() {
+    static std::map<std::string, std::string> f;
+    return f;
+  }
+  inline bool& mounted() {
+    static bool m = true;
+    return m;
+  }
+}
+
+class File {
+public:
+  File() = default;
+  File(std::string name, std::shared_ptr<std::string> data) : name_(std::move(name)), data_(std::move(data)) {}
+
+  explicit operator bool() const { return data_ != nullptr; }
+  const char* name() const { return name_.c_str(); }
+  size_t size() const { return data_ ? data_->size() : 0; }
+  uint32_t position() const { return static_cast<uint32_t>(pos_); }
+  bool isDirectory() const { return false; }
+  File openNextFile() { return File(); }
+
+  int available() const { return data_ ? static_cast<int>(data_->size() - pos_) : 0; }
+  int read() {
+    if (available() <= 0) return -1;
+    return static_cast<uint8_t>((*data_)[pos_++]);
+  }
+  int read(uint8_t* buf, size_t len) {
+    if (!data_) return -1;
+    const size_t n = std::min(len, data_->size() - pos_);
+    std::memcpy(buf, data_->data() + pos_, n);
+    pos_ += n;
+    return static_cast<int>(n);
+  }
+  bool seek(uint32_t pos) {
+    if (!data_ || pos > data_->size()) return false;
+    pos_ = pos;
+    return true;
+  }
+  String readStringUntil(char terminator) {
+    std::string out;
+    int c;
+    while ((c = read()) >= 0 && c != terminator) out += static_cast<char>(c);
+    return String(out.c_str());
+  }
+  void close() { data_.reset(); pos_ = 0; }
+
+private:
+  std::string name_;
+  std::shared_ptr<std::string> data_;
+  size_t pos_ = 0;
+};
+
+class FS {
+public:
+  bool begin(bool = false) { return hostfs::mounted(); }
+  void end() {}
+  bool exists(const String& path) const { return hostfs::files().count(path.c_str()) > 0; }
+  File open(const String& path, const char* = "r") {
+    auto it = hostfs::files().find(path.c_str());
+    if (it == hostfs::files().end()) return File();
+    return File(path.c_str(), std::make_shared<std::string>(it->second));
+  }
+};
+
+inline FS LittleFS;
@@ -0,0 +1,27 @@
+#pragma once
+// Host stand-in for the NVS Preferences: nothing is stored, every read
+// returns its default, so Settings stays at resetDefaults()
+#include <Arduino.h>
+
+class Preferences {
+public:
+  bool begin(const char*, bool = false) { return false; }
+  void end() {}
+  bool clear() { return true; }
+  bool isKey(const char*) { return false; }
+  bool remove(const char*) { return true; }
+
+  uint8_t getUChar(const char*, uint8_t def = 0) { return def; }
+  uint16_t getUShort(const char*, uint16_t def = 0) { return def; }
+  uint32_t getUInt(const char*, uint32_t def = 0) { return def; }
+  uint64_t getULong64(const char*, uint64_t def = 0) { return def; }
+  bool getBool(const char*, bool def = false) { return def; }
+  String getString(const char*, const String& def = String()) { return def; }
+
+  size_t putUChar(const char*, uint8_t) { return 1; }
+  size_t putUShort(const char*, uint16_t) { return 2; }
+  size_t putUInt(const char*, uint32_t) { return 4; }
+  size_t putULong64(const char*, uint64_t) { return 8; }
+  size_t putBool(const char*, bool) { return 1; }
+  size_t putString(const char*, const String& v) { return v.length(); }
+};
@@ -0,0 +1,62 @@
+#pragma once
+// Host stand-in for the Arduino SPI class. Transfers take their bus time on
+// the host clock (bits / clock) and are logged with the chip select that was
+// driven low, so tests can see which generator got which word and when.
+#include <Arduino.h>
+#include <vector>
+
+#define MSBFIRST 1
+#define LSBFIRST 0
+#define SPI_MODE0 0
+#define SPI_MODE1 1
+#define SPI_MODE2 2
+#define SPI_MODE3 3
+
+class SPISettings {
+public:
+  SPISettings(uint32_t clockHz = 1000000, uint8_t bitOrder = MSBFIRST, uint8_t dataMode = SPI_MODE0)
+    : clockHz(clockHz), bitOrder(bitOrder), dataMode(dataMode) {}
+  uint32_t clockHz;
+  uint8_t bitOrder;
+  uint8_t dataMode;
+};
+
+class SPIClass {
+public:
+  struct Transfer {
+    int64_t atUs;
+    int cs;
+    uint16_t word;
+  };
+
+  void begin(int8_t = -1, int8_t = -1, int8_t = -1, int8_t = -1) {}
+  void end() {}
+  void beginTransaction(const SPISettings& settings) { clockHz_ = settings.clockHz; }
+  void endTransaction() {}
+
+  uint16_t transfer16(uint16_t word) {
+    log.push_back(Transfer{hostclock::nowUs(), hostpins::state().lastLow, word});
+    busTime_(16);
+    return 0;
+  }
+  uint8_t transfer(uint8_t byte) {
+    log.push_back(Transfer{hostclock::nowUs(), hostpins::state().lastLow, byte});
+    busTime_(8);
+    return 0;
+  }
+
+  std::vector<Transfer> log;
+
+private:
+  // Whole microseconds, carried over so short words still add up
+  void busTime_(uint32_t bits) {
+    carryNs_ += static_cast<uint64_t>(bits) * 1000000000u / (clockHz_ ? clockHz_ : 1);
+    hostclock::advanceUs(static_cast<int64_t>(carryNs_ / 1000));
+    carryNs_ %= 1000;
+  }
+
+  uint32_t clockHz_ = 1000000;
+  uint64_t carryNs_ = 0;
+};
+
+inline SPIClass SPI;
@@ -0,0 +1,206 @@
+#pragma once
+// Host stand-in for the Arduino I2C master, with register-level MCP23017
+// models on the bus (hosti2c::bus()). Every transaction takes its time on the
+// wire at the bus clock on the host clock, the way the SPI stub does, and each
+// register byte moved is logged so tests can count OLAT writes and bus load.
+#include <Arduino.h>
+#include <map>
+#include <vector>
+
+namespace hosti2c {
+
+  // MCP23017 in IOCON.BANK=0 with sequential addressing. Pins configured as
+  // inputs follow 'inputs' (set with setInput()); GPINTEN pins latch INTF and
+  // INTCAP on change (INTCON=0) or on differing from DEFVAL (INTCON=1), and
+  // the mirrored INT output drives 'intPin' low until GPIO or INTCAP is read.
+  struct Mcp23017 {
+    enum : uint8_t {
+      IODIRA = 0x00, GPINTENA = 0x04, DEFVALA = 0x06, INTCONA = 0x08, IOCONA = 0x0A,
+      GPPUA = 0x0C, INTFA = 0x0E, INTCAPA = 0x10, GPIOA = 0x12, OLATA = 0x14, kRegs = 0x16
+    };
+
+    uint8_t reg[kRegs] = {0xFF, 0xFF};   // Power-on: all inputs
+    uint16_t inputs = 0xFFFF;             // Levels on the pins from outside
+    uint8_t pointer = 0;
+    int intPin = -1;
+
+    uint16_t word(uint8_t regA) const { return static_cast<uint16_t>(reg[regA] | (reg[regA + 1] << 8)); }
+    uint16_t gpio() const {
+      const uint16_t iodir = word(IODIRA);
+      return static_cast<uint16_t>((word(OLATA) & ~iodir) | (inputs & iodir));
+    }
+
+    void setInput(uint8_t pin, bool level) {
+      const uint16_t before = gpio();
+      const uint16_t bit = static_cast<uint16_t>(1u << pin);
+      inputs = level ? static_cast<uint16_t>(inputs | bit) : static_cast<uint16_t>(inputs & ~bit);
+      evaluate_(before);
+    }
+
+    uint8_t read(uint8_t r) {
+      if (r == GPIOA || r == GPIOA + 1) {
+        const uint16_t g = gpio();
+        clearIntf_(r - GPIOA);
+        return static_cast<uint8_t>(r == GPIOA ? g & 0xFF : g >> 8);
+      }
+      if (r == INTCAPA || r == INTCAPA + 1) {
+        const uint8_t v = reg[r];
+        clearIntf_(r - INTCAPA);
+        return v;
+      }
+      return reg[r];
+    }
+
+    void write(uint8_t r, uint8_t v) {
+      if (r == INTFA || r == INTFA + 1 || r == INTCAPA || r == INTCAPA + 1) return;   // Read-only
+      if (r == GPIOA || r == GPIOA + 1) r = static_cast<uint8_t>(r + 2);              // GPIO writes OLAT
+      const uint16_t before = gpio();
+      reg[r] = v;
+      if (r == IOCONA || r == IOCONA + 1) reg[r ^ 1] = v;                              // One IOCON, two addresses
+      evaluate_(before);
+    }
+
+  private:
+    void evaluate_(uint16_t before) {
+      const uint16_t now = gpio();
+      const uint16_t defval = word(DEFVALA);
+      const uint16_t intcon = word(INTCONA);
+      const uint16_t fire = static_cast<uint16_t>(word(GPINTENA) & ~word(INTFA) &
+                                                  ((~intcon & (now ^ before)) | (intcon & (now ^ defval))));
+      if (fire == 0) return;
+      for (uint8_t port = 0; port < 2; ++port) {
+        const uint8_t bits = static_cast<uint8_t>(fire >> (8 * port));
+        if (bits == 0 || reg[INTFA + port] != 0) continue;   // INTCAP holds until the port is read
+        reg[INTFA + port] = bits;
+        reg[INTCAPA + port] = static_cast<uint8_t>(now >> (8 * port));
+      }
+      driveInt_();
+    }
+
+    void clearIntf_(int port) {
+      reg[INTFA + port] = 0;
+      driveInt_();
+    }
+
+    void driveInt_() {
+      if (intPin >= 0) hostpins::drive(static_cast<uint8_t>(intPin), word(INTFA) != 0 ? LOW : HIGH);
+    }
+  };
+
+  struct Access {
+    int64_t atUs;
+    uint8_t addr;
+    uint8_t reg;
+    uint8_t value;
+    bool read;
+  };
+
+  struct Bus {
+    std::map<uint8_t, Mcp23017> devices;
+    std::vector<Access> log;
+    uint32_t transactions = 0;
+    uint64_t busyUs = 0;         // Time on the wire, all transactions
+
+    Mcp23017& add(uint8_t addr, int intPin = -1) {
+      Mcp23017& chip = devices[addr];
+      chip.intPin = intPin;
+      if (intPin >= 0) hostpins::drive(static_cast<uint8_t>(intPin), HIGH);
+      return chip;
+    }
+    Mcp23017* find(uint8_t addr) {
+      auto it = devices.find(addr);
+      return it == devices.end() ? nullptr : &it->second;
+    }
+    // Register bytes written to 'addr' in [reg, reg + span), optionally from 'sinceUs'
+    uint32_t writes(uint8_t addr, uint8_t reg, uint8_t span = 1, int64_t sinceUs = 0) const {
+      uint32_t n = 0;
+      for (const Access& a : log) {
+        if (!a.read && a.addr == addr && a.reg >= reg && a.reg < reg + span && a.atUs >= sinceUs) n++;
+      }
+      return n;
+    }
+  };
+
+  inline Bus& bus() {
+    static Bus b;
+    return b;
+  }
+
+  inline void reset() { bus() = Bus(); }
+}
+
+class TwoWire {
+public:
+  bool begin(int = -1, int = -1, uint32_t frequency = 0) {
+    if (frequency != 0) clockHz_ = frequency;
+    return true;
+  }
+  bool setClock(uint32_t frequency) { clockHz_ = frequency; return true; }
+  uint32_t getClock() const { return clockHz_; }
+  void setTimeOut(uint16_t) {}
+
+  void beginTransmission(uint8_t addr) { addr_ = addr; tx_.clear(); }
+  void beginTransmission(int addr) { beginTransmission(static_cast<uint8_t>(addr)); }
+  size_t write(uint8_t b) { tx_.push_back(b); return 1; }
+  size_t write(const uint8_t* data, size_t len) { tx_.insert(tx_.end(), data, data + len); return len; }
+
+  // 0 = ok, 2 = address NACK, like the ESP32 core
+  uint8_t endTransmission(bool sendStop = true) {
+    busTime_(tx_.size(), sendStop);
+    hosti2c::Mcp23017* chip = hosti2c::bus().find(addr_);
+    if (chip == nullptr) return 2;
+    if (!tx_.empty()) {
+      chip->pointer = tx_[0];
+      for (std::size_t i = 1; i < tx_.size(); ++i) {
+        const uint8_t r = chip->pointer;
+        hosti2c::bus().log.push_back(hosti2c::Access{hostclock::nowUs(), addr_, r, tx_[i], false});
+        chip->write(r, tx_[i]);
+        chip->pointer = next_(r);
+      }
+    }
+    return 0;
+  }
+  uint8_t endTransmission(int sendStop) { return endTransmission(sendStop != 0); }
+
+  uint8_t requestFrom(int addr, int len, bool = true) {
+    rx_.clear();
+    rxPos_ = 0;
+    busTime_(static_cast<std::size_t>(len), true);
+    hosti2c::Mcp23017* chip = hosti2c::bus().find(static_cast<uint8_t>(addr));
+    if (chip == nullptr) return 0;
+    for (int i = 0; i < len; ++i) {
+      const uint8_t r = chip->pointer;
+      const uint8_t v = chip->read(r);
+      hosti2c::bus().log.push_back(hosti2c::Access{hostclock::nowUs(), static_cast<uint8_t>(addr), r, v, true});
+      rx_.push_back(v);
+      chip->pointer = next_(r);
+    }
+    return static_cast<uint8_t>(len);
+  }
+
+  int available() const { return static_cast<int>(rx_.size() - rxPos_); }
+  int read() { return rxPos_ < rx_.size() ? rx_[rxPos_++] : -1; }
+
+private:
+  static uint8_t next_(uint8_t r) { return static_cast<uint8_t>((r + 1) % hosti2c::Mcp23017::kRegs); }
+
+  // Address byte + data bytes, 9 clocks each, plus start and stop
+  void busTime_(std::size_t bytes, bool stop) {
+    const uint64_t bits = (bytes + 1) * 9 + (stop ? 2 : 1);
+    carryNs_ += bits * 1000000000u / (clockHz_ ? clockHz_ : 1);
+    const int64_t us = static_cast<int64_t>(carryNs_ / 1000);
+    carryNs_ %= 1000;
+    hosti2c::bus().transactions++;
+    hosti2c::bus().busyUs += static_cast<uint64_t>(us);
+    hostclock::advanceUs(us);
+  }
+
+  uint32_t clockHz_ = 100000;   // ESP32 core default until setClock()
+  uint8_t addr_ = 0;
+  std::vector<uint8_t> tx_;
+  std::vector<uint8_t> rx_;
+  std::size_t rxPos_ = 0;
+  uint64_t carryNs_ = 0;
+};
+
+inline TwoWire Wire;
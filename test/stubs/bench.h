@@ -0,0 +1,35 @@
+#pragma once
+// Host micro-benchmark helpers for the native suites. Timings come from the
+// PC running the tests, so they compare paths against each other; they are
+// not ESP32 numbers. Results are printed as Unity messages.
+#include <unity.h>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+
+namespace bench {
+
+  // Keeps a value alive so the optimiser cannot drop the work that made it
+  template <typename T>
+  inline void keep(const T& value) { asm volatile("" : : "g"(&value) : "memory"); }
+
+  // Wall time per call of fn(), after one warm-up call
+  template <typename F>
+  double nsPerCall(uint32_t iterations, F&& fn) {
+    fn();
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; ++i) fn();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+  }
+
+  inline void report(const char* fmt, ...) {
+    char line[160];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(line, sizeof(line), fmt, args);
+    va_end(args);
+    TEST_MESSAGE(line);
+  }
+}
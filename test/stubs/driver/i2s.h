@@ -0,0 +1,215 @@
+#pragma once
+// Host stand-in for the legacy ESP-IDF I2S driver. Each port models the TX
+// DMA ring as a byte count that drains at the configured rate on the host
+// clock. Writes block (advance the manual clock) until space frees up or the
+// timeout runs out. Every accepted write is logged so a test can work out when
+// a given byte reaches the DAC.
+#include <Arduino.h>
+#include <vector>
+
+typedef int i2s_port_t;
+enum { I2S_NUM_0 = 0, I2S_NUM_1 = 1, I2S_NUM_MAX = 2 };
+
+typedef enum { I2S_MODE_MASTER = 1, I2S_MODE_SLAVE = 2, I2S_MODE_TX = 4, I2S_MODE_RX = 8 } i2s_mode_t;
+typedef enum {
+  I2S_BITS_PER_SAMPLE_8BIT = 8,
+  I2S_BITS_PER_SAMPLE_16BIT = 16,
+  I2S_BITS_PER_SAMPLE_24BIT = 24,
+  I2S_BITS_PER_SAMPLE_32BIT = 32
+} i2s_bits_per_sample_t;
+typedef enum { I2S_CHANNEL_MONO = 1, I2S_CHANNEL_STEREO = 2 } i2s_channel_t;
+typedef enum {
+  I2S_CHANNEL_FMT_RIGHT_LEFT,
+  I2S_CHANNEL_FMT_ALL_RIGHT,
+  I2S_CHANNEL_FMT_ALL_LEFT,
+  I2S_CHANNEL_FMT_ONLY_RIGHT,
+  I2S_CHANNEL_FMT_ONLY_LEFT
+} i2s_channel_fmt_t;
+typedef enum { I2S_COMM_FORMAT_STAND_I2S = 1, I2S_COMM_FORMAT_STAND_MSB = 2 } i2s_comm_format_t;
+
+#define ESP_INTR_FLAG_LEVEL1 (1 << 1)
+#define I2S_PIN_NO_CHANGE (-1)
+
+typedef struct {
+  i2s_mode_t mode;
+  uint32_t sample_rate;
+  i2s_bits_per_sample_t bits_per_sample;
+  i2s_channel_fmt_t channel_format;
+  i2s_comm_format_t communication_format;
+  int intr_alloc_flags;
+  int dma_buf_count;
+  int dma_buf_len;
+  bool use_apll;
+  bool tx_desc_auto_clear;
+  int fixed_mclk;
+} i2s_config_t;
+
+typedef struct {
+  int bck_io_num;
+  int ws_io_num;
+  int data_out_num;
+  int data_in_num;
+} i2s_pin_config_t;
+
+namespace hosti2s {
+  struct Write {
+    int64_t atUs;            // Host time the bytes were queued
+    uint64_t offset;         // Bytes accepted on this port before this write
+    size_t bytes;
+    uint64_t queuedBefore;   // Bytes still waiting in the ring ahead of them
+  };
+
+  struct Port {
+    bool installed = false;
+    bool running = false;
+    uint32_t sampleRate = 16000;
+    uint32_t bits = 16;
+    uint32_t channels = 2;
+    uint64_t capacity = 0;
+    uint64_t queued = 0;
+    uint64_t accepted = 0;
+    int64_t drainedUntilUs = 0;
+    uint64_t drainCarry = 0;     // Remainder of drainedUntilUs, in byte-microseconds
+    std::vector<Write> log;
+    std::vector<uint8_t> data;   // Everything accepted, in order
+
+    // Offset of the first non-zero 16-bit word from 'from' on, -1 if only silence was written
+    int64_t firstSoundOffset(std::size_t from = 0) const {
+      for (std::size_t i = from; i + 1 < data.size(); i += 2) {
+        if (data[i] != 0 || data[i + 1] != 0) return static_cast<int64_t>(i);
+      }
+      return -1;
+    }
+
+    int64_t lastSoundOffset(std::size_t from = 0) const {
+      int64_t last = -1;
+      for (std::size_t i = from; i + 1 < data.size(); i += 2) {
+        if (data[i] != 0 || data[i + 1] != 0) last = static_cast<int64_t>(i);
+      }
+      return last;
+    }
+
+    uint32_t bytesPerSecond() const { return sampleRate * channels * (bits / 8); }
+
+    // Bytes played since the last call leave the ring (slot-granular)
+    void drain() {
+      const int64_t now = hostclock::nowUs();
+      if (!running) { restartClock(); return; }
+      const uint64_t elapsed = static_cast<uint64_t>(now - drainedUntilUs) * bytesPerSecond();
+      const uint64_t playable = elapsed > drainCarry ? (elapsed - drainCarry) / 1000000u : 0;
+      if (playable == 0) return;
+      const uint64_t played = playable < queued ? playable : queued;
+      queued -= played;
+      if (queued == 0) {
+        drainedUntilUs = now;
+        drainCarry = 0;
+        return;
+      }
+      // Exact: a byte is rarely a whole number of microseconds
+      const uint64_t scaled = played * 1000000u + drainCarry;
+      drainedUntilUs += static_cast<int64_t>(scaled / bytesPerSecond());
+      drainCarry = scaled % bytesPerSecond();
+    }
+
+    void restartClock() {
+      drainedUntilUs = hostclock::nowUs();
+      drainCarry = 0;
+    }
+
+    // When a byte at 'offset' (counted over all writes) reaches the DAC
+    int64_t playTimeUs(uint64_t offset) const {
+      for (const Write& w : log) {
+        if (offset < w.offset || offset >= w.offset + w.bytes) continue;
+        const uint64_t ahead = w.queuedBefore + (offset - w.offset);
+        return w.atUs + static_cast<int64_t>(ahead * 1000000u / bytesPerSecond());
+      }
+      return -1;
+    }
+  };
+
+  inline Port& port(i2s_port_t p) {
+    static Port ports[I2S_NUM_MAX];
+    return ports[p == I2S_NUM_1 ? 1 : 0];
+  }
+}
+
+inline esp_err_t i2s_driver_install(i2s_port_t p, const i2s_config_t* cfg, int, void*) {
+  hosti2s::Port& port = hosti2s::port(p);
+  if (port.installed) return ESP_ERR_INVALID_STATE;
+  port = hosti2s::Port{};
+  port.installed = true;
+  port.running = true;
+  port.sampleRate = cfg->sample_rate;
+  port.bits = cfg->bits_per_sample;
+  port.channels = (cfg->channel_format == I2S_CHANNEL_FMT_ONLY_LEFT ||
+                   cfg->channel_format == I2S_CHANNEL_FMT_ONLY_RIGHT) ? 1 : 2;
+  port.capacity = static_cast<uint64_t>(cfg->dma_buf_count) * cfg->dma_buf_len * port.channels * (port.bits / 8);
+  port.restartClock();
+  return ESP_OK;
+}
+
+inline esp_err_t i2s_driver_uninstall(i2s_port_t p) {
+  hosti2s::port(p).installed = false;
+  hosti2s::port(p).running = false;
+  return ESP_OK;
+}
+
+inline esp_err_t i2s_set_pin(i2s_port_t, const i2s_pin_config_t*) { return ESP_OK; }
+
+inline esp_err_t i2s_set_clk(i2s_port_t p, uint32_t rate, i2s_bits_per_sample_t bits, i2s_channel_t channels) {
+  hosti2s::Port& port = hosti2s::port(p);
+  if (!port.installed) return ESP_ERR_INVALID_STATE;
+  const uint64_t buffers = port.capacity / (port.channels * (port.bits / 8));
+  port.sampleRate = rate;
+  port.bits = bits;
+  port.channels = channels;
+  port.capacity = buffers * port.channels * (port.bits / 8);
+  port.queued = 0;
+  port.running = true;
+  port.restartClock();
+  return ESP_OK;
+}
+
+inline esp_err_t i2s_stop(i2s_port_t p) {
+  hosti2s::port(p).running = false;
+  return ESP_OK;
+}
+
+inline esp_err_t i2s_start(i2s_port_t p) {
+  hosti2s::port(p).running = true;
+  hosti2s::port(p).restartClock();
+  return ESP_OK;
+}
+
+inline esp_err_t i2s_zero_dma_buffer(i2s_port_t p) {
+  hosti2s::port(p).queued = 0;
+  hosti2s::port(p).restartClock();
+  return ESP_OK;
+}
+
+inline esp_err_t i2s_write(i2s_port_t p, const void* src, size_t size, size_t* written, TickType_t timeout) {
+  hosti2s::Port& port = hosti2s::port(p);
+  *written = 0;
+  if (!port.installed) return ESP_ERR_INVALID_STATE;
+
+  const int64_t deadline = hostclock::nowUs() + static_cast<int64_t>(timeout == portMAX_DELAY ? 10000000 : timeout * 1000);
+  while (*written < size) {
+    port.drain();
+    const uint64_t space = port.capacity - port.queued;
+    if (space > 0) {
+      const size_t chunk = static_cast<size_t>(space < size - *written ? space : size - *written);
+      port.log.push_back(hosti2s::Write{hostclock::nowUs(), port.accepted, chunk, port.queued});
+      const uint8_t* bytes = static_cast<const uint8_t*>(src) + *written;
+      port.data.insert(port.data.end(), bytes, bytes + chunk);
+      port.accepted += chunk;
+      port.queued += chunk;
+      *written += chunk;
+      continue;
+    }
+    if (!hostclock::state().manual || !port.running || hostclock::nowUs() >= deadline) break;
+    // Wait for one slot of output, like the driver waiting on the next free descriptor
+    const int64_t step = 1000000 / port.sampleRate + 1;
+    hostclock::advanceUs(step);
+  }
+  return ESP_OK;
+}
@@ -0,0 +1,30 @@
+#pragma once
+// Host stand-in for the partition API: there is no flash, so no partition is
+// found and AudioBank falls back to LittleFS like a board without the bank.
+#include <cstddef>
+#include <cstdint>
+#include "esp_err.h"
+
+typedef enum { ESP_PARTITION_TYPE_APP = 0x00, ESP_PARTITION_TYPE_DATA = 0x01 } esp_partition_type_t;
+typedef int esp_partition_subtype_t;
+typedef enum { SPI_FLASH_MMAP_DATA, SPI_FLASH_MMAP_INST } spi_flash_mmap_memory_t;
+typedef uint32_t spi_flash_mmap_handle_t;
+
+typedef struct {
+  esp_partition_type_t type;
+  esp_partition_subtype_t subtype;
+  uint32_t address;
+  uint32_t size;
+  char label[17];
+} esp_partition_t;
+
+inline const esp_partition_t* esp_partition_find_first(esp_partition_type_t, esp_partition_subtype_t, const char*) {
+  return nullptr;
+}
+
+inline esp_err_t esp_partition_mmap(const esp_partition_t*, size_t, size_t, spi_flash_mmap_memory_t,
+                                    const void**, spi_flash_mmap_handle_t*) {
+  return ESP_ERR_NOT_FOUND;
+}
+
+inline void spi_flash_munmap(spi_flash_mmap_handle_t) {}
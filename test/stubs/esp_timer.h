@@ -0,0 +1,63 @@
+#pragma once
+// Host stand-in for esp_timer: the time base and one-shot/periodic timers on
+// the host clock. Timers only fire while a test advances the manual clock.
+#include <cstdint>
+#include <memory>
+#include "esp_err.h"
+#include "host_clock.h"
+
+typedef hostclock::Timer* esp_timer_handle_t;
+typedef void (*esp_timer_cb_t)(void*);
+
+typedef enum { ESP_TIMER_TASK = 0, ESP_TIMER_ISR = 1 } esp_timer_dispatch_t;
+
+typedef struct {
+  esp_timer_cb_t callback;
+  void* arg;
+  esp_timer_dispatch_t dispatch_method;
+  const char* name;
+  bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+inline int64_t esp_timer_get_time() { return hostclock::nowUs(); }
+
+inline esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* out) {
+  if (args == nullptr || args->callback == nullptr || out == nullptr) return ESP_ERR_INVALID_ARG;
+  auto timer = std::make_unique<hostclock::Timer>();
+  timer->callback = args->callback;
+  timer->arg = args->arg;
+  *out = timer.get();
+  hostclock::state().timers.push_back(std::move(timer));
+  return ESP_OK;
+}
+
+inline esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeoutUs) {
+  if (timer == nullptr) return ESP_ERR_INVALID_ARG;
+  if (timer->armed) return ESP_ERR_INVALID_STATE;
+  timer->dueUs = hostclock::nowUs() + static_cast<int64_t>(timeoutUs);
+  timer->periodUs = 0;
+  timer->armed = true;
+  return ESP_OK;
+}
+
+inline esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t periodUs) {
+  if (timer == nullptr) return ESP_ERR_INVALID_ARG;
+  if (timer->armed) return ESP_ERR_INVALID_STATE;
+  timer->dueUs = hostclock::nowUs() + static_cast<int64_t>(periodUs);
+  timer->periodUs = periodUs;
+  timer->armed = true;
+  return ESP_OK;
+}
+
+inline esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+  if (timer == nullptr) return ESP_ERR_INVALID_ARG;
+  if (!timer->armed) return ESP_ERR_INVALID_STATE;
+  timer->armed = false;
+  return ESP_OK;
+}
+
+inline esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+  if (timer == nullptr) return ESP_ERR_INVALID_ARG;
+  timer->armed = false;
+  return ESP_OK;
+}
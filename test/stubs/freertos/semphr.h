@@ -0,0 +1,3 @@
+#pragma once
+// Host stand-in: the FreeRTOS names live in the Arduino.h stub
+#include <Arduino.h>
@@ -0,0 +1,83 @@
+#pragma once
+// Host clock for the native tests. Runs on the PC's steady clock by default,
+// so CPU-load counters measure real time. A test can switch to a manual clock
+// (useManual) and then drive time itself. advanceUs() fires the stub esp_timers
+// that fall due on the way, at their deadlines. delay() and the SPI stub go
+// through advanceUs() too.
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace hostclock {
+
+  using TimerCallback = void (*)(void*);
+
+  struct Timer {
+    TimerCallback callback = nullptr;
+    void* arg = nullptr;
+    int64_t dueUs = 0;
+    uint64_t periodUs = 0;      // 0 = one-shot
+    bool armed = false;
+  };
+
+  struct State {
+    bool manual = false;
+    int64_t nowUs = 0;
+    bool firing = false;        // Inside a timer callback
+    std::vector<std::unique_ptr<Timer>> timers;
+  };
+
+  inline State& state() {
+    static State s;
+    return s;
+  }
+
+  inline int64_t realUs() {
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+  }
+
+  inline int64_t nowUs() { return state().manual ? state().nowUs : realUs(); }
+
+  // Start away from zero: the firmware uses 0 as "never" in a few timestamps
+  inline void useManual(int64_t startUs = 1000000) {
+    State& s = state();
+    s.manual = true;
+    s.nowUs = startUs;
+    for (auto& t : s.timers) t->armed = false;
+  }
+
+  inline void useReal() { state().manual = false; }
+
+  // Moves the manual clock to 'targetUs', firing due timers in deadline order.
+  // A callback that advances time itself (a blocking wait inside the timer
+  // task) only moves the clock; the outer loop fires what became due.
+  inline void advanceTo(int64_t targetUs) {
+    State& s = state();
+    if (!s.manual) return;
+    if (s.firing) {
+      if (targetUs > s.nowUs) s.nowUs = targetUs;
+      return;
+    }
+    while (true) {
+      Timer* next = nullptr;
+      for (auto& t : s.timers) {
+        if (t->armed && t->dueUs <= targetUs && (next == nullptr || t->dueUs < next->dueUs)) next = t.get();
+      }
+      if (next == nullptr) break;
+      if (next->dueUs > s.nowUs) s.nowUs = next->dueUs;
+      if (next->periodUs > 0) {
+        next->dueUs += static_cast<int64_t>(next->periodUs);
+      } else {
+        next->armed = false;
+      }
+      s.firing = true;
+      next->callback(next->arg);
+      s.firing = false;
+    }
+    if (targetUs > s.nowUs) s.nowUs = targetUs;
+  }
+
+  inline void advanceUs(int64_t us) { advanceTo(state().nowUs + us); }
+}
@@ -0,0 +1,4 @@
+#pragma once
+// Host builds are case sensitive: the firmware includes this name for
+// src/settings/settings.h
+#include "../../../src/settings/settings.h"
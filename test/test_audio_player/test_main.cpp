@@ -0,0 +1,309 @@
+// Host scenarios for AudioPlayer start-up: when the primed callback fires
+// (the D_OUTL close) against when the first clip frame reaches the DAC. The
+// playback task runs as AudioPlayer::runOnce() passes, the main loop as a 1 ms
+// esp_timer calling updatePlayback(), and the I2S stub drains its DMA ring in
+// real time on the manual host clock. The announcement tests add the switch
+// side: ConnectionHandler -> SwitchFabric -> MT8816Driver -> MCP23017 on the
+// I2C stub, with the crosspoints read back from the expander's OLAT writes.
+#include <unity.h>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <esp_timer.h>
+#include <SPI.h>
+#include <Wire.h>
+#include "bench.h"
+#include "services/AudioPlayer.h"
+#include "services/AudioCodecs.h"
+#include "services/ConnectionHandler.h"
+
+namespace {
+  void put16(std::string& s, uint16_t v) { s += static_cast<char>(v & 0xFF); s += static_cast<char>(v >> 8); }
+  void put32(std::string& s, uint32_t v) { put16(s, v & 0xFFFF); put16(s, v >> 16); }
+
+  // Canonical 44-byte header WAV; 'format' is a codec::kFormat* tag
+  std::string wav(uint16_t format, uint32_t rate, uint16_t bits, const std::string& payload) {
+    const uint16_t blockAlign = static_cast<uint16_t>(bits / 8);
+    std::string s = "RIFF";
+    put32(s, static_cast<uint32_t>(36 + payload.size()));
+    s += "WAVEfmt ";
+    put32(s, 16);
+    put16(s, format);
+    put16(s, 1);
+    put32(s, rate);
+    put32(s, rate * blockAlign);
+    put16(s, blockAlign);
+    put16(s, bits);
+    s += "data";
+    put32(s, static_cast<uint32_t>(payload.size()));
+    return s + payload;
+  }
+
+  // 'ms' of a 1 kHz cosine, so the very first sample is loud
+  std::string pcmClip(uint32_t rate, uint32_t ms) {
+    std::string payload;
+    for (uint32_t i = 0; i < rate * ms / 1000; ++i) {
+      put16(payload, static_cast<uint16_t>(static_cast<int16_t>(lrint(8000.0 * cos(2.0 * M_PI * 1000.0 * i / rate)))));
+    }
+    return wav(codec::kFormatPcm, rate, 16, payload);
+  }
+
+  std::string ulawClip(uint32_t ms) {
+    std::string payload;
+    for (uint32_t i = 0; i < 8 * ms; ++i) payload += static_cast<char>(i % 8 < 4 ? 0x8F : 0x0F);
+    return wav(codec::kFormatUlaw, 8000, 8, payload);
+  }
+
+  struct Start {
+    uint32_t firstFrameUs;   // startPlayback() -> first clip frame at the DAC
+    int32_t marginUs;        // Primed callback -> first clip frame at the DAC
+    uint32_t reportedUs;     // streamStats().startLatencyLastUs
+    bool success;
+  };
+
+  struct Rig {
+    PCMDriver pcm;
+    AudioPlayer player{pcm};
+    esp_timer_handle_t loopTimer = nullptr;
+    int64_t primedUs = -1;
+    bool finished = false;
+    bool success = false;
+
+    Rig() {
+      player.begin();
+      player.setPrimedCallback([this] { primedUs = esp_timer_get_time(); });
+      player.setFinishedCallback([this](bool ok) { finished = true; success = ok; });
+      esp_timer_create_args_t args{};
+      args.callback = [](void* arg) { static_cast<Rig*>(arg)->player.updatePlayback(); };
+      args.arg = this;
+      args.name = "loop";
+      esp_timer_create(&args, &loopTimer);
+      esp_timer_start_periodic(loopTimer, 1000);
+    }
+
+    ~Rig() {
+      esp_timer_delete(loopTimer);
+      i2s_driver_uninstall(I2S_NUM_0);
+    }
+
+    // Runs the task until the clip has finished and the task is parked again
+    Start play(const char* path) {
+      hosti2s::Port& port = hosti2s::port(I2S_NUM_0);
+      const std::size_t before = port.data.size();
+      primedUs = -1;
+      finished = false;
+      const int64_t startUs = esp_timer_get_time();
+      if (!player.startPlayback(path)) return Start{0, 0, 0, false};
+
+      const int64_t deadline = startUs + 10000000;
+      while (!finished && esp_timer_get_time() < deadline) {
+        if (player.runOnce() != 0) hostclock::advanceUs(1000);
+      }
+      while (player.runOnce() == 0) {}
+      hostclock::advanceUs(2000);
+
+      const int64_t offset = port.firstSoundOffset(before);
+      const int64_t playUs = offset >= 0 ? port.playTimeUs(static_cast<uint64_t>(offset)) : -1;
+      return Start{static_cast<uint32_t>(playUs - startUs), static_cast<int32_t>(playUs - primedUs),
+                   player.streamStats().startLatencyLastUs, success && playUs >= 0 && primedUs >= 0};
+    }
+  };
+
+  struct Latch {
+    int64_t atUs;
+    uint8_t x;
+    uint8_t y;
+    bool on;
+  };
+
+  // MT8816 latches DATA into (AX, AY) when STROBE falls with CS high
+  std::vector<Latch> crosspointLatches() {
+    std::vector<Latch> out;
+    uint8_t olatA = 0;
+    uint8_t olatB = 0;
+    const uint8_t strobe = static_cast<uint8_t>(1u << cfg::mcp::STROBE);
+    const uint8_t cs = static_cast<uint8_t>(1u << cfg::mcp::CS);
+    for (const hosti2c::Access& a : hosti2c::bus().log) {
+      if (a.read || a.addr != cfg::mcp::MCP_MT8816_ADDRESS) continue;
+      if (a.reg == 0x15 || a.reg == 0x13) olatB = a.value;
+      if (a.reg != 0x14 && a.reg != 0x12) continue;
+      const bool fell = (olatA & strobe) && !(a.value & strobe);
+      olatA = a.value;
+      if (fell && (olatA & cs)) {
+        out.push_back(Latch{a.atUs, static_cast<uint8_t>(olatB & 0x0F), static_cast<uint8_t>((olatB >> 4) & 0x07),
+                            (olatA & (1u << cfg::mcp::DATA)) != 0});
+      }
+    }
+    return out;
+  }
+
+  int64_t latchAt(const std::vector<Latch>& latches, uint8_t line, bool on) {
+    for (const Latch& l : latches) {
+      if (l.x == cfg::mt8816::D_OUTL && l.y == cfg::mt8816::LINE_PORTS[line].y && l.on == on) return l.atUs;
+    }
+    return -1;
+  }
+
+  // The exchange wiring App does: one PCMDriver for synth and player, the
+  // player handed to ConnectionHandler together with ToneGenerator
+  struct Exchange {
+    MCPDriver mcp;
+    MT8816Driver mt8816{mcp, Settings::instance()};
+    SwitchFabric fabric{mt8816, Settings::instance()};
+    ConnectionHandler connections{fabric, Settings::instance()};
+    AD9833Driver d1{10};
+    AD9833Driver d2{11};
+    AD9833Driver d3{12};
+    PCMDriver pcm;
+    ToneSynth synth{pcm};
+    ToneGenerator tones{d1, d2, d3};
+    AudioPlayer player{pcm};
+    esp_timer_handle_t loopTimer = nullptr;
+
+    Exchange() {
+      hosti2c::reset();
+      hosti2c::bus().add(cfg::mcp::MCP_MAIN_ADDRESS, cfg::mcp::MCP_MAIN_INT_PIN);
+      hosti2c::bus().add(cfg::mcp::MCP_MT8816_ADDRESS, cfg::mcp::MCP_MT8816_INT_PIN);
+      for (std::size_t bank = 0; bank < cfg::lines::SLIC_BANK_COUNT; ++bank) {
+        hosti2c::bus().add(cfg::mcp::SLIC_BANK_ADDR[bank], cfg::mcp::SLIC_BANK_INT_PIN[bank]);
+      }
+      mcp.begin();
+      mt8816.begin();
+      if (synth.begin()) tones.setSynth(&synth);
+      tones.begin();
+      if (player.begin()) connections.setAudioPlayer(&player, &tones);
+
+      esp_timer_create_args_t args{};
+      args.callback = [](void* arg) {
+        Exchange* ex = static_cast<Exchange*>(arg);
+        ex->mt8816.update();
+        ex->tones.update();
+        ex->player.updatePlayback();
+      };
+      args.arg = this;
+      args.name = "loop";
+      esp_timer_create(&args, &loopTimer);
+      esp_timer_start_periodic(loopTimer, 1000);
+    }
+
+    ~Exchange() {
+      esp_timer_delete(loopTimer);
+      i2s_driver_uninstall(I2S_NUM_0);
+    }
+
+    // Task passes until the clip is over and the task parked
+    void runClip() {
+      const int64_t deadline = esp_timer_get_time() + 10000000;
+      while (player.isPlaying() && esp_timer_get_time() < deadline) {
+        if (player.runOnce() != 0) hostclock::advanceUs(1000);
+      }
+      while (player.runOnce() == 0) {}
+      hostclock::advanceUs(2000);
+    }
+  };
+}
+
+void setUp() {
+  hostclock::useManual();
+  hostfs::files().clear();
+  Settings::instance().resetDefaults();
+}
+
+void tearDown() {}
+
+// Every clip format starts after the crosspoint close and within the lead-in
+void test_first_clip_frame_follows_the_primed_callback() {
+  hostfs::files()["/audio/pcm16k.wav"] = pcmClip(16000, 400);
+  hostfs::files()["/audio/pcm48k.wav"] = pcmClip(48000, 400);
+  hostfs::files()["/audio/pcm8k.wav"] = pcmClip(8000, 400);
+  hostfs::files()["/audio/ulaw8k.wav"] = ulawClip(400);
+
+  Rig rig;
+  for (const char* path : {"/audio/pcm16k.wav", "/audio/pcm48k.wav", "/audio/pcm8k.wav", "/audio/ulaw8k.wav"}) {
+    const Start s = rig.play(path);
+    bench::report("%-18s first clip frame %6u us after start, %6d us after primed (reported %u us)",
+                  path, static_cast<unsigned>(s.firstFrameUs), static_cast<int>(s.marginUs),
+                  static_cast<unsigned>(s.reportedUs));
+    TEST_ASSERT_TRUE(s.success);
+    TEST_ASSERT_TRUE(s.marginUs > 0);
+  }
+}
+
+// ConnectionHandler closes D_OUTL to the line from the primed callback: after
+// the lead-in started and before the first clip frame plays, with the I2C
+// bus time of the MT8816 strobe writes included. It opens again only after
+// the last clip frame has played.
+void test_announcement_closes_d_outl_inside_the_lead_in() {
+  hostfs::files()["/audio/pcm16k.wav"] = pcmClip(16000, 300);
+  hostfs::files()["/audio/ulaw8k.wav"] = ulawClip(300);
+  Exchange ex;
+
+  const uint8_t line = 2;
+  for (const char* path : {"/audio/pcm16k.wav", "/audio/ulaw8k.wav"}) {
+    hosti2c::bus().log.clear();
+    hosti2c::bus().busyUs = 0;
+    hosti2s::Port& port = hosti2s::port(I2S_NUM_0);
+    const std::size_t before = port.data.size();
+    const int64_t startUs = esp_timer_get_time();
+    TEST_ASSERT_TRUE(ex.connections.playAnnouncement(line, path));
+    TEST_ASSERT_TRUE(ex.tones.synthReserved());
+    ex.runClip();
+
+    const std::vector<Latch> latches = crosspointLatches();
+    const int64_t closeUs = latchAt(latches, line, true);
+    const int64_t openUs = latchAt(latches, line, false);
+    const int64_t offset = port.firstSoundOffset(before);
+    TEST_ASSERT_TRUE(offset >= 0);
+    const int64_t playUs = port.playTimeUs(static_cast<uint64_t>(offset));
+    const int64_t lastUs = port.playTimeUs(static_cast<uint64_t>(port.lastSoundOffset(before)));
+    const ConnectionHandler::AnnouncementStats& st = ex.connections.announcementStats();
+
+    bench::report("%-18s D_OUTL closed %5d us after start, %5d us before the first clip frame (stat %d us), "
+                  "opened %4d us after the last", path, static_cast<int>(closeUs - startUs),
+                  static_cast<int>(playUs - closeUs), static_cast<int>(st.closeMarginLastUs),
+                  static_cast<int>(openUs - lastUs));
+    TEST_ASSERT_TRUE(closeUs > startUs);
+    TEST_ASSERT_TRUE(closeUs < playUs);
+    TEST_ASSERT_TRUE(openUs > lastUs);   // The tail in DMA plays out before the line is cut
+    TEST_ASSERT_EQUAL_UINT32(0, st.lateCloses);
+    TEST_ASSERT_TRUE(st.closeMarginLastUs > 0);
+    TEST_ASSERT_FALSE(ex.connections.announcementActive(line));
+    TEST_ASSERT_FALSE(ex.tones.synthReserved());
+  }
+}
+
+// D_OUTL carries one stream: a line listening to the synth keeps it, and the
+// allocator stays off the synth until the announcement is stopped
+void test_announcement_and_synth_take_turns_on_d_outl() {
+  hostfs::files()["/audio/pcm16k.wav"] = pcmClip(16000, 300);
+  const char* const dualPlan = "ready = 350+440/0\nbusy = 480+620/250, 0/250\n"
+                               "fail = 950+1400/330, 0/330\nring = 440+480/1000, 0/5000\n";
+  hostfs::files()["/tones/dual.txt"] = dualPlan;
+  Settings::instance().tonePlan = "dual";
+  Settings::instance().toneReadyPrearmed = false;
+  Exchange ex;
+
+  // Dual tones go to the synth first
+  TEST_ASSERT_EQUAL_UINT8(cfg::mt8816::D_OUTL, ex.tones.requestTone(0, model::ToneId::Busy));
+  TEST_ASSERT_FALSE(ex.connections.playAnnouncement(3, "/audio/pcm16k.wav"));
+  TEST_ASSERT_FALSE(ex.player.isPlaying());
+
+  ex.tones.releaseLine(0);
+  ex.tones.update();
+  TEST_ASSERT_TRUE(ex.connections.playAnnouncement(3, "/audio/pcm16k.wav"));
+  // While the clip plays the allocator stays off the synth
+  const uint8_t dac = ex.tones.requestTone(1, model::ToneId::Busy);
+  TEST_ASSERT_TRUE(dac != 0 && dac != cfg::mt8816::D_OUTL);
+
+  ex.connections.stopAnnouncement(3);
+  TEST_ASSERT_FALSE(ex.player.isPlaying());
+  TEST_ASSERT_FALSE(ex.tones.synthReserved());
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_first_clip_frame_follows_the_primed_callback);
+  RUN_TEST(test_announcement_closes_d_outl_inside_the_lead_in);
+  RUN_TEST(test_announcement_and_synth_take_turns_on_d_outl);
+  return UNITY_END();
+}
@@ -0,0 +1,140 @@
+// Host measurement of how long the MT8816 and MT8870 paths hold the loop.
+// MCPDriver talks to MCP23017 models on the I2C stub, which charges every
+// byte at the bus clock on the fake clock; delayMicroseconds() advances the
+// same clock. Each call is timed through util::LoopProfiler, like App::update().
+#include <unity.h>
+#include <Wire.h>
+#include "bench.h"
+#include "drivers/InterruptManager.h"
+#include "drivers/MCPDriver.h"
+#include "drivers/MT8816Driver.h"
+#include "services/LineManager.h"
+#include "services/ToneReader.h"
+#include "util/LoopProfiler.h"
+
+namespace {
+  constexpr uint32_t kBudgetUs = util::LoopProfiler::kBudgetUs;
+
+  struct Exchange {
+    MCPDriver mcp;
+    MT8816Driver mt8816{mcp, Settings::instance()};
+    InterruptManager interrupts{mcp, Settings::instance()};
+    LineManager lines{Settings::instance()};
+    ToneReader reader{interrupts, mcp, Settings::instance(), lines};
+    util::LoopProfiler profiler;
+
+    explicit Exchange(uint32_t clockHz) {
+      hosti2c::reset();
+      Wire.setClock(clockHz);
+      hosti2c::bus().add(cfg::mcp::MCP_MAIN_ADDRESS, cfg::mcp::MCP_MAIN_INT_PIN);
+      hosti2c::bus().add(cfg::mcp::MCP_MT8816_ADDRESS, cfg::mcp::MCP_MT8816_INT_PIN);
+      for (std::size_t bank = 0; bank < cfg::lines::SLIC_BANK_COUNT; ++bank) {
+        hosti2c::bus().add(cfg::mcp::SLIC_BANK_ADDR[bank], cfg::mcp::SLIC_BANK_INT_PIN[bank]);
+      }
+      mcp.begin();
+      lines.setToneReader(&reader);
+      lines.begin();
+    }
+
+    // One profiled stage around fn(); returns the time it took
+    template <typename F>
+    uint32_t timed(const char* stage, F&& fn) {
+      profiler.startLoop();
+      fn();
+      profiler.mark(stage);
+      profiler.endLoop();
+      for (std::size_t i = 0; i < profiler.stageCount(); ++i) {
+        if (profiler.stages()[i].name == stage) return profiler.stages()[i].lastUs;
+      }
+      return 0;
+    }
+
+    uint32_t worst(const char* stage) const {
+      for (std::size_t i = 0; i < profiler.stageCount(); ++i) {
+        if (profiler.stages()[i].name == stage) return profiler.stages()[i].maxUs;
+      }
+      return 0;
+    }
+  };
+
+  // A call through the fabric: two crosspoints, made and then broken
+  const MT8816Driver::Crosspoint kConnect[] = {{0, 1, 0, true}, {0, 5, 1, true}};
+  const MT8816Driver::Crosspoint kRelease[] = {{0, 1, 0, false}, {0, 5, 1, false}};
+}
+
+void setUp() {
+  hostclock::useManual();
+  Settings::instance().resetDefaults();
+}
+
+void tearDown() {
+  Wire.setClock(100000);
+}
+
+// begin() raises RESET, update() drops it 100 ms later; neither waits, and a
+// strobe fits the budget once the bus runs at cfg::mcp::I2C_CLOCK_HZ
+void test_mt8816_reset_and_strobes() {
+  for (uint32_t clockHz : {100000u, cfg::mcp::I2C_CLOCK_HZ}) {
+    Exchange ex(clockHz);
+    const uint32_t begin = ex.timed("mt8816.begin", [&] { ex.mt8816.begin(); });
+    for (int ms = 0; ms < 150; ++ms) {
+      ex.timed("mt8816.update", [&] { ex.mt8816.update(); });
+      hostclock::advanceUs(1000);
+    }
+    const uint32_t one = ex.timed("mt8816.setConnection", [&] { ex.mt8816.setConnection(0, 3, 2, true); });
+    const uint32_t call = ex.timed("mt8816.apply(call)", [&] { ex.mt8816.apply(kConnect, 2); });
+    const uint32_t release = ex.timed("mt8816.apply(release)", [&] { ex.mt8816.apply(kRelease, 2); });
+    bench::report("%3u kHz: begin %u us, update max %u us, one strobe %u us, call %u us, release %u us",
+                  clockHz / 1000, begin, ex.worst("mt8816.update"), one, call, release);
+    if (clockHz == cfg::mcp::I2C_CLOCK_HZ) {
+      TEST_ASSERT_TRUE(begin < kBudgetUs);
+      TEST_ASSERT_TRUE(ex.worst("mt8816.update") < kBudgetUs);
+      TEST_ASSERT_TRUE(one < kBudgetUs);
+    } else {
+      TEST_ASSERT_TRUE(one > kBudgetUs);   // Why App sets the clock
+    }
+  }
+}
+
+// A crosspoint written before the reset hold is over ends the reset first;
+// the connection is not lost and nothing waits out the 100 ms
+void test_mt8816_apply_during_reset_hold() {
+  Exchange ex(cfg::mcp::I2C_CLOCK_HZ);
+  ex.mt8816.begin();
+  hostclock::advanceUs(5000);
+  const uint32_t us = ex.timed("mt8816.setConnection", [&] { ex.mt8816.setConnection(0, 3, 2, true); });
+  bench::report("setConnection 5 ms into the reset hold: %u us", us);
+  TEST_ASSERT_TRUE(us < kBudgetUs);
+  TEST_ASSERT_EQUAL_UINT32(4, ex.mt8816.totalWrites());
+}
+
+// First line Ready powers the MT8870 from inside setStatus(); the power-up
+// then runs in update() (Powering -> Settling -> Active) without a stall
+void test_tone_reader_activation() {
+  Exchange ex(cfg::mcp::I2C_CLOCK_HZ);
+  const uint32_t activate = ex.timed("setStatus(Ready)", [&] { ex.lines.setStatus(0, model::LineStatus::Ready); });
+  TEST_ASSERT_TRUE(ex.reader.isActive);
+
+  unsigned long readyAfterMs = 0;
+  for (unsigned long ms = 1; ms <= 200 && readyAfterMs == 0; ++ms) {
+    hostclock::advanceUs(1000);
+    ex.timed("toneReader.update", [&] {
+      ex.interrupts.collectInterrupts();
+      ex.reader.update();
+    });
+    if (ex.reader.isReady()) readyAfterMs = ms;
+  }
+  bench::report("setStatus(Ready) with activate(): %u us, update max %u us, MT8870 ready after %lu ms", activate,
+                ex.worst("toneReader.update"), readyAfterMs);
+  TEST_ASSERT_TRUE(activate < kBudgetUs);
+  TEST_ASSERT_TRUE(ex.worst("toneReader.update") < kBudgetUs);
+  TEST_ASSERT_TRUE(readyAfterMs > 0 && readyAfterMs <= 20);
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_mt8816_reset_and_strobes);
+  RUN_TEST(test_mt8816_apply_during_reset_hold);
+  RUN_TEST(test_tone_reader_activation);
+  return UNITY_END();
+}
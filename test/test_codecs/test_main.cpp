@@ -0,0 +1,193 @@
+// Host tests for the WAV announcement decoders (AudioCodecs): G.711 tables,
+// IMA-ADPCM steps and blocks, and decode throughput per format
+#include <unity.h>
+#include <cmath>
+#include <vector>
+#include "bench.h"
+#include "services/AudioCodecs.h"
+
+void setUp() {}
+void tearDown() {}
+
+namespace {
+  // ITU-T G.711 expansion done per sample, the way a table-less decoder would
+  int16_t ulawArith(uint8_t u) {
+    u = static_cast<uint8_t>(~u);
+    const int exponent = (u >> 4) & 0x07;
+    const int magnitude = ((((u & 0x0F) << 3) + 0x84) << exponent) - 0x84;
+    return static_cast<int16_t>((u & 0x80) ? -magnitude : magnitude);
+  }
+
+  int16_t alawArith(uint8_t a) {
+    a = static_cast<uint8_t>(a ^ 0x55);
+    const int exponent = (a >> 4) & 0x07;
+    const int mantissa = a & 0x0F;
+    const int magnitude = exponent == 0 ? ((mantissa << 4) + 8) : (((mantissa << 4) + 0x108) << (exponent - 1));
+    return static_cast<int16_t>((a & 0x80) ? magnitude : -magnitude);
+  }
+
+  // Reference IMA-ADPCM encoder, to feed the decoder something speech-like
+  uint8_t imaEncode(codec::ImaState& st, int16_t sample) {
+    const int32_t step = codec::kImaStepTable[st.index];
+    int32_t diff = sample - st.predictor;
+    uint8_t code = 0;
+    if (diff < 0) { code = 8; diff = -diff; }
+    if (diff >= step) { code |= 4; diff -= step; }
+    if (diff >= step / 2) { code |= 2; diff -= step / 2; }
+    if (diff >= step / 4) code |= 1;
+    codec::imaDecode(st, code);   // Keep the encoder in step with the decoder
+    return code;
+  }
+
+  // One Microsoft IMA block of a 440 Hz tone at 8 kHz: header + packed nibbles
+  std::vector<uint8_t> imaMonoBlock(uint16_t blockAlign, std::vector<int16_t>& source) {
+    const uint32_t samples = codec::imaSamplesPerBlock(blockAlign, 1);
+    source.resize(samples);
+    for (uint32_t i = 0; i < samples; ++i) {
+      source[i] = static_cast<int16_t>(lrint(12000.0 * sin(2.0 * M_PI * 440.0 * i / 8000.0)));
+    }
+    std::vector<uint8_t> block(blockAlign, 0);
+    codec::ImaState st;
+    st.predictor = source[0];
+    block[0] = static_cast<uint8_t>(source[0] & 0xFF);
+    block[1] = static_cast<uint8_t>((source[0] >> 8) & 0xFF);
+    for (uint32_t i = 1; i < samples; ++i) {
+      const uint8_t code = imaEncode(st, source[i]);
+      const uint32_t nibble = i - 1;
+      block[4 + nibble / 2] |= static_cast<uint8_t>((nibble & 1) ? code << 4 : code);
+    }
+    return block;
+  }
+
+  // Mono block decode as AudioPlayer::decodeImaBlock_ does it, minus the output
+  uint32_t decodeMonoBlock(const uint8_t* block, uint32_t samples, int16_t* out) {
+    codec::ImaState st;
+    st.predictor = static_cast<int16_t>(block[0] | (block[1] << 8));
+    st.index = block[2] > 88 ? 88 : block[2];
+    out[0] = static_cast<int16_t>(st.predictor);
+    const uint8_t* data = block + 4;
+    for (uint32_t i = 1; i < samples; i += 2, ++data) {
+      out[i] = codec::imaDecode(st, *data & 0x0F);
+      if (i + 1 < samples) out[i + 1] = codec::imaDecode(st, *data >> 4);
+    }
+    return samples;
+  }
+}
+
+void test_ulaw_endpoints_and_symmetry() {
+  TEST_ASSERT_EQUAL_INT16(0, codec::ulaw(0xFF));
+  TEST_ASSERT_EQUAL_INT16(0, codec::ulaw(0x7F));
+  TEST_ASSERT_EQUAL_INT16(32124, codec::ulaw(0x80));
+  TEST_ASSERT_EQUAL_INT16(-32124, codec::ulaw(0x00));
+  for (int i = 0; i < 128; ++i) {
+    TEST_ASSERT_EQUAL_INT16(-codec::ulaw(static_cast<uint8_t>(i | 0x80)), codec::ulaw(static_cast<uint8_t>(i)));
+  }
+}
+
+void test_alaw_endpoints_and_symmetry() {
+  TEST_ASSERT_EQUAL_INT16(8, codec::alaw(0xD5));
+  TEST_ASSERT_EQUAL_INT16(-8, codec::alaw(0x55));
+  TEST_ASSERT_EQUAL_INT16(32256, codec::alaw(0xAA));
+  TEST_ASSERT_EQUAL_INT16(-32256, codec::alaw(0x2A));
+  for (int i = 0; i < 128; ++i) {
+    TEST_ASSERT_EQUAL_INT16(-codec::alaw(static_cast<uint8_t>(i | 0x80)), codec::alaw(static_cast<uint8_t>(i)));
+  }
+}
+
+// The flash tables hold exactly what the per-sample expansion computes
+void test_g711_tables_match_arithmetic_expansion() {
+  for (int i = 0; i < 256; ++i) {
+    TEST_ASSERT_EQUAL_INT16(ulawArith(static_cast<uint8_t>(i)), codec::ulaw(static_cast<uint8_t>(i)));
+    TEST_ASSERT_EQUAL_INT16(alawArith(static_cast<uint8_t>(i)), codec::alaw(static_cast<uint8_t>(i)));
+  }
+}
+
+void test_ima_steps_and_saturates() {
+  codec::ImaState st;
+  TEST_ASSERT_EQUAL_INT16(0, codec::imaDecode(st, 0));
+  TEST_ASSERT_EQUAL_INT32(0, st.index);            // Clamped at the bottom
+
+  TEST_ASSERT_EQUAL_INT16(11, codec::imaDecode(st, 7));   // 7/8 + 7 + 7/2 + 7/4 of step 7
+  TEST_ASSERT_EQUAL_INT32(8, st.index);
+
+  for (int i = 0; i < 200; ++i) codec::imaDecode(st, 7);
+  TEST_ASSERT_EQUAL_INT32(32767, st.predictor);
+  TEST_ASSERT_EQUAL_INT32(88, st.index);
+
+  for (int i = 0; i < 200; ++i) codec::imaDecode(st, 15);
+  TEST_ASSERT_EQUAL_INT32(-32768, st.predictor);
+}
+
+void test_ima_samples_per_block() {
+  TEST_ASSERT_EQUAL_UINT32(505, codec::imaSamplesPerBlock(256, 1));
+  TEST_ASSERT_EQUAL_UINT32(505, codec::imaSamplesPerBlock(512, 2));
+  TEST_ASSERT_EQUAL_UINT32(0, codec::imaSamplesPerBlock(4, 1));
+  TEST_ASSERT_EQUAL_UINT32(0, codec::imaSamplesPerBlock(256, 0));
+}
+
+// A whole encoded block decodes back to the tone once the step size has adapted
+void test_ima_block_tracks_the_source() {
+  std::vector<int16_t> source;
+  const std::vector<uint8_t> block = imaMonoBlock(256, source);
+  std::vector<int16_t> out(source.size());
+  TEST_ASSERT_EQUAL_UINT32(505, decodeMonoBlock(block.data(), static_cast<uint32_t>(out.size()), out.data()));
+
+  double signal = 0.0;
+  double noise = 0.0;
+  for (std::size_t i = 64; i < out.size(); ++i) {
+    signal += static_cast<double>(source[i]) * source[i];
+    noise += static_cast<double>(out[i] - source[i]) * (out[i] - source[i]);
+  }
+  const double snrDb = 10.0 * log10(signal / noise);
+  TEST_ASSERT_TRUE(snrDb > 20.0);
+}
+
+// Decode cost per output sample. Announcements are 8 kHz, so real time needs
+// 8000 samples/s per clip; the report gives the multiple of that on the host.
+void test_decode_throughput() {
+  std::vector<uint8_t> g711(4096);
+  for (std::size_t i = 0; i < g711.size(); ++i) g711[i] = static_cast<uint8_t>(i * 73u + (i >> 5));
+  std::vector<int16_t> out(g711.size());
+
+  const double ulawTable = bench::nsPerCall(2000, [&] {
+    for (std::size_t i = 0; i < g711.size(); ++i) out[i] = codec::kUlawTable[g711[i]];
+    bench::keep(out);
+  }) / g711.size();
+  const double ulawCalc = bench::nsPerCall(2000, [&] {
+    for (std::size_t i = 0; i < g711.size(); ++i) out[i] = ulawArith(g711[i]);
+    bench::keep(out);
+  }) / g711.size();
+  const double alawTable = bench::nsPerCall(2000, [&] {
+    for (std::size_t i = 0; i < g711.size(); ++i) out[i] = codec::kAlawTable[g711[i]];
+    bench::keep(out);
+  }) / g711.size();
+
+  std::vector<int16_t> source;
+  const std::vector<uint8_t> block = imaMonoBlock(256, source);
+  std::vector<int16_t> pcm(source.size());
+  const double ima = bench::nsPerCall(20000, [&] {
+    decodeMonoBlock(block.data(), static_cast<uint32_t>(pcm.size()), pcm.data());
+    bench::keep(pcm);
+  }) / pcm.size();
+
+  bench::report("u-law table  %5.2f ns/sample  %7.1f Msamples/s  (arithmetic %5.2f ns)",
+                ulawTable, 1e3 / ulawTable, ulawCalc);
+  bench::report("A-law table  %5.2f ns/sample  %7.1f Msamples/s", alawTable, 1e3 / alawTable);
+  bench::report("IMA mono 256 %5.2f ns/sample  %7.1f Msamples/s  %6.0fx real time at 8 kHz",
+                ima, 1e3 / ima, 1e9 / ima / 8000.0);
+
+  // Even the serial IMA chain keeps far ahead of real time
+  TEST_ASSERT_TRUE(1e9 / ima > 8000.0 * 100.0);
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_ulaw_endpoints_and_symmetry);
+  RUN_TEST(test_alaw_endpoints_and_symmetry);
+  RUN_TEST(test_g711_tables_match_arithmetic_expansion);
+  RUN_TEST(test_ima_steps_and_saturates);
+  RUN_TEST(test_ima_samples_per_block);
+  RUN_TEST(test_ima_block_tracks_the_source);
+  RUN_TEST(test_decode_throughput);
+  return UNITY_END();
+}
@@ -0,0 +1,320 @@
+// Host tests for the Goertzel DTMF detector, fed with synthesised tones,
+// tones in noise, twisted and off-frequency pairs and voiced speech
+#include <unity.h>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "bench.h"
+#include "services/DtmfDetector.h"
+
+namespace {
+  constexpr uint32_t kFs = cfg::dtmf::SAMPLE_RATE_HZ;
+  constexpr std::size_t kBlock = DtmfDetector::kBlock;
+
+  const char kKeys[] = "123A456B789C*0#D";
+  const float kRowHz[4] = {697.0f, 770.0f, 852.0f, 941.0f};
+  const float kColHz[4] = {1209.0f, 1336.0f, 1477.0f, 1633.0f};
+
+  int16_t buffer[kBlock * 8];
+
+  // blocks whole detector blocks of f1 + f2 (0 Hz = off) at amp each
+  void tone(float f1, float f2, std::size_t blocks, float amp = 6000.0f) {
+    const std::size_t n = blocks * kBlock;
+    for (std::size_t i = 0; i < n; ++i) {
+      const float t = static_cast<float>(i) / kFs;
+      float s = 0.0f;
+      if (f1 > 0.0f) s += amp * sinf(2.0f * static_cast<float>(M_PI) * f1 * t);
+      if (f2 > 0.0f) s += amp * sinf(2.0f * static_cast<float>(M_PI) * f2 * t);
+      buffer[i] = static_cast<int16_t>(lrintf(s));
+    }
+  }
+
+  void key(char k, std::size_t blocks) {
+    const std::size_t i = std::string(kKeys).find(k);
+    tone(kRowHz[i / 4], kColHz[i % 4], blocks);
+  }
+
+  std::string heard;
+  uint8_t heardChannel = 0xFF;
+
+  // Deterministic noise: sum of twelve uniforms, unit variance
+  struct Noise {
+    uint32_t state;
+    float next() {
+      float sum = 0.0f;
+      for (int i = 0; i < 12; ++i) {
+        state = state * 1664525u + 1013904223u;
+        sum += static_cast<float>(state >> 8) / 16777216.0f;
+      }
+      return sum - 6.0f;
+    }
+  };
+
+  int16_t clip(float s) {
+    if (s > 32767.0f) return 32767;
+    if (s < -32768.0f) return -32768;
+    return static_cast<int16_t>(lrintf(s));
+  }
+
+  // Key i (index into kKeys) with the row and column at their own amplitude,
+  // both shifted by devPct percent, plus white noise of rms sigma
+  std::vector<int16_t> pair(std::size_t i, float rowAmp, float colAmp, std::size_t blocks, float sigma = 0.0f,
+                            float devPct = 0.0f, uint32_t seed = 1) {
+    std::vector<int16_t> v(blocks * kBlock);
+    Noise noise{seed};
+    const float fr = kRowHz[i / 4] * (1.0f + devPct / 100.0f);
+    const float fc = kColHz[i % 4] * (1.0f + devPct / 100.0f);
+    for (std::size_t n = 0; n < v.size(); ++n) {
+      const float w = 2.0f * static_cast<float>(M_PI) * static_cast<float>(n) / kFs;
+      float s = rowAmp * sinf(w * fr) + colAmp * sinf(w * fc);
+      if (sigma > 0.0f) s += sigma * noise.next();
+      v[n] = clip(s);
+    }
+    return v;
+  }
+
+  // Voiced speech stand-in: a glottal pulse train with 15 % vibrato through
+  // three formant resonators, changing vowel every 150 ms at a 4 Hz syllable rate
+  std::vector<int16_t> speech(float f0, float seconds, uint32_t seed) {
+    static const float kFormants[5][3] = {
+        {730, 1090, 2440}, {270, 2290, 3010}, {300, 870, 2240}, {530, 1840, 2480}, {570, 840, 2410}};
+    std::vector<int16_t> v(static_cast<std::size_t>(seconds * kFs));
+    uint32_t rng = seed;
+    float y[3][2] = {};
+    float phase = 0.0f;
+    int vowel = 0;
+    for (std::size_t n = 0; n < v.size(); ++n) {
+      if (n % 1200 == 0) {
+        rng = rng * 1664525u + 1013904223u;
+        vowel = static_cast<int>((rng >> 8) % 5);
+      }
+      const float t = static_cast<float>(n) / kFs;
+      const float pi2 = 2.0f * static_cast<float>(M_PI);
+      phase += f0 * (1.0f + 0.15f * sinf(pi2 * 3.0f * t)) * (1.0f + 0.05f * sinf(pi2 * 0.7f * t)) / kFs;
+      float pulse = 0.0f;
+      if (phase >= 1.0f) {
+        phase -= 1.0f;
+        pulse = 8000.0f * (0.5f + 0.5f * sinf(pi2 * 4.0f * t));
+      }
+      float out = 0.0f;
+      for (int k = 0; k < 3; ++k) {
+        const float r = expf(-static_cast<float>(M_PI) * (80.0f + 40.0f * k) / kFs);
+        const float c = 2.0f * r * cosf(pi2 * kFormants[vowel][k] / kFs);
+        const float yn = pulse + c * y[k][0] - r * r * y[k][1];
+        y[k][1] = y[k][0];
+        y[k][0] = yn;
+        out += yn / (k + 1);
+      }
+      v[n] = clip(0.3f * out);
+    }
+    return v;
+  }
+
+  DtmfDetector makeDetector() {
+    DtmfDetector d;
+    heard.clear();
+    heardChannel = 0xFF;
+    d.setDigitCallback([](uint8_t channel, char digit) { heard += digit; heardChannel = channel; });
+    return d;
+  }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_every_key_is_decoded_once() {
+  for (const char* k = kKeys; *k; ++k) {
+    DtmfDetector d = makeDetector();
+    key(*k, 4);
+    d.process(0, buffer, 4 * kBlock);
+    TEST_ASSERT_EQUAL_STRING(std::string(1, *k).c_str(), heard.c_str());
+  }
+}
+
+void test_one_block_is_too_short() {
+  DtmfDetector d = makeDetector();
+  key('5', 1);
+  d.process(0, buffer, kBlock);
+  tone(0.0f, 0.0f, 2);
+  d.process(0, buffer, 2 * kBlock);
+  TEST_ASSERT_EQUAL_STRING("", heard.c_str());
+}
+
+void test_silence_and_single_tone_are_rejected() {
+  DtmfDetector d = makeDetector();
+  tone(0.0f, 0.0f, 4);
+  d.process(0, buffer, 4 * kBlock);
+  tone(770.0f, 0.0f, 4);
+  d.process(0, buffer, 4 * kBlock);
+  tone(0.0f, 1336.0f, 4);
+  d.process(0, buffer, 4 * kBlock);
+  TEST_ASSERT_EQUAL_STRING("", heard.c_str());
+}
+
+void test_repeat_needs_a_gap() {
+  DtmfDetector d = makeDetector();
+  key('7', 6);
+  d.process(0, buffer, 6 * kBlock);
+  TEST_ASSERT_EQUAL_STRING("7", heard.c_str());
+
+  tone(0.0f, 0.0f, 2);
+  d.process(0, buffer, 2 * kBlock);
+  key('7', 3);
+  d.process(0, buffer, 3 * kBlock);
+  TEST_ASSERT_EQUAL_STRING("77", heard.c_str());
+}
+
+void test_samples_can_arrive_in_odd_sizes() {
+  DtmfDetector d = makeDetector();
+  key('#', 4);
+  for (std::size_t at = 0; at < 4 * kBlock; at += 37) {
+    const std::size_t n = (4 * kBlock - at < 37) ? 4 * kBlock - at : 37;
+    d.process(0, buffer + at, n);
+  }
+  TEST_ASSERT_EQUAL_STRING("#", heard.c_str());
+}
+
+void test_channels_are_independent() {
+  // Channel 1 gets its two blocks of '1' with channel 0 dialling in between
+  DtmfDetector d = makeDetector();
+  key('1', 1);
+  d.process(1, buffer, kBlock);
+  key('9', 2);
+  d.process(0, buffer, 2 * kBlock);
+  TEST_ASSERT_EQUAL_STRING("9", heard.c_str());
+  TEST_ASSERT_EQUAL_UINT8(0, heardChannel);
+
+  key('1', 1);
+  d.process(1, buffer, kBlock);
+  TEST_ASSERT_EQUAL_STRING("91", heard.c_str());
+  TEST_ASSERT_EQUAL_UINT8(1, heardChannel);
+  TEST_ASSERT_EQUAL_UINT32(2, d.stats(1).blocks);
+  TEST_ASSERT_EQUAL_UINT32(1, d.stats(1).digits);
+}
+
+// Every key in white noise, five noise seeds each. SNR is the power of the
+// pair (two 4000 amplitude tones) over the noise power.
+void test_keys_in_noise() {
+  for (float snr : {20.0f, 10.0f, 6.0f, 3.0f, 0.0f, -3.0f}) {
+    const float sigma = sqrtf(2.0f * 4000.0f * 4000.0f / 2.0f / powf(10.0f, snr / 10.0f));
+    uint32_t ok = 0, wrong = 0, total = 0;
+    for (uint32_t seed = 1; seed <= 5; ++seed) {
+      for (std::size_t i = 0; i < 16; ++i) {
+        DtmfDetector d = makeDetector();
+        std::vector<int16_t> v = pair(i, 4000.0f, 4000.0f, 5, sigma, 0.0f, seed * 31u + i);
+        d.process(0, v.data(), v.size());
+        total++;
+        if (heard == std::string(1, kKeys[i])) ok++;
+        else if (!heard.empty()) wrong++;
+      }
+    }
+    bench::report("SNR %+5.1f dB: %u/%u decoded, %u wrong", snr, ok, total, wrong);
+    TEST_ASSERT_EQUAL_UINT32(0, wrong);
+    if (snr >= 3.0f) TEST_ASSERT_EQUAL_UINT32(total, ok);
+  }
+}
+
+// A minute of noise alone at three levels never talks off a digit
+void test_noise_alone_is_rejected() {
+  for (float sigma : {300.0f, 3000.0f, 10000.0f}) {
+    DtmfDetector d = makeDetector();
+    Noise noise{static_cast<uint32_t>(sigma)};
+    int16_t chunk[kBlock];
+    for (uint32_t block = 0; block < 60u * kFs / kBlock; ++block) {
+      for (std::size_t n = 0; n < kBlock; ++n) chunk[n] = clip(sigma * noise.next());
+      d.process(0, chunk, kBlock);
+    }
+    TEST_ASSERT_EQUAL_STRING("", heard.c_str());
+  }
+}
+
+// Twist is the column level over the row level. The detector takes the
+// column up to +4 dB and the row up to +8 dB above the other tone.
+void test_twist_limits() {
+  for (float twist : {-10.0f, -7.0f, -3.0f, 0.0f, 3.0f, 5.0f, 6.0f}) {
+    uint32_t ok = 0;
+    for (std::size_t i = 0; i < 16; ++i) {
+      DtmfDetector d = makeDetector();
+      std::vector<int16_t> v = pair(i, 4000.0f, 4000.0f * powf(10.0f, twist / 20.0f), 5);
+      d.process(0, v.data(), v.size());
+      if (heard == std::string(1, kKeys[i])) ok++;
+      else TEST_ASSERT_EQUAL_STRING("", heard.c_str());
+    }
+    bench::report("twist %+5.1f dB: %u/16 decoded", twist, ok);
+    if (twist >= -7.0f && twist <= 3.0f) TEST_ASSERT_EQUAL_UINT32(16, ok);
+    if (twist <= -10.0f || twist >= 5.0f) TEST_ASSERT_EQUAL_UINT32(0, ok);
+  }
+}
+
+// Both tones off nominal by the same percentage. Goertzel bins of 205
+// samples are 39 Hz wide, so acceptance falls off past about 1 %.
+void test_frequency_deviation() {
+  for (float dev : {-3.5f, -2.5f, -1.5f, -1.0f, -0.5f, 0.5f, 1.0f, 1.5f, 2.5f, 3.5f}) {
+    uint32_t ok = 0;
+    for (std::size_t i = 0; i < 16; ++i) {
+      DtmfDetector d = makeDetector();
+      std::vector<int16_t> v = pair(i, 4000.0f, 4000.0f, 5, 0.0f, dev);
+      d.process(0, v.data(), v.size());
+      if (heard == std::string(1, kKeys[i])) ok++;
+      else TEST_ASSERT_EQUAL_STRING("", heard.c_str());
+    }
+    bench::report("deviation %+4.1f %%: %u/16 decoded", dev, ok);
+    if (fabsf(dev) <= 0.5f) TEST_ASSERT_EQUAL_UINT32(16, ok);
+    if (fabsf(dev) >= 2.5f) TEST_ASSERT_EQUAL_UINT32(0, ok);
+  }
+}
+
+// Thirty seconds of voiced speech per pitch, low male to child, without a
+// single digit talked off
+void test_speech_is_rejected() {
+  for (float f0 : {90.0f, 120.0f, 160.0f, 210.0f, 250.0f}) {
+    DtmfDetector d = makeDetector();
+    std::vector<int16_t> v = speech(f0, 30.0f, static_cast<uint32_t>(f0));
+    d.process(0, v.data(), v.size());
+    bench::report("speech f0 %3.0f Hz: %u blocks, %u digits", f0, d.stats(0).blocks, d.stats(0).digits);
+    TEST_ASSERT_EQUAL_STRING("", heard.c_str());
+  }
+}
+
+// All channels fed 10 s of keys in noise, interleaved in 10 ms frames the
+// way the I2S reader hands them over. cpuPermille is host time here, so it
+// compares channels and shows the accounting works; it is not an ESP32 figure.
+void test_cpu_per_channel() {
+  constexpr uint8_t kChannels = cfg::dtmf::MAX_CHANNELS;
+  constexpr std::size_t kFrame = kFs / 100;
+  DtmfDetector d = makeDetector();
+  std::vector<std::vector<int16_t>> audio;
+  for (uint8_t c = 0; c < kChannels; ++c) audio.push_back(pair(c % 16, 4000.0f, 4000.0f, 10u * kFs / kBlock, 1000.0f));
+  for (std::size_t at = 0; at + kFrame <= audio[0].size(); at += kFrame) {
+    for (uint8_t c = 0; c < kChannels; ++c) d.process(c, audio[c].data() + at, kFrame);
+  }
+  uint64_t busyUs = 0;
+  for (uint8_t c = 0; c < kChannels; ++c) {
+    const DtmfDetector::Stats& st = d.stats(c);
+    bench::report("channel %u: %llu samples, %llu us busy, cpuPermille %u (%.3f exact)", c,
+                  static_cast<unsigned long long>(st.samples), static_cast<unsigned long long>(st.busyUs),
+                  d.cpuPermille(c), st.busyUs * static_cast<double>(kFs) / (st.samples * 1000.0));
+    TEST_ASSERT_EQUAL_UINT32(audio[c].size() / kFrame * kFrame, st.samples);
+    TEST_ASSERT_EQUAL_UINT32(st.busyUs * kFs / (st.samples * 1000u), d.cpuPermille(c));
+    busyUs += st.busyUs;
+  }
+  bench::report("%u channels: %.3f ms busy per second of audio", kChannels, busyUs / 10.0 / 1000.0);
+  TEST_ASSERT_EQUAL_UINT32(kChannels, heard.size());
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_every_key_is_decoded_once);
+  RUN_TEST(test_one_block_is_too_short);
+  RUN_TEST(test_silence_and_single_tone_are_rejected);
+  RUN_TEST(test_repeat_needs_a_gap);
+  RUN_TEST(test_samples_can_arrive_in_odd_sizes);
+  RUN_TEST(test_channels_are_independent);
+  RUN_TEST(test_keys_in_noise);
+  RUN_TEST(test_noise_alone_is_rejected);
+  RUN_TEST(test_twist_limits);
+  RUN_TEST(test_frequency_deviation);
+  RUN_TEST(test_speech_is_rejected);
+  RUN_TEST(test_cpu_per_channel);
+  return UNITY_END();
+}
@@ -0,0 +1,115 @@
+// Host tests for util::EventBus and the line status events LineManager posts on it
+#include <unity.h>
+#include "services/LineManager.h"
+#include "util/EventBus.h"
+
+using model::LineStatus;
+
+void setUp() {
+  hostclock::useManual();
+  Settings::instance().resetDefaults();
+}
+void tearDown() {}
+
+void test_eventbus_delivers_in_order_from_subscribe() {
+  util::EventBus<int, 8> bus;
+  bus.post(1);
+  auto c = bus.subscribe();
+  bus.post(2);
+  bus.post(3);
+  int e = 0;
+  TEST_ASSERT_EQUAL_UINT32(2, bus.pending(c));
+  TEST_ASSERT_TRUE(bus.poll(c, e));
+  TEST_ASSERT_EQUAL_INT(2, e);
+  TEST_ASSERT_TRUE(bus.poll(c, e));
+  TEST_ASSERT_EQUAL_INT(3, e);
+  TEST_ASSERT_FALSE(bus.poll(c, e));
+  TEST_ASSERT_EQUAL_UINT32(3, bus.posted());
+}
+
+void test_eventbus_counts_overwritten_events() {
+  util::EventBus<int, 4> bus;
+  auto c = bus.subscribe();
+  for (int i = 0; i < 10; ++i) bus.post(i);
+  TEST_ASSERT_EQUAL_UINT32(4, bus.pending(c));
+  int e = -1;
+  TEST_ASSERT_TRUE(bus.poll(c, e));
+  TEST_ASSERT_EQUAL_INT(6, e);        // Oldest still in the ring
+  TEST_ASSERT_EQUAL_UINT32(6, c.dropped);
+}
+
+void test_eventbus_cursors_are_independent() {
+  util::EventBus<int, 4> bus;
+  auto a = bus.subscribe();
+  auto b = bus.subscribe();
+  bus.post(5);
+  int e = 0;
+  TEST_ASSERT_TRUE(bus.poll(a, e));
+  TEST_ASSERT_FALSE(bus.poll(a, e));
+  TEST_ASSERT_TRUE(bus.poll(b, e));
+  TEST_ASSERT_EQUAL_INT(5, e);
+}
+
+// A cursor that falls behind twice keeps adding up what it missed
+void test_eventbus_dropped_accumulates() {
+  util::EventBus<int, 4> bus;
+  auto c = bus.subscribe();
+  int e = 0;
+  for (int i = 0; i < 6; ++i) bus.post(i);
+  while (bus.poll(c, e)) {}
+  for (int i = 0; i < 7; ++i) bus.post(i);
+  TEST_ASSERT_TRUE(bus.poll(c, e));
+  TEST_ASSERT_EQUAL_INT(3, e);
+  TEST_ASSERT_EQUAL_UINT32(2 + 3, c.dropped);
+}
+
+// setStatus() posts one event per change with the old and new status and the
+// time, and nothing is drained until a consumer polls
+void test_setstatus_posts_status_events() {
+  LineManager lines(Settings::instance());
+  lines.begin();
+  auto c = lines.statusEvents.subscribe();
+  const uint32_t atMs = static_cast<uint32_t>(millis());
+  lines.setStatus(2, LineStatus::Ready);
+  hostclock::advanceUs(5000);
+  lines.setStatus(2, LineStatus::Idle);
+  TEST_ASSERT_EQUAL_UINT32(2, lines.statusEvents.pending(c));
+
+  model::LineStatusEvent ev{};
+  TEST_ASSERT_TRUE(lines.statusEvents.poll(c, ev));
+  TEST_ASSERT_EQUAL_UINT8(2, ev.line);
+  TEST_ASSERT_EQUAL_UINT32(atMs, ev.atMs);
+  TEST_ASSERT_TRUE(ev.from == LineStatus::Idle);
+  TEST_ASSERT_TRUE(ev.to == LineStatus::Ready);
+  TEST_ASSERT_TRUE(lines.statusEvents.poll(c, ev));
+  TEST_ASSERT_EQUAL_UINT32(atMs + 5, ev.atMs);
+  TEST_ASSERT_TRUE(ev.from == LineStatus::Ready);
+  TEST_ASSERT_TRUE(ev.to == LineStatus::Idle);
+  TEST_ASSERT_FALSE(lines.statusEvents.poll(c, ev));
+}
+
+// requestStatus() from another task only queues; update() applies it on the
+// loop and that is when the event is posted
+void test_requested_status_is_posted_from_update() {
+  LineManager lines(Settings::instance());
+  lines.begin();
+  auto c = lines.statusEvents.subscribe();
+  lines.requestStatus(1, LineStatus::Disconnected);
+  TEST_ASSERT_EQUAL_UINT32(0, lines.statusEvents.pending(c));
+  lines.update();
+  model::LineStatusEvent ev{};
+  TEST_ASSERT_TRUE(lines.statusEvents.poll(c, ev));
+  TEST_ASSERT_EQUAL_UINT8(1, ev.line);
+  TEST_ASSERT_TRUE(ev.to == LineStatus::Disconnected);
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_eventbus_delivers_in_order_from_subscribe);
+  RUN_TEST(test_eventbus_counts_overwritten_events);
+  RUN_TEST(test_eventbus_cursors_are_independent);
+  RUN_TEST(test_eventbus_dropped_accumulates);
+  RUN_TEST(test_setstatus_posts_status_events);
+  RUN_TEST(test_requested_status_is_posted_from_update);
+  return UNITY_END();
+}
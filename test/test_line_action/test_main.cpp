@@ -0,0 +1,259 @@
+// Exhaustive check of the call state machine: every (LineStatus, LineEvent)
+// pair is run through LineAction::update() on the host and compared with what
+// the if/else version of hookStatusCangeCheck() and timerExpired() did before
+// the tables in model/LineStateTable.h replaced them. kBaseline below is that
+// version written out by hand, one row per status.
+#include <unity.h>
+#include <Wire.h>
+#include "drivers/AD9833Driver.h"
+#include "drivers/InterruptManager.h"
+#include "drivers/MCPDriver.h"
+#include "drivers/MT8816Driver.h"
+#include "services/ConnectionHandler.h"
+#include "services/LineAction.h"
+#include "services/LineManager.h"
+#include "services/RingGenerator.h"
+#include "services/SwitchFabric.h"
+#include "services/ToneGenerator.h"
+#include "services/ToneReader.h"
+
+using model::LineEvent;
+using model::LineStatus;
+
+namespace {
+  // Line 0 is the one the event happens on. Its incomingFrom is line 1 and
+  // its outgoingTo line 2; dialedDigits is line 3's number.
+  constexpr int kSubject = 0;
+  constexpr int kIncomingFrom = 1;
+  constexpr int kOutgoingTo = 2;
+  constexpr int kCalled = 3;
+  // Status the other lines start in; nothing in the call flow sets it
+  constexpr LineStatus kMarker = LineStatus::SystemConfig;
+
+  enum class Other : uint8_t { None, IncomingFrom, OutgoingTo, Called };
+
+  struct Expect {
+    bool stays;            // Subject keeps its status
+    LineStatus next;
+    Other other;           // The one other line that moves, if any
+    LineStatus otherNext;
+  };
+
+  constexpr Expect stay() { return {true, LineStatus::Idle, Other::None, LineStatus::Idle}; }
+  constexpr Expect go(LineStatus next) { return {false, next, Other::None, LineStatus::Idle}; }
+  constexpr Expect go(LineStatus next, Other other, LineStatus otherNext) { return {false, next, other, otherNext}; }
+
+  constexpr LineStatus I = LineStatus::Idle;
+
+  // acb05a9 LineAction: hook branches Idle+HookOff -> Ready, Incoming+HookOff
+  // answers, Connected/Ringing+HookOn move the peer, everything else -> Idle;
+  // timerExpired() switch, default leaves the line alone. Dialing timers are
+  // shown for a free, active called line.
+  //                                 HookOff            HookOn                                         HookOther  TimerExpired
+  const Expect kBaseline[model::kLineStatusCount][model::kLineEventCount] = {
+    /* Idle         */ {go(LineStatus::Ready), go(I), go(I), stay()},
+    /* Ready        */ {go(I), go(I), go(I), go(LineStatus::Timeout)},
+    /* PulseDialing */ {go(I), go(I), go(I), go(LineStatus::Ringing, Other::Called, LineStatus::Incoming)},
+    /* ToneDialing  */ {go(I), go(I), go(I), go(LineStatus::Ringing, Other::Called, LineStatus::Incoming)},
+    /* Busy         */ {go(I), go(I), go(I), go(LineStatus::Timeout)},
+    /* Fail         */ {go(I), go(I), go(I), go(LineStatus::Timeout)},
+    /* Ringing      */ {go(I), go(I, Other::OutgoingTo, I), go(I), go(LineStatus::Disconnected)},
+    /* Connected    */ {go(I), go(I, Other::IncomingFrom, LineStatus::Disconnected), go(I), stay()},
+    /* Disconnected */ {go(I), go(I), go(I), go(LineStatus::Timeout)},
+    /* Timeout      */ {go(I), go(I), go(I), go(LineStatus::Abandoned)},
+    /* Abandoned    */ {go(I), go(I), go(I), stay()},
+    /* Incoming     */ {go(LineStatus::Connected, Other::IncomingFrom, LineStatus::Connected), go(I), go(I), go(I)},
+    /* Operator     */ {go(I), go(I), go(I), stay()},
+    /* SystemConfig */ {go(I), go(I), go(I), stay()},
+  };
+
+  const char* const kEventNames[] = {"HookOff", "HookOn", "HookOther", "TimerExpired"};
+
+  struct Exchange {
+    MCPDriver mcp;
+    InterruptManager interrupts{mcp, Settings::instance()};
+    MT8816Driver mt8816{mcp, Settings::instance()};
+    SwitchFabric fabric{mt8816, Settings::instance()};
+    ConnectionHandler connections{fabric, Settings::instance()};
+    AD9833Driver dds1{cfg::ESP_PINS::CS1_PIN};
+    AD9833Driver dds2{cfg::ESP_PINS::CS2_PIN};
+    AD9833Driver dds3{cfg::ESP_PINS::CS3_PIN};
+    ToneGenerator tones{dds1, dds2, dds3};
+    LineManager lines{Settings::instance()};
+    ToneReader reader{interrupts, mcp, Settings::instance(), lines};
+    RingGenerator ring{mcp, Settings::instance(), lines};
+    LineAction action{lines, Settings::instance(), mt8816, ring, reader, tones, connections};
+
+    Exchange() {
+      hosti2c::reset();
+      hosti2c::bus().add(cfg::mcp::MCP_MAIN_ADDRESS, cfg::mcp::MCP_MAIN_INT_PIN);
+      hosti2c::bus().add(cfg::mcp::MCP_MT8816_ADDRESS, cfg::mcp::MCP_MT8816_INT_PIN);
+      for (std::size_t bank = 0; bank < cfg::lines::SLIC_BANK_COUNT; ++bank) {
+        hosti2c::bus().add(cfg::mcp::SLIC_BANK_ADDR[bank], cfg::mcp::SLIC_BANK_INT_PIN[bank]);
+      }
+      mcp.begin();
+      mt8816.begin();
+      tones.begin();
+      lines.setToneReader(&reader);
+      lines.begin();
+      action.begin();
+    }
+
+    // Puts the subject in 'status' with its call fields set, the other lines
+    // in kMarker, and nothing pending for LineAction
+    void arrange(LineStatus status) {
+      for (int l : {kIncomingFrom, kOutgoingTo}) lines.setStatus(l, kMarker);
+      lines.setStatus(kSubject, status);
+      LineHandler& subject = lines.getLine(kSubject);
+      subject.incomingFrom = kIncomingFrom;
+      subject.outgoingTo = kOutgoingTo;
+      subject.dialedDigits = lines.getLine(kCalled).phoneNumber;
+      for (uint8_t l = 0; l < cfg::lines::MAX_LINES; ++l) lines.clearChangeFlag(l);
+      lines.activeTimersMask.clear();
+      lines.lineHookChangeFlag.clear();
+    }
+
+    void raise(LineEvent event) {
+      LineHandler& subject = lines.getLine(kSubject);
+      switch (event) {
+        case LineEvent::HookOff:
+          subject.previousHookStatus = model::HookStatus::On;
+          subject.currentHookStatus = model::HookStatus::Off;
+          break;
+        case LineEvent::HookOn:
+          subject.previousHookStatus = model::HookStatus::Off;
+          subject.currentHookStatus = model::HookStatus::On;
+          break;
+        case LineEvent::HookOther:
+          subject.previousHookStatus = model::HookStatus::Off;
+          subject.currentHookStatus = model::HookStatus::Disconnected;
+          break;
+        default:
+          subject.lineTimerEnd = millis();
+          lines.activeTimersMask.set(kSubject);
+          return;
+      }
+      lines.lineHookChangeFlag.set(kSubject);
+    }
+
+    LineStatus status(int line) { return lines.getLine(line).currentLineStatus; }
+  };
+
+  int lineOf(Other other) {
+    switch (other) {
+      case Other::IncomingFrom: return kIncomingFrom;
+      case Other::OutgoingTo:   return kOutgoingTo;
+      case Other::Called:       return kCalled;
+      case Other::None:         break;
+    }
+    return -1;
+  }
+
+  LineStatus startOf(int line) { return line == kCalled ? LineStatus::Idle : kMarker; }
+
+  // Runs one dialing timeout with the given called line set up; returns the
+  // subject's status afterwards
+  LineStatus routeWith(bool ownNumber, bool knownNumber, LineStatus calledStatus) {
+    Exchange ex;
+    if (calledStatus != LineStatus::Idle) ex.lines.setStatus(kCalled, calledStatus);
+    ex.arrange(LineStatus::ToneDialing);
+    LineHandler& subject = ex.lines.getLine(kSubject);
+    if (ownNumber) subject.dialedDigits = subject.phoneNumber;
+    if (!knownNumber) subject.dialedDigits = "0000000";
+    ex.raise(LineEvent::TimerExpired);
+    ex.action.update();
+    return ex.status(kSubject);
+  }
+}
+
+void setUp() {
+  hostclock::useManual();
+  Settings::instance().resetDefaults();
+}
+
+void tearDown() {}
+
+// The table rows decode to the baseline without running anything
+void test_table_matches_baseline() {
+  for (std::size_t s = 0; s < model::kLineStatusCount; ++s) {
+    for (std::size_t e = 0; e < model::kLineEventCount; ++e) {
+      const Expect& want = kBaseline[s][e];
+      const model::Transition& t = model::transitionFor(static_cast<LineStatus>(s), static_cast<LineEvent>(e));
+      char where[64];
+      snprintf(where, sizeof(where), "%s + %s", model::LineStatusToString(static_cast<LineStatus>(s)),
+               kEventNames[e]);
+      if (want.stays) {
+        TEST_ASSERT_TRUE_MESSAGE(t.kind == model::TransitionKind::Stay, where);
+        continue;
+      }
+      if (want.other == Other::Called) {
+        TEST_ASSERT_TRUE_MESSAGE(t.kind == model::TransitionKind::RouteDialed, where);
+        continue;
+      }
+      TEST_ASSERT_TRUE_MESSAGE(t.kind == model::TransitionKind::Set, where);
+      TEST_ASSERT_TRUE_MESSAGE(t.next == want.next, where);
+      const model::Peer peer = want.other == Other::IncomingFrom ? model::Peer::IncomingFrom
+                             : want.other == Other::OutgoingTo   ? model::Peer::OutgoingTo
+                                                                 : model::Peer::None;
+      TEST_ASSERT_TRUE_MESSAGE(t.peer == peer, where);
+      if (peer != model::Peer::None) TEST_ASSERT_TRUE_MESSAGE(t.peerNext == want.otherNext, where);
+    }
+  }
+}
+
+// Every pair through LineAction::update(): the subject and the one other line
+// the baseline moved end where it left them, and no other line moves
+void test_every_status_and_event_against_baseline() {
+  uint32_t pairs = 0;
+  for (std::size_t s = 0; s < model::kLineStatusCount; ++s) {
+    for (std::size_t e = 0; e < model::kLineEventCount; ++e) {
+      const LineStatus from = static_cast<LineStatus>(s);
+      const LineEvent event = static_cast<LineEvent>(e);
+      const Expect& want = kBaseline[s][e];
+      char where[64];
+      snprintf(where, sizeof(where), "%s + %s", model::LineStatusToString(from), kEventNames[e]);
+
+      Exchange ex;
+      ex.arrange(from);
+      ex.raise(event);
+      ex.action.update();
+      pairs++;
+
+      TEST_ASSERT_TRUE_MESSAGE(ex.status(kSubject) == (want.stays ? from : want.next), where);
+      const int moved = lineOf(want.other);
+      for (int l : {kIncomingFrom, kOutgoingTo, kCalled}) {
+        const LineStatus expected = (l == moved) ? want.otherNext : startOf(l);
+        TEST_ASSERT_TRUE_MESSAGE(ex.status(l) == expected, where);
+      }
+
+      // Answer links the two lines both ways; a call that is set up to ring
+      // links the caller to the called line
+      if (from == LineStatus::Incoming && event == LineEvent::HookOff) {
+        TEST_ASSERT_EQUAL_INT_MESSAGE(kIncomingFrom, ex.lines.getLine(kSubject).outgoingTo, where);
+        TEST_ASSERT_EQUAL_INT_MESSAGE(kSubject, ex.lines.getLine(kIncomingFrom).incomingFrom, where);
+      }
+      if (want.other == Other::Called) {
+        TEST_ASSERT_EQUAL_INT_MESSAGE(kCalled, ex.lines.getLine(kSubject).outgoingTo, where);
+        TEST_ASSERT_EQUAL_INT_MESSAGE(kSubject, ex.lines.getLine(kCalled).incomingFrom, where);
+      }
+    }
+  }
+  TEST_ASSERT_EQUAL_UINT32(model::kLineStatusCount * model::kLineEventCount, pairs);
+}
+
+// The other outcomes of a dialing timeout in the baseline: own number and
+// unknown number fail, a called line that is not Idle gives Busy
+void test_dialing_timeout_outcomes() {
+  TEST_ASSERT_TRUE(routeWith(false, true, LineStatus::Idle) == LineStatus::Ringing);
+  TEST_ASSERT_TRUE(routeWith(true, true, LineStatus::Idle) == LineStatus::Fail);
+  TEST_ASSERT_TRUE(routeWith(false, false, LineStatus::Idle) == LineStatus::Fail);
+  TEST_ASSERT_TRUE(routeWith(false, true, LineStatus::Connected) == LineStatus::Busy);
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_table_matches_baseline);
+  RUN_TEST(test_every_status_and_event_against_baseline);
+  RUN_TEST(test_dialing_timeout_outcomes);
+  return UNITY_END();
+}
@@ -0,0 +1,149 @@
+// Host tests for model::LineSet, plus the per-loop cost of the mask paths
+// LineAction::update() runs, for 8 to 64 lines
+#include <unity.h>
+#include <vector>
+#include "bench.h"
+#include "model/LineSet.h"
+
+void setUp() {}
+void tearDown() {}
+
+void test_lineset_word_and_all_mask() {
+  static_assert(sizeof(model::LineSet<8>::word_type) == 1, "8 lines fit a byte");
+  static_assert(sizeof(model::LineSet<9>::word_type) == 2, "9 lines need a halfword");
+  static_assert(sizeof(model::LineSet<64>::word_type) == 8, "64 lines need a doubleword");
+  TEST_ASSERT_EQUAL_UINT32(0x1F, model::LineSet<5>::all().value());
+  TEST_ASSERT_EQUAL_UINT32(0xFF, model::LineSet<8>::all().value());
+  TEST_ASSERT_TRUE(model::LineSet<64>::all().value() == ~uint64_t(0));
+  TEST_ASSERT_EQUAL_UINT32(64, model::LineSet<64>::all().count());
+}
+
+void test_lineset_set_reset_out_of_range() {
+  model::LineSet<8> s;
+  s.set(3);
+  s.set(8);               // Ignored
+  TEST_ASSERT_TRUE(s.test(3));
+  TEST_ASSERT_FALSE(s.test(8));
+  TEST_ASSERT_EQUAL_UINT32(1, s.count());
+  s.assign(3, false);
+  TEST_ASSERT_TRUE(s.none());
+  TEST_ASSERT_TRUE(model::LineSet<8>::single(9).none());
+  TEST_ASSERT_EQUAL_UINT32(0x0F, (~model::LineSet<4>()).value());
+}
+
+void test_lineset_iterates_set_bits_in_order() {
+  model::LineSet<16> s;
+  s.set(12);
+  s.set(1);
+  s.set(7);
+  std::vector<int> seen;
+  for (uint8_t i : s) seen.push_back(i);
+  TEST_ASSERT_EQUAL_UINT32(3, seen.size());
+  TEST_ASSERT_EQUAL_INT(1, seen[0]);
+  TEST_ASSERT_EQUAL_INT(7, seen[1]);
+  TEST_ASSERT_EQUAL_INT(12, seen[2]);
+}
+
+void test_lineset_next_after_wraps() {
+  model::LineSet<8> s;
+  TEST_ASSERT_EQUAL_INT(-1, s.nextAfter(-1));
+  s.set(2);
+  s.set(6);
+  TEST_ASSERT_EQUAL_INT(2, s.nextAfter(-1));
+  TEST_ASSERT_EQUAL_INT(6, s.nextAfter(2));
+  TEST_ASSERT_EQUAL_INT(2, s.nextAfter(6));
+  TEST_ASSERT_EQUAL_INT(2, s.nextAfter(7));
+  TEST_ASSERT_EQUAL_INT(2, s.first());
+}
+
+// ---- Per-loop cost vs. line count ----
+//
+// One LineAction::update() pass: hook changes, status changes and running
+// timers, each masked with the active lines and walked. The mask path is what
+// the firmware does (any() early-out, then only the set bits); the scan path
+// is the old "for every line, test the bit" loop it replaced.
+
+namespace {
+  template <std::size_t N>
+  struct LoopMasks {
+    model::LineSet<N> hook, status, timers, active = model::LineSet<N>::all();
+  };
+
+  template <std::size_t N>
+  unsigned maskPass(const LoopMasks<N>& m) {
+    unsigned visited = 0;
+    if (m.hook.any())   for (uint8_t i : (m.hook & m.active))   visited += i + 1;
+    if (m.status.any()) for (uint8_t i : (m.status & m.active)) visited += i + 1;
+    if (m.timers.any()) for (uint8_t i : (m.timers & m.active)) visited += i + 1;
+    return visited;
+  }
+
+  template <std::size_t N>
+  unsigned scanPass(const LoopMasks<N>& m) {
+    unsigned visited = 0;
+    for (std::size_t i = 0; i < N; ++i) {
+      if (m.hook.test(i) && m.active.test(i))   visited += i + 1;
+      if (m.status.test(i) && m.active.test(i)) visited += i + 1;
+      if (m.timers.test(i) && m.active.test(i)) visited += i + 1;
+    }
+    return visited;
+  }
+
+  // Idle exchange, two calls in progress, every line busy
+  template <std::size_t N>
+  LoopMasks<N> scenario(int which) {
+    LoopMasks<N> m;
+    if (which == 1) {
+      m.hook.set(N / 3);
+      m.timers.set(1);
+      m.timers.set(N - 1);
+    } else if (which == 2) {
+      m.hook = m.status = m.timers = model::LineSet<N>::all();
+    }
+    return m;
+  }
+
+  template <std::size_t N>
+  void benchLines() {
+    static const char* const kNames[] = {"idle", "2 calls", "all busy"};
+    for (int which = 0; which < 3; ++which) {
+      LoopMasks<N> m = scenario<N>(which);
+      // Both paths must agree before their timings mean anything
+      TEST_ASSERT_EQUAL_UINT32(scanPass<N>(m), maskPass<N>(m));
+
+      constexpr uint32_t kLoops = 2000000;
+      const double maskNs = bench::nsPerCall(kLoops, [&] { bench::keep(m); bench::keep(maskPass<N>(m)); });
+      const double scanNs = bench::nsPerCall(kLoops, [&] { bench::keep(m); bench::keep(scanPass<N>(m)); });
+      bench::report("N=%2u %-8s mask %6.2f ns/loop  scan %6.2f ns/loop",
+                    static_cast<unsigned>(N), kNames[which], maskNs, scanNs);
+    }
+  }
+}
+
+void test_lineset_iterator_visits_only_set_bits() {
+  model::LineSet<64> s;
+  s.set(0);
+  s.set(33);
+  s.set(63);
+  unsigned steps = 0;
+  for (uint8_t i : s) { (void)i; steps++; }
+  TEST_ASSERT_EQUAL_UINT32(s.count(), steps);
+}
+
+void test_lineset_loop_cost_by_line_count() {
+  benchLines<8>();
+  benchLines<16>();
+  benchLines<32>();
+  benchLines<64>();
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_lineset_word_and_all_mask);
+  RUN_TEST(test_lineset_set_reset_out_of_range);
+  RUN_TEST(test_lineset_iterates_set_bits_in_order);
+  RUN_TEST(test_lineset_next_after_wraps);
+  RUN_TEST(test_lineset_iterator_visits_only_set_bits);
+  RUN_TEST(test_lineset_loop_cost_by_line_count);
+  return UNITY_END();
+}
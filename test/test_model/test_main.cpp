@@ -0,0 +1,58 @@
+// Host tests for the line model: the state tables
+#include <unity.h>
+#include <vector>
+#include "model/LineStateTable.h"
+
+using model::LineEvent;
+using model::LineStatus;
+
+void setUp() {}
+void tearDown() {}
+
+// ---- LineStateTable ----
+
+void test_hook_on_always_goes_idle() {
+  for (std::size_t s = 0; s < model::kLineStatusCount; ++s) {
+    const model::Transition& t = model::transitionFor(static_cast<LineStatus>(s), LineEvent::HookOn);
+    TEST_ASSERT_TRUE(t.kind == model::TransitionKind::Set);
+    TEST_ASSERT_TRUE(t.next == LineStatus::Idle);
+  }
+}
+
+void test_answer_moves_caller_and_links() {
+  const model::Transition& t = model::transitionFor(LineStatus::Incoming, LineEvent::HookOff);
+  TEST_ASSERT_TRUE(t.next == LineStatus::Connected);
+  TEST_ASSERT_TRUE(t.peer == model::Peer::IncomingFrom);
+  TEST_ASSERT_TRUE(t.peerNext == LineStatus::Connected);
+  TEST_ASSERT_TRUE(t.link);
+}
+
+void test_timers_route_or_time_out() {
+  TEST_ASSERT_TRUE(model::transitionFor(LineStatus::ToneDialing, LineEvent::TimerExpired).kind == model::TransitionKind::RouteDialed);
+  TEST_ASSERT_TRUE(model::transitionFor(LineStatus::PulseDialing, LineEvent::TimerExpired).kind == model::TransitionKind::RouteDialed);
+  TEST_ASSERT_TRUE(model::transitionFor(LineStatus::Ready, LineEvent::TimerExpired).next == LineStatus::Timeout);
+  TEST_ASSERT_TRUE(model::transitionFor(LineStatus::Timeout, LineEvent::TimerExpired).next == LineStatus::Abandoned);
+  TEST_ASSERT_TRUE(model::transitionFor(LineStatus::Idle, LineEvent::TimerExpired).kind == model::TransitionKind::Stay);
+}
+
+void test_entry_actions() {
+  const model::EntryAction& ringing = model::entryActionFor(LineStatus::Ringing);
+  TEST_ASSERT_TRUE(ringing.flags & model::kStartTone);
+  TEST_ASSERT_TRUE(ringing.flags & model::kSetTimer);
+  TEST_ASSERT_TRUE(ringing.tone == model::ToneId::Ring);
+  TEST_ASSERT_TRUE(ringing.timer == model::LineTimer::Ringing);
+
+  const model::EntryAction& connected = model::entryActionFor(LineStatus::Connected);
+  TEST_ASSERT_TRUE(connected.flags & model::kConnectLines);
+  TEST_ASSERT_FALSE(connected.flags & model::kSetTimer);
+  TEST_ASSERT_EQUAL_UINT8(0, model::entryActionFor(LineStatus::Operator).flags);
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_hook_on_always_goes_idle);
+  RUN_TEST(test_answer_moves_caller_and_links);
+  RUN_TEST(test_timers_route_or_time_out);
+  RUN_TEST(test_entry_actions);
+  return UNITY_END();
+}
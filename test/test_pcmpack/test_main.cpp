@@ -0,0 +1,252 @@
+// Host tests for the AudioPlayer output kernels (PcmPack): Q12 gain, slot
+// layouts, bit-exactness against the float path they replaced, and cost per
+// output sample
+#include <unity.h>
+#include <cstring>
+#include <vector>
+#include "bench.h"
+#include "config.h"
+#include "services/PcmPack.h"
+
+void setUp() {}
+void tearDown() {}
+
+namespace {
+  using Mode = PCMDriver::SampleWordMode;
+  const Mode kModes[] = {Mode::Bits16, Mode::Bits32High16, Mode::Bits32Low16};
+
+  // ---- The float path as AudioPlayer had it before PcmPack ----
+
+  // applyGainInPlace_: float multiply, clamp, truncating cast. It only ran
+  // for gains above 1.0; 'gated' = false applies it to any gain, the way the
+  // Q12 kernel now does.
+  void floatGainInPlace(int16_t* samples, size_t count, float gain, bool gated = true) {
+    if (gated && gain <= 1.0f) return;
+    for (size_t i = 0; i < count; ++i) {
+      const float scaled = static_cast<float>(samples[i]) * gain;
+      if (scaled > 32767.0f) {
+        samples[i] = 32767;
+      } else if (scaled < -32768.0f) {
+        samples[i] = -32768;
+      } else {
+        samples[i] = static_cast<int16_t>(scaled);
+      }
+    }
+  }
+
+  // writeStereo16_: Bits16 goes out as is, 32-bit modes one slot per sample
+  size_t floatWriteStereo16(const int16_t* stereo, size_t frames, Mode mode, void* out) {
+    if (mode == Mode::Bits16) {
+      const size_t bytes = frames * 2u * sizeof(int16_t);
+      memcpy(out, stereo, bytes);
+      return bytes;
+    }
+    int32_t* packed = static_cast<int32_t*>(out);
+    for (size_t i = 0; i < frames * 2u; ++i) {
+      const int16_t s = stereo[i];
+      if (mode == Mode::Bits32High16) {
+        packed[i] = static_cast<int32_t>(static_cast<uint32_t>(static_cast<uint16_t>(s)) << 16);
+      } else {
+        packed[i] = static_cast<int32_t>(static_cast<uint16_t>(s));
+      }
+    }
+    return frames * 2u * sizeof(int32_t);
+  }
+
+  // processChunk_: mono is duplicated into stereoBuffer_ first, stereo is
+  // copied only when gain applies; then gain, then slot packing
+  size_t floatChunk(const int16_t* in, size_t frames, uint8_t channels, float gain, bool gated, Mode mode,
+                    void* out) {
+    static std::vector<int16_t> stereo;   // stereoBuffer_, allocated once
+    stereo.resize(frames * 2u);
+    for (size_t f = 0; f < frames; ++f) {
+      stereo[2 * f] = channels == 1 ? in[f] : in[2 * f];
+      stereo[2 * f + 1] = channels == 1 ? in[f] : in[2 * f + 1];
+    }
+    floatGainInPlace(stereo.data(), stereo.size(), gain, gated);
+    return floatWriteStereo16(stereo.data(), frames, mode, out);
+  }
+
+  // Every int16 value once; as stereo the right channel runs the other way
+  std::vector<int16_t> allSamples(uint8_t channels) {
+    std::vector<int16_t> in(65536u * channels);
+    for (uint32_t i = 0; i < 65536u; ++i) {
+      const int16_t s = static_cast<int16_t>(i - 32768);
+      if (channels == 1) {
+        in[i] = s;
+      } else {
+        in[2 * i] = s;
+        in[2 * i + 1] = static_cast<int16_t>(32767 - static_cast<int32_t>(i));
+      }
+    }
+    return in;
+  }
+
+  // Q12 and float over every sample, every mode, mono and stereo. Returns
+  // the number of differing output words and the largest difference in LSB.
+  uint32_t compareAll(float gain, bool gated, int32_t* maxDiffLsb) {
+    uint32_t mismatches = 0;
+    *maxDiffLsb = 0;
+    const int32_t q = pcm::gainFromFloat(gain);
+    for (uint8_t channels = 1; channels <= 2; ++channels) {
+      const std::vector<int16_t> in = allSamples(channels);
+      const size_t frames = in.size() / channels;
+      for (Mode mode : kModes) {
+        std::vector<int32_t> fixed(frames * 2u);
+        std::vector<int32_t> reference(frames * 2u);
+        const size_t a = pcm::pack(in.data(), frames, channels, q, mode, fixed.data());
+        const size_t b = floatChunk(in.data(), frames, channels, gain, gated, mode, reference.data());
+        if (a != b) return UINT32_MAX;   // Different frame size: nothing lines up
+        const size_t words = a / sizeof(int16_t);
+        const int16_t* f16 = reinterpret_cast<const int16_t*>(fixed.data());
+        const int16_t* r16 = reinterpret_cast<const int16_t*>(reference.data());
+        for (size_t i = 0; i < words; ++i) {
+          if (f16[i] == r16[i]) continue;
+          mismatches++;
+          const int32_t d = f16[i] > r16[i] ? f16[i] - r16[i] : r16[i] - f16[i];
+          if (d > *maxDiffLsb) *maxDiffLsb = d;
+        }
+      }
+    }
+    return mismatches;
+  }
+}
+
+// ---- Q12 gain and slot helpers ----
+
+void test_gain_from_float() {
+  TEST_ASSERT_EQUAL_INT32(pcm::kUnityGain, pcm::gainFromFloat(1.0f));
+  TEST_ASSERT_EQUAL_INT32(pcm::kUnityGain / 2, pcm::gainFromFloat(0.5f));
+  TEST_ASSERT_EQUAL_INT32(0, pcm::gainFromFloat(0.0f));
+  TEST_ASSERT_EQUAL_INT32(0, pcm::gainFromFloat(-1.0f));
+  TEST_ASSERT_EQUAL_INT32(pcm::kMaxGain, pcm::gainFromFloat(100.0f));
+}
+
+void test_apply_gain_saturates() {
+  TEST_ASSERT_EQUAL_INT16(32767, pcm::applyGain(20000, 2 * pcm::kUnityGain));
+  TEST_ASSERT_EQUAL_INT16(-32768, pcm::applyGain(-20000, 2 * pcm::kUnityGain));
+  TEST_ASSERT_EQUAL_INT16(1234, pcm::applyGain(1234, pcm::kUnityGain));
+  // Truncates toward zero on both sides, like the float cast
+  TEST_ASSERT_EQUAL_INT16(1, pcm::applyGain(3, pcm::kUnityGain / 2));
+  TEST_ASSERT_EQUAL_INT16(-1, pcm::applyGain(-3, pcm::kUnityGain / 2));
+}
+
+void test_slot_layouts() {
+  TEST_ASSERT_EQUAL_HEX32(0xFFFF0000u, static_cast<uint32_t>(pcm::toSlot32(-1, Mode::Bits32High16)));
+  TEST_ASSERT_EQUAL_HEX32(0x0000FFFFu, static_cast<uint32_t>(pcm::toSlot32(-1, Mode::Bits32Low16)));
+  TEST_ASSERT_EQUAL_UINT32(4, pcm::frameBytes(Mode::Bits16));
+  TEST_ASSERT_EQUAL_UINT32(8, pcm::frameBytes(Mode::Bits32High16));
+}
+
+void test_pack_mono_into_high_slots() {
+  const int16_t in[2] = {1, -2};
+  int32_t out[4] = {};
+  TEST_ASSERT_EQUAL_UINT32(16, pcm::pack(in, 2, 1, pcm::kUnityGain, Mode::Bits32High16, out));
+  TEST_ASSERT_EQUAL_INT32(1 << 16, out[0]);
+  TEST_ASSERT_EQUAL_INT32(1 << 16, out[1]);
+  TEST_ASSERT_EQUAL_INT32(pcm::toSlot32(-2, Mode::Bits32High16), out[2]);
+  TEST_ASSERT_EQUAL_INT32(out[2], out[3]);
+}
+
+void test_pack_stereo_16bit_with_gain() {
+  const int16_t in[4] = {100, -100, 3, 4};
+  int16_t out[4] = {};
+  TEST_ASSERT_EQUAL_UINT32(8, pcm::pack(in, 2, 2, pcm::gainFromFloat(0.5f), Mode::Bits16, out));
+  TEST_ASSERT_EQUAL_INT16(50, out[0]);
+  TEST_ASSERT_EQUAL_INT16(-50, out[1]);
+  TEST_ASSERT_EQUAL_INT16(1, out[2]);
+  TEST_ASSERT_EQUAL_INT16(2, out[3]);
+  TEST_ASSERT_EQUAL_UINT32(0, pcm::pack(nullptr, 2, 2, pcm::kUnityGain, Mode::Bits16, out));
+}
+
+// ---- Against the float path ----
+
+// Unity is the only gain the old player ever ran (outputGain_ had no setter):
+// every sample, every slot layout, mono and stereo come out identical
+void test_unity_is_bit_exact_with_float_path() {
+  int32_t maxDiff = 0;
+  TEST_ASSERT_EQUAL_UINT32(0, compareAll(1.0f, true, &maxDiff));
+}
+
+// Gains with at most 8 significant bits in Q12 keep the float product exact
+// (16 + 8 bits fit the 24-bit mantissa), so truncation lands on the same
+// sample. Above 1.0 this is the old gated path; below it the same formula.
+void test_exact_gains_are_bit_exact_with_float_path() {
+  const float above[] = {1.25f, 1.5f, 2.0f, 3.0f, 4.0f, 7.5f};
+  const float below[] = {0.125f, 0.5f, 0.75f, 0.9375f};
+  int32_t maxDiff = 0;
+  for (float g : above) {
+    TEST_ASSERT_EQUAL_UINT32(0, compareAll(g, true, &maxDiff));
+  }
+  for (float g : below) {
+    TEST_ASSERT_EQUAL_UINT32(0, compareAll(g, false, &maxDiff));
+  }
+}
+
+// Any other Q12 gain: the float product is rounded to 24 bits before the
+// cast, the integer one is not, so a product a few 1/4096 under an integer
+// can land one LSB apart. Never more than that.
+void test_other_gains_stay_within_one_lsb() {
+  uint32_t total = 0;
+  uint32_t gains = 0;
+  for (int32_t q = 0x0A3D; q < 8 * pcm::kUnityGain; q += 1187) {
+    const float g = static_cast<float>(q) / pcm::kUnityGain;   // Exactly the Q12 value
+    int32_t maxDiff = 0;
+    total += compareAll(g, false, &maxDiff);
+    gains++;
+    TEST_ASSERT_TRUE(maxDiff <= 1);
+  }
+  bench::report("%u Q12 gains x 6 x 196608 words: %u differ from float by 1 LSB", gains, total);
+}
+
+// ---- Cost ----
+
+// Output runs at cfg::audio::OUTPUT_RATE_HZ stereo, 32000 samples/s. The
+// report puts the host cost of each path against that budget; it is what
+// sizes the need for a SIMD (PIE) version of the loop on the ESP32-S3.
+void test_pack_throughput() {
+  constexpr size_t kFrames = 512;   // Two TASK_CHUNK_BYTES of 16-bit stereo
+  std::vector<int16_t> mono(kFrames);
+  std::vector<int16_t> stereo(2 * kFrames);
+  for (size_t i = 0; i < stereo.size(); ++i) stereo[i] = static_cast<int16_t>(i * 2654435761u >> 16);
+  for (size_t i = 0; i < mono.size(); ++i) mono[i] = stereo[i];
+  std::vector<int32_t> out(2 * kFrames);
+  const double samples = 2.0 * kFrames;   // Output samples per call
+  const double budget = 2.0 * cfg::audio::OUTPUT_RATE_HZ;
+
+  const double fused = bench::nsPerCall(20000, [&] {
+    pcm::pack(mono.data(), kFrames, 1, pcm::gainFromFloat(1.5f), Mode::Bits32High16, out.data());
+    bench::keep(out);
+  }) / samples;
+  const double fusedUnity = bench::nsPerCall(20000, [&] {
+    pcm::pack(stereo.data(), kFrames, 2, pcm::kUnityGain, Mode::Bits32High16, out.data());
+    bench::keep(out);
+  }) / samples;
+  const double floatPath = bench::nsPerCall(20000, [&] {
+    floatChunk(mono.data(), kFrames, 1, 1.5f, true, Mode::Bits32High16, out.data());
+    bench::keep(out);
+  }) / samples;
+
+  bench::report("fused mono gain   %5.2f ns/sample  %8.5f%% of one core at 32000 samples/s",
+                fused, fused * budget / 1e7);
+  bench::report("fused stereo unity %5.2f ns/sample  %8.5f%%", fusedUnity, fusedUnity * budget / 1e7);
+  bench::report("float three-pass  %5.2f ns/sample  %8.5f%%  (%.1fx the fused loop)",
+                floatPath, floatPath * budget / 1e7, floatPath / fused);
+
+  // The fused loop must stay well under a thousandth of the budget here
+  TEST_ASSERT_TRUE(fused * budget < 1e6);
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_gain_from_float);
+  RUN_TEST(test_apply_gain_saturates);
+  RUN_TEST(test_slot_layouts);
+  RUN_TEST(test_pack_mono_into_high_slots);
+  RUN_TEST(test_pack_stereo_16bit_with_gain);
+  RUN_TEST(test_unity_is_bit_exact_with_float_path);
+  RUN_TEST(test_exact_gains_are_bit_exact_with_float_path);
+  RUN_TEST(test_other_gains_stay_within_one_lsb);
+  RUN_TEST(test_pack_throughput);
+  return UNITY_END();
+}
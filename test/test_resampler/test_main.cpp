@@ -0,0 +1,132 @@
+// Host tests for Resampler: formats, output count, level and stop band per
+// clip rate, and the cost per output frame
+#include <unity.h>
+#include <cmath>
+#include <initializer_list>
+#include "bench.h"
+#include "services/Resampler.h"
+
+void setUp() {}
+void tearDown() {}
+
+namespace {
+  struct ToneResult {
+    double rms;          // Output level after the filter has settled
+    uint32_t frames;
+  };
+
+  // A sine of 'hz' at 'inRate', amplitude 10000, resampled to 16 kHz
+  ToneResult resampleTone(uint32_t inRate, double hz) {
+    Resampler r;
+    r.configure(inRate, 16000, 1);
+    double sum = 0.0;
+    uint32_t frames = 0;
+    uint32_t counted = 0;
+    for (uint32_t i = 0; i < inRate / 2; ++i) {
+      const int16_t s = static_cast<int16_t>(lrint(10000.0 * sin(2.0 * M_PI * hz * i / inRate)));
+      r.push(s, s, [&](int16_t l, int16_t) {
+        if (++frames > 400) { sum += static_cast<double>(l) * l; counted++; }
+        return true;
+      });
+    }
+    return ToneResult{sqrt(sum / counted), frames};
+  }
+}
+
+void test_resampler_rejects_bad_formats() {
+  Resampler r;
+  TEST_ASSERT_FALSE(r.configure(0, 16000, 1));
+  TEST_ASSERT_FALSE(r.configure(8000, 16000, 3));
+  TEST_ASSERT_TRUE(r.configure(16000, 16000, 2));
+  TEST_ASSERT_TRUE(r.bypass());
+  TEST_ASSERT_TRUE(r.configure(8000, 16000, 1));
+  TEST_ASSERT_FALSE(r.bypass());
+}
+
+void test_resampler_output_count_follows_ratio() {
+  Resampler up;
+  up.configure(8000, 16000, 1);
+  size_t n = 0;
+  for (int i = 0; i < 800; ++i) up.push(0, 0, [&](int16_t, int16_t) { ++n; return true; });
+  TEST_ASSERT_EQUAL_UINT32(1600, n);
+
+  Resampler down;
+  down.configure(48000, 16000, 2);
+  n = 0;
+  for (int i = 0; i < 4800; ++i) down.push(0, 0, [&](int16_t, int16_t) { ++n; return true; });
+  TEST_ASSERT_UINT32_WITHIN(1, 1600, n);
+}
+
+void test_resampler_passes_dc_and_keeps_channels_apart() {
+  Resampler r;
+  r.configure(22050, 16000, 2);
+  int16_t l = 0;
+  int16_t rr = 0;
+  for (int i = 0; i < 400; ++i) {
+    r.push(10000, -5000, [&](int16_t a, int16_t b) { l = a; rr = b; return true; });
+  }
+  TEST_ASSERT_INT_WITHIN(20, 10000, l);
+  TEST_ASSERT_INT_WITHIN(20, -5000, rr);
+}
+
+void test_resampler_stops_when_sink_refuses() {
+  Resampler r;
+  r.configure(8000, 16000, 1);
+  int calls = 0;
+  TEST_ASSERT_FALSE(r.push(1, 1, [&](int16_t, int16_t) { ++calls; return false; }));
+  TEST_ASSERT_EQUAL_INT(1, calls);
+}
+
+// A 1 kHz tone keeps its level from every clip rate AudioPlayer sees
+void test_resampler_keeps_passband_level() {
+  const double expected = 10000.0 / sqrt(2.0);
+  for (uint32_t rate : {8000u, 11025u, 22050u, 44100u, 48000u}) {
+    const ToneResult t = resampleTone(rate, 1000.0);
+    TEST_ASSERT_UINT32_WITHIN(2, 8000, t.frames);
+    TEST_ASSERT_TRUE(fabs(t.rms - expected) < expected * 0.06);
+  }
+}
+
+// Above the 8 kHz output Nyquist a tone must not fold back into the band
+void test_resampler_rejects_tones_above_output_nyquist() {
+  for (uint32_t rate : {44100u, 48000u}) {
+    const ToneResult t = resampleTone(rate, 12000.0);
+    const double db = 20.0 * log10(t.rms / (10000.0 / sqrt(2.0)));
+    bench::report("%5u Hz clip, 12 kHz tone: %5.1f dB at the output", static_cast<unsigned>(rate), db);
+    TEST_ASSERT_TRUE(db < -20.0);
+  }
+}
+
+// Cost per 16 kHz output frame: 16 taps per channel
+void test_resampler_cost_per_output_frame() {
+  for (uint32_t rate : {8000u, 22050u, 48000u}) {
+    for (uint8_t channels : {1, 2}) {
+      Resampler r;
+      r.configure(rate, 16000, channels);
+      uint32_t out = 0;
+      int16_t x = 0;
+      const uint32_t inputs = rate / 10;
+      const double ns = bench::nsPerCall(200, [&] {
+        for (uint32_t i = 0; i < inputs; ++i) {
+          x = static_cast<int16_t>(x * 31 + 7);
+          r.push(x, static_cast<int16_t>(-x), [&](int16_t l, int16_t rr) { out += static_cast<uint16_t>(l ^ rr); return true; });
+        }
+        bench::keep(out);
+      });
+      bench::report("%5u Hz -> 16 kHz, %u ch: %5.1f ns per output frame", static_cast<unsigned>(rate),
+                    static_cast<unsigned>(channels), ns / 1600.0);
+    }
+  }
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_resampler_rejects_bad_formats);
+  RUN_TEST(test_resampler_output_count_follows_ratio);
+  RUN_TEST(test_resampler_passes_dc_and_keeps_channels_apart);
+  RUN_TEST(test_resampler_stops_when_sink_refuses);
+  RUN_TEST(test_resampler_keeps_passband_level);
+  RUN_TEST(test_resampler_rejects_tones_above_output_nyquist);
+  RUN_TEST(test_resampler_cost_per_output_frame);
+  return UNITY_END();
+}
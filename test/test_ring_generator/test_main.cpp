@@ -0,0 +1,295 @@
+// Host scenarios for RingGenerator: RingGenerator -> MCPDriver -> the SLIC
+// bank MCP23017s on the I2C stub, with update() run as a 1 ms loop on the
+// manual host clock. Bus time is charged at the Wire clock, so the reports
+// give OLAT writes per second and the share of the bus they take, and the
+// cadence simulator adds how many lines ring at once.
+#include <unity.h>
+#include <vector>
+#include <Wire.h>
+#include "bench.h"
+#include "drivers/MCPDriver.h"
+#include "services/LineManager.h"
+#include "services/RingGenerator.h"
+
+namespace {
+  constexpr uint8_t kOlatA = 0x14;
+
+  bool isSlicBank(uint8_t addr) {
+    for (uint8_t a : cfg::mcp::SLIC_BANK_ADDR) {
+      if (a == addr) return true;
+    }
+    return false;
+  }
+
+  // Bus traffic in a window, from the hosti2c log and counters
+  struct Load {
+    uint32_t olatWrites = 0;     // Transactions that wrote a SLIC OLAT register
+    uint32_t transactions = 0;   // Everything on the bus, reads included
+    uint64_t busyUs = 0;
+    int64_t windowUs = 0;
+
+    double perSecond(uint32_t n) const { return n * 1e6 / static_cast<double>(windowUs); }
+    double utilisation() const { return 100.0 * static_cast<double>(busyUs) / static_cast<double>(windowUs); }
+  };
+
+  // OLATA/OLATB bytes at the same instant belong to one transaction
+  uint32_t slicOlatTransactions(int64_t sinceUs) {
+    uint32_t n = 0;
+    int64_t lastUs = -1;
+    uint8_t lastAddr = 0;
+    for (const hosti2c::Access& a : hosti2c::bus().log) {
+      if (a.read || a.atUs < sinceUs || !isSlicBank(a.addr)) continue;
+      if ((a.reg & ~1u) != kOlatA && (a.reg & ~1u) != 0x12) continue;
+      if (a.atUs == lastUs && a.addr == lastAddr) continue;
+      lastUs = a.atUs;
+      lastAddr = a.addr;
+      n++;
+    }
+    return n;
+  }
+
+  struct Exchange {
+    MCPDriver mcp;
+    LineManager lines{Settings::instance()};
+    RingGenerator ring{mcp, Settings::instance(), lines};
+
+    Exchange() {
+      hosti2c::reset();
+      for (std::size_t bank = 0; bank < cfg::lines::SLIC_BANK_COUNT; ++bank) {
+        hosti2c::bus().add(cfg::mcp::SLIC_BANK_ADDR[bank], cfg::mcp::SLIC_BANK_INT_PIN[bank]);
+      }
+      mcp.begin();
+      lines.begin();
+    }
+
+    void ringLines(uint8_t count) {
+      for (uint8_t line = 0; line < count; ++line) {
+        lines.setStatus(line, model::LineStatus::Incoming);
+        ring.generateRingSignal(line);
+      }
+    }
+
+    // The main loop: one update() pass, then 1 ms until the next one
+    void runMs(uint32_t ms) {
+      const int64_t end = hostclock::nowUs() + static_cast<int64_t>(ms) * 1000;
+      while (hostclock::nowUs() < end) {
+        ring.update();
+        hostclock::advanceUs(1000);
+      }
+    }
+
+    Load measure(uint32_t ms) {
+      const int64_t startUs = hostclock::nowUs();
+      const uint32_t transactions = hosti2c::bus().transactions;
+      const uint64_t busy = hosti2c::bus().busyUs;
+      runMs(ms);
+      Load load;
+      load.olatWrites = slicOlatTransactions(startUs);
+      load.transactions = hosti2c::bus().transactions - transactions;
+      load.busyUs = hosti2c::bus().busyUs - busy;
+      load.windowUs = hostclock::nowUs() - startUs;
+      return load;
+    }
+  };
+
+  // The per-line cadence RingGenerator had before the bank clock: RM set once
+  // per burst, then every line's FR toggled on its own 25 ms timer with a
+  // library read-modify-write (digitalWrite reads GPIO, then writes it).
+  Load perLineBaseline(MCPDriver& mcp, uint8_t count, uint32_t ms) {
+    const int64_t startUs = hostclock::nowUs();
+    const uint32_t transactions = hosti2c::bus().transactions;
+    const uint64_t busy = hosti2c::bus().busyUs;
+    bool fr[cfg::lines::MAX_LINES] = {};
+    int64_t lastToggle[cfg::lines::MAX_LINES] = {};
+    for (uint8_t line = 0; line < count; ++line) {
+      mcp.slicChip(line / cfg::lines::LINES_PER_BANK).digitalWrite(cfg::mcp::RM_PINS[line], HIGH);
+      lastToggle[line] = hostclock::nowUs();
+    }
+    const int64_t end = startUs + static_cast<int64_t>(ms) * 1000;
+    while (hostclock::nowUs() < end) {
+      for (uint8_t line = 0; line < count; ++line) {
+        if (hostclock::nowUs() - lastToggle[line] < 25000) continue;
+        fr[line] = !fr[line];
+        mcp.slicChip(line / cfg::lines::LINES_PER_BANK).digitalWrite(cfg::mcp::FR_PINS[line], fr[line]);
+        lastToggle[line] = hostclock::nowUs();
+      }
+      hostclock::advanceUs(1000);
+    }
+    Load load;
+    load.olatWrites = slicOlatTransactions(startUs);
+    load.transactions = hosti2c::bus().transactions - transactions;
+    load.busyUs = hosti2c::bus().busyUs - busy;
+    load.windowUs = hostclock::nowUs() - startUs;
+    return load;
+  }
+
+  // FR of every toggling line on a bank, as the bank's OLAT holds it now
+  bool bankFrInPhase(uint8_t bank, uint8_t lines) {
+    const hosti2c::Mcp23017* chip = hosti2c::bus().find(cfg::mcp::SLIC_BANK_ADDR[bank]);
+    const uint16_t olat = chip->word(kOlatA);
+    int level = -1;
+    for (uint8_t k = 0; k < lines && k < cfg::lines::LINES_PER_BANK; ++k) {
+      const uint8_t line = static_cast<uint8_t>(bank * cfg::lines::LINES_PER_BANK + k);
+      const int fr = (olat >> cfg::mcp::FR_PINS[line]) & 1;
+      const int rm = (olat >> cfg::mcp::RM_PINS[line]) & 1;
+      if (rm != 1) return false;
+      if (level >= 0 && fr != level) return false;
+      level = fr;
+    }
+    return true;
+  }
+}
+
+void setUp() {
+  hostclock::useManual();
+  Settings::instance().resetDefaults();
+  Settings::instance().maxConcurrentRingers = 0;   // All bursts at once: the worst case for the bus
+}
+
+void tearDown() {}
+
+// One OLAT write per bank and FR half cycle, whatever the number of lines
+// ringing on it; the per-line cadence paid a read-modify-write per line.
+// Measured over the first second of the burst at the 100 kHz Wire default.
+void test_olat_writes_per_second_with_4_and_8_lines_ringing() {
+  for (uint8_t count : {4, 8}) {
+    const uint8_t banks = static_cast<uint8_t>((count + cfg::lines::LINES_PER_BANK - 1) / cfg::lines::LINES_PER_BANK);
+    Load batched;
+    {
+      Exchange ex;
+      ex.ringLines(count);
+      const uint32_t before = ex.mcp.slicOlatWrites();
+      batched = ex.measure(Settings::instance().ringLengthMs - 10);
+      TEST_ASSERT_EQUAL_UINT32(ex.mcp.slicOlatWrites() - before, batched.olatWrites);
+      for (uint8_t bank = 0; bank < banks; ++bank) TEST_ASSERT_TRUE(bankFrInPhase(bank, count));
+    }
+    Load perLine;
+    {
+      Exchange ex;
+      perLine = perLineBaseline(ex.mcp, count, Settings::instance().ringLengthMs - 10);
+    }
+
+    bench::report("%u lines, bank clock: %5.1f OLAT writes/s  %6.1f transactions/s  bus %4.1f%%",
+                  count, batched.perSecond(batched.olatWrites), batched.perSecond(batched.transactions),
+                  batched.utilisation());
+    bench::report("%u lines, per line  : %5.1f OLAT writes/s  %6.1f transactions/s  bus %4.1f%%",
+                  count, perLine.perSecond(perLine.olatWrites), perLine.perSecond(perLine.transactions),
+                  perLine.utilisation());
+
+    // 40 FR half cycles a second per bank, plus the RM/GPINTEN set-up at the start
+    TEST_ASSERT_TRUE(batched.perSecond(batched.olatWrites) <= banks * 42.0);
+    TEST_ASSERT_TRUE(batched.perSecond(batched.olatWrites) >= banks * 38.0);
+    TEST_ASSERT_TRUE(batched.transactions * 3 < perLine.transactions);
+  }
+}
+
+// Ring cadence simulator: 'count' calls arrive together and ring to the end
+// of their iterations. Samples the lines in RingToggling every loop pass and
+// each line's burst lengths and pauses.
+namespace {
+struct Schedule {
+  uint8_t peak = 0;
+  double meanRinging = 0.0;    // Average lines toggling while any line is
+  Load load;
+  uint32_t bursts[cfg::lines::MAX_LINES] = {};
+  uint32_t shortestBurstMs = UINT32_MAX;
+  uint32_t longestBurstMs = 0;
+  uint32_t shortestPauseMs = UINT32_MAX;
+  uint32_t longestPauseMs = 0;
+  uint32_t maxWaitMs = 0;
+  uint8_t reportedPeak = 0;    // RingGenerator::stats().peakConcurrent
+};
+
+Schedule simulate(uint8_t count, uint8_t limit) {
+  Settings::instance().maxConcurrentRingers = limit;
+  Exchange ex;
+  ex.ringLines(count);
+  Schedule out;
+  const int64_t startUs = hostclock::nowUs();
+  const uint32_t transactions = hosti2c::bus().transactions;
+  const uint64_t busy = hosti2c::bus().busyUs;
+  bool wasToggling[cfg::lines::MAX_LINES] = {};
+  unsigned long edgeMs[cfg::lines::MAX_LINES] = {};
+  uint64_t ringingSum = 0;
+  uint32_t ringingPasses = 0;
+
+  bool anyActive = true;
+  while (anyActive) {
+    ex.ring.update();
+    const unsigned long now = millis();
+    uint8_t toggling = 0;
+    anyActive = false;
+    for (uint8_t line = 0; line < count; ++line) {
+      const auto& ls = ex.ring.lineStates_[line];
+      const bool on = ls.state == model::RingState::RingToggling;
+      anyActive = anyActive || ls.state != model::RingState::RingIdle;
+      if (on) toggling++;
+      if (on != wasToggling[line]) {
+        const uint32_t span = static_cast<uint32_t>(now - edgeMs[line]);
+        if (on && out.bursts[line] > 0) {
+          if (span < out.shortestPauseMs) out.shortestPauseMs = span;
+          if (span > out.longestPauseMs) out.longestPauseMs = span;
+        } else if (!on) {
+          if (span < out.shortestBurstMs) out.shortestBurstMs = span;
+          if (span > out.longestBurstMs) out.longestBurstMs = span;
+        }
+        if (on) out.bursts[line]++;
+        wasToggling[line] = on;
+        edgeMs[line] = now;
+      }
+    }
+    if (toggling > out.peak) out.peak = toggling;
+    if (toggling > 0) {
+      ringingSum += toggling;
+      ringingPasses++;
+    }
+    hostclock::advanceUs(1000);
+  }
+
+  out.meanRinging = ringingPasses ? static_cast<double>(ringingSum) / ringingPasses : 0.0;
+  out.load.transactions = hosti2c::bus().transactions - transactions;
+  out.load.busyUs = hosti2c::bus().busyUs - busy;
+  out.load.windowUs = hostclock::nowUs() - startUs;
+  out.load.olatWrites = slicOlatTransactions(startUs);
+  out.maxWaitMs = ex.ring.stats().maxWaitMs;
+  out.reportedPeak = ex.ring.stats().peakConcurrent;
+  return out;
+}
+}
+
+// Calls that arrive together start their bursts in each other's pauses even
+// with a slot free; past what fits in one cadence (ringLengthMs + ringPauseMs)
+// they share bursts up to the limit. Each line keeps its burst length and
+// iteration count; only its pauses grow.
+void test_simultaneous_calls_are_staggered() {
+  const Settings& s = Settings::instance();
+  const uint32_t fit = (s.ringLengthMs + s.ringPauseMs) / s.ringLengthMs;
+  for (uint8_t count : {2, 4, 8}) {
+    for (uint8_t limit : {0, 2}) {
+      const Schedule r = simulate(count, limit);
+      bench::report("%u calls, limit %u: peak %u ringing (mean %.2f), bursts %u-%u ms, pauses %u-%u ms, "
+                    "max hold %u ms, %5.1f OLAT writes/s, bus %4.2f%% over %.1f s",
+                    count, limit, r.peak, r.meanRinging, r.shortestBurstMs, r.longestBurstMs, r.shortestPauseMs,
+                    r.longestPauseMs, r.maxWaitMs, r.load.perSecond(r.load.olatWrites), r.load.utilisation(),
+                    r.load.windowUs / 1e6);
+
+      TEST_ASSERT_EQUAL_UINT8(r.peak, r.reportedPeak);
+      for (uint8_t line = 0; line < count; ++line) TEST_ASSERT_EQUAL_UINT32(s.ringIterations, r.bursts[line]);
+      // Edges are sampled after each pass, so bus time moves them by a few ms
+      TEST_ASSERT_TRUE(r.shortestBurstMs + 5 >= s.ringLengthMs && r.longestBurstMs <= s.ringLengthMs + 5);
+      TEST_ASSERT_TRUE(r.shortestPauseMs + 5 >= s.ringPauseMs);
+      if (limit == 0) {
+        TEST_ASSERT_EQUAL_UINT8(count, r.peak);
+      } else {
+        TEST_ASSERT_EQUAL_UINT8(count <= fit ? 1 : limit, r.peak);
+      }
+    }
+  }
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_olat_writes_per_second_with_4_and_8_lines_ringing);
+  RUN_TEST(test_simultaneous_calls_are_staggered);
+  return UNITY_END();
+}
@@ -0,0 +1,232 @@
+// Host scenarios for the ToneGenerator line allocator: three AD9833s (no
+// synth), SPI and esp_timer from the stubs, time on the manual host clock
+#include <unity.h>
+#include <vector>
+#include <LittleFS.h>
+#include <SPI.h>
+#include "bench.h"
+#include "services/ToneGenerator.h"
+
+using model::ToneId;
+
+namespace {
+  struct Attach {
+    uint32_t atMs;
+    uint8_t line;
+    uint8_t dac;
+  };
+
+  struct Rig {
+    AD9833Driver d1{10};
+    AD9833Driver d2{11};
+    AD9833Driver d3{12};
+    ToneGenerator gen{d1, d2, d3};
+    std::vector<Attach> attached;      // First DAC per attach (a dual tone reports two)
+    uint8_t lineDac[cfg::lines::MAX_LINES] = {};
+
+    Rig() {
+      gen.setAttachCallback([this](uint8_t line, uint8_t dac) {
+        if (lineDac[line] != 0) return;
+        lineDac[line] = dac;
+        attached.push_back(Attach{static_cast<uint32_t>(millis()), line, dac});
+      });
+      gen.setDetachCallback([this](uint8_t line, uint8_t) { lineDac[line] = 0; });
+      gen.begin();
+    }
+
+    // Off-hook and on-hook both run through the loop before the next event
+    void hangUp(uint8_t line) {
+      gen.releaseLine(line);
+      gen.update();
+    }
+  };
+
+  // Every tone needs two generators, so three AD9833s hold one session at a time
+  const char* const kDualPlan =
+    "ready = 350+440/0\n"
+    "busy  = 480+620/250, 0/250\n"
+    "fail  = 950+1400/330, 0/330\n"
+    "ring  = 440+480/1000, 0/5000\n";
+
+  // Latest attach of a line (a preempted line attaches twice)
+  int attachIndex(const std::vector<Attach>& log, uint8_t line) {
+    for (std::size_t i = log.size(); i-- > 0;) {
+      if (log[i].line == line) return static_cast<int>(i);
+    }
+    return -1;
+  }
+}
+
+void setUp() {
+  hostclock::useManual();
+  Settings::instance().resetDefaults();
+  hostfs::files().clear();
+}
+
+void tearDown() {}
+
+// Eight dial tones at once share one session
+void test_eight_offhooks_share_one_ready_session() {
+  Rig rig;
+  for (uint8_t line = 0; line < 8; ++line) {
+    TEST_ASSERT_TRUE(rig.gen.requestTone(line, ToneId::Ready) != 0);
+  }
+  rig.gen.update();
+
+  TEST_ASSERT_EQUAL_UINT32(8, rig.attached.size());
+  for (const Attach& a : rig.attached) TEST_ASSERT_EQUAL_UINT8(rig.attached[0].dac, a.dac);
+  TEST_ASSERT_EQUAL_UINT8(8, rig.gen.listenerCount(rig.attached[0].dac));
+  TEST_ASSERT_EQUAL_UINT32(8, rig.gen.stats().immediate);
+  TEST_ASSERT_EQUAL_UINT32(0, rig.gen.stats().queued);
+}
+
+// Eight lines ask for mixed tones in the same loop pass while only one dual
+// session fits. Higher priorities preempt, the rest queue, and every line is
+// attached once the sessions ahead of it end: priority first, FIFO within one.
+void test_eight_simultaneous_requests_priority_preemption_and_drain() {
+  hostfs::files()["/tones/dual.txt"] = kDualPlan;
+  Rig rig;
+  TEST_ASSERT_TRUE(rig.gen.loadTonePlan("dual"));
+
+  const ToneId wants[8] = {ToneId::Ring, ToneId::Fail, ToneId::Busy, ToneId::Ready,
+                           ToneId::Ring, ToneId::Busy, ToneId::Fail, ToneId::Ready};
+  for (uint8_t line = 0; line < 8; ++line) {
+    rig.gen.requestTone(line, wants[line]);
+  }
+  rig.gen.update();
+
+  // Ring lost to Fail, Fail to Busy, Busy to Ready; line 7 joined Ready
+  const ToneGenerator::AllocatorStats& s = rig.gen.stats();
+  TEST_ASSERT_EQUAL_UINT32(3, s.preemptions);
+  TEST_ASSERT_EQUAL_UINT8(6, s.queueHighWater);
+  TEST_ASSERT_TRUE(rig.lineDac[3] != 0);
+  TEST_ASSERT_EQUAL_UINT8(rig.lineDac[3], rig.lineDac[7]);
+  for (uint8_t line : {0, 1, 2, 4, 5, 6}) TEST_ASSERT_EQUAL_UINT8(0, rig.lineDac[line]);
+
+  // Sessions end one priority at a time
+  delay(1000);
+  rig.hangUp(3);
+  rig.hangUp(7);
+  TEST_ASSERT_TRUE(rig.lineDac[2] != 0);   // Busy, FIFO: queued before line 5
+  TEST_ASSERT_EQUAL_UINT8(rig.lineDac[2], rig.lineDac[5]);
+  TEST_ASSERT_EQUAL_UINT8(0, rig.lineDac[1]);
+
+  delay(1000);
+  rig.hangUp(2);
+  rig.hangUp(5);
+  TEST_ASSERT_TRUE(rig.lineDac[1] != 0);   // Fail
+  TEST_ASSERT_EQUAL_UINT8(rig.lineDac[1], rig.lineDac[6]);
+
+  delay(1000);
+  rig.hangUp(1);
+  rig.hangUp(6);
+  TEST_ASSERT_TRUE(rig.lineDac[0] != 0);   // Ring
+  TEST_ASSERT_EQUAL_UINT8(rig.lineDac[0], rig.lineDac[4]);
+
+  // All eight lines got a tone, in priority order
+  for (uint8_t line = 0; line < 8; ++line) TEST_ASSERT_TRUE(attachIndex(rig.attached, line) >= 0);
+  const int last = static_cast<int>(rig.attached.size()) - 1;
+  TEST_ASSERT_TRUE(attachIndex(rig.attached, 2) < attachIndex(rig.attached, 5));
+  TEST_ASSERT_TRUE(attachIndex(rig.attached, 5) < attachIndex(rig.attached, 1));
+  TEST_ASSERT_TRUE(attachIndex(rig.attached, 1) < attachIndex(rig.attached, 6));
+  TEST_ASSERT_TRUE(attachIndex(rig.attached, 6) < attachIndex(rig.attached, 0));
+  TEST_ASSERT_EQUAL_INT(last, attachIndex(rig.attached, 4));
+
+  TEST_ASSERT_EQUAL_UINT32(6, s.waitedAttach);
+  TEST_ASSERT_EQUAL_UINT32(3000, s.waitMaxMs);
+  TEST_ASSERT_EQUAL_UINT32(4, s.starved);     // Fail and Ring lines still queued at 2 s
+  bench::report("8 lines: %u requests, %u immediate, %u queued, %u preemptions, wait avg %u ms max %u ms",
+                static_cast<unsigned>(s.requests), static_cast<unsigned>(s.immediate), static_cast<unsigned>(s.queued),
+                static_cast<unsigned>(s.preemptions), static_cast<unsigned>(s.waitSumMs / s.waitedAttach),
+                static_cast<unsigned>(s.waitMaxMs));
+}
+
+// ---- Hook-off to dial tone, pre-armed vs cold ----
+//
+// The span LineAction::recordDialToneLatency_() measures, minus the parts both
+// modes share (hook debounce, the loop pass, the MT8816 close): requestTone()
+// until the attach callback. AD9833 words cost their 8 MHz SPI bus time on the
+// host clock; per-transaction driver overhead on the ESP32 comes on top.
+
+namespace {
+  struct DialToneSample {
+    uint32_t us;
+    uint32_t spiWords;
+    uint8_t dac;
+  };
+
+  // 'background' lines hold other tones before line 7 goes off-hook
+  DialToneSample dialTone(bool prearmed, std::initializer_list<ToneId> background) {
+    Settings::instance().toneReadyPrearmed = prearmed;
+    Rig rig;
+    uint8_t line = 0;
+    for (ToneId tone : background) rig.gen.requestTone(line++, tone);
+    rig.gen.update();     // Pre-arms Ready on a free channel if enabled
+    delay(10);
+
+    const std::size_t words = SPI.log.size();
+    const uint32_t start = static_cast<uint32_t>(micros());
+    rig.gen.requestTone(7, ToneId::Ready);
+    return DialToneSample{static_cast<uint32_t>(micros()) - start, static_cast<uint32_t>(SPI.log.size() - words),
+                          rig.lineDac[7]};
+  }
+}
+
+void test_dial_tone_latency_prearmed_vs_cold() {
+  struct Case {
+    const char* name;
+    std::initializer_list<ToneId> background;
+  };
+  const Case cases[] = {
+    {"idle exchange", {}},
+    {"2 of 3 busy", {ToneId::Busy, ToneId::Fail}},
+    {"all 3 busy", {ToneId::Busy, ToneId::Fail, ToneId::Ring}},
+  };
+
+  for (const Case& c : cases) {
+    const DialToneSample cold = dialTone(false, c.background);
+    const DialToneSample armed = dialTone(true, c.background);
+    bench::report("%-13s cold %2u us (%u SPI words)  pre-armed %2u us (%u SPI words)",
+                  c.name, static_cast<unsigned>(cold.us), static_cast<unsigned>(cold.spiWords),
+                  static_cast<unsigned>(armed.us), static_cast<unsigned>(armed.spiWords));
+    TEST_ASSERT_TRUE(cold.dac != 0 && armed.dac != 0);
+    TEST_ASSERT_TRUE(armed.us <= cold.us);
+    TEST_ASSERT_TRUE(armed.spiWords <= cold.spiWords);
+  }
+
+  // With a channel to spare, pre-armed hook-off is only the crosspoint close
+  TEST_ASSERT_EQUAL_UINT32(0, dialTone(true, {}).spiWords);
+  TEST_ASSERT_EQUAL_UINT32(0, dialTone(true, {ToneId::Busy, ToneId::Fail}).spiWords);
+}
+
+// The web setter only hands over a plan name; the loop swaps it in once no
+// line listens. An idle pre-armed dial tone does not hold the swap back.
+void test_tone_plan_swap_waits_for_listeners_not_prearm() {
+  hostfs::files()["/tones/dual.txt"] = kDualPlan;
+  Settings::instance().toneReadyPrearmed = true;
+  Rig rig;
+  rig.gen.update();
+  TEST_ASSERT_TRUE(rig.gen.isPlaying());          // Ready pre-armed, nobody listening
+  TEST_ASSERT_TRUE(rig.gen.canLoadTonePlan());
+  TEST_ASSERT_TRUE(rig.gen.loadTonePlan("dual"));
+
+  rig.gen.update();
+  rig.gen.requestTone(0, ToneId::Busy);
+  TEST_ASSERT_FALSE(rig.gen.canLoadTonePlan());
+  TEST_ASSERT_FALSE(rig.gen.loadTonePlan("dual"));
+  TEST_ASSERT_TRUE(rig.gen.hasTonePlan());        // The refused swap left the old plan in place
+
+  rig.hangUp(0);
+  TEST_ASSERT_TRUE(rig.gen.canLoadTonePlan());
+  TEST_ASSERT_FALSE(rig.gen.loadTonePlan("missing"));
+  TEST_ASSERT_FALSE(rig.gen.hasTonePlan());
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_eight_offhooks_share_one_ready_session);
+  RUN_TEST(test_eight_simultaneous_requests_priority_preemption_and_drain);
+  RUN_TEST(test_dial_tone_latency_prearmed_vs_cold);
+  RUN_TEST(test_tone_plan_swap_waits_for_listeners_not_prearm);
+  return UNITY_END();
+}
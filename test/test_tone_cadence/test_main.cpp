@@ -0,0 +1,141 @@
+// Host test of ToneGenerator cadence timing: esp_timer steps on the manual
+// host clock while the loop stalls, with and without the mutex held
+#include <unity.h>
+#include <vector>
+#include <SPI.h>
+#include "bench.h"
+#include "services/ToneGenerator.h"
+
+using model::ToneId;
+
+namespace {
+  constexpr uint8_t kCsPin = 10;
+  constexpr int64_t kStepUs = 250000;    // Built-in Busy: 425 Hz 250 ms, silence 250 ms
+
+  // AD9833 control writes (D15..D14 = 00) on one chip: one per cadence step
+  std::vector<int64_t> stepWrites(int64_t fromUs) {
+    std::vector<int64_t> out;
+    for (const SPIClass::Transfer& t : SPI.log) {
+      if (t.cs == kCsPin && t.atUs >= fromUs && (t.word & 0xC000) == 0) out.push_back(t.atUs);
+    }
+    return out;
+  }
+
+  // The loop: update() once per millisecond
+  void runLoop(ToneGenerator& gen, uint32_t ms) {
+    for (uint32_t i = 0; i < ms; ++i) {
+      gen.update();
+      delay(1);
+    }
+  }
+
+  struct Drift {
+    int64_t maxLateUs;      // Steps due while the loop was stalled
+    int64_t maxErrorUs;     // Every other step
+    int64_t lastErrorUs;
+    std::size_t steps;
+  };
+
+  // Busy cadence for 2 s, a stall of 'stallMs' (mutex held or not), then 3 s
+  Drift runStall(uint32_t stallMs, bool holdMutex, ToneGenerator::CadenceStats& stats) {
+    AD9833Driver d1{kCsPin};
+    AD9833Driver d2{11};
+    AD9833Driver d3{12};
+    ToneGenerator gen{d1, d2, d3};
+    gen.begin();
+    SPI.log.clear();
+
+    gen.requestTone(0, ToneId::Busy);
+    const std::vector<int64_t> start = stepWrites(0);
+    const int64_t baseUs = micros();            // startChannel_ takes the deadline base after the first step
+
+    runLoop(gen, 2000);
+    const int64_t stallFrom = micros();
+    hostrtos::holdMutexes(holdMutex);
+    delay(stallMs);                             // Loop stuck; esp_timer keeps running
+    hostrtos::holdMutexes(false);
+    const int64_t stallTo = micros();
+    runLoop(gen, 3000);
+
+    Drift d{0, 0, 0, 0};
+    const std::vector<int64_t> writes = stepWrites(start.empty() ? 0 : start.back() + 1);
+    d.steps = writes.size();
+    for (std::size_t k = 0; k < writes.size(); ++k) {
+      const int64_t deadline = baseUs + static_cast<int64_t>(k + 1) * kStepUs;
+      const int64_t error = writes[k] - deadline;
+      if (deadline >= stallFrom && deadline <= stallTo) {
+        if (error > d.maxLateUs) d.maxLateUs = error;
+      } else {
+        const int64_t absError = error < 0 ? -error : error;
+        if (absError > d.maxErrorUs) d.maxErrorUs = absError;
+      }
+      d.lastErrorUs = error;
+    }
+    stats = gen.cadenceStats();
+    gen.stopTone(cfg::mt8816::DAC1);
+    return d;
+  }
+}
+
+void setUp() {
+  hostclock::useManual();
+  Settings::instance().resetDefaults();
+}
+
+void tearDown() {
+  hostrtos::holdMutexes(false);
+}
+
+// The loop is busy (LittleFS, web) but not holding the mutex: the timer task
+// steps on time throughout
+void test_loop_stall_does_not_delay_steps() {
+  ToneGenerator::CadenceStats stats;
+  const Drift d = runStall(700, false, stats);
+  bench::report("stall 700 ms, mutex free: %u steps, in-stall late max %lld us, other max %lld us, last %lld us",
+                static_cast<unsigned>(d.steps), static_cast<long long>(d.maxLateUs),
+                static_cast<long long>(d.maxErrorUs), static_cast<long long>(d.lastErrorUs));
+  TEST_ASSERT_EQUAL_UINT32(22, d.steps);      // 5.7 s of 250 ms steps
+  TEST_ASSERT_TRUE(d.maxLateUs == 0);
+  TEST_ASSERT_TRUE(d.maxErrorUs == 0);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.lockRetries);
+}
+
+// The loop holds the mutex for the whole stall: steps due in it are late and
+// retried every kTimerRetryUs, but the deadlines stay on the absolute grid, so
+// the steps after the stall are back on time and nothing accumulates
+void test_mutex_held_stall_late_then_no_drift() {
+  ToneGenerator::CadenceStats stats;
+  const Drift d = runStall(700, true, stats);
+  bench::report("stall 700 ms, mutex held: %u steps, in-stall late max %lld us, other max %lld us, last %lld us, %u retries",
+                static_cast<unsigned>(d.steps), static_cast<long long>(d.maxLateUs),
+                static_cast<long long>(d.maxErrorUs), static_cast<long long>(d.lastErrorUs),
+                static_cast<unsigned>(stats.lockRetries));
+  TEST_ASSERT_EQUAL_UINT32(22, d.steps);
+  TEST_ASSERT_TRUE(d.maxLateUs > 0);
+  TEST_ASSERT_TRUE(d.maxLateUs <= 700000);
+  TEST_ASSERT_TRUE(d.maxErrorUs == 0);
+  TEST_ASSERT_TRUE(d.lastErrorUs == 0);
+  TEST_ASSERT_TRUE(stats.lockRetries > 0);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.staleDropped);
+}
+
+// A stall longer than a step: the missed steps are applied back to back when
+// the mutex frees, then the cadence continues on the original grid
+void test_stall_longer_than_a_step_catches_up() {
+  ToneGenerator::CadenceStats stats;
+  const Drift d = runStall(1300, true, stats);
+  bench::report("stall 1300 ms, mutex held: %u steps, in-stall late max %lld us, other max %lld us, last %lld us",
+                static_cast<unsigned>(d.steps), static_cast<long long>(d.maxLateUs),
+                static_cast<long long>(d.maxErrorUs), static_cast<long long>(d.lastErrorUs));
+  TEST_ASSERT_EQUAL_UINT32(25, d.steps);      // 6.3 s of 250 ms steps
+  TEST_ASSERT_TRUE(d.maxErrorUs == 0);
+  TEST_ASSERT_TRUE(d.lastErrorUs == 0);
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_loop_stall_does_not_delay_steps);
+  RUN_TEST(test_mutex_held_stall_late_then_no_drift);
+  RUN_TEST(test_stall_longer_than_a_step_catches_up);
+  return UNITY_END();
+}
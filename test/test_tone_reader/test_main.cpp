@@ -0,0 +1,247 @@
+// Host simulation of the shared MT8870 scan: ToneReader -> MCPDriver ->
+// MCP_MAIN on the I2C stub, with the TMUX address read back from its OLAT and
+// an MT8870 model driving STD and Q1-Q4 from the selected line. Dialers press
+// keys on several lines at once; the reports give how many digits the
+// weighted scan (pickNextLine_) catches and how long each one takes.
+#include <unity.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <Wire.h>
+#include "bench.h"
+#include "drivers/InterruptManager.h"
+#include "drivers/MCPDriver.h"
+#include "services/LineManager.h"
+#include "services/ToneReader.h"
+
+namespace {
+  // MT8870 with the usual guard-time RC: STD rises once a tone has been on the
+  // selected input this long, and drops this long after it goes away
+  constexpr uint32_t kRecognizeMs = 30;
+  constexpr uint32_t kReleaseMs = 10;
+
+  uint8_t nibbleOf(char digit) {
+    if (digit >= '1' && digit <= '9') return static_cast<uint8_t>(digit - '0');
+    if (digit == '0') return 10;
+    if (digit == '*') return 11;
+    return 12;   // '#'
+  }
+
+  struct Key {
+    unsigned long onMs;
+    unsigned long offMs;
+    char digit;
+  };
+
+  // How a person (or a phone's memory dial) keys a number
+  struct Keying {
+    const char* name;
+    uint32_t toneMs;
+    uint32_t gapMs;
+    uint32_t jitterMs;
+  };
+
+  struct Dialer {
+    std::vector<Key> keys;
+    std::size_t received = 0;     // Digits seen in dialedDigits so far
+  };
+
+  struct Result {
+    uint32_t sent = 0;
+    uint32_t caught = 0;
+    uint32_t wrong = 0;           // Caught on the wrong line or as the wrong digit
+    std::vector<uint32_t> latencyMs;   // Key down -> digit in dialedDigits
+  };
+
+  struct Exchange {
+    MCPDriver mcp;
+    InterruptManager interrupts{mcp, Settings::instance()};
+    LineManager lines{Settings::instance()};
+    ToneReader reader{interrupts, mcp, Settings::instance(), lines};
+    hosti2c::Mcp23017* main = nullptr;
+
+    bool stdHigh = false;
+    unsigned long heardSinceMs = 0;   // Selected input carried the current tone since
+    unsigned long silentSinceMs = 0;
+    int lastSel = -1;
+
+    Exchange() {
+      hosti2c::reset();
+      main = &hosti2c::bus().add(cfg::mcp::MCP_MAIN_ADDRESS, cfg::mcp::MCP_MAIN_INT_PIN);
+      main->setInput(cfg::mcp::STD, false);
+      for (uint8_t q : {cfg::mcp::Q1, cfg::mcp::Q2, cfg::mcp::Q3, cfg::mcp::Q4}) main->setInput(q, false);
+      mcp.begin();
+      lines.setToneReader(&reader);
+      lines.begin();
+    }
+
+    int selectedLine() const {
+      const uint8_t sel = static_cast<uint8_t>(main->word(hosti2c::Mcp23017::OLATA) & 0x07);
+      for (uint8_t l = 0; l < cfg::lines::MAX_LINES; ++l) {
+        const auto& t = const_cast<LineManager&>(lines).getLine(l).tmuxAddress;
+        const uint8_t lineSel = static_cast<uint8_t>((t[0] ? 4 : 0) | (t[1] ? 2 : 0) | (t[2] ? 1 : 0));
+        if (lineSel == sel) return l;
+      }
+      return -1;
+    }
+
+    // One millisecond of the MT8870 on whatever line the TMUX selects
+    void mt8870(const std::vector<Dialer>& dialers, unsigned long now) {
+      const int line = selectedLine();
+      if (line != lastSel) {
+        lastSel = line;
+        heardSinceMs = now;         // New input: the guard time starts over
+      }
+      const Key* key = nullptr;
+      if (line >= 0 && static_cast<std::size_t>(line) < dialers.size()) {
+        for (const Key& k : dialers[line].keys) {
+          if (now >= k.onMs && now < k.offMs) key = &k;
+        }
+      }
+      if (key == nullptr) {
+        if (stdHigh && now - silentSinceMs >= kReleaseMs) {
+          stdHigh = false;
+          main->setInput(cfg::mcp::STD, false);
+        }
+        if (!stdHigh) heardSinceMs = now;
+        return;
+      }
+      silentSinceMs = now + 1;
+      const unsigned long since = heardSinceMs > key->onMs ? heardSinceMs : key->onMs;
+      if (!stdHigh && now - since >= kRecognizeMs) {
+        const uint8_t n = nibbleOf(key->digit);
+        main->setInput(cfg::mcp::Q1, n & 1);
+        main->setInput(cfg::mcp::Q2, n & 2);
+        main->setInput(cfg::mcp::Q3, n & 4);
+        main->setInput(cfg::mcp::Q4, n & 8);
+        stdHigh = true;
+        main->setInput(cfg::mcp::STD, true);
+      }
+    }
+  };
+
+  // Deterministic keying: each line dials 'digits' keys, starting 2-3 s in
+  // (after the MT8870 has powered up), with gaps and tone lengths jittered around 'k'
+  std::vector<Dialer> makeDialers(uint8_t count, uint8_t digits, const Keying& k, uint32_t seed) {
+    std::vector<Dialer> out(count);
+    uint32_t rng = seed;
+    auto next = [&rng](uint32_t range) {
+      rng = rng * 1664525u + 1013904223u;
+      return range ? (rng >> 8) % range : 0u;
+    };
+    const char* const alphabet = "0123456789*#";
+    for (uint8_t l = 0; l < count; ++l) {
+      unsigned long t = 2000 + next(1000);
+      for (uint8_t d = 0; d < digits; ++d) {
+        const uint32_t tone = k.toneMs + next(k.jitterMs + 1);
+        out[l].keys.push_back(Key{t, t + tone, alphabet[next(12)]});
+        t += tone + k.gapMs + next(k.jitterMs + 1);
+      }
+    }
+    return out;
+  }
+
+  Result simulate(uint8_t count, uint8_t digits, const Keying& k, uint32_t seed) {
+    Exchange ex;
+    std::vector<Dialer> dialers = makeDialers(count, digits, k, seed);
+    for (uint8_t l = 0; l < count; ++l) ex.lines.setStatus(l, model::LineStatus::Ready);
+
+    unsigned long end = 0;
+    for (const Dialer& d : dialers) end = std::max(end, d.keys.back().offMs + 500);
+    const unsigned long startMs = millis();
+    Result r;
+    while (millis() - startMs < end) {
+      const unsigned long now = millis() - startMs;
+      ex.mt8870(dialers, now);
+      ex.interrupts.collectInterrupts();
+      ex.reader.update();
+
+      for (uint8_t l = 0; l < count; ++l) {
+        const std::string got = ex.lines.getLine(l).dialedDigits.c_str();
+        Dialer& d = dialers[l];
+        while (d.received < got.size()) {
+          const char c = got[d.received++];
+          // The key this digit belongs to: the latest one pressed by now
+          const Key* key = nullptr;
+          for (const Key& kk : d.keys) {
+            if (kk.onMs <= now) key = &kk;
+          }
+          if (key == nullptr || key->digit != c) {
+            r.wrong++;
+            continue;
+          }
+          r.caught++;
+          r.latencyMs.push_back(static_cast<uint32_t>(now - key->onMs));
+        }
+      }
+      hostclock::advanceUs(1000);
+    }
+    r.sent = static_cast<uint32_t>(count) * digits;
+    return r;
+  }
+
+  uint32_t percentile(std::vector<uint32_t> v, double p) {
+    if (v.empty()) return 0;
+    std::sort(v.begin(), v.end());
+    return v[static_cast<std::size_t>(p * (v.size() - 1))];
+  }
+
+  double mean(const std::vector<uint32_t>& v) {
+    if (v.empty()) return 0.0;
+    double sum = 0.0;
+    for (uint32_t x : v) sum += x;
+    return sum / v.size();
+  }
+
+  const Keying kKeypad{"keypad", 110, 180, 60};    // Finger on a keypad
+  const Keying kMemory{"memory", 80, 80, 0};       // Memory dial, ITU-ish minimums
+}
+
+void setUp() {
+  hostclock::useManual();
+  Settings::instance().resetDefaults();
+}
+
+void tearDown() {}
+
+// One dialer at a time: the scan sits on the line and nothing is missed
+void test_single_dialer_catches_every_digit() {
+  for (const Keying* k : {&kKeypad, &kMemory}) {
+    const Result r = simulate(1, 10, *k, 7);
+    bench::report("1 dialer  %-6s: %u/%u digits, latency avg %.0f ms, max %u ms", k->name, r.caught, r.sent,
+                  mean(r.latencyMs), percentile(r.latencyMs, 1.0));
+    TEST_ASSERT_EQUAL_UINT32(r.sent, r.caught);
+    TEST_ASSERT_EQUAL_UINT32(0, r.wrong);
+  }
+}
+
+// Several lines keying at once through the one MT8870. Every figure is over
+// five seeds of ten digits per line; a digit counts as missed when it never
+// reaches dialedDigits and as wrong when it lands on another line or value.
+void test_concurrent_dialers_miss_rate_and_latency() {
+  for (const Keying* k : {&kKeypad, &kMemory}) {
+    for (uint8_t count : {2, 4, 8}) {
+      Result all;
+      for (uint32_t seed = 1; seed <= 5; ++seed) {
+        const Result r = simulate(count, 10, *k, seed * 7919u);
+        all.sent += r.sent;
+        all.caught += r.caught;
+        all.wrong += r.wrong;
+        all.latencyMs.insert(all.latencyMs.end(), r.latencyMs.begin(), r.latencyMs.end());
+      }
+      const double miss = 100.0 * (all.sent - all.caught) / all.sent;
+      bench::report("%u dialers %-6s: miss %5.1f%% (%u of %u), wrong %u, latency avg %.0f / p95 %u / max %u ms",
+                    count, k->name, miss, all.sent - all.caught, all.sent, all.wrong, mean(all.latencyMs),
+                    percentile(all.latencyMs, 0.95), percentile(all.latencyMs, 1.0));
+      TEST_ASSERT_EQUAL_UINT32(0, all.wrong);
+      if (count == 2 && k == &kKeypad) TEST_ASSERT_TRUE(miss < 25.0);   // Two people dialling at once
+    }
+  }
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_single_dialer_catches_every_digit);
+  RUN_TEST(test_concurrent_dialers_miss_rate_and_latency);
+  return UNITY_END();
+}
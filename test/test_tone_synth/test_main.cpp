@@ -0,0 +1,133 @@
+// Host tests for ToneSynth: the DDS output (frequency, cadence) and render
+// throughput per tone. The synth task does not run on the host; the tests
+// drive the render side through renderNext().
+#include <unity.h>
+#include <cmath>
+#include <vector>
+#include "bench.h"
+#include "services/ToneSynth.h"
+#include "settings/Settings.h"
+
+namespace {
+  constexpr std::size_t kFrames = cfg::synth::BLOCK_FRAMES;
+  constexpr uint32_t kRate = cfg::synth::SAMPLE_RATE_HZ;
+
+  struct Rig {
+    PCMDriver pcm{I2S_NUM_1};
+    ToneSynth synth{pcm};
+    Rig() { synth.begin(); }
+    ~Rig() { i2s_driver_uninstall(I2S_NUM_1); }
+  };
+
+  std::vector<int16_t> render(ToneSynth& synth, std::size_t frames) {
+    std::vector<int16_t> out(frames);
+    for (std::size_t done = 0; done < frames; done += kFrames) {
+      synth.renderNext(out.data() + done, std::min(kFrames, frames - done));
+    }
+    return out;
+  }
+
+  // Sign changes from negative to non-negative = periods
+  uint32_t risingCrossings(const std::vector<int16_t>& s, std::size_t from, std::size_t to) {
+    uint32_t n = 0;
+    for (std::size_t i = from + 1; i < to; ++i) {
+      if (s[i - 1] < 0 && s[i] >= 0) n++;
+    }
+    return n;
+  }
+}
+
+void setUp() {
+  hostclock::useManual();
+  Settings::instance().resetDefaults();
+}
+
+void tearDown() {}
+
+void test_single_tone_frequency_and_level() {
+  Rig rig;
+  const ToneSynth::Step ready[] = {{425.0f, 0.0f, 0}};
+  TEST_ASSERT_TRUE(rig.synth.play(ready, 1));
+  const std::vector<int16_t> s = render(rig.synth, kRate);   // One second
+
+  const uint32_t periods = risingCrossings(s, 0, s.size());
+  TEST_ASSERT_TRUE(periods >= 424 && periods <= 426);
+  int16_t peak = 0;
+  for (int16_t v : s) peak = std::max<int16_t>(peak, static_cast<int16_t>(std::abs(v)));
+  TEST_ASSERT_TRUE(peak >= cfg::synth::AMPLITUDE_Q15 - 200 && peak <= cfg::synth::AMPLITUDE_Q15);
+}
+
+// Busy cadence: 250 ms on, 250 ms off, counted in samples across block edges
+void test_cadence_steps_are_sample_exact() {
+  Rig rig;
+  const ToneSynth::Step busy[] = {{425.0f, 0.0f, 250}, {0.0f, 0.0f, 250}};
+  TEST_ASSERT_TRUE(rig.synth.play(busy, 2));
+  const std::vector<int16_t> s = render(rig.synth, kRate);
+
+  const std::size_t step = kRate / 4;   // 4000 samples, not a multiple of the block
+  for (std::size_t i = step; i < 2 * step; ++i) TEST_ASSERT_EQUAL_INT16(0, s[i]);
+  for (std::size_t i = 3 * step; i < 4 * step; ++i) TEST_ASSERT_EQUAL_INT16(0, s[i]);
+  const uint32_t on = risingCrossings(s, 0, step) + risingCrossings(s, 2 * step, 3 * step);
+  TEST_ASSERT_TRUE(on >= 210 && on <= 214);   // 2 x 106.25 periods
+}
+
+// One session at a time: a new play() replaces the running tone at the next
+// block, stop() silences it
+void test_play_replaces_the_session_and_stop_silences() {
+  Rig rig;
+  const ToneSynth::Step ready[] = {{425.0f, 0.0f, 0}};
+  const ToneSynth::Step fail[] = {{950.0f, 0.0f, 0}};
+  int16_t block[kFrames];
+  rig.synth.play(ready, 1);
+  TEST_ASSERT_EQUAL_UINT32(kFrames, rig.synth.renderNext(block, kFrames));
+
+  rig.synth.play(fail, 1);
+  const std::vector<int16_t> s = render(rig.synth, kRate);
+  const uint32_t periods = risingCrossings(s, 0, s.size());
+  TEST_ASSERT_TRUE(periods >= 949 && periods <= 951);
+
+  rig.synth.stop();
+  TEST_ASSERT_EQUAL_UINT32(0, rig.synth.renderNext(block, kFrames));
+  TEST_ASSERT_FALSE(rig.synth.isActive());
+}
+
+// Render cost per tone shape on the host. The device needs kRate frames per
+// second; the report shows the headroom over that and samples per second per
+// running oscillator, the figure samplesPerSecondPerTone() gives on the ESP32.
+void test_render_throughput_per_tone() {
+  struct Case {
+    const char* name;
+    ToneSynth::Step steps[2];
+    std::size_t count;
+    uint32_t oscillators;
+  };
+  const Case cases[] = {
+    {"se ready 425", {{425.0f, 0.0f, 0}}, 1, 1},
+    {"itu ready 350+440", {{350.0f, 440.0f, 0}}, 1, 2},
+    {"na busy 480+620/500", {{480.0f, 620.0f, 500}, {0.0f, 0.0f, 500}}, 2, 1},   // 2 on, 0 off
+  };
+
+  for (const Case& c : cases) {
+    Rig rig;
+    TEST_ASSERT_TRUE(rig.synth.play(c.steps, c.count));
+    int16_t block[kFrames];
+    const double ns = bench::nsPerCall(20000, [&] {
+      rig.synth.renderNext(block, kFrames);
+      bench::keep(block);
+    });
+    const double framesPerSec = kFrames * 1e9 / ns;
+    bench::report("%-20s %6.0f ns/block  %5.1f Msamples/s per oscillator  %5.0fx real time",
+                  c.name, ns, framesPerSec * c.oscillators / 1e6,
+                  framesPerSec / kRate);
+    TEST_ASSERT_TRUE(framesPerSec > kRate);
+  }
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_single_tone_frequency_and_level);
+  RUN_TEST(test_cadence_steps_are_sample_exact);
+  RUN_TEST(test_play_replaces_the_session_and_stop_silences);
+  RUN_TEST(test_render_throughput_per_tone);
+  return UNITY_END();
+}